@@ -0,0 +1,321 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+/*!
+  \file Shard_Driver.cc
+*/
+
+#include "Shard_Driver.hh"
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <numeric>
+#include <poll.h>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+/* What a worker sends to the parent for each file, followed by the captured
+   std::cout and std::cerr text */
+struct Record_Header {
+  std::uint64_t index;
+  std::uint32_t ok;
+  std::uint32_t unused;
+  double seconds;
+  std::uint64_t out_size;
+  std::uint64_t err_size;
+};
+
+bool write_all(int const fd, char const *buf, std::size_t size) {
+  while (size > 0) {
+    ssize_t const n = write(fd, buf, size);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    buf += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+std::string describe_exit(int const wait_status) {
+  std::ostringstream os;
+  if (WIFSIGNALED(wait_status)) {
+    int const sig = WTERMSIG(wait_status);
+    os << "worker killed by signal " << sig << " (" << strsignal(sig) << ')';
+  } else if (WIFEXITED(wait_status)) {
+    os << "worker exited with status " << WEXITSTATUS(wait_status);
+  } else {
+    os << "worker stopped";
+  }
+  return os.str();
+}
+
+} // namespace
+
+//! The parent's view of a worker process
+struct Shard_Driver::Worker_ {
+  pid_t pid{-1};
+  int fd{-1};
+  //! The files left to do, in order
+  std::vector<std::size_t> shard;
+  //! The number of files in shard that have been reported
+  std::size_t next{0};
+  //! Data received but not yet decoded
+  std::string buf;
+};
+
+bool Shard_Driver::run(std::vector<std::string> const &filenames) {
+  using clock = std::chrono::steady_clock;
+  auto const start = clock::now();
+  std::size_t const N = filenames.size();
+  filenames_ = &filenames;
+  results_.assign(N, Result{});
+  out_.assign(N, std::string{});
+  err_.assign(N, std::string{});
+  next_flush_ = 0;
+  num_failed_ = num_restarts_ = 0;
+  split_(filenames);
+
+  /* Anything still buffered would be written again by each worker */
+  std::cout.flush();
+  std::cerr.flush();
+
+  std::vector<Worker_> workers(shards_.size());
+  for (std::size_t k = 0; k < workers.size(); ++k) {
+    workers[k].shard = std::move(shards_[k]);
+    start_(workers[k]);
+  }
+
+  std::vector<pollfd> fds;
+  std::vector<Worker_ *> polled;
+  char buf[65536];
+  for (;;) {
+    fds.clear();
+    polled.clear();
+    for (auto &w : workers) {
+      if (w.fd >= 0) {
+        fds.push_back(pollfd{w.fd, POLLIN, 0});
+        polled.push_back(&w);
+      }
+    }
+    if (fds.empty())
+      break;
+    if (poll(fds.data(), fds.size(), -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      std::cerr << "Shard_Driver: poll failed: " << std::strerror(errno)
+                << std::endl;
+      break;
+    }
+    for (std::size_t p = 0; p < fds.size(); ++p) {
+      if (!fds[p].revents)
+        continue;
+      Worker_ &w = *polled[p];
+      ssize_t const n = read(w.fd, buf, sizeof(buf));
+      if (n > 0) {
+        receive_(w, buf, static_cast<std::size_t>(n));
+      } else if (n == 0 || errno != EINTR) {
+        close(w.fd);
+        w.fd = -1;
+        int status{0};
+        while (waitpid(w.pid, &status, 0) < 0 && errno == EINTR)
+          ;
+        finish_(w, status);
+      }
+    }
+  }
+
+  filenames_ = nullptr;
+  wall_seconds_ = std::chrono::duration<double>(clock::now() - start).count();
+  return num_failed_ == 0;
+}
+
+std::ostream &Shard_Driver::print_summary(std::ostream &os) const {
+  double const work_seconds = std::accumulate(
+      results_.begin(), results_.end(), 0.0,
+      [](double s, Result const &r) { return s + r.seconds; });
+  return os << results_.size() - num_failed_ << " of " << results_.size()
+            << " files succeeded in " << wall_seconds_ << " s with "
+            << num_workers_ << " worker processes (" << work_seconds
+            << " s of work, " << num_restarts_ << " restarts)\n";
+}
+
+/* Assign each file, largest first, to the shard with the least total size.
+   Each shard is then done in file order, so that output can be written as
+   soon as possible. */
+void Shard_Driver::split_(std::vector<std::string> const &filenames) {
+  std::size_t const N = filenames.size();
+  std::vector<off_t> cost(N, 1);
+  for (std::size_t i = 0; i < N; ++i) {
+    struct stat st;
+    if (stat(filenames[i].c_str(), &st) == 0 && st.st_size > 0)
+      cost[i] = st.st_size;
+  }
+  std::vector<std::size_t> order(N);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&cost](std::size_t a, std::size_t b) {
+                     return cost[a] > cost[b];
+                   });
+
+  shards_.assign(std::min<std::size_t>(num_workers_, N), {});
+  std::vector<off_t> load(shards_.size(), 0);
+  for (std::size_t const i : order) {
+    std::size_t const k = static_cast<std::size_t>(
+        std::min_element(load.begin(), load.end()) - load.begin());
+    shards_[k].push_back(i);
+    load[k] += cost[i];
+  }
+  for (auto &s : shards_)
+    std::sort(s.begin(), s.end());
+}
+
+/* Fork a worker for the files in w.shard */
+void Shard_Driver::start_(Worker_ &w) {
+  w.next = 0;
+  w.buf.clear();
+  int fds[2];
+  pid_t pid{-1};
+  if (pipe(fds) == 0) {
+    pid = fork();
+    if (pid < 0) {
+      close(fds[0]);
+      close(fds[1]);
+    }
+  }
+  if (pid < 0) {
+    std::string const error{std::string{"unable to start a worker: "} +
+                            std::strerror(errno)};
+    for (std::size_t const i : w.shard) {
+      results_[i].done = true;
+      results_[i].error = error;
+      num_failed_ += 1;
+    }
+    w.shard.clear();
+    flush_output_();
+    return;
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    work_loop_(fds[1], w.shard);
+    close(fds[1]);
+    /* Skip the parent's exit handlers and static destructors */
+    _exit(0);
+  }
+  close(fds[1]);
+  w.pid = pid;
+  w.fd = fds[0];
+}
+
+/* The body of a worker process */
+void Shard_Driver::work_loop_(int const fd,
+                              std::vector<std::size_t> const &shard) const {
+  using clock = std::chrono::steady_clock;
+  std::streambuf *const cout_buf = std::cout.rdbuf();
+  std::streambuf *const cerr_buf = std::cerr.rdbuf();
+  for (std::size_t const i : shard) {
+    std::ostringstream out, err;
+    std::cout.rdbuf(out.rdbuf());
+    std::cerr.rdbuf(err.rdbuf());
+    auto const start = clock::now();
+    bool ok{false};
+    try {
+      ok = work_((*filenames_)[i]);
+    } catch (std::exception const &e) {
+      std::cerr << (*filenames_)[i] << ": " << e.what() << '\n';
+    }
+    double const seconds =
+        std::chrono::duration<double>(clock::now() - start).count();
+    std::cout.rdbuf(cout_buf);
+    std::cerr.rdbuf(cerr_buf);
+    std::string const out_text{out.str()}, err_text{err.str()};
+    Record_Header const h{i,       ok, 0, seconds, out_text.size(),
+                          err_text.size()};
+    if (!write_all(fd, reinterpret_cast<char const *>(&h), sizeof(h)) ||
+        !write_all(fd, out_text.data(), out_text.size()) ||
+        !write_all(fd, err_text.data(), err_text.size()))
+      _exit(3);
+  }
+}
+
+/* Decode the complete records in the data from w */
+void Shard_Driver::receive_(Worker_ &w, char const *buf,
+                            std::size_t const size) {
+  w.buf.append(buf, size);
+  std::size_t pos{0};
+  while (w.buf.size() - pos >= sizeof(Record_Header)) {
+    Record_Header h;
+    std::memcpy(&h, w.buf.data() + pos, sizeof(h));
+    std::size_t const total = sizeof(h) + h.out_size + h.err_size;
+    if (w.buf.size() - pos < total)
+      break;
+    assert(w.next < w.shard.size() && w.shard[w.next] == h.index);
+    Result &r = results_[h.index];
+    r.done = true;
+    r.ok = h.ok != 0;
+    r.seconds = h.seconds;
+    char const *const text = w.buf.data() + pos + sizeof(h);
+    out_[h.index].assign(text, h.out_size);
+    err_[h.index].assign(text + h.out_size, h.err_size);
+    if (!r.ok)
+      num_failed_ += 1;
+    w.next += 1;
+    pos += total;
+  }
+  w.buf.erase(0, pos);
+  flush_output_();
+}
+
+/* Handle the end of a worker.  If it didn't report on all of its files, the
+   first unreported file is the one that it died on: record that, and start a
+   new worker on the rest. */
+void Shard_Driver::finish_(Worker_ &w, int const wait_status) {
+  if (w.next < w.shard.size()) {
+    Result &r = results_[w.shard[w.next]];
+    r.done = true;
+    r.crashed = true;
+    r.error = describe_exit(wait_status);
+    num_failed_ += 1;
+    w.shard.erase(w.shard.begin(), w.shard.begin() + w.next + 1);
+    flush_output_();
+    if (!w.shard.empty()) {
+      num_restarts_ += 1;
+      start_(w);
+    }
+  }
+}
+
+/* Write the captured output of the files that are done, in file order, up to
+   the first one that isn't */
+void Shard_Driver::flush_output_() {
+  while (next_flush_ < results_.size() && results_[next_flush_].done) {
+    Result const &r = results_[next_flush_];
+    std::cout << out_[next_flush_];
+    std::cerr << err_[next_flush_];
+    if (!r.error.empty())
+      std::cerr << (*filenames_)[next_flush_] << ": " << r.error << '\n';
+    out_[next_flush_] = std::string{};
+    err_[next_flush_] = std::string{};
+    next_flush_ += 1;
+  }
+  std::cout.flush();
+  std::cerr.flush();
+}
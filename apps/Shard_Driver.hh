@@ -0,0 +1,91 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+/*!
+  \file Shard_Driver.hh
+
+  Run a per-file function over a list of files in forked worker processes.
+*/
+
+#ifndef SHARD_DRIVER_HH
+#define SHARD_DRIVER_HH 1
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//! Split a list of files across worker processes
+/*! The files are divided into one shard per worker, balancing the estimated
+    cost (the file size) of each shard.  Each worker is a fork() of the calling
+    process, and calls the work function on the files of its shard, one at a
+    time.  Anything that the work function writes to std::cout or std::cerr is
+    captured and sent back to the parent over a pipe, along with the return
+    value and the time taken.  The parent writes the captured output in file
+    order, as soon as all of the earlier files are done.
+
+    If a worker dies (a signal, or a call to exit()), the file it was working
+    on is reported as failed, and a new worker is started on the rest of the
+    shard.  So, one bad file costs one file, not a shard or the whole run.
+
+    Call run() before starting any threads: the workers are forked from the
+    calling thread. */
+class Shard_Driver {
+public:
+  //! Process one file, returning true on success
+  using Work_Function = std::function<bool(std::string const &filename)>;
+
+  //! What happened to one file
+  struct Result {
+    bool done{false};    //!< a worker reported on the file
+    bool ok{false};      //!< the work function returned true
+    bool crashed{false}; //!< the worker died while processing the file
+    double seconds{0};   //!< time spent in the work function
+    std::string error;   //!< why the worker died
+  };
+
+  Shard_Driver(unsigned const num_workers, Work_Function work)
+      : num_workers_{num_workers > 0 ? num_workers : 1}, work_{
+                                                             std::move(work)} {}
+
+  //! Process the files, returning true if all of them succeeded
+  bool run(std::vector<std::string> const &filenames);
+
+  std::vector<Result> const &results() const noexcept { return results_; }
+  std::size_t num_failed() const noexcept { return num_failed_; }
+  //! The number of workers started to replace ones that died
+  std::size_t num_restarts() const noexcept { return num_restarts_; }
+  double wall_seconds() const noexcept { return wall_seconds_; }
+  //! Write a one-line summary of the last run()
+  std::ostream &print_summary(std::ostream &os) const;
+
+private:
+  struct Worker_;
+  void split_(std::vector<std::string> const &filenames);
+  void start_(Worker_ &w);
+  void work_loop_(int const fd, std::vector<std::size_t> const &shard) const;
+  void receive_(Worker_ &w, char const *buf, std::size_t const size);
+  void finish_(Worker_ &w, int const wait_status);
+  void flush_output_();
+
+private:
+  unsigned num_workers_;
+  Work_Function work_;
+  std::vector<std::string> const *filenames_{nullptr};
+  std::vector<std::vector<std::size_t>> shards_;
+  std::vector<Result> results_;
+  std::vector<std::string> out_, err_;
+  std::size_t next_flush_{0};
+  std::size_t num_failed_{0}, num_restarts_{0};
+  double wall_seconds_{0};
+};
+
+#endif
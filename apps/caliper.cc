@@ -16,12 +16,20 @@
   scanned for conditional return statements: if they exist, a labeled continue
   statement is introduced about the end caliper, and the return is replaced with
   a branch to that continue.
+
+  Several files may be given.  With -p N, they are split across N worker
+  processes.
 */
 
+#include "Shard_Driver.hh"
 #include "flpr/flpr.hh"
 #include <cassert>
+#include <cstdlib>
 #include <iostream>
 #include <set>
+#include <string>
+#include <unistd.h>
+#include <vector>
 
 /*--------------------------------------------------------------------------*/
 
@@ -39,32 +47,76 @@ bool exclude_procedure(Procedure const &subp);
 void count_return_stmts(Procedure const &proc, int &num_if_stmt_returns,
                         int &num_internal_returns, int &num_final_returns);
 void convert_return_stmts(Procedure &proc, int label);
-bool caliper_file(std::string const &filename);
+bool caliper_file(std::string const &filename, bool const diff_only);
 void write_file(std::ostream &os, File const &f);
+void print_usage(std::ostream &os);
 
 /*--------------------------------------------------------------------------*/
 
-int main(int argc, char const *argv[]) {
-  if (argc != 2) {
-    std::cerr << "Usage: caliper <filename>" << std::endl;
+int main(int argc, char *const argv[]) {
+  bool diff_only{false};
+  unsigned num_procs{0};
+  int ch;
+  while ((ch = getopt(argc, argv, "dp:")) != -1) {
+    switch (ch) {
+    case 'd':
+      diff_only = true;
+      break;
+    case 'p':
+      num_procs = std::strtoul(optarg, nullptr, 10);
+      if (num_procs < 1) {
+        print_usage(std::cerr);
+        return 1;
+      }
+      break;
+    default:
+      print_usage(std::cerr);
+      return 1;
+    }
+  }
+  std::vector<std::string> filenames(argv + optind, argv + argc);
+  if (filenames.empty()) {
+    print_usage(std::cerr);
     return 1;
   }
-  if (!caliper_file(std::string{argv[1]}))
-    return 2;
-  return 0;
+
+  if (num_procs > 0) {
+    Shard_Driver shards(num_procs, [diff_only](std::string const &filename) {
+      return caliper_file(filename, diff_only);
+    });
+    if (!shards.run(filenames))
+      return 2;
+    return 0;
+  }
+
+  bool ok{true};
+  for (auto const &filename : filenames)
+    ok = caliper_file(filename, diff_only) && ok;
+  return ok ? 0 : 2;
+}
+
+void print_usage(std::ostream &os) {
+  os << "Usage: caliper [-d] [-p N] <filename> ..." << std::endl;
+  os << "\t-d\tprint a unified diff rather than the whole file" << std::endl;
+  os << "\t-p N\tprocess the files in N worker processes" << std::endl;
 }
 
 /*--------------------------------------------------------------------------*/
 
-bool caliper_file(std::string const &filename) {
-  File file(filename, 0);
+bool caliper_file(std::string const &filename, bool const diff_only) {
+  File file;
+  file.set_keep_original_lines(diff_only);
+  file.read_file(filename, 0);
   if (!file)
     return false;
 
   FLPR::Procedure_Visitor puv(file, caliper_procedure);
   bool const changed = puv.visit();
   if (changed) {
-    write_file(std::cout, file);
+    if (diff_only)
+      file.logical_file().write_diff(std::cout);
+    else
+      write_file(std::cout, file);
   }
   return changed;
 }
@@ -244,7 +296,5 @@ void convert_return_stmts(Procedure &proc, int label) {
 /*--------------------------------------------------------------------------*/
 
 void write_file(std::ostream &os, File const &f) {
-  for (auto const &ll : f.logical_lines()) {
-    os << ll;
-  }
+  f.logical_file().write(os);
 }
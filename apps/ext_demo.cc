@@ -58,7 +58,7 @@ int main() {
   /* If you have a lot of those kind of commas in your code base, you can create
      an action-stmt grammar extension that accepts that format. */
   auto &exts = FLPR::Stmt::get_parser_exts();
-  exts.register_action_stmt(FLPR::Stmt::write_comma_stmt);
+  exts.register_action_stmt(FLPR::Stmt::write_comma_stmt, "write_comma_stmt");
   std::cout << "Extended ";
   parse_executable_construct(lf_comma);
 
@@ -66,7 +66,8 @@ int main() {
      want to give it something unique, in case you need to act on it
      specially */
   exts.clear();
-  exts.register_action_stmt(FLPR::Stmt::write_comma_stmt_mytag);
+  exts.register_action_stmt(FLPR::Stmt::write_comma_stmt_mytag,
+                            "write_comma_stmt_mytag");
 
   /* If you are printing out the syntax tree, as in this example, you can
      register a label and a type (see Syntax_Tags_Defs.hh for a description of
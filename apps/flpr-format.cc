@@ -20,11 +20,17 @@
   extensions in main(), and run.
 */
 
+#include "Shard_Driver.hh"
 #include "flpr_format_base.hh"
+#include <algorithm>
+#include <flpr/File_Pipeline.hh>
 #include <iostream>
 #include <string>
 #include <vector>
 
+FLPR::Indent_Table select_indents(File const &file, Options const &options);
+bool format_one_file(std::string const &filename, Options const &options);
+
 int main(int argc, char *const argv[]) {
 
   /* Read the command-line arguments */
@@ -39,28 +45,102 @@ int main(int argc, char *const argv[]) {
     return 1;
   }
 
-  /* You could register FLPR syntax extensions here */
+  /* You could register FLPR syntax extensions here.  The files may be
+     formatted on several threads, so nothing changes them after this. */
+  FLPR::Stmt::get_parser_exts().freeze();
+  FLPR::Syntax_Tags::freeze_extensions();
 
-  /* The actual indentation pattern is selected on a file-by-file basis
-     below. */
-  FLPR::Indent_Table indents;
+  /* With -p N, the files are split across N worker processes, each of which
+     formats its files one at a time.  A file that crashes a worker is
+     reported, and the worker is replaced. */
+  if (options.num_procs() > 0) {
+    Shard_Driver shards(options.num_procs(),
+                        [&options](std::string const &filename) {
+                          return format_one_file(filename, options);
+                        });
+    bool const ok = shards.run(filenames);
+    if (options.do_timing() || !ok)
+      shards.print_summary(std::cerr);
+    return ok ? 0 : 1;
+  }
 
-  /* Process each input file */
-  for (auto const &fname : filenames) {
-    File file;
-    VERBOSE_BEGIN("read_file");
-    file.read_file(fname, options[OPT(COL72)]?72:0);
-    VERBOSE_END;
-    /* Define the indentation pattern based on the input format. It would be
-       nice if this was setup from an external configuration file */
-    if (file.logical_file().is_fixed_format() && !options[OPT(FIXED_TO_FREE)]) {
-      indents.apply_constant_fixed_indent(4);
-      indents.set_continued_offset(5);
-    } else {
-      indents.apply_emacs_indent();
-    }
-    if (flpr_format_file(file, options, indents)) {
-      std::cerr << "Error formating file \"" << fname << "\"" << std::endl;
+  /* Process the input files in a pipeline: reading, scanning, transforming
+     and writing overlap.  With -j N, the scan and transform stages each get N
+     threads.  Output to stdout is written in file order.  A failure in one
+     file is reported and doesn't stop the others. */
+  unsigned const jobs = options.num_jobs();
+  bool const inplace = options.write_inplace() &&
+                       options.output_mode() == Options::Output_Mode::FILE;
+  FLPR::File_Pipeline<> pipeline;
+  pipeline.set_last_fixed_col(options[OPT(COL72)] ? 72 : 0);
+  /* The transformations start before the statements are built */
+  pipeline.set_parse_depth(FLPR::File_Pipeline<>::Parse_Depth::NONE);
+  pipeline.set_threads(pipeline.READ, std::min(jobs, 4u));
+  pipeline.set_threads(pipeline.SCAN, jobs);
+  pipeline.set_threads(pipeline.TRANSFORM, jobs);
+  pipeline.set_threads(pipeline.WRITE, inplace ? std::min(jobs, 4u) : 1);
+  pipeline.set_ordered_writes(!inplace);
+  pipeline.set_queue_capacity(4 * jobs);
+  pipeline.set_keep_original_lines(options.output_mode() ==
+                                   Options::Output_Mode::DIFF);
+
+  pipeline.set_transform([&options](FLPR::File_Pipeline<>::Item &item) {
+    File &file = *item.file;
+    item.changed =
+        flpr_format_transform(file, options, select_indents(file, options));
+    return true;
+  });
+  pipeline.set_writer([&options](FLPR::File_Pipeline<>::Item &item) {
+    if (item.ok && !flpr_format_output(*item.file, options, item.changed,
+                                       std::cout))
+      return true;
+    if (!item.error.empty())
+      std::cerr << item.filename << ": " << item.error << '\n';
+    std::cerr << "Error formating file \"" << item.filename << "\""
+              << std::endl;
+    return false;
+  });
+
+  bool const ok = pipeline.run(filenames);
+
+  if (options.do_timing()) {
+    for (int s = 0; s < pipeline.NUM_STAGES; ++s) {
+      auto const stage = static_cast<FLPR::File_Pipeline<>::Stage>(s);
+      auto const &st = pipeline.stats(stage);
+      std::cerr << pipeline.stage_name(stage) << ": " << st.items
+                << " files on " << st.threads << " threads, busy "
+                << st.busy_seconds << " s, starved " << st.input_wait_seconds
+                << " s, blocked " << st.output_wait_seconds
+                << " s, queue depth " << st.mean_queue_depth << " (max "
+                << st.max_queue_depth << ")\n";
     }
   }
+  return ok ? 0 : 1;
+}
+
+/* Define the indentation pattern based on the input format. It would be nice if
+   this was setup from an external configuration file */
+FLPR::Indent_Table select_indents(File const &file, Options const &options) {
+  FLPR::Indent_Table indents;
+  if (file.logical_file().is_fixed_format() && !options[OPT(FIXED_TO_FREE)]) {
+    indents.apply_constant_fixed_indent(4);
+    indents.set_continued_offset(5);
+  } else {
+    indents.apply_emacs_indent();
+  }
+  return indents;
+}
+
+/* The work of one file in a worker process */
+bool format_one_file(std::string const &filename, Options const &options) {
+  File file;
+  file.set_keep_original_lines(options.output_mode() ==
+                               Options::Output_Mode::DIFF);
+  file.read_file(filename, options[OPT(COL72)] ? 72 : 0);
+  if (!file || flpr_format_file(file, options, select_indents(file, options),
+                                std::cout) != 0) {
+    std::cerr << "Error formating file \"" << filename << "\"" << std::endl;
+    return false;
+  }
+  return true;
 }
@@ -18,8 +18,13 @@
 
 #include "flpr_format_base.hh"
 #include <array>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
 #include <fstream>
 #include <iostream>
+#include <sys/stat.h>
 #include <unistd.h>
 
 /* Define a handy shortcut */
@@ -34,90 +39,113 @@ bool split_compound_stmts(typename FLPR::LL_SEQ &ll_seq);
 /* -------------------------------------------------------------------------- */
 
 int flpr_format_file(File &file, Options const &options,
-                     FLPR::Indent_Table const &indents) {
-  if (file) {
-    bool do_write = false;
-
-    /* first, do any transformations that just work on the sequence of
-       Logical_Lines, accessed through file.logical_lines(). These are the most
-       primitive transformations.  Doing these later requires updating
-       higher-level data structures, which is unnecessary overhead. */
-
-    /* this one is implemented in Logical_File, so we'll call it first */
-    if (options[OPT(FIXED_TO_FREE)]) {
-      VERBOSE_BEGIN("fixed_to_free");
-      do_write |= file.logical_file().convert_fixed_to_free();
-      VERBOSE_END;
-    }
+                     FLPR::Indent_Table const &indents, std::ostream &os) {
+  if (!file)
+    return 0;
+  bool const changed = flpr_format_transform(file, options, indents);
+  return flpr_format_output(file, options, changed, os);
+}
 
-    /* remove_empty_stmts doesn't even need the sequence: it just changes the
-       internals of a logical_line.  We pass the sequence just to move the
-       iteration out of main() */
-    if (options[OPT(REMOVE_EMPTY_STMTS)] &&
-        !options[OPT(SPLIT_COMPOUND_STMTS)]) {
-      VERBOSE_BEGIN("remove_empty_stmts");
-      do_write |= remove_empty_stmts(file.logical_lines());
-      VERBOSE_END;
-    }
+bool flpr_format_transform(File &file, Options const &options,
+                           FLPR::Indent_Table const &indents) {
+  bool do_write = false;
 
-    /* split_compound_stmts can create new Logical_Lines, so it needs to be
-       able to insert items into the sequence */
-    if (options[OPT(SPLIT_COMPOUND_STMTS)]) {
-      VERBOSE_BEGIN("split_compound_stmts");
-      do_write |= split_compound_stmts(file.logical_lines());
-      VERBOSE_END;
-    }
+  /* first, do any transformations that just work on the sequence of
+     Logical_Lines, accessed through file.logical_lines(). These are the most
+     primitive transformations.  Doing these later requires updating
+     higher-level data structures, which is unnecessary overhead. */
 
-    /* Now do transformations that require the sequence of LL_Stmts, accessed
-       via file.statements().  NOTE: any operations on LL_Stmts that will modify
-       the underlying Logical_Line sequence should be performed via
-       logical_file(), NOT directly on logical_lines().  The operations in
-       logical_file() maintain the consistency between the LL_Stmts and the
-       Logical_Lines. */
-
-    /* A note on Parsed_File: it uses lazy evaluation for more complicated
-       higher-level data structures, including the list of statements() and the
-       parse_tree().  If you call parse_tree(), it will build whatever it needs:
-       you don't have to explicitly build any lower-level structure.
-
-       In this demo, I wanted to be able to put timers around the statement
-       creation and parse_tree creation, so I am explicitly building.  THIS
-       ISN'T NECESSARY IN NORMAL APPLICATIONS. */
-
-    /* prebuild statements just for timing (see above) */
-    VERBOSE_BEGIN("make_stmts");
-    file.prefetch_statements();
+  /* this one is implemented in Logical_File, so we'll call it first */
+  if (options[OPT(FIXED_TO_FREE)]) {
+    VERBOSE_BEGIN("fixed_to_free");
+    do_write |= file.logical_file().convert_fixed_to_free();
     VERBOSE_END;
+  }
 
-    /* Now do transformations that require the concrete syntax tree, accessed
-       via file.parse_tree(). */
+  /* remove_empty_stmts doesn't even need the sequence: it just changes the
+     internals of a logical_line.  We pass the sequence just to move the
+     iteration out of main() */
+  if (options[OPT(REMOVE_EMPTY_STMTS)] &&
+      !options[OPT(SPLIT_COMPOUND_STMTS)]) {
+    VERBOSE_BEGIN("remove_empty_stmts");
+    do_write |= remove_empty_stmts(file.logical_lines());
+    VERBOSE_END;
+  }
 
-    /* prebuild parse_tree just for timing (see above) */
-    VERBOSE_BEGIN("build_parse_tree");
-    file.prefetch_parse_tree();
+  /* split_compound_stmts can create new Logical_Lines, so it needs to be
+     able to insert items into the sequence */
+  if (options[OPT(SPLIT_COMPOUND_STMTS)]) {
+    VERBOSE_BEGIN("split_compound_stmts");
+    do_write |= split_compound_stmts(file.logical_lines());
     VERBOSE_END;
+  }
 
-    /* indent last, because why bother until all statements are in the correct
-       position? */
-    if (options[OPT(REINDENT)]) {
-      VERBOSE_BEGIN("indent");
-      do_write |= file.indent(indents);
-      VERBOSE_END;
-    }
+  /* Now do transformations that require the sequence of LL_Stmts, accessed
+     via file.statements().  NOTE: any operations on LL_Stmts that will modify
+     the underlying Logical_Line sequence should be performed via
+     logical_file(), NOT directly on logical_lines().  The operations in
+     logical_file() maintain the consistency between the LL_Stmts and the
+     Logical_Lines. */
+
+  /* A note on Parsed_File: it uses lazy evaluation for more complicated
+     higher-level data structures, including the list of statements() and the
+     parse_tree().  If you call parse_tree(), it will build whatever it needs:
+     you don't have to explicitly build any lower-level structure.
+
+     In this demo, I wanted to be able to put timers around the statement
+     creation and parse_tree creation, so I am explicitly building.  THIS
+     ISN'T NECESSARY IN NORMAL APPLICATIONS. */
+
+  /* prebuild statements just for timing (see above) */
+  VERBOSE_BEGIN("make_stmts");
+  file.prefetch_statements();
+  VERBOSE_END;
+
+  /* Now do transformations that require the concrete syntax tree, accessed
+     via file.parse_tree(). */
+
+  /* prebuild parse_tree just for timing (see above) */
+  VERBOSE_BEGIN("build_parse_tree");
+  file.prefetch_parse_tree();
+  VERBOSE_END;
+
+  /* indent last, because why bother until all statements are in the correct
+     position? */
+  if (options[OPT(REINDENT)]) {
+    VERBOSE_BEGIN("indent");
+    do_write |= file.indent(indents);
+    VERBOSE_END;
+  }
 
-    /* now, if any transformation made a change, write the output. */
-    if (options.do_output() || (do_write && !options.quiet())) {
-      VERBOSE_BEGIN("write");
-      if (options.write_inplace()) {
-        std::cerr << "write in place not implemented yet" << '\n';
-      } else {
-        write_file(std::cout, file);
-      }
-      VERBOSE_END;
+  /* A transformation may report a change that leaves the text as it was
+     (e.g. re-indenting an already indented file), so check the lines */
+  if (do_write)
+    do_write = !file.logical_file().changed_line_ranges().empty();
+  return do_write;
+}
+
+int flpr_format_output(File &file, Options const &options, bool const do_write,
+                       std::ostream &os) {
+  /* now, if any transformation made a change, write the output.  An
+     unchanged file is never rewritten in place, even with do_output(). */
+  bool const inplace = options.write_inplace() &&
+                       options.output_mode() == Options::Output_Mode::FILE;
+  if ((options.do_output() && !inplace) || (do_write && !options.quiet())) {
+    VERBOSE_BEGIN("write");
+    if (options.output_mode() == Options::Output_Mode::DIFF) {
+      file.logical_file().write_diff(os);
+    } else if (options.output_mode() == Options::Output_Mode::RANGES) {
+      write_line_ranges(os, file);
+    } else if (inplace) {
+      if (!write_file_inplace(file, options.do_fsync()))
+        return 1;
     } else {
-      if (options.verbose())
-        std::cerr << "nothing changed" << std::endl;
+      write_file(os, file);
     }
+    VERBOSE_END;
+  } else {
+    if (options.verbose())
+      std::cerr << "nothing changed" << std::endl;
   }
   return 0;
 }
@@ -196,31 +224,126 @@ bool elaborate_end_stmts(File &f) {
 }
 
 void write_file(std::ostream &os, File const &f) {
-  for (auto const &ll : f.logical_lines()) {
-    os << ll;
+  f.logical_file().write(os);
+}
+
+/* Replace the input file with the new text.  The text is written to a
+   temporary file in the same directory, which is renamed over the original, so
+   a reader sees either the old or the new file, never a partial one. */
+bool write_file_inplace(File const &f, bool const do_fsync) {
+  auto const &lf = f.logical_file();
+  if (!lf.file_info) {
+    std::cerr << "write_file_inplace: no file name" << std::endl;
+    return false;
+  }
+  std::string const &filename{lf.file_info->filename};
+  std::string::size_type const slash = filename.rfind('/');
+  std::string const dir{slash == std::string::npos ? "."
+                                                   : filename.substr(0, slash)};
+  std::string tmpname{dir + "/.flpr-format.XXXXXX"};
+  int const fd = mkstemp(&tmpname[0]);
+  if (fd < 0) {
+    std::cerr << "Unable to create a temporary file in \"" << dir
+              << "\": " << std::strerror(errno) << std::endl;
+    return false;
+  }
+  auto const fail = [&](char const *what) {
+    std::cerr << "Unable to " << what << " \"" << tmpname
+              << "\": " << std::strerror(errno) << std::endl;
+    close(fd);
+    unlink(tmpname.c_str());
+    return false;
+  };
+
+  std::string const buf{lf.render()};
+  for (std::string::size_type done = 0; done < buf.size();) {
+    ssize_t const n = write(fd, buf.data() + done, buf.size() - done);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return fail("write");
+    }
+    done += static_cast<std::string::size_type>(n);
+  }
+  /* keep the permissions of the original */
+  struct stat st;
+  if (stat(filename.c_str(), &st) == 0 && fchmod(fd, st.st_mode & 07777) != 0)
+    return fail("set the mode of");
+  if (do_fsync && fsync(fd) != 0)
+    return fail("sync");
+  if (close(fd) != 0) {
+    std::cerr << "Unable to close \"" << tmpname
+              << "\": " << std::strerror(errno) << std::endl;
+    unlink(tmpname.c_str());
+    return false;
+  }
+  if (rename(tmpname.c_str(), filename.c_str()) != 0) {
+    std::cerr << "Unable to rename \"" << tmpname << "\" to \"" << filename
+              << "\": " << std::strerror(errno) << std::endl;
+    unlink(tmpname.c_str());
+    return false;
+  }
+  if (do_fsync) {
+    /* make the rename itself durable */
+    int const dir_fd = open(dir.c_str(), O_RDONLY);
+    if (dir_fd >= 0) {
+      fsync(dir_fd);
+      close(dir_fd);
+    }
+  }
+  return true;
+}
+
+/* One line per change: the original and new line ranges (index origin 1,
+   inclusive, with an empty range given as the line before it and a length of
+   0) */
+void write_line_ranges(std::ostream &os, File const &f) {
+  auto const &lf = f.logical_file();
+  std::string const name{lf.file_info ? lf.file_info->filename : "-"};
+  auto const range = [&os](int const begin, int const end) {
+    if (begin == end)
+      os << begin - 1 << ",0";
+    else
+      os << begin << ',' << end - 1;
+  };
+  for (auto const &c : lf.changed_line_ranges()) {
+    os << name << ": ";
+    range(c.old_begin, c.old_end);
+    os << " -> ";
+    range(c.new_begin, c.new_end);
+    os << '\n';
   }
 }
 
 void print_usage(std::ostream &os) {
-  os << "usage: flpr-format [-foqtv] file ...\n";
+  os << "usage: flpr-format [-cdefiloqstvw] [-j N | -p N] file ...\n";
   os << "\t-c\ttreat fixed-format input past col 72 as comments\n";
+  os << "\t-d\toutput a unified diff of the changed lines\n";
   os << "\t-e\telaborate procedure END statements\n";
   os << "\t-f\tdo fixed-format to free-format conversion\n";
   os << "\t-i\treindent\n";
+  os << "\t-j N\tformat up to N files at once\n";
+  os << "\t-l\toutput the changed line ranges\n";
   os << "\t-o\tforce output, even if no changes\n";
+  os << "\t-p N\tformat the files in N worker processes\n";
   os << "\t-q\tquiet: no output of any kind \n";
+  os << "\t-s\tsync files written in place to disk\n";
   os << "\t-t\ttime each phase\n";
   os << "\t-v\tshow transformation phases\n";
+  os << "\t-w\twrite changed files in place\n";
 }
 
 bool parse_cmd_line(std::vector<std::string> &filenames, Options &options,
                     int argc, char *const argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, "cefioqtv")) != -1) {
+  while ((ch = getopt(argc, argv, "cdefij:lop:qstvw")) != -1) {
     switch (ch) {
     case 'c':
       options[Options::COL72] = true;
       break;
+    case 'd':
+      options.set_output_mode(Options::Output_Mode::DIFF);
+      break;
     case 'e':
       options[Options::ELABORATE_END_STMTS] = true;
       break;
@@ -230,15 +353,41 @@ bool parse_cmd_line(std::vector<std::string> &filenames, Options &options,
     case 'i':
       options[Options::REINDENT] = true;
       break;
+    case 'j': {
+      char *end;
+      long const n = std::strtol(optarg, &end, 10);
+      if (*end != '\0' || n < 1) {
+        std::cerr << "-j needs a positive number of jobs\n";
+        print_usage(std::cerr);
+        return false;
+      }
+      options.set_num_jobs(static_cast<unsigned>(n));
+    } break;
+    case 'l':
+      options.set_output_mode(Options::Output_Mode::RANGES);
+      break;
     case 'o':
       options.set_do_output(true);
       break;
+    case 'p': {
+      char *end;
+      long const n = std::strtol(optarg, &end, 10);
+      if (*end != '\0' || n < 1) {
+        std::cerr << "-p needs a positive number of processes\n";
+        print_usage(std::cerr);
+        return false;
+      }
+      options.set_num_procs(static_cast<unsigned>(n));
+    } break;
     case 'q': /* really just for testing */
       options.set_quiet(true);
       options.set_verbose(false);
       options.set_do_timing(false);
       options.set_do_output(false);
       break;
+    case 's':
+      options.set_do_fsync(true);
+      break;
     case 't':
       options.set_do_timing(true);
       options.set_verbose(true);
@@ -246,6 +395,9 @@ bool parse_cmd_line(std::vector<std::string> &filenames, Options &options,
     case 'v':
       options.set_verbose(true);
       break;
+    case 'w':
+      options.set_write_inplace(true);
+      break;
     default:
       std::cerr << "unknown option\n";
       print_usage(std::cerr);
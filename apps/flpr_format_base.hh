@@ -15,6 +15,7 @@
 #include <array>
 #include <flpr/Indent_Table.hh>
 #include <flpr/flpr.hh>
+#include <iostream>
 #include <ostream>
 
 /* Manage the transformation options */
@@ -29,6 +30,13 @@ struct Options {
     NUM_FILTERS /* must be last */
   };
 
+  /* What to write for a file that changed */
+  enum class Output_Mode {
+    FILE,  /* the whole transformed file */
+    DIFF,  /* a unified diff of the changed lines */
+    RANGES /* the changed line ranges */
+  };
+
   Options() noexcept
       : write_inplace_{false}, verbose_{false}, do_timing_{false}, quiet_{
                                                                        false} {
@@ -54,6 +62,18 @@ struct Options {
   constexpr bool quiet() const noexcept { return quiet_; }
   constexpr void set_do_output(bool const val) noexcept { do_output_ = val; }
   constexpr bool do_output() const noexcept { return do_output_; }
+  constexpr void set_output_mode(Output_Mode const val) noexcept {
+    output_mode_ = val;
+  }
+  constexpr Output_Mode output_mode() const noexcept { return output_mode_; }
+  constexpr void set_do_fsync(bool const val) noexcept { do_fsync_ = val; }
+  constexpr bool do_fsync() const noexcept { return do_fsync_; }
+  constexpr void set_num_jobs(unsigned const val) noexcept { num_jobs_ = val; }
+  constexpr unsigned num_jobs() const noexcept { return num_jobs_; }
+  constexpr void set_num_procs(unsigned const val) noexcept {
+    num_procs_ = val;
+  }
+  constexpr unsigned num_procs() const noexcept { return num_procs_; }
 
 private:
   bool write_inplace_;
@@ -61,6 +81,10 @@ private:
   bool do_timing_;
   bool quiet_;
   bool do_output_;
+  Output_Mode output_mode_{Output_Mode::FILE};
+  bool do_fsync_{false};
+  unsigned num_jobs_{1};
+  unsigned num_procs_{0};
   std::array<bool, NUM_FILTERS> filters_;
 };
 
@@ -71,8 +95,17 @@ using File = FLPR::Parsed_File<>;
 bool parse_cmd_line(std::vector<std::string> &filenames, Options &options,
                     int argc, char *const argv[]);
 int flpr_format_file(File &file, Options const &options,
-                     FLPR::Indent_Table const &indents);
+                     FLPR::Indent_Table const &indents,
+                     std::ostream &os = std::cout);
+/* The two halves of flpr_format_file(): transform returns true if the text
+   changed, and output writes the result according to the options */
+bool flpr_format_transform(File &file, Options const &options,
+                           FLPR::Indent_Table const &indents);
+int flpr_format_output(File &file, Options const &options, bool const do_write,
+                       std::ostream &os);
 void write_file(std::ostream &os, File const &file);
+bool write_file_inplace(File const &file, bool const do_fsync);
+void write_line_ranges(std::ostream &os, File const &file);
 
 #define OPT(T) Options::T
 /* -------------------------------------------------------------------------- */
@@ -18,12 +18,17 @@
   A backup copy of the original file contents will be made '.bak' extension,
   then the changes will be made under the original file name.
 
+  With -p N, the files are split across N worker processes.  A file that
+  makes a worker exit is reported, and the other files carry on.
+
   The code is split up in an unusual way to allow you to easily use the module
   operations with your own syntax extensions: just copy this file, add your
   extensions in main(), and run.
 */
 
+#include "Shard_Driver.hh"
 #include "module_base.hh"
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <stdio.h>
@@ -35,7 +40,8 @@ using vec_str = std::vector<std::string>;
 
 void parse_cmd_line(int argc, char *const argv[], vec_str &only_names,
                     std::string &call_name, bool &call_name_is_file,
-                    std::string &module_name, vec_str &fortran_filenames);
+                    std::string &module_name, vec_str &fortran_filenames,
+                    bool &diff_only, unsigned &num_procs);
 void print_usage(std::ostream &os);
 
 /*--------------------------------------------------------------------------*/
@@ -46,12 +52,14 @@ int main(int argc, char *argv[]) {
   vec_str fortran_filenames;
   std::string call_name, module_name;
   bool call_name_is_file{false};
+  bool diff_only{false};
+  unsigned num_procs{0};
 
   /* only_names is the beginning of support for creating statements like "USE
      <module_name>, ONLY: <only_name>+".  The logic for properly inserting ONLY
      names isn't complete, so it isn't wired up to the command line yet */
   parse_cmd_line(argc, argv, only_names, call_name, call_name_is_file,
-                 module_name, fortran_filenames);
+                 module_name, fortran_filenames, diff_only, num_procs);
 
   /* You could register FLPR syntax extensions here */
 
@@ -72,30 +80,55 @@ int main(int argc, char *argv[]) {
     action.add_subroutine_name(call_name);
   }
 
+  if (num_procs > 0) {
+    Shard_Driver shards(num_procs, [&](std::string const &filename) {
+      return FLPR_Module::do_file(filename, 0,
+                                  FLPR::file_type_from_extension(filename),
+                                  action, diff_only);
+    });
+    return shards.run(fortran_filenames) ? 0 : 1;
+  }
+
+  bool ok{true};
   for (std::string const &filename : fortran_filenames) {
     /* you could change to an alternative file_type_from_ext function here */
-    FLPR_Module::do_file(filename, 0, FLPR::file_type_from_extension(filename),
-                         action);
+    ok = FLPR_Module::do_file(filename, 0,
+                              FLPR::file_type_from_extension(filename), action,
+                              diff_only) &&
+         ok;
   }
 
-  return 0;
+  return ok ? 0 : 1;
 }
 
 /*--------------------------------------------------------------------------*/
 
 void parse_cmd_line(int argc, char *const argv[], vec_str &only_names,
                     std::string &call_name, bool &call_name_is_file,
-                    std::string &module_name, vec_str &fortran_filenames) {
+                    std::string &module_name, vec_str &fortran_filenames,
+                    bool &diff_only, unsigned &num_procs) {
 
   call_name_is_file = false;
+  diff_only = false;
+  num_procs = 0;
 
   int ch;
-  while ((ch = getopt(argc, argv, "f:")) != -1) {
+  while ((ch = getopt(argc, argv, "df:p:")) != -1) {
     switch (ch) {
+    case 'd':
+      diff_only = true;
+      break;
     case 'f':
       call_name = std::string{optarg};
       call_name_is_file = true;
       break;
+    case 'p':
+      num_procs = std::strtoul(optarg, nullptr, 10);
+      if (num_procs < 1) {
+        print_usage(std::cerr);
+        exit(1);
+      }
+      break;
     default:
       print_usage(std::cerr);
       exit(1);
@@ -104,13 +137,13 @@ void parse_cmd_line(int argc, char *const argv[], vec_str &only_names,
 
   int idx = optind;
   if (!call_name_is_file) {
-    if (argc < 4) {
+    if (argc - idx < 3) {
       print_usage(std::cerr);
       exit(1);
     }
     call_name = std::string{argv[idx++]};
   } else {
-    if (argc < 3) {
+    if (argc - idx < 2) {
       print_usage(std::cerr);
       exit(1);
     }
@@ -125,9 +158,11 @@ void parse_cmd_line(int argc, char *const argv[], vec_str &only_names,
 /*--------------------------------------------------------------------------*/
 
 void print_usage(std::ostream &os) {
-  os << "Usage: module (-f <filename> | <call name>) "
+  os << "Usage: module [-d] [-p N] (-f <filename> | <call name>) "
         "<module name> <filename> ... \n";
+  os << "\t-d\t\tprint a unified diff instead of rewriting the files\n";
   os << "\t-f <filename>\tname of file containing call names\n";
+  os << "\t-p N\t\tprocess the files in N worker processes\n";
   os << "\t<call name>\tthe subroutine name that triggers module addition\n";
   os << "\t<module name>\tthe module for which an use-stmt will be added\n";
   os << "\t<filename>\tthe Fortran source file to operate on\n";
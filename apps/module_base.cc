@@ -19,6 +19,7 @@
 #include "module_base.hh"
 #include <cassert>
 #include <fstream>
+#include <iostream>
 
 #define TAG(X) FLPR::Syntax_Tags::X
 
@@ -27,17 +28,23 @@ namespace FLPR_Module {
 /*--------------------------------------------------------------------------*/
 
 bool do_file(std::string const &filename, int const last_fixed_col,
-             FLPR::File_Type file_type, Module_Action const &visit_action) {
+             FLPR::File_Type file_type, Module_Action const &visit_action,
+             bool const diff_only) {
 
-  File file(filename, last_fixed_col, file_type);
-  if (!file)
-    exit(1);
+  File file;
+  file.set_keep_original_lines(diff_only);
+  file.read_file(filename, last_fixed_col, file_type);
+  if (!file || !file.prefetch_parse_tree())
+    return false;
 
   FLPR::Procedure_Visitor puv(file, visit_action);
 
-  bool const changed = puv.visit();
+  bool const changed = puv.visit() &&
+                       !file.logical_file().changed_line_ranges().empty();
 
-  if (changed) {
+  if (changed && diff_only) {
+    file.logical_file().write_diff(std::cout);
+  } else if (changed) {
     std::string bak{filename + ".bak"};
     if (!rename(filename.c_str(), bak.c_str())) {
       std::ofstream os(filename);
@@ -46,10 +53,10 @@ bool do_file(std::string const &filename, int const last_fixed_col,
     } else {
       std::cerr << "Unable to rename \"" << filename << "\" to \"" << bak
                 << std::endl;
-      exit(2);
+      return false;
     }
   }
-  return changed;
+  return true;
 }
 
 /*--------------------------------------------------------------------------*/
@@ -178,9 +185,7 @@ Stmt_Cursor find_use_module_name(FLPR::LL_Stmt &stmt) {
 /*--------------------------------------------------------------------------*/
 
 void write_file(std::ostream &os, File const &f) {
-  for (auto const &ll : f.logical_lines()) {
-    os << ll;
-  }
+  f.logical_file().write(os);
 }
 
 } // namespace FLPR_Module
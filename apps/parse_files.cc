@@ -11,14 +11,33 @@
 /*!
   \file parse_files.cc
 
-  This executable just runs the FLPR parser on a list of files.
+  This executable just runs the FLPR parser on a list of files.  With the
+  --check option, it only checks the syntax of each file (without building
+  parse trees), reports the first error in each file, and returns non-zero if
+  any file fails.  The --budget option limits the parser work (statement
+  parses, plus the backtracking they do) spent on each file.  With -j N, the
+  files are parsed N at a time by a Batch_Parser, and a summary of each phase
+  is printed at the end.  With -p N, the files are split across N worker
+  processes instead, so that a file that crashes the parser only costs that
+  file.  With -j N, the --cache DIR option keeps the parse of each file in DIR,
+  so that unchanged files aren't parsed again by the next run.
 */
 
+#include "Shard_Driver.hh"
+#include "flpr/Batch_Parser.hh"
 #include "flpr/Logical_File.hh"
+#include "flpr/Parse_Cache.hh"
+#include "flpr/Parsed_File.hh"
 #include "flpr/Prgm_Parsers.hh"
 #include "flpr/Prgm_Tree.hh"
+#include <cstdlib>
 #include <fstream>
+#include <getopt.h>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <unistd.h>
 
 using Parse = FLPR::Prgm::Parsers<FLPR::Prgm::Prgm_Node_Data>;
@@ -29,26 +48,64 @@ struct File {
   Parse_Tree parse_tree;
 };
 
-bool read_file(std::string const &filename, std::vector<File> &files);
-bool parse_cmd_line(std::vector<std::string> &filenames, int argc,
-                    char *const argv[]);
+struct Options {
+  bool check_only{false};
+  size_t work_budget{0};
+  unsigned num_jobs{0};
+  unsigned num_procs{0};
+  std::string cache_dir;
+};
+
+bool read_file(std::string const &filename, Options const &options,
+               std::vector<File> &files);
+bool check_file(std::string const &filename, Options const &options);
+int batch_parse(std::vector<std::string> const &filenames,
+                Options const &options);
+int sharded_parse(std::vector<std::string> const &filenames,
+                  Options const &options);
+bool parse_cmd_line(std::vector<std::string> &filenames, Options &options,
+                    int argc, char *const argv[]);
 
 int main(int argc, char *const argv[]) {
   std::vector<std::string> filenames;
-  if (!parse_cmd_line(filenames, argc, argv)) {
+  Options options;
+  if (!parse_cmd_line(filenames, options, argc, argv)) {
     std::cerr << "exiting on error." << std::endl;
     return 1;
   }
 
+  /* Any extensions would be registered above.  The files may be parsed on
+     several threads, so make sure that nothing changes them from here on. */
+  FLPR::Stmt::get_parser_exts().freeze();
+  FLPR::Syntax_Tags::freeze_extensions();
+
+  if (options.num_procs > 0)
+    return sharded_parse(filenames, options);
+
+  if (options.check_only) {
+    size_t num_failed{0};
+    for (auto const &f : filenames) {
+      if (!check_file(f, options))
+        num_failed += 1;
+    }
+    std::cout << filenames.size() - num_failed << " of " << filenames.size()
+              << " files passed." << std::endl;
+    return num_failed ? 2 : 0;
+  }
+
+  if (options.num_jobs > 0)
+    return batch_parse(filenames, options);
+
   std::vector<File> files;
   for (auto const &f : filenames) {
-    read_file(f, files);
+    read_file(f, options, files);
   }
   std::cout << "done." << std::endl;
   return 0;
 }
 
-bool read_file(std::string const &filename, std::vector<File> &files) {
+bool read_file(std::string const &filename, Options const &options,
+               std::vector<File> &files) {
   File f;
   std::cout << "Processing: '" << filename << "'"
             << "\n\tscanning..." << std::endl;
@@ -62,11 +119,16 @@ bool read_file(std::string const &filename, std::vector<File> &files) {
   std::cout << "\tparsing..." << std::endl;
   f.logical_file.make_stmts();
   Parse::State state(f.logical_file.ll_stmts);
+  state.work_budget = options.work_budget;
   auto result{Parse::program(state)};
   if (!result.match) {
+    if (state.budget_exhausted)
+      std::cout << "\twork budget exhausted" << std::endl;
     std::cout << "\tparsing FAILED" << std::endl;
     return false;
   }
+  std::cout << "\tparse used " << state.work_done << " units of work."
+            << std::endl;
 
   auto c{result.parse_tree.ccursor()};
   std::cout << "\troot rule \"" << *c << "\" has " << c.node().num_branches()
@@ -77,6 +139,87 @@ bool read_file(std::string const &filename, std::vector<File> &files) {
   return true;
 }
 
+bool check_file(std::string const &filename, Options const &options) {
+  FLPR::Parsed_File<> f(filename, 0);
+  if (!f) {
+    std::cerr << filename << ": error: read/scan failed" << std::endl;
+    return false;
+  }
+  f.set_work_budget(options.work_budget);
+  FLPR::Syntax_Check const res{f.validate()};
+  if (res)
+    return true;
+  std::cerr << res.filename << ':' << res.line << ": error: ";
+  if (res.budget_exhausted) {
+    std::cerr << "work budget exhausted while parsing ";
+  } else if (res.stmt) {
+    std::cerr << "unrecognized statement while parsing ";
+  } else {
+    std::cerr << "unexpected end of file while parsing ";
+  }
+  FLPR::Syntax_Tags::print(std::cerr, res.expected) << '\n';
+  if (res.stmt)
+    res.stmt->print_me(std::cerr, false) << '\n';
+  std::cerr << std::flush;
+  return false;
+}
+
+int batch_parse(std::vector<std::string> const &filenames,
+                Options const &options) {
+  FLPR::Batch_Parser<> batch(options.num_jobs);
+  batch.set_work_budget(options.work_budget);
+  std::unique_ptr<FLPR::Parse_Cache> cache;
+  if (!options.cache_dir.empty()) {
+    cache = std::make_unique<FLPR::Parse_Cache>(options.cache_dir);
+    batch.set_parse_cache(cache.get());
+  }
+  batch.set_keep_policy(FLPR::Batch_Parser<>::Keep_Policy::RELEASE);
+  std::mutex report_mutex;
+  batch.set_callback([&](std::size_t const index, FLPR::Parsed_File<> &,
+                         bool const ok) {
+    if (!ok) {
+      std::lock_guard<std::mutex> const lock{report_mutex};
+      std::cout << "'" << filenames[index] << "': FAILED" << std::endl;
+    }
+  });
+  batch.run(filenames);
+
+  auto const &stats = batch.stats();
+  auto const phase = [](char const *name, auto const &p, char const *units) {
+    std::cout << '\t' << std::left << std::setw(6) << name << std::right
+              << std::setw(10) << p.count << ' ' << units << " in "
+              << p.seconds << " thread-s";
+    if (p.seconds > 0)
+      std::cout << " (" << static_cast<std::size_t>(p.count / p.seconds) << ' '
+                << units << "/s)";
+    std::cout << '\n';
+  };
+  std::cout << stats.num_files - stats.num_failed << " of " << stats.num_files
+            << " files parsed in " << stats.wall_seconds << " s with "
+            << options.num_jobs << " jobs\n";
+  phase("scan", stats.scan, "lines");
+  phase("stmts", stats.stmts, "stmts");
+  phase("parse", stats.parse, "stmts");
+  if (cache)
+    cache->print_stats(std::cout);
+  std::cout << "done." << std::endl;
+  return stats.num_failed ? 2 : 0;
+}
+
+int sharded_parse(std::vector<std::string> const &filenames,
+                  Options const &options) {
+  Shard_Driver shards(options.num_procs, [&options](std::string const &f) {
+    if (options.check_only)
+      return check_file(f, options);
+    std::vector<File> files;
+    return read_file(f, options, files);
+  });
+  bool const ok = shards.run(filenames);
+  shards.print_summary(std::cout);
+  std::cout << "done." << std::endl;
+  return ok ? 0 : 2;
+}
+
 bool file_list_from_file(std::vector<std::string> &filenames,
                          char const *file_list_name) {
   std::ifstream is(file_list_name);
@@ -94,11 +237,42 @@ bool file_list_from_file(std::vector<std::string> &filenames,
   return filenames.size() > orig_size;
 }
 
-bool parse_cmd_line(std::vector<std::string> &filenames, int argc,
-                    char *const argv[]) {
+bool parse_cmd_line(std::vector<std::string> &filenames, Options &options,
+                    int argc, char *const argv[]) {
+  static struct option long_options[] = {
+      {"budget", required_argument, nullptr, 'b'},
+      {"cache", required_argument, nullptr, 'C'},
+      {"check", no_argument, nullptr, 'c'},
+      {"jobs", required_argument, nullptr, 'j'},
+      {"procs", required_argument, nullptr, 'p'},
+      {nullptr, 0, nullptr, 0}};
   int ch;
-  while ((ch = getopt(argc, argv, "f:")) != -1) {
+  while ((ch = getopt_long(argc, argv, "b:cC:f:j:p:", long_options, nullptr)) !=
+         -1) {
     switch (ch) {
+    case 'b':
+      options.work_budget = std::strtoul(optarg, nullptr, 10);
+      break;
+    case 'c':
+      options.check_only = true;
+      break;
+    case 'C':
+      options.cache_dir = optarg;
+      break;
+    case 'j':
+      options.num_jobs = std::strtoul(optarg, nullptr, 10);
+      if (options.num_jobs < 1) {
+        std::cerr << "-j needs a positive number of jobs" << std::endl;
+        return false;
+      }
+      break;
+    case 'p':
+      options.num_procs = std::strtoul(optarg, nullptr, 10);
+      if (options.num_procs < 1) {
+        std::cerr << "-p needs a positive number of processes" << std::endl;
+        return false;
+      }
+      break;
     case 'f':
       if (!file_list_from_file(filenames, optarg))
         return false;
@@ -113,5 +287,9 @@ bool parse_cmd_line(std::vector<std::string> &filenames, int argc,
   for (int i = 0; i < argc; ++i) {
     filenames.emplace_back(std::string{argv[i]});
   }
+  if (!options.cache_dir.empty() && options.num_jobs == 0) {
+    std::cerr << "--cache needs -j" << std::endl;
+    return false;
+  }
   return true;
 };
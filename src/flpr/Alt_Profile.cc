@@ -0,0 +1,104 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+/*!
+  \file Alt_Profile.cc
+*/
+
+#include "flpr/Alt_Profile.hh"
+#include "flpr/Syntax_Tags.hh"
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+
+namespace FLPR {
+
+Alt_Profile::Site::Site(int const num_alts)
+    : counts_(num_alts, 0), order_(num_alts), pos_(num_alts) {
+  std::iota(order_.begin(), order_.end(), 0);
+  std::iota(pos_.begin(), pos_.end(), 0);
+}
+
+void Alt_Profile::Site::set_counts(std::vector<unsigned long> const &counts) {
+  assert(counts.size() == counts_.size());
+  counts_ = counts;
+  std::iota(order_.begin(), order_.end(), 0);
+  std::stable_sort(order_.begin(), order_.end(), [this](int a, int b) {
+    return counts_[a] > counts_[b];
+  });
+  for (std::size_t i = 0; i < order_.size(); ++i)
+    pos_[order_[i]] = static_cast<int>(i);
+}
+
+bool Alt_Profile::save(std::ostream &os) const {
+  for (std::size_t tag = 0; tag < sites_.size(); ++tag) {
+    Site const &s = sites_[tag];
+    if (s.empty())
+      continue;
+    os << Syntax_Tags::label(static_cast<int>(tag)) << ' ' << s.size();
+    for (std::size_t i = 0; i < s.size(); ++i)
+      os << ' ' << s.count(static_cast<int>(i));
+    os << '\n';
+  }
+  return static_cast<bool>(os);
+}
+
+namespace {
+//! Find the statement grammar syntag with the given label, or -1
+int sg_tag_from_label(std::string const &label) {
+  for (int tag = Syntax_Tags::SG_000_LB + 1; tag < Syntax_Tags::SG_ZZZ_UB;
+       ++tag) {
+    if (Syntax_Tags::label(tag) == label)
+      return tag;
+  }
+  return -1;
+}
+} // namespace
+
+bool Alt_Profile::load(std::istream &is) {
+  int linenum = 0;
+  for (std::string line; std::getline(is, line);) {
+    linenum += 1;
+    if (line.empty())
+      continue;
+    std::istringstream iss{line};
+    std::string label;
+    int num_alts{0};
+    if (!(iss >> label >> num_alts) || num_alts < 1) {
+      std::cerr << "Alt_Profile::load: malformed line " << linenum << std::endl;
+      return false;
+    }
+    int const tag = sg_tag_from_label(label);
+    if (tag < 0) {
+      std::cerr << "Alt_Profile::load: unknown site \"" << label
+                << "\" on line " << linenum << std::endl;
+      return false;
+    }
+    std::vector<unsigned long> counts(num_alts);
+    for (auto &c : counts) {
+      if (!(iss >> c)) {
+        std::cerr << "Alt_Profile::load: missing counts on line " << linenum
+                  << std::endl;
+        return false;
+      }
+    }
+    site(tag, num_alts).set_counts(counts);
+  }
+  return true;
+}
+
+Alt_Profile &alt_profile() noexcept {
+  static thread_local Alt_Profile the_alt_profile;
+  return the_alt_profile;
+}
+
+} // namespace FLPR
@@ -0,0 +1,122 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+/*!
+  \file Alt_Profile.hh
+*/
+
+#ifndef FLPR_ALT_PROFILE_HH
+#define FLPR_ALT_PROFILE_HH 1
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace FLPR {
+
+//! Select profile-guided ordering of the adaptive alternatives sites
+/*! When true, each adaptive alternatives site (see Stmt::adaptive_alts())
+    counts which alternative matches, and probes the alternatives in order of
+    decreasing hit count.  The default is false, meaning that all alternatives
+    are probed in grammar order.  The mode can be changed while other threads
+    are parsing. */
+inline std::atomic<bool> &adaptive_alternatives() noexcept {
+  static std::atomic<bool> enabled{false};
+  return enabled;
+}
+
+//! Hit counts and probe orders for the adaptive alternatives sites
+/*! A site is identified by a syntag.  The profile can be saved after parsing a
+    representative corpus, and loaded to seed the probe order of later runs.
+
+    Each thread has its own profile, accessed through alt_profile(). */
+class Alt_Profile {
+public:
+  //! The hit counts and probe order for one site
+  class Site {
+  public:
+    Site() = default;
+    explicit Site(int const num_alts);
+
+    bool empty() const noexcept { return order_.empty(); }
+    std::size_t size() const noexcept { return order_.size(); }
+    //! The alternative to try at position pos of the probe sequence
+    int probe(int const pos) const noexcept { return order_[pos]; }
+    //! The number of times alternative alt has matched
+    unsigned long count(int const alt) const noexcept { return counts_[alt]; }
+
+    //! Record a match of alternative alt, updating the probe order
+    /*! This keeps the probe order sorted by decreasing hit count by moving alt
+        towards the front until it reaches an alternative with at least as
+        many hits.  Ties are left in their current order. */
+    void hit(int const alt) noexcept {
+      assert(alt >= 0 && static_cast<std::size_t>(alt) < counts_.size());
+      unsigned long const c = ++counts_[alt];
+      int pos = pos_[alt];
+      while (pos > 0 && counts_[order_[pos - 1]] < c) {
+        int const other = order_[pos - 1];
+        order_[pos] = other;
+        pos_[other] = pos;
+        pos -= 1;
+      }
+      order_[pos] = alt;
+      pos_[alt] = pos;
+    }
+
+    //! Replace the hit counts, and sort the probe order accordingly
+    void set_counts(std::vector<unsigned long> const &counts);
+
+  private:
+    std::vector<unsigned long> counts_; //!< hits, in grammar order
+    std::vector<int> order_;            //!< probe position -> alternative
+    std::vector<int> pos_;              //!< alternative -> probe position
+  };
+
+public:
+  //! Return the Site for syntag, creating it if needed
+  /*! If the site has the wrong number of alternatives (e.g. it was loaded from
+      a profile made with a different grammar), it is reset. */
+  Site &site(int const syntag, int const num_alts) {
+    if (static_cast<std::size_t>(syntag) >= sites_.size())
+      sites_.resize(syntag + 1);
+    Site &s = sites_[syntag];
+    if (s.size() != static_cast<std::size_t>(num_alts))
+      s = Site{num_alts};
+    return s;
+  }
+
+  //! Forget all hit counts, restoring grammar order at every site
+  void clear() noexcept { sites_.clear(); }
+
+  //! Write the hit counts of each site
+  /*! The format is one line per site: the site syntag label, the number of
+      alternatives, then the hit count for each alternative in grammar
+      order. */
+  bool save(std::ostream &os) const;
+
+  //! Read hit counts written by save()
+  /*! Sites in the stream are merged into this profile (replacing the counts of
+      existing sites).  Returns false, reporting to std::cerr, if the stream is
+      malformed or names an unknown site. */
+  bool load(std::istream &is);
+
+private:
+  std::vector<Site> sites_; //!< indexed by syntag
+};
+
+//! Return the (per-thread) Alt_Profile
+Alt_Profile &alt_profile() noexcept;
+
+} // namespace FLPR
+
+#endif
@@ -0,0 +1,263 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+/*!
+  \file Batch_Parser.hh
+*/
+
+#ifndef FLPR_BATCH_PARSER_HH
+#define FLPR_BATCH_PARSER_HH 1
+
+#include "flpr/Parallel_For.hh"
+#include "flpr/Parsed_File.hh"
+#include "flpr/Stmt_Parser_Exts.hh"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace FLPR {
+
+//! Read, scan and parse a list of files concurrently
+/*! Each file goes through the scan, statement and parse phases of a
+    Parsed_File on one thread.  The files are handed out to the threads one at
+    a time, largest first, so that a big file isn't started last and left
+    running alone.
+
+    When a file is done, it is passed to the callback (if any), along with its
+    index in the list given to run() and whether all of the phases succeeded.
+    The callback is called from the worker threads, so it must be safe to call
+    concurrently for different files.  The Keep_Policy then decides whether
+    the Parsed_File is kept, to be retrieved with files(), or released right
+    away.
+
+    An exception thrown while processing a file (including by the callback)
+    is reported on std::cerr and fails that file only. */
+template <typename PG_NODE_DATA = Prgm::Prgm_Node_Data> class Batch_Parser {
+public:
+  using File = Parsed_File<PG_NODE_DATA>;
+  using Callback =
+      std::function<void(std::size_t const index, File &file, bool const ok)>;
+
+  //! What to do with a Parsed_File after the callback
+  enum class Keep_Policy {
+    KEEP,   //!< keep it in files()
+    RELEASE //!< destroy it
+  };
+
+  //! The time spent in a phase, summed over threads, and the work done
+  struct Phase_Stats {
+    double seconds{0};
+    std::size_t count{0};
+  };
+
+  struct Stats {
+    std::size_t num_files{0};
+    std::size_t num_failed{0};
+    Phase_Stats scan;  //!< count is input lines
+    Phase_Stats stmts; //!< count is statements
+    Phase_Stats parse; //!< count is statements in parsed files
+    double wall_seconds{0};
+  };
+
+public:
+  explicit Batch_Parser(unsigned const num_threads = 1) noexcept
+      : num_threads_{num_threads} {}
+
+  void set_num_threads(unsigned const num_threads) noexcept {
+    num_threads_ = num_threads;
+  }
+  void set_callback(Callback cb) { callback_ = std::move(cb); }
+  void set_keep_policy(Keep_Policy const policy) noexcept {
+    keep_policy_ = policy;
+  }
+  //! Passed on to each Parsed_File (see Parsed_File::set_work_budget())
+  void set_work_budget(std::size_t const budget) noexcept {
+    work_budget_ = budget;
+  }
+  void set_last_fixed_col(int const last_fixed_col) noexcept {
+    last_fixed_col_ = last_fixed_col;
+  }
+  //! Passed on to each Parsed_File (see Parsed_File::set_parser_exts())
+  void set_parser_exts(Stmt::Parser_Exts const *exts) noexcept {
+    parser_exts_ = exts;
+  }
+  //! Passed on to each Parsed_File (see Parsed_File::set_parse_cache())
+  void set_parse_cache(Parse_Cache *cache) noexcept { parse_cache_ = cache; }
+
+  //! Process all of the files, returning true if all of them parsed
+  /*! The files are parsed with a frozen copy of the statement parser
+      extensions (those given to set_parser_exts(), else
+      Stmt::get_parser_exts()), taken when run() starts, so the set itself
+      isn't frozen.  The kept files get the original set back.  Syntax_Tags
+      extensions can't be copied, so they must be registered before run();
+      an application may call Syntax_Tags::freeze_extensions() once its
+      setup is done to make sure of that. */
+  bool run(std::vector<std::string> const &filenames);
+
+  //! The kept files, in the order given to run()
+  /*! Files that were not kept (see Keep_Policy) are nullptr. */
+  std::vector<std::unique_ptr<File>> &files() noexcept { return files_; }
+  //! Whether each file was read, scanned and parsed successfully
+  bool ok(std::size_t const index) const noexcept { return ok_[index]; }
+  //! The statistics of the last run()
+  Stats const &stats() const noexcept { return stats_; }
+
+private:
+  struct File_Stats_ {
+    Phase_Stats scan, stmts, parse;
+  };
+  void process_(std::size_t const index, std::string const &filename);
+
+private:
+  unsigned num_threads_;
+  Callback callback_;
+  Keep_Policy keep_policy_{Keep_Policy::KEEP};
+  std::size_t work_budget_{0};
+  int last_fixed_col_{0};
+  Stmt::Parser_Exts const *parser_exts_{nullptr};
+  //! The frozen copy of the extensions, during run()
+  Stmt::Parser_Exts const *run_exts_{nullptr};
+  Parse_Cache *parse_cache_{nullptr};
+  std::vector<std::unique_ptr<File>> files_;
+  std::vector<char> ok_;
+  std::vector<File_Stats_> file_stats_;
+  Stats stats_;
+};
+
+template <typename PG_NODE_DATA>
+bool Batch_Parser<PG_NODE_DATA>::run(
+    std::vector<std::string> const &filenames) {
+  using clock = std::chrono::steady_clock;
+  auto const start = clock::now();
+  std::size_t const N = filenames.size();
+  /* the files are parsed concurrently, so the extensions must not change */
+  Stmt::Parser_Exts run_exts{parser_exts_ ? *parser_exts_
+                                          : Stmt::get_parser_exts()};
+  run_exts.freeze();
+  run_exts_ = &run_exts;
+  files_.clear();
+  files_.resize(N);
+  ok_.assign(N, 0);
+  file_stats_.assign(N, File_Stats_{});
+
+  /* Largest files first.  A file that can't be opened sorts last, and fails
+     when its turn comes. */
+  std::vector<std::streamoff> sizes(N, 0);
+  for (std::size_t i = 0; i < N; ++i) {
+    std::ifstream is(filenames[i], std::ios::binary | std::ios::ate);
+    if (is)
+      sizes[i] = is.tellg();
+  }
+  std::vector<std::size_t> order(N);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&sizes](std::size_t a, std::size_t b) {
+                     return sizes[a] > sizes[b];
+                   });
+
+  parallel_for(N, num_threads_, [&](std::size_t const i) {
+    process_(order[i], filenames[order[i]]);
+  });
+  run_exts_ = nullptr;
+
+  stats_ = Stats{};
+  stats_.num_files = N;
+  for (std::size_t i = 0; i < N; ++i) {
+    if (!ok_[i])
+      stats_.num_failed += 1;
+    auto const accum = [](Phase_Stats &total, Phase_Stats const &p) {
+      total.seconds += p.seconds;
+      total.count += p.count;
+    };
+    accum(stats_.scan, file_stats_[i].scan);
+    accum(stats_.stmts, file_stats_[i].stmts);
+    accum(stats_.parse, file_stats_[i].parse);
+  }
+  stats_.wall_seconds =
+      std::chrono::duration<double>(clock::now() - start).count();
+  return stats_.num_failed == 0;
+}
+
+template <typename PG_NODE_DATA>
+void Batch_Parser<PG_NODE_DATA>::process_(std::size_t const index,
+                                          std::string const &filename) {
+  using clock = std::chrono::steady_clock;
+  auto const seconds = [](clock::time_point const since) {
+    return std::chrono::duration<double>(clock::now() - since).count();
+  };
+  File_Stats_ &fs = file_stats_[index];
+  auto file_ptr = std::make_unique<File>();
+  File &file = *file_ptr;
+  bool ok{false};
+
+  file.set_work_budget(work_budget_);
+  file.set_parser_exts(run_exts_);
+  file.set_parse_cache(parse_cache_);
+  /* An exception only fails this file, and the other threads carry on */
+  auto const report = [&filename](char const *const what) {
+    std::cerr << "Batch_Parser: exception processing \"" << filename
+              << "\": " << what << std::endl;
+  };
+  try {
+    auto t = clock::now();
+    bool const read_ok = !file.read_file(filename, last_fixed_col_);
+    fs.scan.seconds = seconds(t);
+    if (read_ok) {
+      fs.scan.count = file.logical_file().num_input_lines;
+
+      t = clock::now();
+      bool const stmts_ok = file.prefetch_statements();
+      fs.stmts.seconds = seconds(t);
+      if (stmts_ok) {
+        std::size_t const num_stmts = file.statements().size();
+        fs.stmts.count = num_stmts;
+        t = clock::now();
+        ok = file.prefetch_parse_tree() && file;
+        fs.parse.seconds = seconds(t);
+        if (ok)
+          fs.parse.count = num_stmts;
+      }
+    }
+  } catch (std::exception const &e) {
+    report(e.what());
+    ok = false;
+  } catch (...) {
+    report("unknown exception");
+    ok = false;
+  }
+  if (callback_) {
+    try {
+      callback_(index, file, ok);
+    } catch (std::exception const &e) {
+      report(e.what());
+      ok = false;
+    } catch (...) {
+      report("unknown exception");
+      ok = false;
+    }
+  }
+  ok_[index] = ok;
+  if (keep_policy_ == Keep_Policy::KEEP) {
+    file.set_parser_exts(parser_exts_); // run_exts_ is gone after run()
+    files_[index] = std::move(file_ptr);
+  }
+}
+
+} // namespace FLPR
+
+#endif
@@ -0,0 +1,123 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+/*!
+  \file Bounded_Queue.hh
+*/
+
+#ifndef FLPR_BOUNDED_QUEUE_HH
+#define FLPR_BOUNDED_QUEUE_HH 1
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+namespace FLPR {
+
+//! A FIFO with a fixed capacity, shared by producer and consumer threads
+/*! push() blocks while the queue is full, and pop() blocks while it is empty
+    and open.  Once close() is called, pop() drains the remaining items and
+    then returns false.  The queue records its depth after each push, and the
+    time that threads spent blocked in push() and pop(). */
+template <typename T> class Bounded_Queue {
+public:
+  explicit Bounded_Queue(std::size_t const capacity)
+      : capacity_{std::max<std::size_t>(capacity, 1)} {}
+  Bounded_Queue(Bounded_Queue const &) = delete;
+  Bounded_Queue &operator=(Bounded_Queue const &) = delete;
+
+  //! Add an item, waiting for room.  Returns false if the queue is closed.
+  bool push(T &&item) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    if (items_.size() >= capacity_ && !closed_) {
+      auto const start = clock::now();
+      not_full_.wait(lock,
+                     [this] { return items_.size() < capacity_ || closed_; });
+      push_wait_ += clock::now() - start;
+    }
+    if (closed_)
+      return false;
+    items_.push_back(std::move(item));
+    num_pushed_ += 1;
+    depth_sum_ += items_.size();
+    max_depth_ = std::max(max_depth_, items_.size());
+    lock.unlock();
+    not_empty_.notify_one();
+    return true;
+  }
+
+  //! Remove the oldest item, waiting for one.  Returns false once the queue
+  //! is closed and empty.
+  bool pop(T &item) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    if (items_.empty() && !closed_) {
+      auto const start = clock::now();
+      not_empty_.wait(lock, [this] { return !items_.empty() || closed_; });
+      pop_wait_ += clock::now() - start;
+    }
+    if (items_.empty())
+      return false;
+    item = std::move(items_.front());
+    items_.pop_front();
+    lock.unlock();
+    not_full_.notify_one();
+    return true;
+  }
+
+  //! Stop accepting items, and wake up any waiting threads
+  void close() {
+    {
+      std::lock_guard<std::mutex> const lock{mutex_};
+      closed_ = true;
+    }
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+  std::size_t capacity() const noexcept { return capacity_; }
+  //! The largest number of items held at once
+  std::size_t max_depth() const {
+    std::lock_guard<std::mutex> const lock{mutex_};
+    return max_depth_;
+  }
+  //! The average number of items held, as seen by each push()
+  double mean_depth() const {
+    std::lock_guard<std::mutex> const lock{mutex_};
+    return num_pushed_ ? static_cast<double>(depth_sum_) / num_pushed_ : 0.0;
+  }
+  //! Total seconds that producers waited for room
+  double push_wait_seconds() const {
+    std::lock_guard<std::mutex> const lock{mutex_};
+    return std::chrono::duration<double>(push_wait_).count();
+  }
+  //! Total seconds that consumers waited for an item
+  double pop_wait_seconds() const {
+    std::lock_guard<std::mutex> const lock{mutex_};
+    return std::chrono::duration<double>(pop_wait_).count();
+  }
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  std::size_t const capacity_;
+  mutable std::mutex mutex_;
+  std::condition_variable not_full_, not_empty_;
+  std::deque<T> items_;
+  bool closed_{false};
+  std::size_t num_pushed_{0}, depth_sum_{0}, max_depth_{0};
+  clock::duration push_wait_{0}, pop_wait_{0};
+};
+
+} // namespace FLPR
+
+#endif
@@ -0,0 +1,564 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+/*!
+  \file File_Image.cc
+*/
+
+#include "flpr/File_Image.hh"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+
+namespace FLPR {
+
+namespace {
+constexpr char image_magic[8] = {'F', 'L', 'P', 'R', 'I', 'M', 'G', '\0'};
+
+/* The record size of each section, in Section_Id order */
+constexpr std::uint32_t record_sizes[File_Image::NUM_SECTIONS] = {
+    sizeof(File_Image::File_Rec),   1,
+    sizeof(File_Image::Line_Rec),   sizeof(File_Image::Layout_Rec),
+    sizeof(File_Image::Token_Rec),  sizeof(File_Image::Stmt_Rec),
+    sizeof(std::uint32_t),          sizeof(File_Image::Prgm_Node),
+    sizeof(File_Image::Stmt_Node),  sizeof(File_Image::String_Ref)};
+
+/* Sections start on this boundary, so that their records can be read in
+   place */
+constexpr std::size_t section_align = 8;
+
+static_assert(std::is_trivially_copyable_v<File_Image::Header> &&
+                  std::is_trivially_copyable_v<File_Image::Section> &&
+                  std::is_trivially_copyable_v<File_Image::Layout_Rec> &&
+                  std::is_trivially_copyable_v<File_Image::Token_Rec> &&
+                  std::is_trivially_copyable_v<File_Image::Prgm_Node> &&
+                  std::is_trivially_copyable_v<File_Image::Stmt_Node>,
+              "File_Image records must be trivially copyable");
+static_assert(sizeof(File_Image::Header) % section_align == 0 &&
+                  sizeof(File_Image::Section) % section_align == 0,
+              "File_Image header must keep the sections aligned");
+
+using CF = File_Line::class_flags;
+
+std::uint32_t classification_bits(File_Line const &fl) {
+  std::pair<CF, bool> const flags[] = {
+      {CF::blank, fl.is_blank()},
+      {CF::comment, fl.is_comment()},
+      {CF::continued, fl.is_continued()},
+      {CF::continuation, fl.is_continuation()},
+      {CF::label, fl.has_label()},
+      {CF::preprocessor, fl.is_preprocessor()},
+      {CF::include, fl.is_include()},
+      {CF::flpr_pp, fl.is_flpr_pp()},
+      {CF::flpr_lit, fl.is_flpr_lit()},
+      {CF::fixed_format, fl.is_fixed_format()}};
+  static_assert(std::size(flags) == static_cast<std::size_t>(CF::zzz_num),
+                "a File_Line::class_flags is missing");
+  std::uint32_t bits{0};
+  for (auto const &f : flags)
+    if (f.second)
+      bits |= 1u << static_cast<unsigned>(f.first);
+  return bits;
+}
+
+/* Collects the STRINGS section, sharing the storage of repeated short strings
+   (mostly spacing) */
+class String_Table {
+public:
+  File_Image::String_Ref add(std::string const &s) {
+    if (s.empty())
+      return File_Image::String_Ref{0, 0};
+    if (s.size() <= max_shared_size) {
+      auto const found = shared_.find(s);
+      if (found != shared_.end())
+        return found->second;
+    }
+    File_Image::String_Ref const ref{static_cast<std::uint32_t>(text_.size()),
+                                     static_cast<std::uint32_t>(s.size())};
+    text_ += s;
+    if (s.size() <= max_shared_size)
+      shared_.emplace(s, ref);
+    return ref;
+  }
+  std::string const &text() const noexcept { return text_; }
+
+private:
+  static constexpr std::size_t max_shared_size = 16;
+  std::string text_;
+  std::unordered_map<std::string, File_Image::String_Ref> shared_;
+};
+
+template <typename Recs>
+void append_section(std::string &image, File_Image::Section &sec,
+                    Recs const &recs) {
+  using Rec = typename Recs::value_type;
+  image.resize((image.size() + section_align - 1) / section_align *
+               section_align);
+  sec.offset = image.size();
+  sec.count = recs.size();
+  image.append(reinterpret_cast<char const *>(recs.data()),
+               recs.size() * sizeof(Rec));
+}
+
+bool fail(char const *const why) {
+  std::cerr << "File_Image::read: " << why << std::endl;
+  return false;
+}
+
+/* Append the nodes of st in preorder, with token offsets into toks (the
+   tokens of the statement).  Returns false if a token range isn't in the
+   statement. */
+bool flatten_stmt_tree(Stmt::Stmt_Tree::const_reference st,
+                       std::vector<TT_Range::const_iterator> const &toks,
+                       std::vector<File_Image::Stmt_Node> &nodes) {
+  LL_TT_Range const &r = st->token_range;
+  File_Image::Stmt_Node n{st->syntag, -1, 0,
+                          static_cast<std::uint32_t>(st.num_branches()), 0};
+  if (!r.empty()) {
+    auto const first = std::find(toks.begin(), toks.end(), r.cbegin());
+    if (first == toks.end() ||
+        r.size() > static_cast<std::size_t>(toks.end() - first))
+      return false;
+    n.first_token = static_cast<std::int32_t>(first - toks.begin());
+    n.num_tokens = static_cast<std::uint32_t>(r.size());
+  } else if (r.has_it()) {
+    n.flags |= File_Image::HAS_LINE;
+  }
+  nodes.push_back(n);
+  for (auto const &b : st.branches())
+    if (!flatten_stmt_tree(b, toks, nodes))
+      return false;
+  return true;
+}
+
+/* True if nodes[0, count) is a whole tree in preorder, with token ranges
+   inside a statement of num_tokens */
+bool valid_stmt_tree(File_Image::Stmt_Node const *nodes,
+                     std::uint32_t const count,
+                     std::uint32_t const num_tokens) {
+  std::uint64_t pending{1};
+  for (std::uint32_t i = 0; i < count; ++i) {
+    File_Image::Stmt_Node const &n = nodes[i];
+    if (pending == 0 || n.first_token < -1 ||
+        (n.first_token >= 0 &&
+         (static_cast<std::uint32_t>(n.first_token) > num_tokens ||
+          n.num_tokens > num_tokens - n.first_token)))
+      return false;
+    pending += n.num_branches;
+    pending -= 1;
+  }
+  return pending == 0;
+}
+
+Stmt::ST_Node_Data
+stmt_node_data(File_Image::Stmt_Node const &n, LL_SEQ::iterator const ll_it,
+               std::vector<TT_Range::iterator> const &toks) {
+  if (n.first_token < 0) {
+    Stmt::ST_Node_Data nd{n.syntag};
+    if (n.flags & File_Image::HAS_LINE)
+      nd.token_range.set_it(ll_it);
+    return nd;
+  }
+  return Stmt::ST_Node_Data{
+      n.syntag, LL_TT_Range{ll_it, toks[n.first_token],
+                            toks[n.first_token + n.num_tokens]}};
+}
+
+/* Attach the branches of nodes[idx] to st, returning the index following the
+   subtree rooted at nodes[idx] */
+std::size_t unflatten_stmt_tree(Stmt::Stmt_Tree::reference st,
+                                File_Image::Stmt_Node const *nodes,
+                                std::size_t const idx,
+                                LL_SEQ::iterator const ll_it,
+                                std::vector<TT_Range::iterator> const &toks) {
+  std::size_t next = idx + 1;
+  for (std::uint32_t b = 0; b < nodes[idx].num_branches; ++b) {
+    auto branch = st.emplace_back(
+        Stmt::Stmt_Tree::node{stmt_node_data(nodes[next], ll_it, toks)});
+    next = unflatten_stmt_tree(*branch, nodes, next, ll_it, toks);
+  }
+  return next;
+}
+} // namespace
+
+/*--------------------------------------------------------------------------*/
+
+File_Image::View::View(char const *data, std::size_t const size) {
+  Header h;
+  if (!data || size < sizeof(h) ||
+      reinterpret_cast<std::uintptr_t>(data) % section_align != 0)
+    return;
+  std::memcpy(&h, data, sizeof(h));
+  if (std::memcmp(h.magic, image_magic, sizeof(image_magic)) != 0 ||
+      h.version != version || h.byte_order != byte_order_mark ||
+      h.num_sections != NUM_SECTIONS ||
+      size < sizeof(h) + NUM_SECTIONS * sizeof(Section))
+    return;
+  auto const sections = reinterpret_cast<Section const *>(data + sizeof(h));
+  for (std::uint32_t i = 0; i < NUM_SECTIONS; ++i) {
+    Section const &s = sections[i];
+    if (s.id != i || s.record_size != record_sizes[i] ||
+        s.offset % section_align != 0 || s.offset > size ||
+        s.count > (size - s.offset) / s.record_size)
+      return;
+  }
+  if (sections[FILE_INFO].count != 1)
+    return;
+  data_ = data;
+  size_ = size;
+  sections_ = sections;
+}
+
+std::string_view File_Image::View::string(String_Ref const s) const noexcept {
+  std::size_t const n = count(STRINGS);
+  if (s.offset > n || s.size > n - s.offset)
+    return std::string_view{};
+  return std::string_view{section_data_(STRINGS) + s.offset, s.size};
+}
+
+/*--------------------------------------------------------------------------*/
+
+File_Image::Mapping::Mapping(std::string const &path) {
+  int const fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::cerr << "File_Image::Mapping: unable to open \"" << path
+              << "\": " << std::strerror(errno) << std::endl;
+    return;
+  }
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    void *const addr = mmap(nullptr, static_cast<std::size_t>(st.st_size),
+                            PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED) {
+      addr_ = addr;
+      size_ = static_cast<std::size_t>(st.st_size);
+    }
+  }
+  close(fd);
+  if (addr_)
+    view_ = View{static_cast<char const *>(addr_), size_};
+  if (!view_)
+    std::cerr << "File_Image::Mapping: \"" << path
+              << "\" is not a valid image" << std::endl;
+}
+
+File_Image::Mapping::~Mapping() {
+  if (addr_)
+    munmap(addr_, size_);
+}
+
+/*--------------------------------------------------------------------------*/
+
+bool File_Image::save(std::string const &path, std::string const &image) {
+  std::ofstream os(path, std::ios::binary | std::ios::trunc);
+  if (os && os.write(image.data(), image.size()) && os.flush())
+    return true;
+  std::cerr << "File_Image::save: unable to write \"" << path << '"'
+            << std::endl;
+  return false;
+}
+
+/*--------------------------------------------------------------------------*/
+
+std::string File_Image::write(Logical_File const &lf, Prgm_Nodes const &nodes,
+                              bool const stmt_trees) {
+  String_Table strings;
+  std::vector<File_Rec> file(1);
+  std::vector<Line_Rec> lines;
+  std::vector<Layout_Rec> layout;
+  std::vector<Token_Rec> tokens;
+  std::vector<Stmt_Rec> stmts;
+  std::vector<std::uint32_t> prefixes;
+  std::vector<Stmt_Node> stmt_nodes;
+  std::vector<String_Ref> original_lines;
+
+  if (lf.file_info) {
+    file[0].filename = strings.add(lf.file_info->filename);
+    file[0].file_type = static_cast<std::int32_t>(lf.file_info->file_type);
+    file[0].last_fixed_column = lf.file_info->last_fixed_column;
+  }
+  file[0].has_flpr_pp = lf.has_flpr_pp;
+  file[0].num_input_lines = lf.num_input_lines;
+  for (auto const &l : lf.original_lines())
+    original_lines.push_back(strings.add(l));
+
+  std::unordered_map<Logical_Line const *, std::uint32_t> line_index;
+  for (auto const &ll : lf.lines) {
+    line_index.emplace(&ll, static_cast<std::uint32_t>(lines.size()));
+    Line_Rec l{};
+    l.label = ll.label;
+    l.cat = static_cast<std::int32_t>(ll.cat);
+    if (ll.suppress)
+      l.flags |= SUPPRESS;
+    if (ll.needs_reformat)
+      l.flags |= NEEDS_REFORMAT;
+    if (ll.dirty)
+      l.flags |= DIRTY;
+    if (ll.has_stmts())
+      l.flags |= HAS_STMTS;
+    l.first_layout = static_cast<std::uint32_t>(layout.size());
+    l.num_layout = static_cast<std::uint32_t>(ll.layout().size());
+    l.first_token = static_cast<std::uint32_t>(tokens.size());
+    l.num_tokens = static_cast<std::uint32_t>(ll.fragments().size());
+    lines.push_back(l);
+
+    for (auto const &fl : ll.layout()) {
+      layout.push_back(Layout_Rec{
+          fl.linenum, classification_bits(fl), fl.open_delim,
+          strings.add(fl.left_txt), strings.add(fl.left_space),
+          strings.add(fl.main_txt), strings.add(fl.right_space),
+          strings.add(fl.right_txt)});
+    }
+    for (auto const &tt : ll.fragments()) {
+      tokens.push_back(Token_Rec{
+          tt.token, tt.start_line, tt.start_pos, strings.add(tt.text()),
+          tt.mt_begin_line_, tt.mt_begin_col_, tt.mt_end_line_,
+          tt.mt_end_col_, tt.pre_spaces_, tt.post_spaces_});
+    }
+  }
+
+  std::vector<TT_Range::const_iterator> toks;
+  for (auto const &stmt : lf.ll_stmts) {
+    Stmt_Rec s{};
+    s.line = line_index.at(&stmt.ll());
+    if (!stmt.empty()) {
+      s.first_token = static_cast<std::uint32_t>(
+          std::distance(stmt.ll().fragments().begin(), stmt.begin()));
+      s.num_tokens = static_cast<std::uint32_t>(stmt.size());
+    }
+    s.label = stmt.label();
+    s.compound = stmt.is_compound();
+    s.syntag = stmt.syntax_tag();
+    s.first_prefix = static_cast<std::uint32_t>(prefixes.size());
+    s.num_prefix = static_cast<std::uint32_t>(stmt.prefix_lines.size());
+    for (auto const &p : stmt.prefix_lines)
+      prefixes.push_back(line_index.at(&*p));
+    if (stmt_trees && stmt.has_stmt_tree() && !stmt.stmt_tree().empty()) {
+      toks.clear();
+      for (auto it = stmt.cbegin(); it != stmt.cend(); ++it)
+        toks.push_back(it);
+      std::size_t const first = stmt_nodes.size();
+      if (flatten_stmt_tree(*stmt.stmt_tree(), toks, stmt_nodes)) {
+        s.first_stmt_node = static_cast<std::uint32_t>(first);
+        s.num_stmt_nodes =
+            static_cast<std::uint32_t>(stmt_nodes.size() - first);
+      } else {
+        /* Leave it to be rebuilt */
+        stmt_nodes.resize(first);
+      }
+    }
+    stmts.push_back(s);
+  }
+
+  Header h{};
+  std::memcpy(h.magic, image_magic, sizeof(image_magic));
+  h.version = version;
+  h.byte_order = byte_order_mark;
+  h.num_sections = NUM_SECTIONS;
+  std::vector<Section> table(NUM_SECTIONS);
+  for (std::uint32_t i = 0; i < NUM_SECTIONS; ++i) {
+    table[i].id = i;
+    table[i].record_size = record_sizes[i];
+  }
+
+  std::string image(sizeof(h) + NUM_SECTIONS * sizeof(Section), '\0');
+  append_section(image, table[FILE_INFO], file);
+  append_section(image, table[STRINGS], strings.text());
+  append_section(image, table[LINES], lines);
+  append_section(image, table[LAYOUT], layout);
+  append_section(image, table[TOKENS], tokens);
+  append_section(image, table[STMTS], stmts);
+  append_section(image, table[PREFIXES], prefixes);
+  append_section(image, table[PRGM_NODES], nodes);
+  append_section(image, table[STMT_NODES], stmt_nodes);
+  append_section(image, table[ORIGINAL_LINES], original_lines);
+  std::memcpy(&image[0], &h, sizeof(h));
+  std::memcpy(&image[sizeof(h)], table.data(),
+              NUM_SECTIONS * sizeof(Section));
+  return image;
+}
+
+/*--------------------------------------------------------------------------*/
+
+bool File_Image::read(View const &image, std::string const &name,
+                      Logical_File &lf, Prgm_Nodes &nodes) {
+  if (!image)
+    return fail("not a valid image");
+  Logical_File::Line_Buf original_lines;
+  std::size_t const n = image.count(ORIGINAL_LINES);
+  String_Ref const *const refs = image.original_lines();
+  original_lines.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    if (refs[i].size > 0 && image.string(refs[i]).empty())
+      return fail("bad original line");
+    original_lines.emplace_back(image.string(refs[i]));
+  }
+  return read_(image, name, (n > 0) ? &original_lines : nullptr, lf, nodes);
+}
+
+bool File_Image::read(View const &image, std::string const &name,
+                      Logical_File::Line_Buf &&original_lines,
+                      Logical_File &lf, Prgm_Nodes &nodes) {
+  return read_(image, name, &original_lines, lf, nodes);
+}
+
+bool File_Image::read_(View const &image, std::string const &name,
+                       Logical_File::Line_Buf *const original_lines,
+                       Logical_File &lf, Prgm_Nodes &nodes) {
+  if (!image)
+    return fail("not a valid image");
+  File_Rec const &file = image.file();
+  if (original_lines && file.num_input_lines != original_lines->size())
+    return fail("the image does not match the text");
+
+  /* Check the indices before following any of them */
+  std::size_t const num_lines = image.count(LINES);
+  std::size_t const num_stmts = image.count(STMTS);
+  Line_Rec const *const line_recs = image.lines();
+  for (std::size_t i = 0; i < num_lines; ++i) {
+    Line_Rec const &l = line_recs[i];
+    if (l.first_layout > image.count(LAYOUT) ||
+        l.num_layout > image.count(LAYOUT) - l.first_layout ||
+        l.first_token > image.count(TOKENS) ||
+        l.num_tokens > image.count(TOKENS) - l.first_token)
+      return fail("bad Logical_Line record");
+  }
+  Stmt_Rec const *const stmt_recs = image.stmts();
+  std::uint32_t const *const prefix_recs = image.prefixes();
+  for (std::size_t i = 0; i < num_stmts; ++i) {
+    Stmt_Rec const &s = stmt_recs[i];
+    if (s.line >= num_lines ||
+        s.first_token > line_recs[s.line].num_tokens ||
+        s.num_tokens > line_recs[s.line].num_tokens - s.first_token ||
+        s.first_prefix > image.count(PREFIXES) ||
+        s.num_prefix > image.count(PREFIXES) - s.first_prefix ||
+        s.first_stmt_node > image.count(STMT_NODES) ||
+        s.num_stmt_nodes > image.count(STMT_NODES) - s.first_stmt_node ||
+        (s.num_stmt_nodes > 0 &&
+         !valid_stmt_tree(image.stmt_nodes() + s.first_stmt_node,
+                          s.num_stmt_nodes, s.num_tokens)))
+      return fail("bad LL_Stmt record");
+    for (std::uint32_t p = 0; p < s.num_prefix; ++p)
+      if (prefix_recs[s.first_prefix + p] >= num_lines)
+        return fail("bad LL_Stmt prefix line");
+  }
+  std::size_t const num_nodes = image.count(PRGM_NODES);
+  Prgm_Node const *const node_recs = image.prgm_nodes();
+  Stmt_Node const *const stmt_node_recs = image.stmt_nodes();
+  for (std::size_t i = 0; i < num_nodes; ++i) {
+    Prgm_Node const &n = node_recs[i];
+    auto const self = static_cast<std::int32_t>(i);
+    if (n.stmt >= static_cast<std::int32_t>(num_stmts) || n.stmt < -1 ||
+        (i == 0) != (n.parent == -1) || n.parent >= self ||
+        (n.next_sibling != -1 &&
+         (n.next_sibling <= self ||
+          n.next_sibling >= static_cast<std::int32_t>(num_nodes))) ||
+        (n.num_branches > 0 && i + 1 >= num_nodes))
+      return fail("bad program tree node");
+  }
+
+  lf.clear();
+  lf.file_info = std::make_shared<File_Info>(
+      name, static_cast<File_Type>(file.file_type));
+  lf.file_info->last_fixed_column = file.last_fixed_column;
+  lf.has_flpr_pp = file.has_flpr_pp != 0;
+  lf.num_input_lines = file.num_input_lines;
+  if (original_lines && lf.keep_original_lines())
+    lf.original_lines_ = std::move(*original_lines);
+
+  std::vector<LL_SEQ::iterator> line_its;
+  line_its.reserve(num_lines);
+  Layout_Rec const *const layout_recs = image.layout();
+  Token_Rec const *const token_recs = image.tokens();
+  for (std::size_t i = 0; i < num_lines; ++i) {
+    Line_Rec const &l = line_recs[i];
+    lf.lines.emplace_back();
+    auto const ll_it = std::prev(lf.lines.end());
+    line_its.push_back(ll_it);
+    Logical_Line &ll = *ll_it;
+    ll.file_info = lf.file_info;
+    ll.label = l.label;
+    ll.cat = static_cast<LineCat>(l.cat);
+    ll.suppress = (l.flags & SUPPRESS) != 0;
+    ll.needs_reformat = (l.flags & NEEDS_REFORMAT) != 0;
+    ll.dirty = (l.flags & DIRTY) != 0;
+
+    ll.layout().resize(l.num_layout);
+    for (std::uint32_t j = 0; j < l.num_layout; ++j) {
+      Layout_Rec const &r = layout_recs[l.first_layout + j];
+      File_Line &fl = ll.layout()[j];
+      fl.linenum = r.linenum;
+      fl.left_txt = image.string(r.left_txt);
+      fl.left_space = image.string(r.left_space);
+      fl.main_txt = image.string(r.main_txt);
+      fl.right_space = image.string(r.right_space);
+      fl.right_txt = image.string(r.right_txt);
+      fl.open_delim = static_cast<char>(r.open_delim);
+      for (unsigned b = 0; b < static_cast<unsigned>(CF::zzz_num); ++b)
+        if (r.classification & (1u << b))
+          fl.set_classification(static_cast<CF>(b));
+    }
+
+    for (std::uint32_t j = 0; j < l.num_tokens; ++j) {
+      Token_Rec const &r = token_recs[l.first_token + j];
+      ll.fragments().emplace_back(std::string{image.string(r.text)}, r.token,
+                                  r.start_line, r.start_pos);
+      Token_Text &tt = ll.fragments().back();
+      tt.mt_begin_line_ = r.mt_begin_line;
+      tt.mt_begin_col_ = r.mt_begin_col;
+      tt.mt_end_line_ = r.mt_end_line;
+      tt.mt_end_col_ = r.mt_end_col;
+      tt.pre_spaces_ = r.pre_spaces;
+      tt.post_spaces_ = r.post_spaces;
+    }
+    if (l.flags & HAS_STMTS)
+      ll.init_stmts();
+  }
+
+  std::vector<TT_Range::iterator> toks;
+  for (std::size_t i = 0; i < num_stmts; ++i) {
+    Stmt_Rec const &s = stmt_recs[i];
+    LL_SEQ::iterator const ll_it = line_its[s.line];
+    auto const first = std::next(ll_it->fragments().begin(), s.first_token);
+    lf.ll_stmts.emplace_back(ll_it,
+                             TT_Range{first, std::next(first, s.num_tokens)},
+                             s.label, s.compound);
+    LL_Stmt &stmt = lf.ll_stmts.back();
+    for (std::uint32_t p = 0; p < s.num_prefix; ++p)
+      stmt.prefix_lines.push_back(line_its[prefix_recs[s.first_prefix + p]]);
+    stmt.set_stmt_syntag(s.syntag);
+    if (s.num_stmt_nodes > 0) {
+      toks.clear();
+      for (auto it = stmt.begin(); it != stmt.end(); ++it)
+        toks.push_back(it);
+      toks.push_back(stmt.end());
+      Stmt_Node const *const st_nodes = stmt_node_recs + s.first_stmt_node;
+      Stmt::Stmt_Tree st{stmt_node_data(st_nodes[0], ll_it, toks)};
+      unflatten_stmt_tree(*st, st_nodes, 0, ll_it, toks);
+      stmt.set_stmt_tree(std::move(st));
+    }
+  }
+
+  nodes.assign(node_recs, node_recs + num_nodes);
+  return true;
+}
+
+} // namespace FLPR
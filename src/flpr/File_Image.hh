@@ -0,0 +1,340 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+/*!
+  \file File_Image.hh
+*/
+
+#ifndef FLPR_FILE_IMAGE_HH
+#define FLPR_FILE_IMAGE_HH 1
+
+#include "flpr/Logical_File.hh"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace FLPR {
+
+//! A flat binary image of a Logical_File, its Stmt_Trees and program tree
+/*! An image is a Header, a table of Sections, and the sections themselves.
+    Each section is an array of fixed-size records (or, for STRINGS, the
+    characters of every string), and records refer to each other and to
+    strings by index rather than by pointer.  So an image can be written out
+    and read back in as-is, and walked in place by a View, for example over a
+    Mapping of an image file.
+
+    The integers are in the byte order of the writer, which is recorded in
+    the Header, and a View rejects an image written with a different order or
+    a different version.
+
+    write() builds the image of a Logical_File, along with the flattened
+    program tree from flatten().  read() rebuilds the Logical_Lines, the
+    LL_Stmts (with their syntags and any saved Stmt_Trees), and the
+    Prgm_Nodes that describe the program tree.  Statements whose Stmt_Trees
+    were not saved rebuild them from the syntags on demand (see
+    LL_Stmt::stmt_tree()). */
+class File_Image {
+public:
+  //! Change this whenever the layout or meaning of a record changes
+  static constexpr std::uint32_t version = 2;
+
+  struct Header {
+    char magic[8];             //!< "FLPRIMG"
+    std::uint32_t version;     //!< File_Image::version
+    std::uint32_t byte_order;  //!< byte_order_mark, as written
+    std::uint32_t num_sections;
+    std::uint32_t reserved;
+  };
+  static constexpr std::uint32_t byte_order_mark = 0x01020304;
+
+  enum Section_Id : std::uint32_t {
+    FILE_INFO,      //!< one File_Rec
+    STRINGS,        //!< the characters of all strings
+    LINES,          //!< a Line_Rec for each Logical_Line
+    LAYOUT,         //!< a Layout_Rec for each File_Line
+    TOKENS,         //!< a Token_Rec for each Token_Text
+    STMTS,          //!< a Stmt_Rec for each LL_Stmt
+    PREFIXES,       //!< the Line_Rec indices of the LL_Stmt prefix_lines
+    PRGM_NODES,     //!< a Prgm_Node for each program tree node, in preorder
+    STMT_NODES,     //!< the Stmt_Node of each saved Stmt_Tree, in preorder
+    ORIGINAL_LINES, //!< a String_Ref for each Logical_File::original_lines()
+    NUM_SECTIONS
+  };
+
+  //! An entry in the section table, which follows the Header
+  struct Section {
+    std::uint32_t id;
+    std::uint32_t record_size; //!< 1 for STRINGS
+    std::uint64_t offset;      //!< from the start of the image
+    std::uint64_t count;       //!< number of records
+  };
+
+  //! A string in the STRINGS section
+  struct String_Ref {
+    std::uint32_t offset;
+    std::uint32_t size;
+  };
+
+  struct File_Rec {
+    String_Ref filename;
+    std::int32_t file_type;
+    std::int32_t last_fixed_column;
+    std::uint32_t has_flpr_pp;
+    std::uint32_t reserved;
+    std::uint64_t num_input_lines;
+  };
+
+  //! Line_Rec::flags bits
+  enum Line_Flags : std::uint32_t {
+    SUPPRESS = 1,
+    NEEDS_REFORMAT = 2,
+    DIRTY = 4,
+    HAS_STMTS = 8 //!< Logical_Line::init_stmts() had been called
+  };
+
+  struct Line_Rec {
+    std::int32_t label;
+    std::int32_t cat;
+    std::uint32_t flags;
+    std::uint32_t first_layout; //!< index into LAYOUT
+    std::uint32_t num_layout;
+    std::uint32_t first_token; //!< index into TOKENS
+    std::uint32_t num_tokens;
+  };
+
+  struct Layout_Rec {
+    std::int32_t linenum;
+    std::uint32_t classification; //!< bit i is File_Line::class_flags(i)
+    std::int32_t open_delim;
+    String_Ref left_txt, left_space, main_txt, right_space, right_txt;
+  };
+
+  struct Token_Rec {
+    std::int32_t token;
+    std::int32_t start_line;
+    std::int32_t start_pos;
+    String_Ref text;
+    std::int32_t mt_begin_line, mt_begin_col;
+    std::int32_t mt_end_line, mt_end_col;
+    std::int32_t pre_spaces, post_spaces;
+  };
+
+  struct Stmt_Rec {
+    std::uint32_t line;        //!< index into LINES
+    std::uint32_t first_token; //!< relative to the line's first_token
+    std::uint32_t num_tokens;
+    std::int32_t label;
+    std::int32_t compound;
+    std::int32_t syntag;
+    std::uint32_t first_prefix; //!< index into PREFIXES
+    std::uint32_t num_prefix;
+    std::uint32_t first_stmt_node; //!< index into STMT_NODES
+    std::uint32_t num_stmt_nodes;  //!< 0 if the Stmt_Tree wasn't saved
+  };
+
+  //! Stmt_Node::flags bits
+  enum Stmt_Node_Flags : std::uint32_t {
+    //! An empty token range that still refers to the Logical_Line
+    HAS_LINE = 1
+  };
+
+  //! A Stmt_Tree node.  The branches, if any, follow in preorder.
+  struct Stmt_Node {
+    std::int32_t syntag;
+    std::int32_t first_token; //!< relative to the statement, or -1 if empty
+    std::uint32_t num_tokens;
+    std::uint32_t num_branches;
+    std::uint32_t flags;
+  };
+
+  //! A program tree node.  The first branch, if any, is the next node.
+  struct Prgm_Node {
+    std::int32_t syntag;
+    std::int32_t stmt;         //!< index into STMTS, or -1
+    std::int32_t parent;       //!< -1 for the root
+    std::int32_t next_sibling; //!< -1 for the last branch
+    std::uint32_t num_branches;
+  };
+
+  using Prgm_Nodes = std::vector<Prgm_Node>;
+
+  //! Read-only access to an image in memory
+  /*! The View does not copy the data, which must outlive it.  If the image
+      is malformed, the View is false and every section is empty. */
+  class View {
+  public:
+    View() = default;
+    View(char const *data, std::size_t size);
+
+    explicit operator bool() const noexcept { return data_ != nullptr; }
+
+    //! The records of section id
+    template <typename Rec> Rec const *records(Section_Id id) const noexcept {
+      return reinterpret_cast<Rec const *>(section_data_(id));
+    }
+    std::size_t count(Section_Id id) const noexcept {
+      return sections_ ? sections_[id].count : 0;
+    }
+    //! Return s, or an empty string if it is out of range
+    std::string_view string(String_Ref s) const noexcept;
+
+    File_Rec const &file() const noexcept {
+      return *records<File_Rec>(FILE_INFO);
+    }
+    Line_Rec const *lines() const noexcept { return records<Line_Rec>(LINES); }
+    Layout_Rec const *layout() const noexcept {
+      return records<Layout_Rec>(LAYOUT);
+    }
+    Token_Rec const *tokens() const noexcept {
+      return records<Token_Rec>(TOKENS);
+    }
+    Stmt_Rec const *stmts() const noexcept { return records<Stmt_Rec>(STMTS); }
+    std::uint32_t const *prefixes() const noexcept {
+      return records<std::uint32_t>(PREFIXES);
+    }
+    Prgm_Node const *prgm_nodes() const noexcept {
+      return records<Prgm_Node>(PRGM_NODES);
+    }
+    Stmt_Node const *stmt_nodes() const noexcept {
+      return records<Stmt_Node>(STMT_NODES);
+    }
+    String_Ref const *original_lines() const noexcept {
+      return records<String_Ref>(ORIGINAL_LINES);
+    }
+
+  private:
+    char const *section_data_(Section_Id id) const noexcept {
+      return sections_ ? data_ + sections_[id].offset : nullptr;
+    }
+
+  private:
+    char const *data_{nullptr};
+    std::size_t size_{0};
+    Section const *sections_{nullptr};
+  };
+
+  //! A read-only memory map of an image file
+  /*! The image is walked in place through view(), and is unmapped when the
+      Mapping is destroyed.  If the file can't be mapped, or isn't a valid
+      image, the Mapping is false, with a message to std::cerr. */
+  class Mapping {
+  public:
+    Mapping() = default;
+    explicit Mapping(std::string const &path);
+    Mapping(Mapping const &) = delete;
+    Mapping &operator=(Mapping const &) = delete;
+    Mapping(Mapping &&other) noexcept { swap(other); }
+    Mapping &operator=(Mapping &&other) noexcept {
+      Mapping{std::move(other)}.swap(*this);
+      return *this;
+    }
+    ~Mapping();
+
+    explicit operator bool() const noexcept { return static_cast<bool>(view_); }
+    View const &view() const noexcept { return view_; }
+    std::size_t size() const noexcept { return size_; }
+
+    void swap(Mapping &other) noexcept {
+      std::swap(addr_, other.addr_);
+      std::swap(size_, other.size_);
+      std::swap(view_, other.view_);
+    }
+
+  private:
+    void *addr_{nullptr};
+    std::size_t size_{0};
+    View view_;
+  };
+
+public:
+  //! Flatten the program tree, which must be linked to lf.ll_stmts
+  template <typename Tree>
+  static Prgm_Nodes flatten(Tree const &tree, Logical_File const &lf);
+
+  //! Return the image of lf and the flattened program tree
+  /*! If stmt_trees is true, the Stmt_Trees that are currently built are
+      saved as well. */
+  static std::string write(Logical_File const &lf, Prgm_Nodes const &nodes,
+                           bool const stmt_trees = true);
+
+  //! Write image to the file at path, returning false on failure
+  static bool save(std::string const &path, std::string const &image);
+
+  //! Rebuild lf and the flattened program tree from an image
+  /*! lf is rebuilt under the given name (rather than the name in the image),
+      and original_lines become its Logical_File::original_lines() if lf keeps
+      them.  Returns false, with a message to std::cerr, if the image is bad
+      or doesn't match original_lines. */
+  static bool read(View const &image, std::string const &name,
+                   Logical_File::Line_Buf &&original_lines, Logical_File &lf,
+                   Prgm_Nodes &nodes);
+  //! Rebuild lf and the program tree, taking the original lines from image
+  /*! The image only has the original lines if the Logical_File it was
+      written from kept them. */
+  static bool read(View const &image, std::string const &name,
+                   Logical_File &lf, Prgm_Nodes &nodes);
+
+private:
+  //! The read()s, where original_lines is nullptr if they aren't known
+  static bool read_(View const &image, std::string const &name,
+                    Logical_File::Line_Buf *original_lines, Logical_File &lf,
+                    Prgm_Nodes &nodes);
+  template <typename Node>
+  static void flatten_recurse_(
+      Node const &n, std::int32_t const parent,
+      std::unordered_map<LL_Stmt const *, std::int32_t> const &stmt_index,
+      Prgm_Nodes &nodes);
+};
+
+template <typename Tree>
+auto File_Image::flatten(Tree const &tree, Logical_File const &lf)
+    -> Prgm_Nodes {
+  Prgm_Nodes nodes;
+  if (tree.empty())
+    return nodes;
+  std::unordered_map<LL_Stmt const *, std::int32_t> stmt_index;
+  std::int32_t i{0};
+  for (auto const &stmt : lf.ll_stmts)
+    stmt_index.emplace(&stmt, i++);
+  flatten_recurse_(*tree, -1, stmt_index, nodes);
+  return nodes;
+}
+
+template <typename Node>
+void File_Image::flatten_recurse_(
+    Node const &n, std::int32_t const parent,
+    std::unordered_map<LL_Stmt const *, std::int32_t> const &stmt_index,
+    Prgm_Nodes &nodes) {
+  std::int32_t const self = static_cast<std::int32_t>(nodes.size());
+  std::int32_t stmt{-1};
+  if (n->is_stmt()) {
+    auto const s = stmt_index.find(&n->ll_stmt());
+    if (s != stmt_index.end())
+      stmt = s->second;
+  }
+  nodes.push_back(Prgm_Node{n->syntag(), stmt, parent, -1,
+                            static_cast<std::uint32_t>(n.num_branches())});
+  std::int32_t prev{-1};
+  for (auto const &b : n.branches()) {
+    std::int32_t const branch = static_cast<std::int32_t>(nodes.size());
+    if (prev >= 0)
+      nodes[prev].next_sibling = branch;
+    flatten_recurse_(b, self, stmt_index, nodes);
+    prev = branch;
+  }
+}
+
+} // namespace FLPR
+
+#endif
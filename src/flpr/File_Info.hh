@@ -20,6 +20,10 @@
 
 //! Namespace for FLPR: The Fortran Language Program Remodeling system
 namespace FLPR {
+namespace Stmt {
+class Parser_Exts;
+}
+
 //! The type of a Logical_File
 enum class File_Type {
   UNKNOWN,
@@ -39,6 +43,10 @@ struct File_Info {
   File_Type file_type;
   //! If fixed-format, the last column
   int last_fixed_column = 0;
+  //! The extension statement parsers that the file was parsed with
+  /*! nullptr means Stmt::get_parser_exts().  LL_Stmt::stmt_tree() uses these
+      to rebuild a Stmt_Tree on demand. */
+  Stmt::Parser_Exts const *parser_exts{nullptr};
 };
 
 //! Guess the type of a file from its extension
@@ -15,6 +15,7 @@
 #include "flpr/File_Line.hh"
 #include "flpr/utils.hh"
 
+#include <algorithm>
 #include <cassert>
 #include <cctype>
 #include <cstdlib>
@@ -457,6 +458,23 @@ size_t File_Line::size() const noexcept {
          right_space.size() + right_txt.size();
 }
 
+size_t File_Line::print_size() const noexcept {
+  size_t const n = size();
+  if (is_fortran() && is_fixed_format() && left_txt.size() < 6)
+    return n + 6 - left_txt.size();
+  return n;
+}
+
+char *File_Line::render(char *dst) const noexcept {
+  dst = std::copy(left_txt.begin(), left_txt.end(), dst);
+  if (is_fortran() && is_fixed_format() && left_txt.size() < 6)
+    dst = std::fill_n(dst, 6 - left_txt.size(), ' ');
+  dst = std::copy(left_space.begin(), left_space.end(), dst);
+  dst = std::copy(main_txt.begin(), main_txt.end(), dst);
+  dst = std::copy(right_space.begin(), right_space.end(), dst);
+  return std::copy(right_txt.begin(), right_txt.end(), dst);
+}
+
 bool File_Line::set_leading_spaces(int const spaces) {
   if (is_comment()) {
     std::string::size_type pos = left_txt.find('!');
@@ -182,6 +182,15 @@ public:
   //! Return the number of characters across
   size_t size() const noexcept;
 
+  //! Return the number of characters written by operator<<
+  /*! This is size(), plus the padding of a fixed-format left_txt to six
+      columns. */
+  size_t print_size() const noexcept;
+
+  //! Copy the characters written by operator<< to dst, returning the end
+  /*! dst must have room for print_size() characters. */
+  char *render(char *dst) const noexcept;
+
   //! Set the number of spaces aligning the main_txt or comment
   /*! Note that this will make no changes if not is_fortran() or is_comment().
       This function returns true if the spacing was altered, false otherwise. */
@@ -0,0 +1,363 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+/*!
+  \file File_Pipeline.hh
+*/
+
+#ifndef FLPR_FILE_PIPELINE_HH
+#define FLPR_FILE_PIPELINE_HH 1
+
+#include "flpr/Bounded_Queue.hh"
+#include "flpr/Parsed_File.hh"
+#include "flpr/Stmt_Parser_Exts.hh"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace FLPR {
+
+//! Process a list of files in overlapped stages
+/*! Each file becomes an Item that passes through five stages, connected by
+    Bounded_Queues:
+      - READ reads the raw lines of the file
+      - SCAN builds the Logical_Lines
+      - PARSE builds the statements and parse tree (see set_parse_depth())
+      - TRANSFORM calls the client transform function
+      - WRITE calls the client writer function
+
+    Each stage has its own threads, so that reading and writing overlap with
+    scanning and parsing.  When a stage's output queue is full, the stage
+    waits (backpressure), which bounds the number of files in memory.
+
+    An Item that fails in a stage, including by throwing, is marked !ok and
+    skips the later stages up to the writer.  The writer sees every Item, so
+    it can report failures.  Both client functions are called concurrently
+    for different Items, unless the stage has one thread. */
+template <typename PG_NODE_DATA = Prgm::Prgm_Node_Data> class File_Pipeline {
+public:
+  using File = Parsed_File<PG_NODE_DATA>;
+
+  //! A file on its way through the pipeline
+  struct Item {
+    std::size_t index{0};         //!< position in the list given to run()
+    std::string filename;         //!< the name given to run()
+    Logical_File::Line_Buf lines; //!< the raw text, until it is scanned
+    std::unique_ptr<File> file;   //!< built by the SCAN stage
+    bool ok{false};               //!< true if all stages have succeeded
+    bool changed{false};          //!< for the transform to set
+    std::string output;           //!< from the transform, for the writer
+    std::string error;            //!< reason for a failure
+  };
+
+  //! Returns false if the Item failed
+  using Stage_Function = std::function<bool(Item &)>;
+
+  enum Stage { READ, SCAN, PARSE, TRANSFORM, WRITE, NUM_STAGES };
+
+  //! How much the PARSE stage builds
+  enum class Parse_Depth { NONE, STATEMENTS, TREE };
+
+  struct Stage_Stats {
+    unsigned threads{0};
+    std::size_t items{0};           //!< Items that the stage processed
+    double busy_seconds{0};         //!< summed over the stage's threads
+    double input_wait_seconds{0};   //!< waiting for the previous stage
+    double output_wait_seconds{0};  //!< waiting for room in the next stage
+    std::size_t max_queue_depth{0}; //!< of the input queue
+    double mean_queue_depth{0};     //!< of the input queue
+  };
+
+public:
+  File_Pipeline() { threads_.fill(1); }
+
+  void set_threads(Stage const stage, unsigned const num_threads) noexcept {
+    threads_[stage] = std::max(num_threads, 1u);
+  }
+  unsigned threads(Stage const stage) const noexcept {
+    return threads_[stage];
+  }
+  //! The capacity of each queue between stages
+  void set_queue_capacity(std::size_t const capacity) noexcept {
+    queue_capacity_ = capacity;
+  }
+  void set_parse_depth(Parse_Depth const depth) noexcept {
+    parse_depth_ = depth;
+  }
+  void set_transform(Stage_Function f) { transform_ = std::move(f); }
+  void set_writer(Stage_Function f) { writer_ = std::move(f); }
+  //! Hand Items to the writer in the order given to run()
+  /*! This uses a single writer thread, which holds any Items that finish
+      early.  The READ stage doesn't start a file until it is within the
+      reorder window of the oldest file that hasn't been written, so that a
+      slow file holds back at most that many others. */
+  void set_ordered_writes(bool const ordered) noexcept {
+    ordered_writes_ = ordered;
+  }
+  //! The number of files that ordered writes may have in flight
+  void set_reorder_window(std::size_t const window) noexcept {
+    reorder_window_ = std::max<std::size_t>(window, 1);
+  }
+  std::size_t reorder_window() const noexcept { return reorder_window_; }
+  void set_last_fixed_col(int const last_fixed_col) noexcept {
+    last_fixed_col_ = last_fixed_col;
+  }
+  //! Passed on to each Parsed_File (see Parsed_File::set_work_budget())
+  void set_work_budget(std::size_t const budget) noexcept {
+    work_budget_ = budget;
+  }
+  //! Passed on to each Parsed_File (see Parsed_File::set_parser_exts())
+  void set_parser_exts(Stmt::Parser_Exts const *exts) noexcept {
+    parser_exts_ = exts;
+  }
+  //! Passed on to each Parsed_File (see Parsed_File::set_parse_cache())
+  void set_parse_cache(Parse_Cache *cache) noexcept { parse_cache_ = cache; }
+  //! Passed on to each Parsed_File (see
+  //! Parsed_File::set_keep_original_lines())
+  void set_keep_original_lines(bool const keep) noexcept {
+    keep_original_lines_ = keep;
+  }
+
+  //! Process the files, returning true if no Item failed
+  /*! As with Batch_Parser::run(), the files are parsed with a frozen copy of
+      the statement parser extensions, and Syntax_Tags extensions must be
+      registered before run(). */
+  bool run(std::vector<std::string> const &filenames);
+
+  Stage_Stats const &stats(Stage const stage) const noexcept {
+    return stats_[stage];
+  }
+  static char const *stage_name(Stage const stage) noexcept {
+    static char const *const names[NUM_STAGES] = {"read", "scan", "parse",
+                                                  "transform", "write"};
+    return names[stage];
+  }
+
+private:
+  using Queue_ = Bounded_Queue<Item>;
+
+  bool process_(Stage const stage, Item &item);
+  void record_(Stage const stage, std::size_t const items,
+               double const seconds);
+
+private:
+  std::array<unsigned, NUM_STAGES> threads_;
+  std::size_t queue_capacity_{16};
+  Parse_Depth parse_depth_{Parse_Depth::TREE};
+  Stage_Function transform_, writer_;
+  bool ordered_writes_{false};
+  std::size_t reorder_window_{64};
+  int last_fixed_col_{0};
+  Stmt::Parser_Exts const *parser_exts_{nullptr};
+  //! The frozen copy of the extensions, during run()
+  Stmt::Parser_Exts const *run_exts_{nullptr};
+  Parse_Cache *parse_cache_{nullptr};
+  std::size_t work_budget_{0};
+  bool keep_original_lines_{false};
+  std::array<Stage_Stats, NUM_STAGES> stats_;
+  std::mutex stats_mutex_;
+  std::atomic<std::size_t> num_failed_{0};
+};
+
+template <typename PG_NODE_DATA>
+bool File_Pipeline<PG_NODE_DATA>::run(
+    std::vector<std::string> const &filenames) {
+  using clock = std::chrono::steady_clock;
+  stats_.fill(Stage_Stats{});
+  num_failed_ = 0;
+  /* the files are parsed concurrently, so the extensions must not change */
+  Stmt::Parser_Exts run_exts{parser_exts_ ? *parser_exts_
+                                          : Stmt::get_parser_exts()};
+  run_exts.freeze();
+  run_exts_ = &run_exts;
+  if (ordered_writes_)
+    threads_[WRITE] = 1;
+
+  /* queues[s] feeds stage s + 1 */
+  std::vector<std::unique_ptr<Queue_>> queues;
+  for (int s = READ; s < WRITE; ++s)
+    queues.push_back(std::make_unique<Queue_>(queue_capacity_));
+  std::array<std::atomic<unsigned>, NUM_STAGES> running;
+  for (int s = READ; s < NUM_STAGES; ++s)
+    running[s] = threads_[s];
+
+  std::atomic<std::size_t> next_file{0};
+  /* For ordered writes, the number of files written so far */
+  std::size_t num_written{0};
+  std::mutex window_mutex;
+  std::condition_variable window_moved;
+  auto const worker = [&](Stage const stage) {
+    std::size_t items{0};
+    clock::duration busy{0};
+    Queue_ *const in = (stage == READ) ? nullptr : queues[stage - 1].get();
+    Queue_ *const out = (stage == WRITE) ? nullptr : queues[stage].get();
+    std::map<std::size_t, Item> pending;
+    std::size_t next_write{0};
+    for (;;) {
+      Item item;
+      if (stage == READ) {
+        std::size_t const i = next_file++;
+        if (i >= filenames.size())
+          break;
+        if (ordered_writes_) {
+          std::unique_lock<std::mutex> lock{window_mutex};
+          window_moved.wait(
+              lock, [&] { return i < num_written + reorder_window_; });
+        }
+        item.index = i;
+        item.filename = filenames[i];
+        item.ok = true;
+      } else if (!in->pop(item)) {
+        break;
+      }
+      auto const start = clock::now();
+      if (stage == WRITE && ordered_writes_) {
+        std::size_t const index = item.index;
+        pending.emplace(index, std::move(item));
+        for (auto p = pending.find(next_write); p != pending.end();
+             p = pending.find(++next_write)) {
+          process_(stage, p->second);
+          pending.erase(p);
+          items += 1;
+        }
+        {
+          std::lock_guard<std::mutex> const lock{window_mutex};
+          num_written = next_write;
+        }
+        window_moved.notify_all();
+      } else {
+        process_(stage, item);
+        items += 1;
+      }
+      busy += clock::now() - start;
+      if (out)
+        out->push(std::move(item));
+    }
+    record_(stage, items, std::chrono::duration<double>(busy).count());
+    if (--running[stage] == 0 && out)
+      out->close();
+  };
+
+  std::vector<std::thread> pool;
+  for (int s = READ; s < NUM_STAGES; ++s)
+    for (unsigned t = 0; t < threads_[s]; ++t)
+      pool.emplace_back(worker, static_cast<Stage>(s));
+  for (auto &t : pool)
+    t.join();
+  run_exts_ = nullptr;
+
+  for (int s = READ; s < NUM_STAGES; ++s) {
+    Stage_Stats &st = stats_[s];
+    st.threads = threads_[s];
+    if (s > READ) {
+      Queue_ const &in = *queues[s - 1];
+      st.input_wait_seconds = in.pop_wait_seconds();
+      st.max_queue_depth = in.max_depth();
+      st.mean_queue_depth = in.mean_depth();
+    }
+    if (s < WRITE)
+      st.output_wait_seconds = queues[s]->push_wait_seconds();
+  }
+  return num_failed_ == 0;
+}
+
+template <typename PG_NODE_DATA>
+bool File_Pipeline<PG_NODE_DATA>::process_(Stage const stage, Item &item) {
+  if (!item.ok && stage != WRITE)
+    return false;
+  try {
+    bool ok{true};
+    switch (stage) {
+    case READ:
+      ok = Logical_File::read_lines(item.filename, item.lines);
+      if (!ok)
+        item.error = "unable to read the file";
+      break;
+    case SCAN:
+      item.file = std::make_unique<File>();
+      item.file->set_work_budget(work_budget_);
+      item.file->set_parser_exts(run_exts_);
+      item.file->set_parse_cache(parse_cache_);
+      item.file->set_keep_original_lines(keep_original_lines_);
+      ok = !item.file->scan_lines(std::move(item.lines), item.filename,
+                                  last_fixed_col_);
+      item.lines = Logical_File::Line_Buf{};
+      if (!ok)
+        item.error = "scan failed";
+      break;
+    case PARSE:
+      if (parse_depth_ != Parse_Depth::NONE)
+        ok = item.file->prefetch_statements();
+      if (ok && parse_depth_ == Parse_Depth::TREE)
+        ok = item.file->prefetch_parse_tree() && *item.file;
+      if (!ok)
+        item.error = "parse failed";
+      break;
+    case TRANSFORM:
+      if (transform_)
+        ok = transform_(item);
+      if (!ok && item.error.empty())
+        item.error = "transform failed";
+      break;
+    case WRITE: {
+      bool const was_ok = item.ok;
+      if (writer_)
+        ok = writer_(item);
+      if (was_ok && !ok && item.error.empty())
+        item.error = "write failed";
+      ok = ok && was_ok;
+    } break;
+    default:
+      break;
+    }
+    if (!ok && item.ok) {
+      item.ok = false;
+      num_failed_ += 1;
+    }
+  } catch (std::exception const &e) {
+    item.error = e.what();
+    if (item.ok) {
+      item.ok = false;
+      num_failed_ += 1;
+    }
+  } catch (...) {
+    item.error = "unknown exception";
+    if (item.ok) {
+      item.ok = false;
+      num_failed_ += 1;
+    }
+  }
+  if (stage == WRITE)
+    item.file.reset();
+  return item.ok;
+}
+
+template <typename PG_NODE_DATA>
+void File_Pipeline<PG_NODE_DATA>::record_(Stage const stage,
+                                          std::size_t const items,
+                                          double const seconds) {
+  std::lock_guard<std::mutex> const lock{stats_mutex_};
+  stats_[stage].items += items;
+  stats_[stage].busy_seconds += seconds;
+}
+
+} // namespace FLPR
+
+#endif
@@ -14,6 +14,9 @@
 
 #include "flpr/LL_Stmt.hh"
 #include "flpr/parse_stmt.hh"
+#include <array>
+#include <cstdint>
+#include <mutex>
 #include <ostream>
 
 #define DEBUG_PRINT 0
@@ -57,7 +60,18 @@ int LL_Stmt::stmt_tag(bool const look_inside_if_stmt) const {
   return retval;
 }
 
+/* The statement trees are rebuilt under a lock picked by address, rather than
+   giving every LL_Stmt a mutex */
+static std::mutex &rebuild_mutex(LL_Stmt const *const stmt) noexcept {
+  static std::array<std::mutex, 64> mutexes;
+  std::uintptr_t const addr = reinterpret_cast<std::uintptr_t>(stmt);
+  return mutexes[(addr / sizeof(LL_Stmt)) % mutexes.size()];
+}
+
 bool LL_Stmt::rebuild_tree_() const {
+  std::lock_guard<std::mutex> const lock{rebuild_mutex(this)};
+  if (has_tree_)
+    return true; // another thread got here first
   if (Syntax_Tags::UNKNOWN == stmt_syntag_) {
 #if DEBUG_PRINT
     std::cerr << "UNKNOWN stmt_syntag on ";
@@ -66,19 +80,26 @@ bool LL_Stmt::rebuild_tree_() const {
     return false;
   }
   TT_Stream tts{*const_cast<LL_Stmt *>(this)};
+  if (ll().file_info)
+    tts.set_parser_exts(ll().file_info->parser_exts);
   if (Stmt::is_action_stmt(stmt_syntag_)) {
     stmt_tree_ = Stmt::parse_stmt_dispatch(Syntax_Tags::SG_ACTION_STMT, tts);
   } else {
     stmt_tree_ = Stmt::parse_stmt_dispatch(stmt_syntag_, tts);
   }
-  extract_tree_tag_();
+  /* Other threads may be reading stmt_syntag_ (it is a relaxed atomic), and
+     it only changes if the rebuilt tree disagrees */
+  int const tag = tree_tag_();
+  if (tag != stmt_syntag_)
+    stmt_syntag_ = tag;
 #if DEBUG_PRINT
   if (stmt_tree_.empty()) {
     Syntax_Tags::print(std::cerr << "Parsing ", stmt_syntag_) << " failed on\n";
     print_me(std::cerr, false) << '\n';
   }
 #endif
-  return !stmt_tree_.empty();
+  has_tree_ = !stmt_tree_.empty();
+  return has_tree_;
 }
 
 std::ostream &LL_Stmt::print_me(std::ostream &os,
@@ -16,6 +16,7 @@
 #define FLPR_LL_STMT_HH 1
 
 #include "flpr/LL_TT_Range.hh"
+#include "flpr/Lazy_Flag.hh"
 #include "flpr/Safe_List.hh"
 #include "flpr/Stmt_Tree.hh"
 #include <ostream>
@@ -38,7 +39,7 @@ public:
     LL_TT_Range::operator=(src);
     compound_ = src.compound_;
     label_ = src.label_;
-    stmt_tree_.clear(); // It is bad at this point
+    clear_tree_(); // It is bad at this point
   }
 
   constexpr bool has_label() const { return label_ > 0; }
@@ -72,15 +73,18 @@ public:
   bool set_leading_spaces(int const spaces, int const continued_offset);
   int get_leading_spaces() const noexcept { return ll().get_leading_spaces(); }
 
+  //! Return the Stmt_Tree, rebuilding it if it was dropped
+  /*! Concurrent calls on the same LL_Stmt are safe: one thread rebuilds the
+      tree and publishes it to the others (see build_stmt_tree()). */
   Stmt_Tree const &stmt_tree() const noexcept {
-    if (stmt_tree_.empty()) {
+    if (!has_tree_) {
       bool res = rebuild_tree_();
       assert(res);
     }
     return stmt_tree_;
   }
   Stmt_Tree &stmt_tree() noexcept {
-    if (stmt_tree_.empty()) {
+    if (!has_tree_) {
       bool res = rebuild_tree_();
       assert(res);
     }
@@ -89,16 +93,37 @@ public:
   void set_stmt_tree(Stmt_Tree &&stmt_tree) {
     stmt_tree_ = std::move(stmt_tree);
     extract_tree_tag_();
+    has_tree_ = !stmt_tree_.empty();
   }
-  void drop_stmt_tree() { stmt_tree_.clear(); }
+  //! Release the Stmt_Tree, keeping the syntag so that it can be rebuilt
+  void drop_stmt_tree() { clear_tree_(); }
+  //! Select whether a Stmt_Tree rebuilt on demand is kept indefinitely
+  /*! The program parser clears this when it doesn't keep the Stmt_Trees, so
+      that consumer passes (see Procedure_Visitor) can give back the trees
+      they rebuilt with release_stmt_tree(). */
+  void set_keep_stmt_tree(bool const keep) noexcept { keep_tree_ = keep; }
+  bool keeps_stmt_tree() const noexcept { return keep_tree_; }
+  //! Drop the Stmt_Tree, unless it is being kept (see set_keep_stmt_tree())
+  /*! No other thread may be using this Stmt_Tree. */
+  void release_stmt_tree() {
+    if (!keep_tree_)
+      clear_tree_();
+  }
+  //! Return true if the Stmt_Tree is currently built
+  bool has_stmt_tree() const noexcept { return has_tree_; }
+  //! Rebuild a dropped Stmt_Tree from the syntag, if needed
+  /*! Returns false if there is no tree and it can't be rebuilt.  The rebuild
+      holds a lock on this LL_Stmt, so any number of threads may call this
+      (or stmt_tree()) on the same or different statements. */
+  bool build_stmt_tree() const { return has_tree_ || rebuild_tree_(); }
   void reset_stmt_tree() {
-    stmt_tree_.clear();
+    clear_tree_();
     extract_tree_tag_();
   }
   void set_stmt_syntag(int syntag) {
     /* This overrules anything in the tree */
     if (syntag != stmt_syntag_) {
-      stmt_tree_.clear();
+      clear_tree_();
     }
     stmt_syntag_ = syntag;
   }
@@ -122,7 +147,7 @@ public:
     return std::next(prefix_lines.back());
   }
   LL_IT stmt_ll() const { return it(); }
-  constexpr int syntax_tag() const { return stmt_syntag_; }
+  int syntax_tag() const noexcept { return stmt_syntag_; }
 
 public:
   //! A sequence of non-Fortran Logical_Lines before this statement.
@@ -146,18 +171,25 @@ private:
      we use void* instead. */
   void *hook_;
   mutable Stmt_Tree stmt_tree_;
-  mutable int stmt_syntag_;
+  //! Rebuilding a tree may correct this while other threads read it
+  mutable Relaxed_Value<int> stmt_syntag_;
+  //! Set once stmt_tree_ is built, so that it can be read by other threads
+  mutable Publish_Flag has_tree_;
+  bool keep_tree_{true};
 
 private:
-  void extract_tree_tag_() const {
+  int tree_tag_() const {
     if (stmt_tree_.empty())
-      stmt_syntag_ = Syntax_Tags::UNKNOWN;
-    else {
-      auto c = stmt_tree_.ccursor();
-      if (c->syntag == Syntax_Tags::SG_ACTION_STMT)
-        c.down();
-      stmt_syntag_ = c->syntag;
-    }
+      return Syntax_Tags::UNKNOWN;
+    auto c = stmt_tree_.ccursor();
+    if (c->syntag == Syntax_Tags::SG_ACTION_STMT)
+      c.down();
+    return c->syntag;
+  }
+  void extract_tree_tag_() const { stmt_syntag_ = tree_tag_(); }
+  void clear_tree_() {
+    has_tree_ = false;
+    stmt_tree_.clear();
   }
   bool rebuild_tree_() const;
 };
@@ -42,6 +42,9 @@ public:
     return line_ref_;
   }
 
+  //! Return true if the owning Logical_Line iterator has been set
+  constexpr bool has_it() const noexcept { return ll_set_; }
+
   //! Access the owning Logical_Line
   Logical_Line &ll() { return *it(); }
   Logical_Line const &ll() const {
@@ -15,6 +15,7 @@
 #define FLPR_LABEL_STACK_HH 1
 
 #include <cassert>
+#include <cstddef>
 #include <vector>
 
 namespace FLPR {
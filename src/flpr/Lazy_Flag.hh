@@ -0,0 +1,122 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+/*!
+  \file Lazy_Flag.hh
+*/
+
+#ifndef FLPR_LAZY_FLAG_HH
+#define FLPR_LAZY_FLAG_HH 1
+
+#include <atomic>
+#include <mutex>
+
+namespace FLPR {
+
+//! A bool that publishes lazily built data to other threads
+/*! Setting the flag is a release store, and reading it is an acquire load, so
+    a thread that sees the flag set also sees everything written before it was
+    set.  On the common platforms, reading costs the same as a plain bool.
+
+    Copying a Publish_Flag copies the value, so that classes holding one keep
+    their implicit copy and move operations. */
+class Publish_Flag {
+public:
+  constexpr Publish_Flag(bool const value = false) noexcept : value_{value} {}
+  Publish_Flag(Publish_Flag const &src) noexcept : value_{src.test()} {}
+  Publish_Flag &operator=(Publish_Flag const &src) noexcept {
+    set(src.test());
+    return *this;
+  }
+  Publish_Flag &operator=(bool const value) noexcept {
+    set(value);
+    return *this;
+  }
+
+  bool test() const noexcept { return value_.load(std::memory_order_acquire); }
+  void set(bool const value = true) noexcept {
+    value_.store(value, std::memory_order_release);
+  }
+  operator bool() const noexcept { return test(); }
+
+private:
+  std::atomic<bool> value_;
+};
+
+//! A value that threads may read while another thread overwrites it
+/*! Loads and stores are relaxed atomics: a reader sees either the old or the
+    new value, but nothing else is ordered by them (use a Publish_Flag for
+    that).  As with Publish_Flag, copying copies the value. */
+template <typename T> class Relaxed_Value {
+public:
+  constexpr Relaxed_Value(T const value = T{}) noexcept : value_{value} {}
+  Relaxed_Value(Relaxed_Value const &src) noexcept : value_{src.load()} {}
+  Relaxed_Value &operator=(Relaxed_Value const &src) noexcept {
+    store(src.load());
+    return *this;
+  }
+  Relaxed_Value &operator=(T const value) noexcept {
+    store(value);
+    return *this;
+  }
+
+  T load() const noexcept { return value_.load(std::memory_order_relaxed); }
+  void store(T const value) noexcept {
+    value_.store(value, std::memory_order_relaxed);
+  }
+  operator T() const noexcept { return load(); }
+
+private:
+  std::atomic<T> value_;
+};
+
+//! A Publish_Flag that serializes the code that sets it
+/*! call(build) runs build() if the flag is clear, holding a lock so that
+    concurrent callers wait for the first one to finish rather than building
+    again.  build() sets the flag (by assignment) if it succeeds.  Once the flag
+    is set, call() is a single acquire load.
+
+    Unlike std::once_flag, the flag can be cleared again, so that the data can
+    be rebuilt.  Clearing it is not synchronized with call(). */
+class Once_Flag {
+public:
+  constexpr Once_Flag(bool const value = false) noexcept : done_{value} {}
+  //! Copy the value, but not the lock
+  Once_Flag(Once_Flag const &src) noexcept : done_{src.done_} {}
+  Once_Flag &operator=(Once_Flag const &src) noexcept {
+    done_ = src.done_;
+    return *this;
+  }
+  Once_Flag &operator=(bool const value) noexcept {
+    done_.set(value);
+    return *this;
+  }
+
+  bool test() const noexcept { return done_.test(); }
+  operator bool() const noexcept { return test(); }
+
+  //! Run build() if the flag is clear, and return the flag
+  template <typename F> bool call(F &&build) {
+    if (done_.test())
+      return true;
+    std::lock_guard<std::mutex> const lock{mutex_};
+    if (!done_.test())
+      build();
+    return done_.test();
+  }
+
+private:
+  Publish_Flag done_;
+  std::mutex mutex_;
+};
+
+} // namespace FLPR
+
+#endif
@@ -15,6 +15,7 @@
 #include "flpr/Logical_File.hh"
 #include "flpr/File_Line.hh"
 #include "flpr/LL_Stmt_Src.hh"
+#include "flpr/Parallel_For.hh"
 #include "flpr/utils.hh"
 
 #include <cassert>
@@ -24,30 +25,45 @@
 #include <iomanip>
 #include <iostream>
 #include <set>
+#include <sstream>
+#include <unordered_map>
 
 namespace FLPR {
 void Logical_File::clear() {
   file_info.reset();
   lines.clear();
   ll_stmts.clear();
+  original_lines_.clear();
   has_flpr_pp = false;
   num_input_lines = 0;
+  undo_log_.clear();
+  saved_lines_.clear();
+  num_snapshots_ = 0;
 }
 
 bool Logical_File::read_and_scan(std::string const &filename,
                                  int const last_fixed_col,
                                  File_Type file_type) {
+  Line_Buf buf;
+  if (!read_lines(filename, buf))
+    return false;
+  return scan(std::move(buf), filename, last_fixed_col, file_type);
+}
+
+bool Logical_File::read_lines(std::string const &filename,
+                              Line_Buf &line_buffer) {
   std::ifstream is(filename.c_str());
   if (!is) {
-    std::cerr << "Logical_File::read_and_scan: unable to open file \""
+    std::cerr << "Logical_File::read_lines: unable to open file \""
               << filename << "\" for reading\n";
     return false;
   }
-
-  bool res = read_and_scan(is, filename, last_fixed_col, file_type);
-
-  is.close();
-  return res;
+  line_buffer.clear();
+  line_buffer.reserve(1024);
+  for (std::string line; std::getline(is, line);) {
+    line_buffer.push_back(line);
+  }
+  return true;
 }
 
 bool Logical_File::read_and_scan(std::istream &is,
@@ -59,7 +75,17 @@ bool Logical_File::read_and_scan(std::istream &is,
   for (std::string line; std::getline(is, line);) {
     buf.push_back(line);
   }
-  return scan(buf, stream_name, last_fixed_col, stream_type);
+  return scan(std::move(buf), stream_name, last_fixed_col, stream_type);
+}
+
+bool Logical_File::scan(Line_Buf &&buf, std::string const &buffer_name,
+                        int const last_fixed_col, File_Type buffer_type) {
+  if (!keep_original_lines_)
+    return scan(static_cast<Line_Buf const &>(buf), buffer_name,
+                last_fixed_col, buffer_type);
+  /* Keep the text without copying it (see scan_fixed() and scan_free()) */
+  original_lines_ = std::move(buf);
+  return scan(original_lines_, buffer_name, last_fixed_col, buffer_type);
 }
 
 bool Logical_File::scan(Line_Buf const &buf, std::string const &buffer_name,
@@ -84,6 +110,8 @@ bool Logical_File::scan(Line_Buf const &buf, std::string const &buffer_name,
 }
 
 bool Logical_File::scan_fixed(Line_Buf const &raw_lines, int const last_col) {
+  if (keep_original_lines_ && &raw_lines != &original_lines_)
+    original_lines_ = raw_lines;
   const size_t N = raw_lines.size();
   num_input_lines = N;
   // Convert the raw text input into File_Lines
@@ -178,6 +206,8 @@ bool Logical_File::scan_fixed(Line_Buf const &raw_lines, int const last_col) {
 }
 
 bool Logical_File::scan_free(std::vector<std::string> const &raw_lines) {
+  if (keep_original_lines_ && &raw_lines != &original_lines_)
+    original_lines_ = raw_lines;
   const size_t N = raw_lines.size();
   num_input_lines = N;
   bool in_literal_block = false;
@@ -285,6 +315,7 @@ bool Logical_File::scan_free(std::vector<std::string> const &raw_lines) {
 }
 
 void Logical_File::make_stmts() {
+  assert(!has_snapshot());
   ll_stmts.clear();
   LL_Stmt_Src ss{lines, false};
   while (ss.advance()) {
@@ -303,10 +334,12 @@ bool Logical_File::split_compound_before(LL_STMT_SEQ::iterator pos) {
 
   auto ll_seq_orig = prev_stmt->it();
   size_t const num_stmts{ll_seq_orig->stmts().size()};
+  save_line_(pos);
 
   /* create a new LL after the original to hold the pos stmt (and its subsequent
      compounds */
   auto ll_seq_new = lines.insert(std::next(ll_seq_orig), Logical_Line());
+  note_inserted_line_(ll_seq_new);
   bool res = ll_seq_orig->split_after(prev_stmt->last(), *ll_seq_new);
   assert(res);
 
@@ -360,10 +393,12 @@ LL_STMT_SEQ::iterator Logical_File::emplace_ll_stmt(LL_STMT_SEQ::iterator pos,
 
   /* Insert a Logical_Line to hold the new statement at the correct position */
   LL_SEQ::iterator ll_new = lines.emplace(ll_insert_pos, std::move(ll));
+  note_inserted_line_(ll_new);
 
   /* Insert and record the iterator to the new statement */
   LL_Stmt_Src ss{ll_new, true};
   auto result = ll_stmts.emplace(pos, ss.move());
+  note_inserted_stmt_(result);
   result->set_stmt_syntag(new_syntag);
 
   return result;
@@ -380,13 +415,16 @@ Logical_File::emplace_ll_stmt_after_prefix(LL_STMT_SEQ::iterator pos,
 
   /* As this stmt has a prefix, it must be on its own */
   assert(pos->is_compound() < 2);
+  save_line_(pos);
   LL_SEQ::iterator ll_insert_pos = pos->prefix_ll_end();
   /* Insert a Logical_Line to hold the new statement at the correct position */
   LL_SEQ::iterator ll_new = lines.emplace(ll_insert_pos, std::move(ll));
+  note_inserted_line_(ll_new);
 
   /* Insert and record the iterator to the first new statement */
   LL_Stmt_Src ss{ll_new, true};
   auto result = ll_stmts.emplace(pos, ss.move());
+  note_inserted_stmt_(result);
   result->set_stmt_syntag(new_syntag);
 
   /* Now transfer the prefix from the old to the new */
@@ -401,6 +439,7 @@ void Logical_File::replace_stmt_text(LL_STMT_SEQ::iterator stmt,
                                      int new_syntag) {
   /* put the stmt on its own line */
   isolate_stmt(stmt);
+  save_line_(stmt);
 
   stmt->ll().replace_main_text(new_text);
   assert(stmt->ll().has_stmts());
@@ -422,6 +461,7 @@ void Logical_File::replace_stmt_substr(LL_STMT_SEQ::iterator stmt,
   auto const end_off = std::distance(stmt->begin(), orig_tt.end());
 
   isolate_stmt(stmt);
+  save_line_(stmt);
 
   /* find the updated TT_Range using the offsets */
   auto new_beg_it = std::next(stmt->ll().fragments().begin(), beg_off);
@@ -440,6 +480,7 @@ void Logical_File::insert_text_after(LL_STMT_SEQ::iterator stmt,
                                      std::string const &new_text) {
   auto const frag_off = std::distance(stmt->begin(), frag);
   isolate_stmt(stmt);
+  save_line_(stmt);
   auto new_frag_it = std::next(stmt->ll().fragments().begin(), frag_off);
   stmt->ll().insert_text_after(new_frag_it, new_text);
   stmt->assign_range(stmt->ll().stmts()[0]);
@@ -451,6 +492,7 @@ void Logical_File::append_stmt_text(LL_STMT_SEQ::iterator stmt,
                                     std::string const &new_text) {
   /* put the stmt on its own line */
   isolate_stmt(stmt);
+  save_line_(stmt);
 
   stmt->ll().insert_text_before(stmt->end(), new_text);
   assert(stmt->ll().has_stmts());
@@ -467,18 +509,196 @@ bool Logical_File::set_stmt_label(LL_STMT_SEQ::iterator stmt, int label) {
       return false;
     split_compound_before(stmt); // can't label something in a compound
   }
+  save_line_(stmt);
   bool retval = stmt->ll().set_label(label);
   stmt->cache_new_label_value(stmt->ll().label);
+  /* A label can change the program structure (e.g. a label-do-stmt's end) */
+  stmt->unhook();
   return retval;
 }
 
+void Logical_File::Edit_Batch::replace_stmt_text(
+    LL_STMT_SEQ::iterator stmt, std::vector<std::string> const &new_text,
+    int new_syntag) {
+  edits_.push_back(Edit_{Kind::REPLACE_TEXT, stmt, 0, 0, new_text, new_syntag});
+}
+
+void Logical_File::Edit_Batch::replace_stmt_substr(
+    LL_STMT_SEQ::iterator stmt, LL_TT_Range const &orig_tt_const,
+    std::string const &new_text) {
+  LL_TT_Range &orig_tt{const_cast<LL_TT_Range &>(orig_tt_const)};
+  assert(!orig_tt.empty());
+  edits_.push_back(Edit_{Kind::REPLACE_SUBSTR, stmt,
+                         std::distance(stmt->begin(), orig_tt.begin()),
+                         std::distance(stmt->begin(), orig_tt.end()),
+                         {new_text},
+                         0});
+}
+
+void Logical_File::Edit_Batch::insert_text_after(LL_STMT_SEQ::iterator stmt,
+                                                 TT_SEQ::iterator frag,
+                                                 std::string const &new_text) {
+  auto const frag_off = std::distance(stmt->begin(), frag);
+  edits_.push_back(
+      Edit_{Kind::INSERT_AFTER, stmt, frag_off, frag_off, {new_text}, 0});
+}
+
+void Logical_File::Edit_Batch::append_stmt_text(LL_STMT_SEQ::iterator stmt,
+                                                std::string const &new_text) {
+  edits_.push_back(Edit_{Kind::APPEND, stmt, 0, 0, {new_text}, 0});
+}
+
+void Logical_File::Edit_Batch::set_stmt_label(LL_STMT_SEQ::iterator stmt,
+                                              int label) {
+  assert(!(label < 0));
+  edits_.push_back(Edit_{Kind::LABEL, stmt, 0, 0, {}, label});
+}
+
+bool Logical_File::set_leading_spaces(LL_STMT_SEQ::iterator stmt,
+                                      int const spaces,
+                                      int const continued_offset) {
+  if (stmt->is_compound() >= 2)
+    return false;
+  bool changed{false};
+  auto const indent = [this, spaces, continued_offset](LL_SEQ::iterator line) {
+    auto const log_size = undo_log_.size();
+    save_layout_(line);
+    if (line->set_leading_spaces(spaces, continued_offset))
+      return true;
+    /* Don't keep the saved layout of a line that was already indented */
+    undo_log_.erase(undo_log_.begin() + log_size, undo_log_.end());
+    return false;
+  };
+  for (LL_SEQ::iterator ll_it : stmt->prefix_lines)
+    changed |= indent(ll_it);
+  changed |= indent(stmt->it());
+  return changed;
+}
+
+bool Logical_File::apply(Edit_Batch &batch) {
+  using Kind = Edit_Batch::Kind;
+  /* Group the edits by statement, in order of first appearance */
+  std::vector<std::vector<Edit_Batch::Edit_ const *>> groups;
+  std::unordered_map<LL_Stmt const *, std::size_t> group_idx;
+  for (auto const &e : batch.edits_) {
+    auto const [pos, inserted] = group_idx.emplace(&*e.stmt, groups.size());
+    if (inserted)
+      groups.emplace_back();
+    groups[pos->second].push_back(&e);
+  }
+
+  /* Check the whole batch before changing anything */
+  for (auto const &g : groups) {
+    int num_replace{0}, num_text{0};
+    for (auto const e : g) {
+      if (e->kind == Kind::REPLACE_TEXT)
+        num_replace += 1;
+      if (e->kind != Kind::LABEL)
+        num_text += 1;
+    }
+    if (num_replace > 0 && num_text > 1) {
+      std::cerr << "Logical_File::apply: replace_stmt_text can't be combined "
+                   "with other text edits of the same statement:\n";
+      g.front()->stmt->print_me(std::cerr, false) << std::endl;
+      return false;
+    }
+  }
+
+  for (auto const &g : groups)
+    apply_stmt_edits_(g);
+  batch.clear();
+  return true;
+}
+
+void Logical_File::apply_stmt_edits_(
+    std::vector<Edit_Batch::Edit_ const *> const &edits) {
+  using Kind = Edit_Batch::Kind;
+  LL_STMT_SEQ::iterator const stmt = edits.front()->stmt;
+
+  Edit_Batch::Edit_ const *replace{nullptr};
+  bool has_text_edits{false};
+  for (auto const e : edits) {
+    if (e->kind == Kind::REPLACE_TEXT)
+      replace = e;
+    else if (e->kind != Kind::LABEL)
+      has_text_edits = true;
+  }
+  assert(!(replace && has_text_edits)); // checked by apply()
+
+  if (replace) {
+    replace_stmt_text(stmt, replace->text, replace->value);
+  } else if (has_text_edits) {
+    isolate_stmt(stmt);
+    save_line_(stmt);
+    Logical_Line &ll = stmt->ll();
+    auto const frag = [&ll](long const off) {
+      return std::next(ll.fragments().begin(), off);
+    };
+
+    /* Convert the token offsets into layout coordinates */
+    std::vector<Logical_Line::Text_Edit> text_edits;
+    std::string appended;
+    for (auto const e : edits) {
+      switch (e->kind) {
+      case Kind::REPLACE_SUBSTR: {
+        auto const first = frag(e->begin_off);
+        auto const last = frag(e->end_off - 1);
+        text_edits.push_back({first->mt_begin_line_, first->mt_begin_col_,
+                              last->mt_end_line_, last->mt_end_col_,
+                              e->text.front()});
+      } break;
+      case Kind::INSERT_AFTER: {
+        auto const f = frag(e->begin_off);
+        text_edits.push_back({f->mt_end_line_, f->mt_end_col_, f->mt_end_line_,
+                              f->mt_end_col_, e->text.front()});
+      } break;
+      case Kind::APPEND:
+        appended += e->text.front();
+        break;
+      default:
+        break;
+      }
+    }
+    if (!appended.empty()) {
+      /* As in Logical_Line::insert_text_before(stmt->end()).  This goes first
+         so that it stays behind anything inserted at the same position. */
+      auto const end = stmt->end();
+      int line, col;
+      if (end == ll.fragments().end()) {
+        line = ll.fragments().back().mt_end_line_;
+        col = ll.fragments().back().mt_end_col_;
+      } else {
+        line = end->mt_begin_line_;
+        col = end->mt_begin_col_;
+      }
+      text_edits.insert(
+          text_edits.begin(),
+          Logical_Line::Text_Edit{line, col, line, col, std::move(appended)});
+    }
+
+    ll.apply_text_edits(text_edits);
+    assert(ll.has_stmts());
+    assert(ll.stmts().size() == 1);
+    stmt->assign_range(ll.stmts()[0]);
+    stmt->drop_stmt_tree();
+    stmt->unhook();
+  }
+
+  for (auto const e : edits)
+    if (e->kind == Kind::LABEL)
+      set_stmt_label(stmt, e->value);
+}
+
 bool Logical_File::convert_fixed_to_free() {
   bool changed{false};
-  for (Logical_Line &ll : lines) {
+  for (auto ll_it = lines.begin(); ll_it != lines.end(); ++ll_it) {
+    Logical_Line &ll{*ll_it};
     if (ll.layout().empty())
       continue;
     if (!ll.layout().front().is_fixed_format())
       continue;
+    save_layout_(ll_it);
+    ll.dirty = true;
 
     using FL_VEC = typename Logical_Line::FL_VEC;
 
@@ -579,11 +799,265 @@ bool Logical_File::convert_fixed_to_free() {
     changed = true;
   } // foreach ll
   if (changed) {
-    if (file_info)
+    if (file_info) {
+      if (has_snapshot()) {
+        undo_log_.emplace_back(Undo_::Kind::FILE_TYPE);
+        undo_log_.back().file_type = file_info->file_type;
+      }
       file_info->file_type = File_Type::FREEFMT;
+    }
   }
 
   return changed;
 }
 
+bool Logical_File::has_dirty_lines() const noexcept {
+  for (auto const &ll : lines)
+    if (ll.dirty)
+      return true;
+  return false;
+}
+
+std::vector<Logical_File::Line_Change>
+Logical_File::changed_line_ranges() const {
+  return find_changes_(nullptr);
+}
+
+std::vector<Logical_File::Line_Change>
+Logical_File::find_changes_(std::vector<std::string> *new_text) const {
+  std::vector<Line_Change> changes;
+  int old_next{1}, new_next{1};
+  /* The first output line of the current run of dirty lines, or -1 */
+  int run_begin{-1};
+  auto const close_run = [&](int const old_end) {
+    int const new_begin = (run_begin < 0) ? new_next : run_begin;
+    if (old_end > old_next || new_next > new_begin)
+      changes.push_back(Line_Change{old_next, old_end, new_begin, new_next});
+    run_begin = -1;
+  };
+
+  for (auto const &ll : lines) {
+    /* A clean line is an anchor in the original text, unless it has been
+       moved out of order */
+    if (!ll.dirty && !ll.layout().empty() && ll.start_line() >= old_next) {
+      close_run(ll.start_line());
+      old_next = ll.end_line();
+      new_next += ll.suppress ? 0 : static_cast<int>(ll.layout().size());
+      continue;
+    }
+    if (run_begin < 0)
+      run_begin = new_next;
+    if (ll.suppress)
+      continue;
+    for (auto const &fl : ll.layout()) {
+      if (new_text) {
+        std::ostringstream os;
+        os << fl;
+        new_text->push_back(os.str());
+      }
+      new_next += 1;
+    }
+  }
+  close_run(static_cast<int>(num_input_lines) + 1);
+  return changes;
+}
+
+std::string Logical_File::render(unsigned const num_threads) const {
+  std::vector<Logical_Line const *> ll_ptrs;
+  std::vector<std::size_t> offsets{0};
+  for (auto const &ll : lines) {
+    ll_ptrs.push_back(&ll);
+    offsets.push_back(offsets.back() + ll.print_size());
+  }
+  std::string buf(offsets.back(), '\0');
+  char *const dst = &buf[0];
+  parallel_for(
+      ll_ptrs.size(), num_threads,
+      [&](std::size_t const i) {
+        char *const end = ll_ptrs[i]->render(dst + offsets[i]);
+        assert(end == dst + offsets[i + 1]);
+        (void)end;
+      },
+      256);
+  return buf;
+}
+
+bool Logical_File::write(std::ostream &os, unsigned const num_threads) const {
+  std::string const buf{render(num_threads)};
+  os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+  return static_cast<bool>(os);
+}
+
+bool Logical_File::write_diff(std::ostream &os, int const context) const {
+  std::vector<std::string> new_text;
+  std::vector<Line_Change> const changes{find_changes_(&new_text)};
+  if (changes.empty())
+    return false;
+  if (original_lines_.size() != num_input_lines) {
+    std::cerr << "Logical_File::write_diff: the original lines were not kept "
+                 "(see set_keep_original_lines())\n";
+    return false;
+  }
+
+  std::string const name{file_info ? file_info->filename : "-"};
+  os << "--- " << name << '\n' << "+++ " << name << '\n';
+
+  /* Hunk ranges in unified diff format: a zero-length range is labeled with
+     the line before it */
+  auto const range = [](int const begin, int const end) {
+    int const len = end - begin;
+    std::ostringstream r;
+    r << ((len == 0) ? begin - 1 : begin);
+    if (len != 1)
+      r << ',' << len;
+    return r.str();
+  };
+  int const num_old = static_cast<int>(num_input_lines);
+  std::size_t text_idx{0};
+  std::size_t first = 0;
+  while (first < changes.size()) {
+    /* Merge changes whose context overlaps into one hunk */
+    std::size_t last = first + 1;
+    while (last < changes.size() &&
+           changes[last].old_begin - changes[last - 1].old_end <= 2 * context)
+      last += 1;
+    int const old_begin = std::max(1, changes[first].old_begin - context);
+    int const old_end =
+        std::min(num_old + 1, changes[last - 1].old_end + context);
+    int const lead = changes[first].old_begin - old_begin;
+    int const trail = old_end - changes[last - 1].old_end;
+    int const new_begin = changes[first].new_begin - lead;
+    int const new_end = changes[last - 1].new_end + trail;
+    os << "@@ -" << range(old_begin, old_end) << " +"
+       << range(new_begin, new_end) << " @@\n";
+
+    int old_line = old_begin;
+    for (std::size_t i = first; i < last; ++i) {
+      Line_Change const &c = changes[i];
+      for (; old_line < c.old_begin; ++old_line)
+        os << ' ' << original_lines_[old_line - 1] << '\n';
+      for (; old_line < c.old_end; ++old_line)
+        os << '-' << original_lines_[old_line - 1] << '\n';
+      for (int n = c.new_begin; n < c.new_end; ++n)
+        os << '+' << new_text[text_idx++] << '\n';
+    }
+    for (; old_line < old_end; ++old_line)
+      os << ' ' << original_lines_[old_line - 1] << '\n';
+    first = last;
+  }
+  return true;
+}
+
+Logical_File::Snapshot Logical_File::snapshot() {
+  num_snapshots_ += 1;
+  /* Lines saved for an earlier snapshot must be saved again, as they may
+     change between the two */
+  saved_lines_.clear();
+  return undo_log_.size();
+}
+
+void Logical_File::rollback(Snapshot const s) {
+  assert(has_snapshot());
+  assert(s <= undo_log_.size());
+  while (undo_log_.size() > s) {
+    undo_(undo_log_.back());
+    undo_log_.pop_back();
+  }
+  saved_lines_.clear();
+  release(s);
+}
+
+void Logical_File::release(Snapshot const s) {
+  assert(has_snapshot());
+  assert(s <= undo_log_.size());
+  (void)s;
+  num_snapshots_ -= 1;
+  if (num_snapshots_ == 0) {
+    undo_log_.clear();
+    saved_lines_.clear();
+  }
+}
+
+void Logical_File::save_line_(LL_STMT_SEQ::iterator stmt) {
+  if (!has_snapshot())
+    return;
+  LL_SEQ::iterator const line = stmt->it();
+  if (!saved_lines_.insert(&*line).second)
+    return;
+
+  undo_log_.emplace_back(Undo_::Kind::LINE, line);
+  Undo_ &u = undo_log_.back();
+  u.saved_line = *line;
+
+  /* The statements of a Logical_Line are adjacent in ll_stmts */
+  auto const on_line = [line](LL_Stmt const &s) {
+    return s.has_it() && s.it() == line;
+  };
+  while (stmt != ll_stmts.begin() && on_line(*std::prev(stmt)))
+    --stmt;
+  auto const frags_begin = line->fragments().begin();
+  for (; stmt != ll_stmts.end() && on_line(*stmt); ++stmt) {
+    u.saved_stmts.push_back(Undo_::Stmt_State{
+        stmt, std::distance(frags_begin, stmt->begin()),
+        std::distance(frags_begin, stmt->end()), stmt->label(),
+        stmt->is_compound(), stmt->syntax_tag(), stmt->get_hook(),
+        stmt->prefix_lines});
+  }
+}
+
+void Logical_File::save_layout_(LL_SEQ::iterator line) {
+  if (!has_snapshot())
+    return;
+  undo_log_.emplace_back(Undo_::Kind::LAYOUT, line);
+  undo_log_.back().layout = line->layout();
+  undo_log_.back().dirty = line->dirty;
+}
+
+void Logical_File::note_inserted_line_(LL_SEQ::iterator line) {
+  if (!has_snapshot())
+    return;
+  undo_log_.emplace_back(Undo_::Kind::INSERTED_LINE, line);
+  /* There is no need to save the prior state of a new line */
+  saved_lines_.insert(&*line);
+}
+
+void Logical_File::note_inserted_stmt_(LL_STMT_SEQ::iterator stmt) {
+  if (!has_snapshot())
+    return;
+  undo_log_.emplace_back(Undo_::Kind::INSERTED_STMT);
+  undo_log_.back().stmt = stmt;
+}
+
+void Logical_File::undo_(Undo_ &u) {
+  switch (u.kind) {
+  case Undo_::Kind::LINE: {
+    *u.line = std::move(u.saved_line);
+    auto const frags_begin = u.line->fragments().begin();
+    for (auto &ss : u.saved_stmts) {
+      ss.stmt->update_range(LL_Stmt{
+          u.line,
+          TT_Range{std::next(frags_begin, ss.begin_off),
+                   std::next(frags_begin, ss.end_off)},
+          ss.label, ss.compound});
+      ss.stmt->set_stmt_syntag(ss.syntag);
+      ss.stmt->set_hook(ss.hook);
+      ss.stmt->prefix_lines = std::move(ss.prefix_lines);
+    }
+  } break;
+  case Undo_::Kind::INSERTED_LINE:
+    lines.erase(u.line);
+    break;
+  case Undo_::Kind::INSERTED_STMT:
+    ll_stmts.erase(u.stmt);
+    break;
+  case Undo_::Kind::LAYOUT:
+    u.line->layout() = std::move(u.layout);
+    u.line->dirty = u.dirty;
+    break;
+  case Undo_::Kind::FILE_TYPE:
+    file_info->file_type = u.file_type;
+    break;
+  }
+}
+
 } // namespace FLPR
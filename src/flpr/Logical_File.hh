@@ -19,23 +19,30 @@
 #include "flpr/LL_Stmt.hh"
 #include "flpr/Logical_Line.hh"
 #include "flpr/Safe_List.hh"
+#include <cstddef>
 #include <istream>
 #include <memory>
+#include <ostream>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace FLPR {
+class File_Image;
+
 /*! \brief A sequence of Logical_Lines and LL_Stmts that make up a file, plus
   other identifying information. */
 class Logical_File {
 public:
+  friend class File_Image;
+
   //! Container for raw text lines of a file
   using Line_Buf = std::vector<std::string>;
   //! Type for the container of lines
   using const_iterator = typename LL_SEQ::const_iterator;
   using iterator = typename LL_SEQ::iterator;
 
-  constexpr Logical_File() : has_flpr_pp{false}, num_input_lines{0} {}
+  Logical_File() : has_flpr_pp{false}, num_input_lines{0} {}
   Logical_File(Logical_File &&) = default;
   Logical_File(Logical_File const &) = delete;
   Logical_File &operator=(Logical_File const &) = delete;
@@ -55,6 +62,15 @@ public:
   bool scan(Line_Buf const &line_buffer, std::string const &buffer_name,
             int const last_fixed_col, File_Type file_type = File_Type::UNKNOWN);
 
+  //! Scan a list of raw lines, moving them into original_lines() if kept
+  bool scan(Line_Buf &&line_buffer, std::string const &buffer_name,
+            int const last_fixed_col, File_Type file_type = File_Type::UNKNOWN);
+
+  //! Read the raw lines of the named file, without scanning them
+  /*! This is the I/O part of read_and_scan(), for clients that read and scan
+      on different threads. */
+  static bool read_lines(std::string const &filename, Line_Buf &line_buffer);
+
   //! Scan the file assuming F77-style fixed format
   bool scan_fixed(Line_Buf const &fl, int const last_col);
 
@@ -113,9 +129,151 @@ public:
   //! Label a statement (label == 0 will unlabel it)
   bool set_stmt_label(LL_STMT_SEQ::iterator stmt, int label);
 
+  //! Indent a statement and its prefix lines (see LL_Stmt::set_leading_spaces)
+  bool set_leading_spaces(LL_STMT_SEQ::iterator stmt, int spaces,
+                          int continued_offset);
+
+  //! A collection of statement edits to be applied together
+  /*! The member functions mirror the Logical_File edits of the same names,
+      but only record the change.  All token iterators refer to the text of the
+      statements as it is when the edit is recorded, i.e. before any of the
+      batch is applied.  Logical_File::apply() then applies the edits one
+      statement at a time: the statement is isolated once, all of its text
+      edits are made to the layout from back to front, and its Logical_Line is
+      re-tokenized once.  The result is the same as making the edits one by
+      one, but the cost is per statement rather than per edit.
+
+      Text edits to one statement must not overlap, and replace_stmt_text()
+      can't be combined with any other text edit of the same statement (which
+      apply() reports). */
+  class Edit_Batch {
+  public:
+    void replace_stmt_text(LL_STMT_SEQ::iterator stmt,
+                           std::vector<std::string> const &new_text,
+                           int new_syntag);
+    void replace_stmt_substr(LL_STMT_SEQ::iterator stmt,
+                             LL_TT_Range const &orig_tt,
+                             std::string const &new_text);
+    void insert_text_after(LL_STMT_SEQ::iterator stmt, TT_SEQ::iterator frag,
+                           std::string const &new_text);
+    void append_stmt_text(LL_STMT_SEQ::iterator stmt,
+                          std::string const &new_text);
+    void set_stmt_label(LL_STMT_SEQ::iterator stmt, int label);
+
+    bool empty() const noexcept { return edits_.empty(); }
+    std::size_t size() const noexcept { return edits_.size(); }
+    void clear() noexcept { edits_.clear(); }
+
+  private:
+    friend class Logical_File;
+    enum class Kind {
+      REPLACE_TEXT,
+      REPLACE_SUBSTR,
+      INSERT_AFTER,
+      APPEND,
+      LABEL
+    };
+    struct Edit_ {
+      Kind kind;
+      LL_STMT_SEQ::iterator stmt;
+      long begin_off, end_off; //!< token offsets from stmt->begin()
+      std::vector<std::string> text;
+      int value; //!< new syntag or label
+    };
+    std::vector<Edit_> edits_;
+  };
+
+  //! Apply (and clear) a batch of statement edits
+  /*! If a statement has a replace_stmt_text() along with another text edit,
+      an error is reported, nothing is applied, the batch is left as it is,
+      and false is returned. */
+  bool apply(Edit_Batch &batch);
+
   //! Convert fixed format to free
   bool convert_fixed_to_free();
 
+  //! The text of the file as it was scanned
+  /*! This is empty unless set_keep_original_lines(true) was called before
+      the file was scanned. */
+  Line_Buf const &original_lines() const noexcept { return original_lines_; }
+
+  //! Select whether scanning keeps a copy of the text, for write_diff()
+  /*! The copy is off by default, as it doubles the text held for each file.
+      changed_line_ranges() works without it.  Call this before scanning. */
+  void set_keep_original_lines(bool const keep) noexcept {
+    keep_original_lines_ = keep;
+  }
+  bool keep_original_lines() const noexcept { return keep_original_lines_; }
+
+  //! Return true if any Logical_Line is dirty (see Logical_Line::dirty)
+  bool has_dirty_lines() const noexcept;
+
+  //! A region of the output that differs from the scanned text
+  /*! Line numbers have index origin 1, and the ranges are half-open, so a
+      pure insertion has old_begin == old_end, and a pure deletion has
+      new_begin == new_end. */
+  struct Line_Change {
+    int old_begin, old_end; //!< lines of original_lines()
+    int new_begin, new_end; //!< lines of the current output
+  };
+
+  //! Find the regions of the output that have changed
+  /*! Each run of dirty Logical_Lines (and any scanned lines that have been
+      removed) forms one Line_Change.  The clean Logical_Lines are known to
+      print as they were read, so this only renders the dirty ones.  The
+      result is empty if the file would be written unchanged. */
+  std::vector<Line_Change> changed_line_ranges() const;
+
+  //! Write a unified diff of the changes to the scanned text
+  /*! The diff has context lines of context around each change, and is
+      labeled with the file name (for patch -p0).  Nothing is written if there
+      are no changes.  Returns true if there were changes.  The
+      original_lines() must have been kept (see set_keep_original_lines()).
+   */
+  bool write_diff(std::ostream &os, int const context = 3) const;
+
+  //! Return the text of the file, exactly as printing each line would
+  /*! The buffer is sized up front from Logical_Line::print_size(), and the
+      lines are copied into place.  With num_threads > 1, blocks of lines are
+      rendered concurrently. */
+  std::string render(unsigned const num_threads = 1) const;
+
+  //! Write the text of the file to os, with a single write
+  /*! The output is the same as writing each Logical_Line with operator<<.
+      Returns false if the stream fails. */
+  bool write(std::ostream &os, unsigned const num_threads = 1) const;
+
+  //! A point in the edit history, for rollback()
+  using Snapshot = std::size_t;
+
+  //! Start recording the edits, so that they can be rolled back
+  /*! Taking a snapshot is O(1): nothing is copied until an edit is made.
+      From then on, the first time that one of the Logical_File edits above
+      (including apply() and convert_fixed_to_free()) changes a Logical_Line,
+      the prior state of the line and of its LL_Stmts is saved, and any
+      inserted Logical_Lines and LL_Stmts are noted.  Each snapshot must be
+      ended by either rollback() or release(), in the reverse order that they
+      were taken.
+
+      Only changes made through the Logical_File are recorded: the lines and
+      ll_stmts must not be modified directly while a snapshot is open, and the
+      statements must already have been made (see make_stmts()). */
+  Snapshot snapshot();
+
+  //! Undo the edits made since s was taken, and end s
+  /*! This is O(edits), not O(file).  The Logical_Lines and LL_Stmts that were
+      edited are restored in place (so Safe_List iterators to them remain
+      good), with their syntags and hooks, and the inserted ones are erased.
+      The Stmt_Trees of restored statements are dropped, to be rebuilt on
+      demand. */
+  void rollback(Snapshot s);
+
+  //! Keep the edits made since s was taken, and end s
+  void release(Snapshot s);
+
+  //! True if there is a snapshot that hasn't been ended
+  bool has_snapshot() const noexcept { return num_snapshots_ > 0; }
+
 public:
   //! Basic information about the input file
   std::shared_ptr<File_Info> file_info;
@@ -131,6 +289,53 @@ public:
 private:
   //! Clear the contents of this structure
   void clear();
+  //! Apply the edits of one statement from an Edit_Batch
+  void apply_stmt_edits_(std::vector<Edit_Batch::Edit_ const *> const &edits);
+  //! Find the changes, appending the new text of each to new_text if given
+  std::vector<Line_Change>
+  find_changes_(std::vector<std::string> *new_text) const;
+
+  //! The text of the file as it was scanned, if keep_original_lines_
+  Line_Buf original_lines_;
+  bool keep_original_lines_{false};
+
+  //! A change recorded for rollback()
+  struct Undo_ {
+    enum class Kind { LINE, INSERTED_LINE, INSERTED_STMT, LAYOUT, FILE_TYPE };
+    //! The state of an LL_Stmt on a saved Logical_Line
+    struct Stmt_State {
+      LL_STMT_SEQ::iterator stmt;
+      long begin_off, end_off; //!< token offsets into the line's fragments
+      int label, compound, syntag;
+      void *hook;
+      LL_Stmt::LL_IT_SEQ prefix_lines;
+    };
+    explicit Undo_(Kind k, LL_SEQ::iterator l = LL_SEQ::iterator{})
+        : kind{k}, line{l} {}
+    Kind kind;
+    LL_SEQ::iterator line;
+    LL_STMT_SEQ::iterator stmt;
+    Logical_Line saved_line;                 //!< LINE
+    std::vector<Stmt_State> saved_stmts;     //!< LINE
+    Logical_Line::FL_VEC layout;             //!< LAYOUT
+    bool dirty{false};                       //!< LAYOUT
+    File_Type file_type{File_Type::UNKNOWN}; //!< FILE_TYPE
+  };
+
+  //! Save the Logical_Line of stmt (and its LL_Stmts) before changing it
+  void save_line_(LL_STMT_SEQ::iterator stmt);
+  //! Save the layout of line before changing only the layout
+  void save_layout_(LL_SEQ::iterator line);
+  //! Note a Logical_Line inserted by an edit
+  void note_inserted_line_(LL_SEQ::iterator line);
+  //! Note an LL_Stmt inserted by an edit
+  void note_inserted_stmt_(LL_STMT_SEQ::iterator stmt);
+  void undo_(Undo_ &u);
+
+  std::vector<Undo_> undo_log_;
+  //! The lines saved (or inserted) since the last snapshot() or rollback()
+  std::unordered_set<Logical_Line const *> saved_lines_;
+  int num_snapshots_{0};
 };
 
 } // namespace FLPR
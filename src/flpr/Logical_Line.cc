@@ -14,7 +14,9 @@
 
 #include <iomanip>
 #include <iostream>
+#include <new>
 #include <stdexcept>
+#include <tuple>
 
 #include "flpr/Logical_Line.hh"
 #include "flpr/Syntax_Tags.hh"
@@ -23,8 +25,29 @@
 #include "Smash_Hash.hh"
 #include "scan_fort.hh"
 
-// Defined in scan_toks.l
-extern int curr_line_pos;
+namespace {
+/* The flex scanner (see scan_fort.l) is reentrant, and each thread keeps one
+   for all of the lines that it tokenizes */
+class Thread_Scanner {
+public:
+  Thread_Scanner() {
+    if (yylex_init(&scanner_))
+      throw std::bad_alloc{};
+  }
+  ~Thread_Scanner() { yylex_destroy(scanner_); }
+  Thread_Scanner(Thread_Scanner const &) = delete;
+  Thread_Scanner &operator=(Thread_Scanner const &) = delete;
+  yyscan_t get() const noexcept { return scanner_; }
+
+private:
+  yyscan_t scanner_;
+};
+
+yyscan_t thread_scanner() {
+  static thread_local Thread_Scanner scanner;
+  return scanner.get();
+}
+} // namespace
 
 namespace FLPR {
 /* ------------------------------------------------------------------------ */
@@ -34,8 +57,8 @@ Logical_Line::Logical_Line() noexcept { clear(); }
 Logical_Line::Logical_Line(Logical_Line const &src) noexcept
     : file_info{src.file_info}, label{src.label}, cat{src.cat},
       suppress{src.suppress}, needs_reformat{src.needs_reformat},
-      num_semicolons_{src.num_semicolons_}, layout_{src.layout_},
-      fragments_{src.fragments_}, stmts_{src.stmts_} {
+      dirty{src.dirty}, num_semicolons_{src.num_semicolons_},
+      layout_{src.layout_}, fragments_{src.fragments_}, stmts_{src.stmts_} {
   // Now we need to update the iterators in stmts_ to point to new fragments
   TT_SEQ::iterator dstb{fragments_.begin()};
   TT_SEQ::const_iterator srcb{src.fragments_.cbegin()};
@@ -53,6 +76,7 @@ Logical_Line &Logical_Line::operator=(Logical_Line const &src) noexcept {
   cat = src.cat;
   suppress = src.suppress;
   needs_reformat = src.needs_reformat;
+  dirty = src.dirty;
   num_semicolons_ = src.num_semicolons_;
 
   // Now we need to update the iterators in stmts to point to new fragments
@@ -68,6 +92,7 @@ Logical_Line::Logical_Line(std::string const &raw_text) {
   clear();
   layout_.emplace_back(File_Line::analyze_free(raw_text));
   init_from_layout();
+  dirty = true;
 }
 
 /* ------------------------------------------------------------------------ */
@@ -85,6 +110,7 @@ Logical_Line::Logical_Line(std::vector<std::string> const &raw_text) {
     prev_line_cont = layout_.back().is_continued();
   }
   init_from_layout();
+  dirty = true;
 }
 
 /* ------------------------------------------------------------------------ */
@@ -92,6 +118,7 @@ Logical_Line::Logical_Line(std::string const &raw_text, int const last_col) {
   clear();
   layout_.emplace_back(File_Line::analyze_fixed(raw_text, last_col));
   init_from_layout();
+  dirty = true;
 }
 
 /* ------------------------------------------------------------------------ */
@@ -106,6 +133,7 @@ Logical_Line::Logical_Line(std::vector<std::string> const &raw_text,
     prev_open_delim = layout_.back().open_delim;
   }
   init_from_layout();
+  dirty = true;
 }
 
 /* ------------------------------------------------------------------------ */
@@ -116,6 +144,7 @@ void Logical_Line::clear() noexcept {
   label = 0;
   cat = LineCat::UNKNOWN;
   needs_reformat = false;
+  dirty = false;
   clear_stmts();
 }
 
@@ -217,6 +246,7 @@ void Logical_Line::text_from_frags() noexcept {
   auto fline_it = layout_.begin();
   if (!fline_it->is_fortran())
     return;
+  dirty = true;
   fline_it->main_txt.clear();
   fline_it->make_uncontinued();
 
@@ -312,6 +342,7 @@ void Logical_Line::replace_fragment(typename TT_SEQ::iterator frag,
 
   auto const old_text_len = frag->text().size();
   int len_change = (int)new_text.size() - (int)old_text_len;
+  dirty = true;
 
   frag->token = new_syntag;
   frag->mod_text() = new_text;
@@ -335,6 +366,7 @@ void Logical_Line::replace_fragment(typename TT_SEQ::iterator frag,
 void Logical_Line::remove_fragment(typename TT_SEQ::iterator frag) {
 
   auto const old_text_len = frag->text().size();
+  dirty = true;
 
   /* this isn't setup to do tokens that are split across continuations */
   assert(!frag->is_split_token_());
@@ -362,6 +394,7 @@ void Logical_Line::replace_main_text(std::vector<std::string> const &new_text) {
     return;
   assert(!layout_.empty());
   assert(!is_compound());
+  dirty = true;
 
   size_t const old_size = layout_.size();
 
@@ -461,6 +494,28 @@ void Logical_Line::replace_stmt_substr(TT_Range const &orig,
   erase_stmt_text_(sl, sc, el, ec);
   layout_[sl].main_txt.insert(sc, new_text);
   init_from_layout();
+  dirty = true;
+}
+
+/* ------------------------------------------------------------------------ */
+void Logical_Line::apply_text_edits(std::vector<Text_Edit> &edits) {
+  if (edits.empty())
+    return;
+  std::stable_sort(edits.begin(), edits.end(),
+                   [](Text_Edit const &a, Text_Edit const &b) {
+                     return std::tie(a.begin_line, a.begin_col) >
+                            std::tie(b.begin_line, b.begin_col);
+                   });
+  for (Text_Edit const &e : edits) {
+    if (e.begin_line != e.end_line || e.begin_col != e.end_col)
+      erase_stmt_text_(e.begin_line, e.begin_col, e.end_line, e.end_col);
+    assert(e.begin_line < static_cast<int>(layout_.size()));
+    assert(e.begin_col <=
+           static_cast<int>(layout_[e.begin_line].main_txt.size()));
+    layout_[e.begin_line].main_txt.insert(e.begin_col, e.text);
+  }
+  init_from_layout();
+  dirty = true;
 }
 
 /* ------------------------------------------------------------------------ */
@@ -479,6 +534,7 @@ void Logical_Line::insert_text_before(typename TT_SEQ::iterator frag,
   assert(sc <= static_cast<int>(layout_[sl].main_txt.size()));
   layout_[sl].main_txt.insert(sc, new_text);
   init_from_layout();
+  dirty = true;
 }
 
 /* ------------------------------------------------------------------------ */
@@ -493,6 +549,7 @@ void Logical_Line::insert_text_after(typename TT_SEQ::iterator frag,
   assert(ec <= static_cast<int>(layout_[el].main_txt.size()));
   layout_[el].main_txt.insert(ec, new_text);
   init_from_layout();
+  dirty = true;
 }
 
 /* ------------------------------------------------------------------------ */
@@ -502,6 +559,7 @@ bool Logical_Line::split_after(typename TT_SEQ::iterator frag,
     return false;
   int const split_line = frag->mt_end_line_;
   assert(split_line < static_cast<int>(fragments_.size()));
+  dirty = true;
 
   auto const num_left_sp = layout_[0].main_first_col() - 1;
 
@@ -632,6 +690,7 @@ bool Logical_Line::split_after(typename TT_SEQ::iterator frag,
   /* The fragments starting after frag need to be cleaned up for this line */
   fragments_.erase(std::next(frag), fragments_.end());
 
+  new_ll.dirty = true;
   return true;
 }
 
@@ -733,6 +792,7 @@ bool Logical_Line::set_leading_spaces(int const spaces, int continued_offset) {
   for (size_t i = 1; i < N; ++i) {
     changed |= layout_[i].set_leading_spaces(spaces + continued_offset);
   }
+  dirty |= changed;
   return changed;
 }
 
@@ -742,6 +802,7 @@ bool Logical_Line::set_label(int new_label) {
     return false;
   layout_[0].set_label(new_label);
   label = new_label;
+  dirty = true;
   return true;
 }
 
@@ -750,24 +811,29 @@ void Logical_Line::tokenize(Line_Accum const &la) {
   // Clear out any previous tokens
   fragments_.clear();
 
+  yyscan_t const scanner = thread_scanner();
+
   // The index into la.accum()
-  curr_line_pos = 0;
+  int curr_line_pos = 0;
+  yyset_extra(&curr_line_pos, scanner);
 
   // Feed the la.accum() to the flex parser to generate
   // the Logical_Line token fragment data.
-  YY_BUFFER_STATE bs = yy_scan_string(la.accum().c_str());
+  YY_BUFFER_STATE bs = yy_scan_string(la.accum().c_str(), scanner);
   const int N = la.accum().size();
   int tok_start_col = curr_line_pos;
   int next_pre_sp = 0;
   int space_between;
 
-  for (int result_tok = yylex(); result_tok != Syntax_Tags::EOL;
-       result_tok = yylex()) {
+  for (int result_tok = yylex(scanner); result_tok != Syntax_Tags::EOL;
+       result_tok = yylex(scanner)) {
     /* tok_start is an index into la.accum().  Convert this into a file line and
      column number */
     int li, ci, tli, tci;
     la.linecolno(tok_start_col, li, ci, tli, tci);
-    fragments_.emplace_back(std::string(yytext, yyleng), result_tok, li, ci);
+    fragments_.emplace_back(
+        std::string(yyget_text(scanner), yyget_leng(scanner)), result_tok, li,
+        ci);
     /* Break up keywords with no space. */
     if (result_tok == Syntax_Tags::TK_NAME)
       unsmash();
@@ -801,7 +867,7 @@ void Logical_Line::tokenize(Line_Accum const &la) {
 
     next_pre_sp = space_between;
   }
-  yy_delete_buffer(bs);
+  yy_delete_buffer(bs, scanner);
   init_stmts();
 }
 
@@ -809,6 +875,7 @@ void Logical_Line::tokenize(Line_Accum const &la) {
 void Logical_Line::append_comment(std::string const &comment_text) {
   if (comment_text.empty())
     return;
+  dirty = true;
   if (layout_[0].right_txt.empty()) {
     int lline_len = layout_[0].main_first_col() + layout_[0].main_txt.size();
     int c_len = 2 + comment_text.size();
@@ -890,6 +957,27 @@ std::ostream &Logical_Line::print(std::ostream &os) const {
   return os;
 };
 
+/* ------------------------------------------------------------------------ */
+size_t Logical_Line::print_size() const noexcept {
+  size_t n{0};
+  if (!suppress) {
+    for (auto const &fl : layout_)
+      n += fl.print_size() + 1;
+  }
+  return n;
+}
+
+/* ------------------------------------------------------------------------ */
+char *Logical_Line::render(char *dst) const noexcept {
+  if (!suppress) {
+    for (auto const &fl : layout_) {
+      dst = fl.render(dst);
+      *dst++ = '\n';
+    }
+  }
+  return dst;
+}
+
 /* ------------------------------------------------------------------------ */
 std::ostream &operator<<(std::ostream &os, Logical_Line const &ll) {
   return ll.print(os);
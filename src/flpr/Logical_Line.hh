@@ -62,6 +62,11 @@ public:
   LineCat cat;         //!< what sort of line is this (special)
   bool suppress;       //!< don't output this line
   bool needs_reformat; //!< true->reformat before output
+  //! True if the text may differ from what was scanned
+  /*! This is set by every mutator below.  Logical_Lines made from raw text
+      (rather than scanned from a file) start out dirty.  Clients that modify
+      layout() or fragments() directly must set it themselves. */
+  bool dirty;
 
   Logical_Line() noexcept;
 
@@ -77,7 +82,7 @@ public:
   template <typename Iter>
   Logical_Line(Iter first, Iter last) noexcept
       : label{0}, cat{LineCat::UNKNOWN}, suppress{false}, needs_reformat{false},
-        num_semicolons_{-1} {
+        dirty{false}, num_semicolons_{-1} {
     std::move(first, last, std::back_inserter(layout_));
     init_from_layout();
   }
@@ -166,8 +171,29 @@ public:
   void insert_text_after(typename TT_SEQ::iterator frag,
                          std::string const &new_text);
 
+  //! A pending replacement of main text, in layout (line, column) coordinates
+  /*! An insertion has begin == end. */
+  struct Text_Edit {
+    int begin_line, begin_col;
+    int end_line, end_col;
+    std::string text;
+  };
+
+  //! Apply several non-overlapping Text_Edits, then reinitialize once
+  /*! The edits are applied from the back of the line to the front, so each
+      one's coordinates refer to the text before any edits.  Edits at the same
+      position are applied in the order given, which is the same result as
+      applying each one with insert_text_after() or replace_stmt_substr() and
+      reinitializing in between. */
+  void apply_text_edits(std::vector<Text_Edit> &edits);
+
   //! Standard output
   std::ostream &print(std::ostream &os) const;
+  //! Return the number of characters written by print()
+  size_t print_size() const noexcept;
+  //! Copy the characters written by print() to dst, returning the end
+  /*! dst must have room for print_size() characters. */
+  char *render(char *dst) const noexcept;
 
   //! Diagnostic output
   std::ostream &dump(std::ostream &os) const;
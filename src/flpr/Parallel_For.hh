@@ -0,0 +1,91 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+/*!
+  \file Parallel_For.hh
+*/
+
+#ifndef FLPR_PARALLEL_FOR_HH
+#define FLPR_PARALLEL_FOR_HH 1
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace FLPR {
+
+//! Call f(i) for each i in [0, count), using up to num_threads threads
+/*! The indices are handed out in blocks of grain consecutive values, so that
+    each thread works on a contiguous stretch.  The calling thread is one of
+    the workers, and all calls have completed when this returns.  With
+    num_threads < 2 (or a single block), everything runs on the calling
+    thread, in index order.
+
+    The calls for different indices may run concurrently, so f must only
+    write to state that belongs to its index.
+
+    If f throws, no more blocks are started, and the first exception is
+    rethrown on the calling thread once the running calls have finished.  If
+    a thread can't be started, the work is shared among the threads that
+    were. */
+template <typename F>
+void parallel_for(std::size_t const count, unsigned const num_threads, F &&f,
+                  std::size_t const grain = 1) {
+  std::size_t const block = std::max<std::size_t>(grain, 1);
+  std::size_t const num_blocks = (count + block - 1) / block;
+  std::size_t const num_workers =
+      std::min<std::size_t>(std::max(num_threads, 1u), num_blocks);
+  if (num_workers < 2) {
+    for (std::size_t i = 0; i < count; ++i)
+      f(i);
+    return;
+  }
+
+  std::atomic<std::size_t> next_block{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto worker = [&]() {
+    try {
+      for (std::size_t b = next_block++; b < num_blocks; b = next_block++) {
+        std::size_t const last = std::min(count, (b + 1) * block);
+        for (std::size_t i = b * block; i < last; ++i)
+          f(i);
+      }
+    } catch (...) {
+      next_block = num_blocks;
+      std::lock_guard<std::mutex> const lock{error_mutex};
+      if (!error)
+        error = std::current_exception();
+    }
+  };
+  std::vector<std::thread> pool;
+  pool.reserve(num_workers - 1);
+  for (std::size_t t = 1; t < num_workers; ++t) {
+    try {
+      pool.emplace_back(worker);
+    } catch (std::system_error const &) {
+      break;
+    }
+  }
+  worker();
+  for (auto &t : pool)
+    t.join();
+  if (error)
+    std::rethrow_exception(error);
+}
+
+} // namespace FLPR
+
+#endif
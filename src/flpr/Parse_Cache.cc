@@ -0,0 +1,275 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+/*!
+  \file Parse_Cache.cc
+*/
+
+#include "flpr/Parse_Cache.hh"
+#include "flpr/File_Image.hh"
+#include "flpr/Stmt_Parser_Exts.hh"
+#include "flpr/Syntax_Tags.hh"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+
+/* Set by the build (see src/flpr/CMakeLists.txt) */
+#ifndef FLPR_VERSION_STRING
+#define FLPR_VERSION_STRING "unknown"
+#endif
+
+namespace fs = std::filesystem;
+
+namespace FLPR {
+
+namespace {
+char const *const entry_extension = ".fli";
+
+/* Two independent 64-bit hashes of a byte stream.  The first is FNV-1a, and
+   the second a multiply-xorshift, so that the pair is a 128-bit key. */
+class Key_Hash {
+public:
+  void add(char const *p, std::size_t const n) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+      std::uint64_t const c = static_cast<unsigned char>(p[i]);
+      a_ = (a_ ^ c) * 1099511628211ULL;
+      b_ = (b_ + c) * 0x9e3779b97f4a7c15ULL;
+      b_ ^= b_ >> 29;
+    }
+    size_ += n;
+  }
+  void add(std::uint64_t const v) noexcept {
+    char bytes[8];
+    for (int i = 0; i < 8; ++i)
+      bytes[i] = static_cast<char>((v >> (8 * i)) & 0xff);
+    add(bytes, sizeof(bytes));
+  }
+  //! Strings are prefixed by their size, so that they can't run together
+  void add(std::string const &s) noexcept {
+    add(static_cast<std::uint64_t>(s.size()));
+    add(s.data(), s.size());
+  }
+  std::string hex() const {
+    static char const digits[] = "0123456789abcdef";
+    std::string result;
+    for (std::uint64_t h : {mix_(a_ ^ size_), mix_(b_ + a_)})
+      for (int i = 60; i >= 0; i -= 4)
+        result += digits[(h >> i) & 0xf];
+    return result;
+  }
+
+private:
+  /* The splitmix64 finalizer */
+  static std::uint64_t mix_(std::uint64_t h) noexcept {
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+  }
+
+  std::uint64_t a_{14695981039346656037ULL};
+  std::uint64_t b_{0x243f6a8885a308d3ULL};
+  std::uint64_t size_{0};
+};
+
+bool is_entry(fs::directory_entry const &e) {
+  std::error_code ec;
+  return e.is_regular_file(ec) && e.path().extension() == entry_extension;
+}
+} // namespace
+
+Parse_Cache::Parse_Cache(std::string directory, std::uint64_t const max_bytes)
+    : directory_{std::move(directory)}, max_bytes_{max_bytes} {
+  std::error_code ec;
+  fs::create_directories(directory_, ec);
+  if (ec || !fs::is_directory(directory_, ec)) {
+    std::cerr << "Parse_Cache: unable to use \"" << directory_
+              << "\" as a cache directory";
+    if (ec)
+      std::cerr << ": " << ec.message();
+    std::cerr << std::endl;
+    return;
+  }
+  ok_ = true;
+  std::uint64_t total{0};
+  for (auto const &e : fs::directory_iterator(directory_, ec))
+    if (is_entry(e))
+      total += e.file_size(ec);
+  total_bytes_ = total;
+}
+
+std::string Parse_Cache::key(Logical_File::Line_Buf const &lines,
+                             File_Type const file_type,
+                             int const last_fixed_col,
+                             Stmt::Parser_Exts const *exts) const {
+  if (!exts)
+    exts = &Stmt::get_parser_exts();
+  Key_Hash h;
+  h.add(std::string{FLPR_VERSION_STRING});
+  h.add(static_cast<std::uint64_t>(File_Image::version));
+  h.add(static_cast<std::uint64_t>(file_type));
+  h.add(static_cast<std::uint64_t>(last_fixed_col));
+  for (int i = 0; i < Syntax_Tags::num_extensions(); ++i) {
+    int const tag = Syntax_Tags::CLIENT_EXTENSION + i;
+    h.add(Syntax_Tags::label(tag));
+    h.add(static_cast<std::uint64_t>(Syntax_Tags::type(tag)));
+  }
+  h.add(exts->identity());
+  h.add(salt_);
+  h.add(static_cast<std::uint64_t>(lines.size()));
+  for (auto const &l : lines)
+    h.add(l);
+  return h.hex();
+}
+
+std::string Parse_Cache::path_(std::string const &key) const {
+  return (fs::path{directory_} / (key + entry_extension)).string();
+}
+
+bool Parse_Cache::load(std::string const &key, std::string &image) {
+  if (ok_) {
+    std::string const path{path_(key)};
+    std::ifstream is(path, std::ios::binary | std::ios::ate);
+    if (is) {
+      std::streamoff const size = is.tellg();
+      image.resize(size > 0 ? static_cast<std::size_t>(size) : 0);
+      is.seekg(0);
+      if (size > 0 && is.read(&image[0], size)) {
+        /* A hit makes this the most recently used entry */
+        std::error_code ec;
+        fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+        hits_ += 1;
+        bytes_read_ += image.size();
+        return true;
+      }
+      errors_ += 1;
+    }
+  }
+  misses_ += 1;
+  image.clear();
+  return false;
+}
+
+void Parse_Cache::note_bad_entry(std::string const &key) {
+  /* load() counted it as a hit */
+  hits_ -= 1;
+  misses_ += 1;
+  errors_ += 1;
+  std::error_code ec;
+  fs::remove(path_(key), ec);
+}
+
+bool Parse_Cache::store(std::string const &key, std::string const &image) {
+  if (!ok_)
+    return false;
+  std::string const path{path_(key)};
+  std::ostringstream tmp;
+  tmp << path << '.' << getpid() << '.'
+      << std::hash<std::thread::id>{}(std::this_thread::get_id()) << ".tmp";
+  bool ok{false};
+  {
+    std::ofstream os(tmp.str(), std::ios::binary | std::ios::trunc);
+    ok = os && os.write(image.data(), image.size()) && os.flush();
+  }
+  std::error_code ec;
+  if (ok) {
+    /* The rename is atomic, so readers see the whole entry or none of it */
+    fs::rename(tmp.str(), path, ec);
+    ok = !ec;
+  }
+  if (!ok) {
+    fs::remove(tmp.str(), ec);
+    errors_ += 1;
+    return false;
+  }
+  stores_ += 1;
+  bytes_written_ += image.size();
+  total_bytes_ += image.size();
+  std::uint64_t const limit = max_bytes_;
+  if (limit > 0 && total_bytes_ > limit)
+    evict();
+  return true;
+}
+
+std::size_t Parse_Cache::evict() {
+  if (!ok_)
+    return 0;
+  std::uint64_t const limit = max_bytes_;
+  if (limit == 0)
+    return 0;
+  return evict_to_(limit - limit / 4);
+}
+
+std::size_t Parse_Cache::clear() {
+  if (!ok_)
+    return 0;
+  return evict_to_(0);
+}
+
+std::size_t Parse_Cache::evict_to_(std::uint64_t const target) {
+  std::lock_guard<std::mutex> const lock{evict_mutex_};
+  using Entry = std::tuple<fs::file_time_type, std::uint64_t, fs::path>;
+  std::vector<Entry> entries;
+  std::uint64_t total{0};
+  std::error_code ec;
+  for (auto const &e : fs::directory_iterator(directory_, ec)) {
+    if (!is_entry(e))
+      continue;
+    std::uint64_t const size = e.file_size(ec);
+    if (ec)
+      continue;
+    fs::file_time_type const time = e.last_write_time(ec);
+    if (ec)
+      continue;
+    entries.emplace_back(time, size, e.path());
+    total += size;
+  }
+  std::sort(entries.begin(), entries.end());
+  std::size_t removed{0};
+  for (auto const &e : entries) {
+    if (total <= target)
+      break;
+    /* Another process may have removed it first */
+    if (fs::remove(std::get<2>(e), ec))
+      removed += 1;
+    total -= std::get<1>(e);
+  }
+  total_bytes_ = total;
+  evictions_ += removed;
+  return removed;
+}
+
+auto Parse_Cache::stats() const -> Stats {
+  Stats s;
+  s.hits = hits_;
+  s.misses = misses_;
+  s.stores = stores_;
+  s.evictions = evictions_;
+  s.errors = errors_;
+  s.bytes_read = bytes_read_;
+  s.bytes_written = bytes_written_;
+  return s;
+}
+
+std::ostream &Parse_Cache::print_stats(std::ostream &os) const {
+  Stats const s{stats()};
+  return os << "parse cache: " << s.hits << " hits, " << s.misses
+            << " misses, " << s.stores << " stores, " << s.evictions
+            << " evictions, " << s.errors << " errors (" << s.bytes_read
+            << " bytes read, " << s.bytes_written << " bytes written)\n";
+}
+
+} // namespace FLPR
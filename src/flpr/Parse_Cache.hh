@@ -0,0 +1,135 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+/*!
+  \file Parse_Cache.hh
+*/
+
+#ifndef FLPR_PARSE_CACHE_HH
+#define FLPR_PARSE_CACHE_HH 1
+
+#include "flpr/File_Info.hh"
+#include "flpr/Logical_File.hh"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace FLPR {
+namespace Stmt {
+class Parser_Exts;
+}
+
+//! A directory of File_Images, keyed by the text that they were parsed from
+/*! Parsed_File (see Parsed_File::set_parse_cache()) looks up each file that
+    it reads, and on a hit rebuilds the Logical_File and parse tree from the
+    saved File_Image, rather than scanning and parsing the text.  On a miss,
+    the image is saved once the parse tree has been built.
+
+    The key is a 128-bit hash of the text, the File_Type, the last fixed
+    column, the FLPR and File_Image versions, the registered Syntax_Tags
+    extensions and the Parser_Exts::identity() of the statement parser
+    extensions.  Register extensions with ids so that their entries can be
+    found by later runs: an extension without an id is identified by its
+    address, so its entries are only found by the same process.  A key salt
+    (see set_key_salt()) can tell apart anything else that affects a parse.
+
+    Each entry is a file in the directory.  When the entries total more than
+    max_bytes(), the least recently used ones (by modification time, which a
+    hit refreshes) are removed.  Entries are written to a temporary file and
+    renamed into place, so any number of threads and processes can share a
+    directory.  The counts returned by stats() are for this object only. */
+class Parse_Cache {
+public:
+  //! The counts for one Parse_Cache object
+  struct Stats {
+    std::size_t hits{0};
+    std::size_t misses{0};
+    std::size_t stores{0};
+    std::size_t evictions{0};
+    //! Entries that could not be read, decoded or written
+    std::size_t errors{0};
+    std::uint64_t bytes_read{0};
+    std::uint64_t bytes_written{0};
+  };
+
+  static constexpr std::uint64_t default_max_bytes = 512ULL << 20;
+
+public:
+  //! Use (and create, if needed) the given directory
+  /*! If the directory can't be used, the cache is false, with a message to
+      std::cerr, and every lookup misses. */
+  explicit Parse_Cache(std::string directory,
+                       std::uint64_t const max_bytes = default_max_bytes);
+  Parse_Cache(Parse_Cache const &) = delete;
+  Parse_Cache &operator=(Parse_Cache const &) = delete;
+
+  explicit operator bool() const noexcept { return ok_; }
+  std::string const &directory() const noexcept { return directory_; }
+
+  //! The total size of the entries to keep (0 for no limit)
+  void set_max_bytes(std::uint64_t const max_bytes) noexcept {
+    max_bytes_ = max_bytes;
+  }
+  std::uint64_t max_bytes() const noexcept { return max_bytes_; }
+
+  //! Mix a client string into every key
+  /*! Set this before the first lookup. */
+  void set_key_salt(std::string salt) { salt_ = std::move(salt); }
+
+  //! Return the key for lines, as parsed with the given settings
+  /*! A null exts means Stmt::get_parser_exts(). */
+  std::string key(Logical_File::Line_Buf const &lines,
+                  File_Type const file_type, int const last_fixed_col,
+                  Stmt::Parser_Exts const *exts) const;
+
+  //! Load the entry for key into image, returning false on a miss
+  bool load(std::string const &key, std::string &image);
+
+  //! Save image as the entry for key, returning false on failure
+  bool store(std::string const &key, std::string const &image);
+
+  //! Count an entry that was loaded but could not be used
+  void note_bad_entry(std::string const &key);
+
+  //! Remove the oldest entries until they total no more than 3/4 max_bytes()
+  /*! This is called by store() once max_bytes() is exceeded, and goes below
+      the limit so that a full cache isn't rescanned by every store().
+      Returns the number of entries removed. */
+  std::size_t evict();
+
+  //! Remove every entry, returning the number removed
+  std::size_t clear();
+
+  Stats stats() const;
+  //! Write a one-line summary of stats()
+  std::ostream &print_stats(std::ostream &os) const;
+
+private:
+  std::string path_(std::string const &key) const;
+  std::size_t evict_to_(std::uint64_t const target);
+
+private:
+  std::string directory_;
+  std::atomic<std::uint64_t> max_bytes_;
+  std::string salt_;
+  bool ok_{false};
+  //! An estimate of the size of the entries, updated by store() and evict()
+  std::atomic<std::uint64_t> total_bytes_{0};
+  std::mutex evict_mutex_;
+  std::atomic<std::size_t> hits_{0}, misses_{0}, stores_{0}, evictions_{0},
+      errors_{0};
+  std::atomic<std::uint64_t> bytes_read_{0}, bytes_written_{0};
+};
+
+} // namespace FLPR
+
+#endif
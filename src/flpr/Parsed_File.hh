@@ -15,16 +15,45 @@
 #ifndef FLPR_PARSED_FILE_HH
 #define FLPR_PARSED_FILE_HH 1
 
+#include "flpr/File_Image.hh"
 #include "flpr/Indent_Table.hh"
 #include "flpr/LL_Stmt_Src.hh"
+#include "flpr/Lazy_Flag.hh"
 #include "flpr/Logical_File.hh"
+#include "flpr/Parallel_For.hh"
+#include "flpr/Parse_Cache.hh"
 #include "flpr/Prgm_Parsers.hh"
 #include "flpr/Prgm_Tree.hh"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
 #include <ostream>
 #include <string>
+#include <vector>
 
 namespace FLPR {
 
+//! The result of Parsed_File::validate()
+struct Syntax_Check {
+  //! True if the file is a syntactically valid program
+  bool ok{false};
+  //! The first statement that could not be matched (nullptr: end of file)
+  LL_Stmt const *stmt{nullptr};
+  //! The construct that was being parsed when the error was detected
+  int expected{Syntax_Tags::UNKNOWN};
+  //! The name of the file
+  std::string filename;
+  //! The (index origin = 1) line number of the error
+  int line{-1};
+  //! The number of statement parser invocations used
+  std::size_t work{0};
+  //! True if the check was abandoned because the work budget ran out
+  bool budget_exhausted{false};
+
+  constexpr explicit operator bool() const noexcept { return ok; }
+};
+
 //! A lazy-evaluation container for all FLPR constructs related to a file
 template <typename PG_NODE_DATA = Prgm::Prgm_Node_Data> class Parsed_File {
 public:
@@ -54,16 +83,63 @@ public:
                        int const last_fixed_col,
                        File_Type stream_type = File_Type::UNKNOWN);
 
+  //! Construct an empty Parsed_File, to be filled by read_file() or
+  //! scan_lines()
   Parsed_File() = default;
   Parsed_File(Parsed_File &&) = default;
   Parsed_File(Parsed_File const &) = delete;
   Parsed_File &operator=(Parsed_File &&) = default;
   Parsed_File &operator=(Parsed_File const &) = delete;
 
+  //! Read and scan a file
+  /*! Returns true if the Parsed_File is left in a bad state, i.e. if reading
+      or scanning the file failed. */
   bool read_file(std::string const &filename, int const last_fixed_col,
                  File_Type file_type = File_Type::UNKNOWN);
 
-  constexpr operator bool() const noexcept { return !bad_state_; }
+  //! Scan lines that have already been read (see Logical_File::read_lines())
+  /*! The name is used as the filename.  As with read_file(), this returns
+      true if the Parsed_File is left in a bad state, i.e. if the scan
+      failed. */
+  bool scan_lines(Logical_File::Line_Buf &&lines, std::string const &name,
+                  int const last_fixed_col,
+                  File_Type file_type = File_Type::UNKNOWN);
+
+  operator bool() const noexcept { return !bad_state_; }
+
+  //! Look up the files read by read_file() and scan_lines() in cache
+  /*! On a hit, the Logical_File, statements and parse tree are rebuilt from
+      the saved File_Image, and from_cache() is true.  On a miss, the file is
+      scanned as usual, and once the parse tree is built, its image is saved
+      in the cache (unless the file has been changed, or recovered from
+      syntax errors).  The Stmt_Trees of a file from the cache are rebuilt on
+      demand.  Call this before reading the file: the constructors that read
+      a file don't use a cache.  cache must outlive the Parsed_File, and may
+      be shared by any number of them. */
+  void set_parse_cache(Parse_Cache *cache) noexcept { parse_cache_ = cache; }
+  Parse_Cache *parse_cache() const noexcept { return parse_cache_; }
+  //! True if the file was loaded from the parse cache
+  constexpr bool from_cache() const noexcept { return from_cache_; }
+
+  //! Keep the text of the file, for Logical_File::write_diff()
+  /*! See Logical_File::set_keep_original_lines().  Call this before reading
+      the file: the constructors that read a file don't keep the text. */
+  void set_keep_original_lines(bool const keep) noexcept {
+    logical_file_.set_keep_original_lines(keep);
+  }
+
+  //! Return a File_Image of the file, its statements and parse tree
+  /*! The parse tree is built if needed, and the Stmt_Trees that are built
+      are saved too (unless stmt_trees is false).  Returns an empty string if
+      the file can't be parsed.  Write the image out with File_Image::save().
+   */
+  std::string write_image(bool const stmt_trees = true);
+
+  //! Rebuild the file from a File_Image, rather than reading and parsing it
+  /*! The image can be walked in place, for example through a
+      File_Image::Mapping of a saved image file.  The name is used as the
+      filename.  Returns true on success. */
+  bool read_image(File_Image::View const &image, std::string const &name);
 
   constexpr Logical_File &logical_file() noexcept { return logical_file_; }
   constexpr Logical_File const &logical_file() const noexcept {
@@ -75,10 +151,11 @@ public:
   }
 
   //! Build the LL_Stmts (Logical Line Statements) sequence, if needed.
+  /*! This, statements(), prefetch_parse_tree() and parse_tree() may be called
+      concurrently: the first caller builds, and the others wait for it.  The
+      functions that change the file are not thread-safe. */
   bool prefetch_statements() {
-    if (!stmts_ok_)
-      build_stmts_();
-    return stmts_ok_;
+    return stmts_ok_.call([this] { build_stmts_(); });
   }
 
   //! Build/return the LL_Stmts (Logical Line Statements) sequence
@@ -89,9 +166,7 @@ public:
 
   //! Build the parse tree, if needed.
   bool prefetch_parse_tree() {
-    if (!tree_ok_)
-      build_tree_();
-    return tree_ok_;
+    return tree_ok_.call([this] { build_tree_(); });
   }
 
   //! Build/return the parse tree
@@ -100,6 +175,147 @@ public:
     return parse_tree_;
   }
 
+  //! Select whether the parse tree build keeps the Stmt_Trees
+  /*! With keep == false, building the parse tree only records the syntag of
+      each LL_Stmt, and the Stmt_Trees are rebuilt one at a time on demand by
+      LL_Stmt::stmt_tree().  This greatly reduces the memory needed for
+      operations that only use the program structure, such as indent().  The
+      rebuilt trees are not kept either: Procedure_Visitor releases them after
+      each procedure, and release_stmt_trees() releases them all. */
+  void set_keep_stmt_trees(bool const keep) noexcept {
+    keep_stmt_trees_ = keep;
+  }
+
+  //! Use exts, rather than Stmt::get_parser_exts(), to build the parse tree
+  /*! exts must outlive the parse, and any Stmt_Trees that
+      LL_Stmt::stmt_tree() rebuilds on demand, and nullptr restores the
+      default. */
+  void set_parser_exts(Stmt::Parser_Exts const *exts) noexcept {
+    parser_exts_ = exts;
+    record_parser_exts_();
+  }
+  Stmt::Parser_Exts const *parser_exts() const noexcept { return parser_exts_; }
+
+  //! Select the number of threads used to build the parse tree
+  /*! With more than one thread, the top-level program-units are parsed
+      concurrently (see Prgm::Parsers::program_parallel()).  The default is
+      one, a serial parse. */
+  void set_parse_threads(unsigned const threads) noexcept {
+    parse_threads_ = threads;
+  }
+  constexpr unsigned parse_threads() const noexcept { return parse_threads_; }
+
+  //! Select whether building the parse tree recovers from syntax errors
+  /*! With recover == true, the parse tree is built by
+      Prgm::Parsers::program_recover(): the constructs, subprograms or
+      program-units with syntax errors are wrapped in PG_SYNTAX_ERROR nodes and
+      listed in failed_ranges(), and the rest of the file is still available
+      to clients.  Nothing is reported for the errors recovered from: see
+      recovered_errors().  This parses serially, regardless of
+      parse_threads(). */
+  void set_error_recovery(bool const recover) noexcept {
+    error_recovery_ = recover;
+  }
+
+  //! The statement ranges that were skipped while building the parse tree
+  std::vector<Prgm::Failed_Range> const &failed_ranges() const noexcept {
+    return failed_ranges_;
+  }
+
+  //! Describe the syntax errors that building the parse tree recovered from
+  /*! There is one entry for each of failed_ranges(), filled in as
+      validate() would for that error. */
+  std::vector<Syntax_Check> recovered_errors() const;
+
+  //! Build every dropped or missing Stmt_Tree, using up to threads threads
+  /*! Clients that look at the Stmt_Tree of nearly every statement (e.g.
+      through LL_Stmt::stmt_tag()) can call this after building the parse
+      tree, rather than having the trees rebuilt one at a time on demand.
+      Each statement is parsed into its own LL_Stmt, so the statements are
+      split across the threads.  Returns false if the parse tree can't be
+      built or a statement fails to parse. */
+  bool materialize_stmt_trees(unsigned const threads = 1);
+
+  //! Drop the Stmt_Trees that were rebuilt since a parse that didn't keep them
+  /*! See set_keep_stmt_trees().  No other thread may be using the trees. */
+  void release_stmt_trees() {
+    for (auto &stmt : statements())
+      stmt.release_stmt_tree();
+  }
+
+  //! Limit the work that the parser may do on this file
+  /*! The budget counts statement parser invocations, rewinds inside the
+      statement parsers, and failed program-level alternatives (see
+      Prgm::Parsers::State::work_budget).  0 (the default) means unlimited.
+      If the budget runs out, the parse fails with a diagnostic naming the
+      construct and statement where it stopped.  This allows batch drivers to
+      bound the time spent on pathological input. */
+  void set_work_budget(std::size_t const budget) noexcept {
+    work_budget_ = budget;
+  }
+  constexpr std::size_t work_budget() const noexcept { return work_budget_; }
+
+  //! The units of work used to build the parse tree
+  constexpr std::size_t parse_work() const noexcept { return parse_work_; }
+
+  //! True if building the parse tree failed because the budget ran out
+  constexpr bool budget_exhausted() const noexcept {
+    return budget_exhausted_;
+  }
+
+  //! Bring the parse tree up to date with edited statements
+  /*! The Logical_File edits (replace_stmt_text(), emplace_ll_stmt(), ...)
+      unhook the statements they change from the parse tree.  For each run of
+      unhooked statements, this finds the smallest construct node covering
+      the run and its hooked neighbours that has a Parse::construct_rule(),
+      re-parses just that node's statements, and splices the new subtree into
+      place.  If no enclosing construct re-parses cleanly, the whole tree is
+      rebuilt.  Returns false if the statements no longer form a valid
+      program.
+
+      Each re-parse starts with the labels of the enclosing label-do-stmts,
+      as the full parse would have, and is held to the work budget, with its
+      work added to parse_work().  If the budget runs out, this gives up
+      (leaving the edited statements unhooked) and returns false, with
+      budget_exhausted() set. */
+  bool reparse_dirty();
+
+  //! A point that the file and its parse tree can be rolled back to
+  struct Snapshot {
+    Logical_File::Snapshot file;
+    std::size_t tree;
+  };
+
+  //! Start recording edits, so that they can be rolled back
+  /*! This allows speculative transformations to be abandoned without
+      re-reading the file.  Taking a snapshot is O(1).  The Logical_File edits
+      are recorded as described in Logical_File::snapshot(), and any parse
+      tree nodes replaced by reparse_dirty() (or by a rebuild) are kept.  Each
+      snapshot must be ended by rollback() or release(), in the reverse order
+      that they were taken. */
+  Snapshot snapshot() {
+    prefetch_statements();
+    return Snapshot{logical_file_.snapshot(), tree_log_.size()};
+  }
+
+  //! Undo the edits and re-parses since s was taken, and end s
+  /*! The cost is proportional to the size of the edits and of the re-parsed
+      subtrees, not to the size of the file. */
+  void rollback(Snapshot const &s);
+
+  //! Keep the changes made since s was taken, and end s
+  void release(Snapshot const &s) {
+    logical_file_.release(s.file);
+    if (!logical_file_.has_snapshot())
+      tree_log_.clear();
+  }
+
+  //! Check the syntax of the file without building the parse tree
+  /*! This runs Parse::check() over the statements, so no Prgm_Tree is built
+      and no Stmt_Trees are retained.  If the parse tree has already been
+      successfully built, this just reports success. */
+  Syntax_Check validate();
+
   //! Indent the statements according to the provided Indent_Table.
   bool indent(Indent_Table const &indents) {
     if (parse_tree().empty())
@@ -121,7 +337,31 @@ private:
   mutable Logical_File logical_file_;
   mutable Parse_Tree parse_tree_;
   bool from_stream_{false};
-  mutable bool bad_state_{true}, stmts_ok_{false}, tree_ok_{false};
+  std::size_t work_budget_{0}, parse_work_{0};
+  bool budget_exhausted_{false}, keep_stmt_trees_{true};
+  bool error_recovery_{false};
+  unsigned parse_threads_{1};
+  Stmt::Parser_Exts const *parser_exts_{nullptr};
+  std::vector<Prgm::Failed_Range> failed_ranges_;
+  Parse_Cache *parse_cache_{nullptr};
+  //! The key of a cache miss, to store the parse under
+  std::string cache_key_;
+  bool from_cache_{false};
+  mutable Publish_Flag bad_state_{true};
+  mutable Once_Flag stmts_ok_{false}, tree_ok_{false};
+
+  //! A parse tree change recorded for rollback()
+  struct Tree_Undo_ {
+    //! The node that was re-parsed, or nullptr for the whole tree
+    typename Parse_Tree::node *n;
+    //! The prior contents of n (or the prior parse tree)
+    Parse_Tree saved;
+    //! The ancestors of n, from the root down
+    std::vector<typename Parse_Tree::node *> ancestors;
+    bool tree_ok, bad_state;
+    std::vector<Prgm::Failed_Range> failed_ranges;
+  };
+  std::vector<Tree_Undo_> tree_log_;
 
 private:
   void link_stmts_recurse_(typename Parse_Tree::node &n);
@@ -132,6 +372,26 @@ private:
     }
   }
   void build_tree_();
+  //! Note parser_exts_ in the File_Info, for rebuilding the Stmt_Trees
+  void record_parser_exts_() noexcept {
+    if (logical_file_.file_info)
+      logical_file_.file_info->parser_exts = parser_exts_;
+  }
+  //! Load lines from the parse cache, or scan them
+  bool load_or_scan_(Logical_File::Line_Buf &&lines, std::string const &name,
+                     int const last_fixed_col, File_Type const file_type);
+  //! Rebuild everything from image, using lines if given
+  bool load_image_(File_Image::View const &image, std::string const &name,
+                   Logical_File::Line_Buf *lines);
+  Parse_Tree unflatten_(File_Image::Prgm_Nodes const &nodes,
+                        std::size_t const index,
+                        std::vector<LL_STMT_SEQ::iterator> const &stmts);
+  void store_image_();
+  //! Clear the parse tree, keeping it for rollback() if needed
+  void discard_tree_();
+  bool reparse_between_(LL_STMT_SEQ::iterator prev,
+                        LL_STMT_SEQ::iterator next);
+  void report_budget_exhausted_(typename Parse::State const &state) const;
   bool indent_recurse_(typename Parse_Tree::node &n,
                        Indent_Table const &indents, int curr_spaces);
 };
@@ -162,32 +422,401 @@ bool Parsed_File<PG_NODE_DATA>::read_file(std::string const &filename,
                                           int const last_fixed_col,
                                           File_Type file_type) {
   assert(bad_state_);
-  if (logical_file_.read_and_scan(filename, last_fixed_col, file_type)) {
+  Logical_File::Line_Buf lines;
+  if (Logical_File::read_lines(filename, lines) &&
+      load_or_scan_(std::move(lines), filename, last_fixed_col, file_type)) {
+    bad_state_ = false;
+  }
+  return bad_state_;
+}
+
+template <typename PG_NODE_DATA>
+bool Parsed_File<PG_NODE_DATA>::scan_lines(Logical_File::Line_Buf &&lines,
+                                           std::string const &name,
+                                           int const last_fixed_col,
+                                           File_Type file_type) {
+  assert(bad_state_);
+  if (load_or_scan_(std::move(lines), name, last_fixed_col, file_type)) {
     bad_state_ = false;
   }
   return bad_state_;
 }
 
+template <typename PG_NODE_DATA>
+bool Parsed_File<PG_NODE_DATA>::load_or_scan_(Logical_File::Line_Buf &&lines,
+                                              std::string const &name,
+                                              int const last_fixed_col,
+                                              File_Type const file_type) {
+  cache_key_.clear();
+  if (parse_cache_ && *parse_cache_) {
+    File_Type const type = (file_type == File_Type::UNKNOWN)
+                               ? file_type_from_extension(name)
+                               : file_type;
+    std::string key{parse_cache_->key(lines, type, last_fixed_col,
+                                      parser_exts_)};
+    std::string image;
+    if (parse_cache_->load(key, image)) {
+      if (load_image_(File_Image::View{image.data(), image.size()}, name,
+                      &lines)) {
+        from_cache_ = true;
+        return true;
+      }
+      parse_cache_->note_bad_entry(key);
+    }
+    cache_key_ = std::move(key);
+  }
+  return logical_file_.scan(std::move(lines), name, last_fixed_col,
+                            file_type);
+}
+
+template <typename PG_NODE_DATA>
+std::string Parsed_File<PG_NODE_DATA>::write_image(bool const stmt_trees) {
+  if (!prefetch_parse_tree() || bad_state_)
+    return std::string{};
+  return File_Image::write(logical_file_,
+                           File_Image::flatten(parse_tree_, logical_file_),
+                           stmt_trees);
+}
+
+template <typename PG_NODE_DATA>
+bool Parsed_File<PG_NODE_DATA>::read_image(File_Image::View const &image,
+                                           std::string const &name) {
+  assert(bad_state_);
+  if (load_image_(image, name, nullptr)) {
+    bad_state_ = false;
+  }
+  return !bad_state_;
+}
+
+/* lines is only consumed on success */
+template <typename PG_NODE_DATA>
+bool Parsed_File<PG_NODE_DATA>::load_image_(File_Image::View const &image,
+                                            std::string const &name,
+                                            Logical_File::Line_Buf *lines) {
+  File_Image::Prgm_Nodes nodes;
+  if (!(lines ? File_Image::read(image, name, std::move(*lines),
+                                 logical_file_, nodes)
+              : File_Image::read(image, name, logical_file_, nodes)))
+    return false;
+  std::vector<LL_STMT_SEQ::iterator> stmts;
+  stmts.reserve(logical_file_.ll_stmts.size());
+  for (auto it = logical_file_.ll_stmts.begin();
+       it != logical_file_.ll_stmts.end(); ++it)
+    stmts.push_back(it);
+  parse_tree_ = nodes.empty() ? Parse_Tree{} : unflatten_(nodes, 0, stmts);
+  if (!parse_tree_.empty())
+    link_stmts_recurse_(*parse_tree_);
+  record_parser_exts_();
+  failed_ranges_.clear();
+  parse_work_ = 0;
+  stmts_ok_ = true;
+  tree_ok_ = true;
+  return true;
+}
+
+template <typename PG_NODE_DATA>
+auto Parsed_File<PG_NODE_DATA>::unflatten_(
+    File_Image::Prgm_Nodes const &nodes, std::size_t const index,
+    std::vector<LL_STMT_SEQ::iterator> const &stmts) -> Parse_Tree {
+  File_Image::Prgm_Node const &n = nodes[index];
+  Parse_Tree t = (n.stmt >= 0) ? Parse_Tree{n.syntag, stmts[n.stmt]}
+                               : Parse_Tree{n.syntag};
+  std::int32_t b = n.num_branches > 0 ? static_cast<std::int32_t>(index) + 1
+                                      : -1;
+  for (std::uint32_t i = 0; i < n.num_branches && b >= 0; ++i) {
+    t.graft_back(unflatten_(nodes, static_cast<std::size_t>(b), stmts));
+    b = nodes[b].next_sibling;
+  }
+  Parse::cover_branches(*t);
+  return t;
+}
+
+/* Save the parse of an unchanged file after a cache miss */
+template <typename PG_NODE_DATA>
+void Parsed_File<PG_NODE_DATA>::store_image_() {
+  std::string const key{std::move(cache_key_)};
+  cache_key_.clear();
+  if (bad_state_ || !failed_ranges_.empty())
+    return;
+  for (auto const &ll : logical_file_.lines)
+    if (ll.dirty)
+      return;
+  /* Leave out the Stmt_Trees, which are rebuilt on demand, to keep the
+     entries small */
+  parse_cache_->store(
+      key, File_Image::write(logical_file_,
+                             File_Image::flatten(parse_tree_, logical_file_),
+                             false));
+}
+
+template <typename PG_NODE_DATA>
+bool Parsed_File<PG_NODE_DATA>::materialize_stmt_trees(unsigned const threads) {
+  if (!prefetch_parse_tree() || bad_state_)
+    return false;
+  std::vector<LL_Stmt const *> todo;
+  for (auto const &stmt : statements())
+    if (!stmt.has_stmt_tree())
+      todo.push_back(&stmt);
+  std::atomic<bool> ok{true};
+  parallel_for(
+      todo.size(), threads,
+      [&todo, &ok](std::size_t const i) {
+        if (!todo[i]->build_stmt_tree())
+          ok = false;
+      },
+      64);
+  return ok;
+}
+
+template <typename PG_NODE_DATA>
+bool Parsed_File<PG_NODE_DATA>::reparse_dirty() {
+  if (!tree_ok_)
+    return prefetch_parse_tree() && !bad_state_;
+  if (bad_state_)
+    return false;
+
+  budget_exhausted_ = false;
+  LL_STMT_SEQ &stmts = statements();
+  auto const is_hooked = [](LL_Stmt const &s) { return s.has_hook(); };
+  for (;;) {
+    auto const dirty = std::find_if_not(stmts.begin(), stmts.end(), is_hooked);
+    if (dirty == stmts.end())
+      return true;
+    auto const next = std::find_if(dirty, stmts.end(), is_hooked);
+    if (dirty == stmts.begin() || next == stmts.end() ||
+        !reparse_between_(std::prev(dirty), next)) {
+      if (budget_exhausted_)
+        return false;
+      /* Start over */
+      for (auto &s : stmts)
+        s.unhook();
+      discard_tree_();
+      tree_ok_ = false;
+      return prefetch_parse_tree() && !bad_state_;
+    }
+  }
+}
+
+/* Re-parse the smallest construct that covers the hooked statements prev and
+   next (and so everything in between), returning false if none will do, or
+   if the work budget runs out */
+template <typename PG_NODE_DATA>
+bool Parsed_File<PG_NODE_DATA>::reparse_between_(LL_STMT_SEQ::iterator prev,
+                                                 LL_STMT_SEQ::iterator next) {
+  using node = typename Parse_Tree::node;
+  auto const ancestors = [](node *n) {
+    std::vector<node *> path{n};
+    while (!n->is_root()) {
+      n = &*(n->trunk());
+      path.push_back(n);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+  };
+  std::vector<node *> const prev_path{
+      ancestors(static_cast<node *>(prev->get_hook()))};
+  std::vector<node *> const next_path{
+      ancestors(static_cast<node *>(next->get_hook()))};
+  std::size_t common = 0;
+  while (common < prev_path.size() && common < next_path.size() &&
+         prev_path[common] == next_path[common])
+    common += 1;
+  assert(common > 0);
+
+  for (std::size_t i = common; i-- > 1;) {
+    node &n = *prev_path[i];
+    typename Parse::Rule const rule = Parse::construct_rule(n->syntag());
+    if (!rule)
+      continue;
+    /* The node's stmt_range size may be stale after emplace_ll_stmt(), so
+       rebuild the range from its end points */
+    typename Parse::State state(
+        SL_Range<LL_Stmt>{n->stmt_range().begin(), n->stmt_range().end()});
+    state.keep_stmt_trees = keep_stmt_trees_;
+    state.parser_exts = parser_exts_;
+    state.quiet = true;
+    state.work_budget = work_budget_;
+    /* Anything in n that ends a label-do-stmt of an enclosing do-construct
+       must be left for that construct */
+    for (std::size_t j = 1; j < i; ++j) {
+      node &a = *prev_path[j];
+      if (a->syntag() != Syntax_Tags::PG_DO_CONSTRUCT &&
+          a->syntag() != Syntax_Tags::PG_NONBLOCK_DO_CONSTRUCT)
+        continue;
+      TT_Stream ts(a->stmt_range().front());
+      ts.set_parser_exts(parser_exts_);
+      Stmt::Stmt_Tree const do_stmt_tree{Stmt::do_stmt(ts)};
+      if (do_stmt_tree) {
+        int const label = Stmt::get_label_do_label(do_stmt_tree);
+        if (label > 0)
+          state.do_label_stack.push(label);
+      }
+    }
+    auto result{rule(state)};
+    parse_work_ += state.work_done;
+    if (state.budget_exhausted) {
+      budget_exhausted_ = true;
+      report_budget_exhausted_(state);
+      return false;
+    }
+    if (!result.match || state.ss)
+      continue;
+    n.swap(*result.parse_tree);
+    if (logical_file_.has_snapshot()) {
+      tree_log_.push_back(Tree_Undo_{
+          &n, std::move(result.parse_tree),
+          std::vector<node *>(prev_path.begin(), prev_path.begin() + i),
+          tree_ok_, bad_state_, failed_ranges_});
+    }
+    link_stmts_recurse_(n);
+    for (std::size_t j = i; j-- > 0;) {
+      Parse::cover_branches(*prev_path[j]);
+      (*prev_path[j])->clear_hash();
+    }
+    return true;
+  }
+  return false;
+}
+
+template <typename PG_NODE_DATA>
+void Parsed_File<PG_NODE_DATA>::rollback(Snapshot const &s) {
+  /* Restore the statements first, so that the restored subtrees can be
+     relinked to them */
+  logical_file_.rollback(s.file);
+  while (tree_log_.size() > s.tree) {
+    Tree_Undo_ &u = tree_log_.back();
+    if (u.n) {
+      u.n->swap(*u.saved);
+      link_stmts_recurse_(*u.n);
+      for (auto a = u.ancestors.rbegin(); a != u.ancestors.rend(); ++a) {
+        Parse::cover_branches(**a);
+        (**a)->clear_hash();
+      }
+    } else {
+      parse_tree_ = std::move(u.saved);
+      if (!parse_tree_.empty())
+        link_stmts_recurse_(*parse_tree_);
+      else
+        for (auto &stmt : logical_file_.ll_stmts)
+          stmt.unhook();
+    }
+    tree_ok_ = u.tree_ok;
+    bad_state_ = u.bad_state;
+    failed_ranges_ = std::move(u.failed_ranges);
+    tree_log_.pop_back();
+  }
+  if (!logical_file_.has_snapshot())
+    tree_log_.clear();
+}
+
+template <typename PG_NODE_DATA>
+void Parsed_File<PG_NODE_DATA>::discard_tree_() {
+  if (logical_file_.has_snapshot())
+    tree_log_.push_back(Tree_Undo_{nullptr, std::move(parse_tree_), {},
+                                   tree_ok_, bad_state_, failed_ranges_});
+  parse_tree_ = Parse_Tree{};
+}
+
 template <typename PG_NODE_DATA> void Parsed_File<PG_NODE_DATA>::build_tree_() {
   if (bad_state_)
     return;
+  discard_tree_();
+  record_parser_exts_();
 
   if (statements().empty()) {
     parse_tree_ = Parse_Tree{};
   } else {
 
     typename Parse::State state(statements());
-    auto result{Parse::program(state)};
+    state.work_budget = work_budget_;
+    state.keep_stmt_trees = keep_stmt_trees_;
+    state.parser_exts = parser_exts_;
+    state.quiet = error_recovery_;
+    auto result{error_recovery_
+                    ? Parse::program_recover(state)
+                    : Parse::program_parallel(state, parse_threads_)};
+    parse_work_ = state.work_done;
+    budget_exhausted_ = state.budget_exhausted;
+    failed_ranges_ = std::move(state.failed_ranges);
     if (!result.match) {
+      if (budget_exhausted_)
+        report_budget_exhausted_(state);
       std::cerr << "\tparsing FAILED" << std::endl;
       bad_state_ = true;
     }
     parse_tree_.swap(result.parse_tree);
-    link_stmts_recurse_(*parse_tree_);
+    if (!parse_tree_.empty())
+      link_stmts_recurse_(*parse_tree_);
   }
+  if (parse_cache_ && !cache_key_.empty())
+    store_image_();
   tree_ok_ = true;
 }
 
+template <typename PG_NODE_DATA>
+Syntax_Check Parsed_File<PG_NODE_DATA>::validate() {
+  Syntax_Check result;
+  if (logical_file_.file_info)
+    result.filename = logical_file_.file_info->filename;
+
+  if (tree_ok_ && !bad_state_) {
+    result.ok = true;
+    return result;
+  }
+  if (!prefetch_statements())
+    return result;
+  if (statements().empty()) {
+    result.ok = true;
+    return result;
+  }
+
+  typename Parse::State state(statements());
+  state.work_budget = work_budget_;
+  state.parser_exts = parser_exts_;
+  result.ok = Parse::check(state);
+  result.work = state.work_done;
+  result.budget_exhausted = state.budget_exhausted;
+  if (!result.ok) {
+    result.expected = state.fail_syntag;
+    result.stmt = state.fail_stmt;
+    if (result.stmt)
+      result.line = result.stmt->ll().start_line();
+    else if (!logical_lines().empty())
+      result.line = logical_lines().back().end_line() - 1;
+  }
+  return result;
+}
+
+template <typename PG_NODE_DATA>
+std::vector<Syntax_Check> Parsed_File<PG_NODE_DATA>::recovered_errors() const {
+  std::vector<Syntax_Check> errors;
+  for (auto const &range : failed_ranges_) {
+    Syntax_Check &error = errors.emplace_back();
+    if (logical_file_.file_info)
+      error.filename = logical_file_.file_info->filename;
+    error.expected = range.fail_syntag;
+    error.stmt = range.fail_stmt;
+    if (error.stmt)
+      error.line = error.stmt->ll().start_line();
+    else if (!logical_file_.lines.empty())
+      error.line = logical_file_.lines.back().end_line() - 1;
+  }
+  return errors;
+}
+
+template <typename PG_NODE_DATA>
+void Parsed_File<PG_NODE_DATA>::report_budget_exhausted_(
+    typename Parse::State const &state) const {
+  std::cerr << "Parser work budget of " << state.work_budget
+            << " exhausted";
+  if (state.fail_stmt) {
+    std::cerr << " at\n";
+    state.fail_stmt->print_me(std::cerr, false);
+  }
+  std::cerr << "\nwhile parsing ";
+  Syntax_Tags::print(std::cerr, state.fail_syntag) << std::endl;
+}
+
 template <typename PG_NODE_DATA>
 void Parsed_File<PG_NODE_DATA>::link_stmts_recurse_(
     typename Parse_Tree::node &n) {
@@ -214,8 +843,8 @@ bool Parsed_File<PG_NODE_DATA>::indent_recurse_(typename Parse_Tree::node &n,
          line.  Note that the other statements on a compound line have their
          'spaces' member set correctly, so you can uncompound them easily. */
       if (n->ll_stmt().is_compound() < 2) {
-        changed = n->ll_stmt().set_leading_spaces(curr_spaces,
-                                                  indents.continued_offset());
+        changed = logical_file_.set_leading_spaces(
+            n->ll_stmt_iter(), curr_spaces, indents.continued_offset());
       }
     }
   } else {
@@ -0,0 +1,143 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+/*!
+  \file Parser_Trace.hh
+*/
+
+#ifndef FLPR_PARSER_TRACE_HH
+#define FLPR_PARSER_TRACE_HH 1
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace FLPR {
+
+//! Select recognize-then-build evaluation of the parser combinators
+/*! When true, each combinator-defined rule first runs a recognizer pass that
+    records its decisions in a Parser_Trace, then builds the tree once along
+    the winning path.  The parser functions of parse_stmt.cc recognize with
+    their own combinators, so a failed alternative allocates nothing.  The few
+    that are opaque to the combinators (such as expr) build their trees during
+    the recognizer pass, and the results are stashed for the build pass.  When
+    false, the combinators build their trees eagerly, discarding partial trees
+    on failure.  Both modes produce identical results, and two passes (the
+    default) is the faster.  The mode can be changed while other threads are
+    parsing: the change applies to the rules that start after it. */
+inline std::atomic<bool> &two_pass_parsing() noexcept {
+  static std::atomic<bool> enabled{true};
+  return enabled;
+}
+
+namespace details_ {
+
+//! Record of the decisions made by a recognizer pass
+/*! The combinators can run in two passes: a recognizer pass that only decides
+    whether (and how) the input matches, followed by a build pass that
+    constructs the parse tree along the winning path.  The recognizer appends
+    its decisions (which alternative matched, how many repetitions, ...) to
+    this trace, and the build pass replays them in the same order.
+
+    Rules that are opaque to the combinators (parser functions that build
+    their own trees) are run once during the recognizer pass, and their result
+    is stashed as a \c Cached entry to be picked up by the build pass.
+
+    The trace is intended to be reused: rewind() does not release capacity, so
+    once the buffers have grown to fit the deepest parse, there is no further
+    heap traffic from the trace itself. */
+template <typename Cached> class Parser_Trace {
+public:
+  //! A position in the trace that can be returned to
+  struct Mark {
+    std::size_t decision;
+    std::size_t cached;
+  };
+
+public:
+  Parser_Trace() : next_decision_{0}, next_cached_{0} {
+    decisions_.reserve(64);
+    cached_.reserve(16);
+  }
+  Parser_Trace(Parser_Trace const &) = delete;
+  Parser_Trace &operator=(Parser_Trace const &) = delete;
+
+  /* ---------------------- Recognizer interface ------------------------ */
+
+  //! Mark the current end of the trace
+  Mark mark() const noexcept { return Mark{decisions_.size(), cached_.size()}; }
+  //! Discard everything recorded after m
+  void rewind(Mark const &m) {
+    assert(m.decision <= decisions_.size());
+    assert(m.cached <= cached_.size());
+    decisions_.resize(m.decision);
+    cached_.erase(cached_.begin() + m.cached, cached_.end());
+  }
+  //! Reserve a slot for a decision, returning the slot index
+  std::size_t push_decision(int const decision = 0) {
+    decisions_.push_back(decision);
+    return decisions_.size() - 1;
+  }
+  //! Fill in a previously reserved decision slot
+  void set_decision(std::size_t const slot, int const decision) noexcept {
+    assert(slot < decisions_.size());
+    decisions_[slot] = decision;
+  }
+  //! Stash the result of an opaque rule
+  void push_cached(Cached &&c) { cached_.emplace_back(std::move(c)); }
+
+  /* ------------------------- Build interface --------------------------- */
+
+  //! Start replaying from m
+  void replay(Mark const &m) noexcept {
+    next_decision_ = m.decision;
+    next_cached_ = m.cached;
+  }
+  //! Return the replay position, for nesting
+  Mark replay_position() const noexcept {
+    return Mark{next_decision_, next_cached_};
+  }
+  //! The next decision in replay order
+  int next_decision() noexcept {
+    assert(next_decision_ < decisions_.size());
+    return decisions_[next_decision_++];
+  }
+  //! The next stashed rule result in replay order
+  Cached next_cached() noexcept {
+    assert(next_cached_ < cached_.size());
+    return std::move(cached_[next_cached_++]);
+  }
+
+private:
+  std::vector<int> decisions_;
+  std::vector<Cached> cached_;
+  std::size_t next_decision_, next_cached_;
+};
+
+//! Invoke f(x) for the idx'th element x of a tuple
+/*! This is used by the build pass of Alternatives_Parser to get to the parser
+    that the recognizer selected. */
+template <typename Tuple, typename F>
+inline void visit_at(Tuple const &t, int const idx, F &&f) {
+  std::apply(
+      [idx, &f](auto const &... xs) {
+        int i = 0;
+        (void)((i++ == idx ? (f(xs), true) : false) || ...);
+      },
+      t);
+}
+
+} // namespace details_
+} // namespace FLPR
+
+#endif
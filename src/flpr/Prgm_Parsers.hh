@@ -16,11 +16,19 @@
 
 #include "flpr/LL_Stmt.hh"
 #include "flpr/Label_Stack.hh"
+#include "flpr/Parallel_For.hh"
 #include "flpr/Parser_Result.hh"
+#include "flpr/Parser_Trace.hh"
 #include "flpr/Prgm_Tree.hh"
+#include "flpr/Stmt_Shape_Cache.hh"
 #include "flpr/Tree.hh"
 #include "flpr/parse_stmt.hh"
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
+#include <map>
+#include <type_traits>
+#include <vector>
 
 #define FLPR_TRACE_PG 0
 
@@ -29,6 +37,20 @@ namespace FLPR {
 //! All of the parser information for program-level constructs
 namespace Prgm {
 
+//! A stretch of statements skipped by Parsers::program_recover()
+struct Failed_Range {
+  //! The skipped statements, which are wrapped in a PG_SYNTAX_ERROR node
+  SL_Range<LL_Stmt> stmts;
+  //! The first statement that could not be matched (nullptr: end of stream)
+  LL_Stmt const *fail_stmt{nullptr};
+  //! The construct that was being parsed at fail_stmt
+  int fail_syntag{Syntax_Tags::UNKNOWN};
+  //! What the skipped statements would have formed
+  /*! This is the construct or contained subprogram that enclosed fail_stmt,
+      or PG_PROGRAM_UNIT when the whole program-unit was skipped. */
+  int skipped_syntag{Syntax_Tags::PG_PROGRAM_UNIT};
+};
+
 //! The parsers that organize statements into program structures
 /*! This is a wrapper for a bunch of static functions, used so that the client
   can extend the \c Node_Data type or provide an alternative \c Stmt_Src */
@@ -50,8 +72,153 @@ template <typename Node_Data = Prgm_Node_Data> struct Parsers {
         : stmt_range_(ll_stmt_range), ss{stmt_range_} {}
     SL_Range_Iterator<LL_Stmt> ss;
     Label_Stack do_label_stack;
+
+    //! If true, only recognize the input (see Parsers::check())
+    bool check_only{false};
+    //! If true, syntax errors are recorded but not reported to std::cerr
+    bool quiet{false};
+    //! If false, only record the syntag of each matched LL_Stmt
+    /*! The Stmt_Tree of each statement is discarded after classification,
+        and gets rebuilt on demand by LL_Stmt::stmt_tree(). */
+    bool keep_stmt_trees{true};
+    //! The construct being parsed at the first syntax error, else UNKNOWN
+    int fail_syntag{Syntax_Tags::UNKNOWN};
+    //! The statement at the first syntax error (nullptr: end of stream)
+    LL_Stmt const *fail_stmt{nullptr};
+
+    //! The maximum amount of parser work (0: unlimited)
+    /*! Each statement parser invocation costs one unit, as does each
+        TT_Stream rewind inside the statement parsers, and each alternative
+        that the program parsers try and back out of. */
+    std::size_t work_budget{0};
+    //! The units of parser work so far
+    std::size_t work_done{0};
+    //! Set when work_budget has run out, which forces the parse to fail
+    bool budget_exhausted{false};
+
+    //! The statements skipped by program_recover(), in order
+    std::vector<Failed_Range> failed_ranges;
+
+    //! A range that program_recover() matches as a PG_SYNTAX_ERROR node
+    struct Skip_Region {
+      //! One past the last statement of the range
+      LL_STMT_SEQ::iterator end;
+      //! The construct or subprogram that the range is matched in place of
+      int syntag;
+    };
+    //! The ranges being skipped by program_recover(), by first statement
+    std::map<LL_Stmt const *, Skip_Region> skip_regions;
+
+    //! The extension statement parsers (nullptr: Stmt::get_parser_exts())
+    Stmt::Parser_Exts const *parser_exts{nullptr};
+
+    //! Return true if a syntax error has been recorded
+    constexpr bool failed() const noexcept {
+      return fail_syntag != Syntax_Tags::UNKNOWN;
+    }
+    //! Record a syntax error at the current statement while parsing syntag
+    /*! As the statement stream never moves backwards, a failure at a new
+        position supersedes the one recorded. Failures of enclosing constructs
+        at the same position are ignored, so the innermost construct is the
+        one that gets reported. */
+    void note_failure(int const syntag) noexcept {
+      LL_Stmt const *const curr = ss ? &(*ss) : nullptr;
+      if (!failed() || curr != fail_stmt) {
+        fail_syntag = syntag;
+        fail_stmt = curr;
+      }
+    }
+
+    //! Charge for a statement parser invocation
+    /*! The rewinds and backtracks since the last charge are charged along
+        with it.  Returns false if the budget has run out, in which case the
+        caller should fail without consuming anything. */
+    bool charge_work() noexcept {
+      std::size_t const rewinds = TT_Stream::num_rewinds();
+      if (!counting_rewinds_) {
+        counting_rewinds_ = true;
+        rewinds_seen_ = rewinds;
+      }
+      std::size_t const units = 1 + backtracks_ + (rewinds - rewinds_seen_);
+      rewinds_seen_ = rewinds;
+      backtracks_ = 0;
+      if (work_budget && work_done + units > work_budget) {
+        work_done = work_budget;
+        budget_exhausted = true;
+        return false;
+      }
+      work_done += units;
+      return true;
+    }
+    //! Note that an alternative failed, to be charged with the next parse
+    void charge_backtrack() noexcept { backtracks_ += 1; }
+
+  private:
+    std::size_t rewinds_seen_{0}, backtracks_{0};
+    bool counting_rewinds_{false};
   };
 
+  //! Check the syntax of a program without building or retaining any trees
+  /*! The same grammar as program() is applied, but only the recognizer pass
+      of the combinators is run, no Prgm_Tree is built, and no Stmt_Trees are
+      attached to the LL_Stmts.  Returns true if the statements form a valid
+      program.  Otherwise, state.fail_stmt and state.fail_syntag describe the
+      first statement that could not be matched. */
+  static bool check(State &state);
+
+  //! Parse a program, parsing its program-units concurrently
+  /*! The statements are split into top-level program-units with
+      split_program_units(), and each unit is parsed by program_unit() with its
+      own State on one of up to num_threads threads.  The units are then
+      grafted under one PG_PROGRAM root, giving the same tree as program().
+
+      Each unit must parse as exactly one program-unit, which also validates
+      the split.  If the split is ambiguous, any unit fails, or the state is
+      checking syntax or has a work budget, this falls back to program(state),
+      so diagnostics are the same as for a serial parse.  An exception thrown
+      while parsing a unit (e.g. by a statement parser extension) is rethrown
+      here, after the other units stop (see parallel_for()). */
+  static PP_Result program_parallel(State &state, unsigned num_threads);
+
+  //! Parse a program, skipping over the constructs with syntax errors
+  /*! Each program-unit is parsed as in program().  When one fails, the
+      innermost construct or contained subprogram around the error is
+      skipped: its statements, from the opening statement through the
+      matching end statement, are matched as a PG_SYNTAX_ERROR node of
+      UNKNOWN statement leaves in its place, and the unit is parsed again.
+      If the unit still fails at the same place, the next enclosing construct
+      is skipped instead.  When there's nothing left to skip inside the unit,
+      the statements from its start up to the next top-level unit-opening
+      statement (see split_program_units()) are skipped as a whole.
+
+      Each skipped range is recorded in state.failed_ranges.  The skipped
+      statements lose any Stmt_Trees attached during the failed attempts.
+
+      This matches (giving a partial tree) unless the work budget runs out.
+      state.fail_stmt and state.fail_syntag describe the first error. */
+  static PP_Result program_recover(State &state);
+
+  //! The signature of the rules that make up the program grammar
+  using Rule = PP_Result (*)(State &);
+
+  //! Return the rule that parses a construct on its own, or nullptr
+  /*! This is used to re-parse one node of a Prgm_Tree over its statement
+      range.  Only constructs that are delimited by their own statements are
+      included: not, for example, execution-part (which depends on what
+      follows it) or do-construct (which may share a terminal statement with
+      an enclosing label-do). */
+  static Rule construct_rule(int syntag);
+
+  //! Find the statement ranges of the top-level program-units
+  /*! This is a cheap pre-pass that matches unit-opening statements (program,
+      module, subroutine and function statements) against the end statements
+      that close them, counting nesting depth for the module and internal
+      subprograms and interface bodies.  Returns false if the remaining
+      statements of state can't be split this way, e.g. when a main program
+      has no program-stmt, or for submodules and block data. */
+  static bool split_program_units(State &state,
+                                  std::vector<SL_Range<LL_Stmt>> &units);
+
   static PP_Result associate_construct(State &state);
   static PP_Result block(State &state);
   static PP_Result block_construct(State &state);
@@ -95,6 +262,17 @@ template <typename Node_Data = Prgm_Node_Data> struct Parsers {
   static PP_Result where_construct(State &state);
 
 #include "Prgm_Parsers_utils.hh"
+
+private:
+  static int unit_nesting_(LL_Stmt &stmt);
+  static LL_STMT_SEQ::iterator resync_point_(LL_STMT_SEQ::iterator unit_begin,
+                                             LL_STMT_SEQ::iterator fail_pos,
+                                             LL_STMT_SEQ::iterator end);
+  static int block_nesting_(LL_Stmt &stmt, int &syntag);
+  static constexpr bool closes_(int end_syntag, int open_syntag) noexcept;
+  static bool skip_enclosing_(State &state, LL_STMT_SEQ::iterator unit_begin,
+                              std::size_t unit_failures);
+  static PP_Result skip_region_(State &state, int context);
 };
 
 #include "Prgm_Parsers_impl.hh"
@@ -103,6 +103,8 @@ PPARSER(declaration_construct) {
          STMT(data_stmt),
          STMT(format_stmt),
          STMT(entry_stmt));
+  if (auto skipped = skip_region_(state, rule_tag); skipped.match)
+    return skipped;
   EVAL(PG_DECLARATION_CONSTRUCT, p(state));
 }
 
@@ -166,6 +168,8 @@ PPARSER(executable_construct) {
      that we are looking for, we force a non-match so that the end-do-stmt rule
      can look at it */
   if(state.do_label_stack.is_top(state.ss->label())) return PP_Result{};
+  if (auto skipped = skip_region_(state, rule_tag); skipped.match)
+    return skipped;
   EVAL(PG_EXECUTABLE_CONSTRUCT, p(state));
 }
 
@@ -325,6 +329,8 @@ PPARSER(internal_subprogram) {
   constexpr auto p = alts(rule_tag,
                           function_subprogram,
                           subroutine_subprogram);
+  if (auto skipped = skip_region_(state, rule_tag); skipped.match)
+    return skipped;
   EVAL(PG_INTERNAL_SUBPROGRAM, p(state));
 }
 
@@ -377,6 +383,8 @@ PPARSER(module_subprogram) {
          function_subprogram,
          subroutine_subprogram,
          separate_module_subprogram);
+  if (auto skipped = skip_region_(state, rule_tag); skipped.match)
+    return skipped;
   EVAL(PG_MODULE_SUBPROGRAM, p(state));
 }
 
@@ -407,6 +415,488 @@ PPARSER(program) {
   EVAL(PG_PROGRAM, p(state));
 }
 
+template <typename Node_Data>
+bool Parsers<Node_Data>::check(State &state) {
+  bool const save_check_only = state.check_only;
+  state.check_only = true;
+  bool const match = program(state).match;
+  state.check_only = save_check_only;
+  return match;
+}
+
+template <typename Node_Data>
+auto Parsers<Node_Data>::program_parallel(State &state,
+                                          unsigned const num_threads)
+    -> PP_Result {
+  std::vector<SL_Range<LL_Stmt>> units;
+  if (num_threads < 2 || state.check_only || state.work_budget ||
+      !split_program_units(state, units) || units.size() < 2)
+    return program(state);
+
+  std::vector<PP_Result> results(units.size());
+  std::vector<std::size_t> work(units.size(), 0);
+  parallel_for(units.size(), num_threads, [&](std::size_t const i) {
+    State unit_state(units[i]);
+    unit_state.keep_stmt_trees = state.keep_stmt_trees;
+    unit_state.parser_exts = state.parser_exts;
+    unit_state.quiet = true;
+    results[i] = program_unit(unit_state);
+    work[i] = unit_state.work_done;
+    /* the unit must account for the entire slice */
+    if (unit_state.ss)
+      results[i].match = false;
+  });
+
+  for (auto const &r : results)
+    if (!r.match)
+      return program(state);
+
+  Prgm_Tree root(TAG(PG_PROGRAM));
+  for (std::size_t i = 0; i < units.size(); ++i) {
+    hoist_back(root, std::move(results[i].parse_tree));
+    state.work_done += work[i];
+  }
+  cover_branches(*root);
+  while (state.ss)
+    state.ss.advance();
+  return PP_Result{std::move(root), true};
+}
+
+template <typename Node_Data>
+auto Parsers<Node_Data>::program_recover(State &state) -> PP_Result {
+  if (!state.ss)
+    return program(state);
+
+  Prgm_Tree root(TAG(PG_PROGRAM));
+  while (state.ss) {
+    LL_STMT_SEQ::iterator const unit_begin = state.ss.iter();
+    std::size_t const unit_failures = state.failed_ranges.size();
+    LL_Stmt const *unit_fail_stmt{nullptr};
+    int unit_fail_syntag{Syntax_Tags::UNKNOWN};
+    PP_Result unit;
+    for (;;) {
+      state.fail_syntag = Syntax_Tags::UNKNOWN;
+      state.fail_stmt = nullptr;
+      unit = program_unit(state);
+      if (unit.match || state.budget_exhausted)
+        break;
+      if (state.failed_ranges.size() == unit_failures) {
+        unit_fail_stmt = state.fail_stmt;
+        unit_fail_syntag = state.fail_syntag;
+      }
+      /* Try again with the construct around the error skipped */
+      if (!skip_enclosing_(state, unit_begin, unit_failures))
+        break;
+      state.do_label_stack = Label_Stack{};
+      SL_Range<LL_Stmt> rest{unit_begin, state.ss.end()};
+      state.ss = SL_Range_Iterator<LL_Stmt>{rest};
+    }
+    state.skip_regions.clear();
+    if (unit.match) {
+      hoist_back(root, std::move(unit.parse_tree));
+      continue;
+    }
+    if (state.budget_exhausted)
+      return PP_Result{};
+
+    /* Skip ahead to the next program-unit */
+    state.failed_ranges.erase(
+        std::next(state.failed_ranges.begin(), unit_failures),
+        state.failed_ranges.end());
+    LL_STMT_SEQ::iterator const resume =
+        resync_point_(unit_begin, state.ss.iter(), state.ss.end());
+    Prgm_Tree skipped(TAG(PG_SYNTAX_ERROR));
+    for (auto it = unit_begin; it != resume; ++it) {
+      it->reset_stmt_tree();
+      hoist_back(skipped, Prgm_Tree{TAG(UNKNOWN), it});
+    }
+    cover_branches(*skipped);
+    hoist_back(root, std::move(skipped));
+    state.failed_ranges.push_back(
+        Failed_Range{SL_Range<LL_Stmt>{unit_begin, resume}, unit_fail_stmt,
+                     unit_fail_syntag, TAG(PG_PROGRAM_UNIT)});
+
+    state.do_label_stack = Label_Stack{};
+    while (state.ss && state.ss.iter() != resume)
+      state.ss.advance();
+  }
+  if (state.failed_ranges.empty()) {
+    state.fail_syntag = Syntax_Tags::UNKNOWN;
+    state.fail_stmt = nullptr;
+  } else {
+    state.fail_syntag = state.failed_ranges.front().fail_syntag;
+    state.fail_stmt = state.failed_ranges.front().fail_stmt;
+  }
+  cover_branches(*root);
+  return PP_Result{std::move(root), true};
+}
+
+/* After the program-unit starting at unit_begin has failed, find the
+   innermost construct or contained subprogram open at the error that isn't
+   already being skipped, and add it to state.skip_regions and
+   state.failed_ranges.  Skipped ranges that it contains (recorded since
+   unit_failures) are dropped.  Returns false if there is no such construct
+   with a matching end statement in the unit. */
+template <typename Node_Data>
+bool Parsers<Node_Data>::skip_enclosing_(State &state,
+                                         LL_STMT_SEQ::iterator const unit_begin,
+                                         std::size_t const unit_failures) {
+  LL_STMT_SEQ::iterator const unit_end =
+      resync_point_(unit_begin, state.ss.iter(), state.ss.end());
+  LL_STMT_SEQ::iterator fail_pos = state.ss.iter();
+  for (auto it = unit_begin; it != unit_end; ++it)
+    if (&*it == state.fail_stmt) {
+      fail_pos = it;
+      break;
+    }
+
+  /* An end statement closes the innermost open block that it matches, along
+     with anything left open inside of that */
+  using Open_Block = std::pair<LL_STMT_SEQ::iterator, int>;
+  auto const close = [](std::vector<Open_Block> &open, int const end_syntag) {
+    for (std::size_t i = open.size(); i-- > 0;)
+      if (closes_(end_syntag, open[i].second)) {
+        open.resize(i);
+        return;
+      }
+  };
+  auto const track = [&close](std::vector<Open_Block> &open,
+                              LL_STMT_SEQ::iterator const it) {
+    int syntag;
+    int const nesting = block_nesting_(*it, syntag);
+    if (nesting > 0)
+      open.emplace_back(it, syntag);
+    else if (nesting < 0)
+      close(open, syntag);
+  };
+
+  std::vector<Open_Block> open;
+  for (auto it = unit_begin; it != fail_pos && it != unit_end; ++it)
+    track(open, it);
+
+  while (!open.empty()) {
+    Open_Block const candidate = open.back();
+    open.pop_back();
+    if (candidate.first == unit_begin)
+      break;
+    if (state.skip_regions.count(&*candidate.first))
+      continue;
+    std::vector<Open_Block> inner{candidate};
+    auto it = std::next(candidate.first);
+    for (; it != unit_end; ++it) {
+      track(inner, it);
+      if (inner.empty())
+        break;
+    }
+    if (it == unit_end)
+      continue;
+    LL_STMT_SEQ::iterator const region_end = std::next(it);
+
+    std::vector<LL_Stmt const *> subsumed;
+    for (auto jt = candidate.first; jt != region_end; ++jt)
+      if (state.skip_regions.erase(&*jt))
+        subsumed.push_back(&*jt);
+    state.failed_ranges.erase(
+        std::remove_if(std::next(state.failed_ranges.begin(), unit_failures),
+                       state.failed_ranges.end(),
+                       [&subsumed](Failed_Range const &r) {
+                         return std::find(subsumed.begin(), subsumed.end(),
+                                          &r.stmts.front()) != subsumed.end();
+                       }),
+        state.failed_ranges.end());
+
+    state.skip_regions.emplace(
+        &*candidate.first,
+        typename State::Skip_Region{region_end, candidate.second});
+    state.failed_ranges.push_back(Failed_Range{
+        SL_Range<LL_Stmt>{candidate.first, region_end}, state.fail_stmt,
+        state.fail_syntag, candidate.second});
+    return true;
+  }
+  return false;
+}
+
+/* If the current statement starts one of state.skip_regions, and the
+   construct that it stands in for is parsed by the context rule, match the
+   whole range as a PG_SYNTAX_ERROR node */
+template <typename Node_Data>
+auto Parsers<Node_Data>::skip_region_(State &state, int const context)
+    -> PP_Result {
+  if (state.skip_regions.empty() || !state.ss)
+    return PP_Result{};
+  auto const found = state.skip_regions.find(&*state.ss);
+  if (found == state.skip_regions.end())
+    return PP_Result{};
+  switch (found->second.syntag) {
+  case TAG(PG_DERIVED_TYPE_DEF):
+  case TAG(PG_ENUM_DEF):
+  case TAG(PG_INTERFACE_BLOCK):
+    if (context != TAG(PG_DECLARATION_CONSTRUCT))
+      return PP_Result{};
+    break;
+  case TAG(PG_FUNCTION_SUBPROGRAM):
+  case TAG(PG_SUBROUTINE_SUBPROGRAM):
+    if (context != TAG(PG_INTERNAL_SUBPROGRAM) &&
+        context != TAG(PG_MODULE_SUBPROGRAM))
+      return PP_Result{};
+    break;
+  case TAG(PG_SEPARATE_MODULE_SUBPROGRAM):
+    if (context != TAG(PG_MODULE_SUBPROGRAM))
+      return PP_Result{};
+    break;
+  default:
+    if (context != TAG(PG_EXECUTABLE_CONSTRUCT))
+      return PP_Result{};
+  }
+
+  LL_STMT_SEQ::iterator const end = found->second.end;
+  Prgm_Tree skipped(TAG(PG_SYNTAX_ERROR));
+  while (state.ss && state.ss.iter() != end) {
+    state.ss->reset_stmt_tree();
+    hoist_back(skipped, Prgm_Tree{TAG(UNKNOWN), state.ss.iter()});
+    state.ss.advance();
+  }
+  cover_branches(*skipped);
+  return PP_Result{std::move(skipped), true};
+}
+
+/* Find where to resume parsing after the program-unit starting at unit_begin
+   failed at fail_pos: the first top-level unit-opening statement after both,
+   or end.  Nesting depth is counted from unit_begin, so that the units and
+   subprograms nested in the failed one are skipped too. */
+template <typename Node_Data>
+LL_STMT_SEQ::iterator
+Parsers<Node_Data>::resync_point_(LL_STMT_SEQ::iterator const unit_begin,
+                                  LL_STMT_SEQ::iterator const fail_pos,
+                                  LL_STMT_SEQ::iterator const end) {
+  bool past_fail = (fail_pos == unit_begin);
+  int depth = 0;
+  for (auto it = unit_begin; it != end; ++it) {
+    if (it == fail_pos)
+      past_fail = true;
+    int const nesting = unit_nesting_(*it);
+    if (depth == 0 && nesting == 1 && it != unit_begin && past_fail)
+      return it;
+    depth = std::max(depth + nesting, 0);
+  }
+  return end;
+}
+
+template <typename Node_Data>
+auto Parsers<Node_Data>::construct_rule(int const syntag) -> Rule {
+  switch (syntag) {
+  case TAG(PG_ASSOCIATE_CONSTRUCT):
+    return associate_construct;
+  case TAG(PG_BLOCK_CONSTRUCT):
+    return block_construct;
+  case TAG(PG_CASE_CONSTRUCT):
+    return case_construct;
+  case TAG(PG_DERIVED_TYPE_DEF):
+    return derived_type_def;
+  case TAG(PG_ENUM_DEF):
+    return enum_def;
+  case TAG(PG_FORALL_CONSTRUCT):
+    return forall_construct;
+  case TAG(PG_FUNCTION_SUBPROGRAM):
+    return function_subprogram;
+  case TAG(PG_IF_CONSTRUCT):
+    return if_construct;
+  case TAG(PG_INTERFACE_BLOCK):
+    return interface_block;
+  case TAG(PG_MAIN_PROGRAM):
+    return main_program;
+  case TAG(PG_MODULE):
+    return module;
+  case TAG(PG_PROGRAM_UNIT):
+    return program_unit;
+  case TAG(PG_SELECT_RANK_CONSTRUCT):
+    return select_rank_construct;
+  case TAG(PG_SELECT_TYPE_CONSTRUCT):
+    return select_type_construct;
+  case TAG(PG_SEPARATE_MODULE_SUBPROGRAM):
+    return separate_module_subprogram;
+  case TAG(PG_SUBROUTINE_SUBPROGRAM):
+    return subroutine_subprogram;
+  case TAG(PG_WHERE_CONSTRUCT):
+    return where_construct;
+  default:
+    break;
+  }
+  return nullptr;
+}
+
+template <typename Node_Data>
+bool Parsers<Node_Data>::split_program_units(
+    State &state, std::vector<SL_Range<LL_Stmt>> &units) {
+  units.clear();
+  if (!state.ss)
+    return false;
+  auto const end = state.ss.end();
+  auto unit_begin = end;
+  int depth = 0;
+  for (auto it = state.ss.iter(); it != end; ++it) {
+    int const nesting = unit_nesting_(*it);
+    if (depth == 0) {
+      /* Anything other than a unit-opening statement at the top level (e.g. a
+         main-program without a program-stmt) is left to program() */
+      if (nesting != 1)
+        return false;
+      unit_begin = it;
+    }
+    depth += nesting;
+    if (depth == 0)
+      units.emplace_back(unit_begin, std::next(it));
+  }
+  return depth == 0;
+}
+
+/* Return 1 if stmt opens a program-unit or subprogram, -1 if it could end
+   one, and 0 otherwise.  The keyword checks keep the statement parsers off of
+   the bulk of the statements. */
+template <typename Node_Data>
+int Parsers<Node_Data>::unit_nesting_(LL_Stmt &stmt) {
+  if (stmt.empty())
+    return 0;
+  auto matches = [&stmt](Stmt::Shape_Cache::parser_function f) {
+    TT_Stream ts(stmt);
+    return static_cast<bool>(f(ts));
+  };
+  int const first = stmt.begin()->token;
+  if (first == TAG(KW_END)) {
+    if (matches(Stmt::end_subroutine_stmt) ||
+        matches(Stmt::end_function_stmt) || matches(Stmt::end_module_stmt) ||
+        matches(Stmt::end_program_stmt))
+      return -1;
+    return 0;
+  }
+  if (first == TAG(KW_PROGRAM) && matches(Stmt::program_stmt))
+    return 1;
+  if (first == TAG(KW_MODULE) && matches(Stmt::module_stmt))
+    return 1;
+  for (auto const &tok : stmt) {
+    if (tok.token == TAG(KW_SUBROUTINE))
+      return matches(Stmt::subroutine_stmt) ? 1 : 0;
+    if (tok.token == TAG(KW_FUNCTION))
+      return matches(Stmt::function_stmt) ? 1 : 0;
+  }
+  return 0;
+}
+
+/* Return 1 if stmt opens a construct or subprogram that is closed by an end
+   statement, -1 if it is one of those end statements, and 0 otherwise.
+   syntag is set to the construct, for closes_().  A bare "end" gets
+   PG_PROGRAM_UNIT. */
+template <typename Node_Data>
+int Parsers<Node_Data>::block_nesting_(LL_Stmt &stmt, int &syntag) {
+  syntag = TAG(UNKNOWN);
+  if (stmt.empty())
+    return 0;
+  struct Block_Stmt {
+    int keyword;
+    Stmt::Shape_Cache::parser_function f;
+    int syntag;
+  };
+  static Block_Stmt const block_stmts[] = {
+      {TAG(KW_IF), Stmt::if_then_stmt, TAG(PG_IF_CONSTRUCT)},
+      {TAG(KW_DO), Stmt::nonlabel_do_stmt, TAG(PG_DO_CONSTRUCT)},
+      {TAG(KW_SELECT), Stmt::select_case_stmt, TAG(PG_CASE_CONSTRUCT)},
+      {TAG(KW_SELECT), Stmt::select_type_stmt, TAG(PG_SELECT_TYPE_CONSTRUCT)},
+      {TAG(KW_SELECT), Stmt::select_rank_stmt, TAG(PG_SELECT_RANK_CONSTRUCT)},
+      {TAG(KW_ASSOCIATE), Stmt::associate_stmt, TAG(PG_ASSOCIATE_CONSTRUCT)},
+      {TAG(KW_BLOCK), Stmt::block_stmt, TAG(PG_BLOCK_CONSTRUCT)},
+      {TAG(KW_WHERE), Stmt::where_construct_stmt, TAG(PG_WHERE_CONSTRUCT)},
+      {TAG(KW_FORALL), Stmt::forall_construct_stmt, TAG(PG_FORALL_CONSTRUCT)},
+      {TAG(KW_TYPE), Stmt::derived_type_stmt, TAG(PG_DERIVED_TYPE_DEF)},
+      {TAG(KW_INTERFACE), Stmt::interface_stmt, TAG(PG_INTERFACE_BLOCK)},
+      {TAG(KW_ABSTRACT), Stmt::interface_stmt, TAG(PG_INTERFACE_BLOCK)},
+      {TAG(KW_ENUM), Stmt::enum_def_stmt, TAG(PG_ENUM_DEF)},
+      {TAG(KW_MODULE), Stmt::module_stmt, TAG(PG_MODULE)},
+      {TAG(KW_MODULE), Stmt::mp_subprogram_stmt,
+       TAG(PG_SEPARATE_MODULE_SUBPROGRAM)},
+      {TAG(KW_PROGRAM), Stmt::program_stmt, TAG(PG_MAIN_PROGRAM)}};
+  static Block_Stmt const end_stmts[] = {
+      {TAG(KW_END), Stmt::end_if_stmt, TAG(PG_IF_CONSTRUCT)},
+      {TAG(KW_END), Stmt::end_do_stmt, TAG(PG_DO_CONSTRUCT)},
+      {TAG(KW_END), Stmt::end_select_stmt, TAG(PG_CASE_CONSTRUCT)},
+      {TAG(KW_END), Stmt::end_associate_stmt, TAG(PG_ASSOCIATE_CONSTRUCT)},
+      {TAG(KW_END), Stmt::end_block_stmt, TAG(PG_BLOCK_CONSTRUCT)},
+      {TAG(KW_END), Stmt::end_where_stmt, TAG(PG_WHERE_CONSTRUCT)},
+      {TAG(KW_END), Stmt::end_forall_stmt, TAG(PG_FORALL_CONSTRUCT)},
+      {TAG(KW_END), Stmt::end_type_stmt, TAG(PG_DERIVED_TYPE_DEF)},
+      {TAG(KW_END), Stmt::end_interface_stmt, TAG(PG_INTERFACE_BLOCK)},
+      {TAG(KW_END), Stmt::end_enum_stmt, TAG(PG_ENUM_DEF)},
+      {TAG(KW_END), Stmt::end_subroutine_stmt, TAG(PG_SUBROUTINE_SUBPROGRAM)},
+      {TAG(KW_END), Stmt::end_function_stmt, TAG(PG_FUNCTION_SUBPROGRAM)},
+      {TAG(KW_END), Stmt::end_mp_subprogram_stmt,
+       TAG(PG_SEPARATE_MODULE_SUBPROGRAM)},
+      {TAG(KW_END), Stmt::end_module_stmt, TAG(PG_MODULE)},
+      {TAG(KW_END), Stmt::end_program_stmt, TAG(PG_MAIN_PROGRAM)}};
+
+  auto matches = [&stmt](Stmt::Shape_Cache::parser_function f) {
+    TT_Stream ts(stmt);
+    return static_cast<bool>(f(ts));
+  };
+  auto first = stmt.begin();
+  /* Look past a construct-name */
+  if (first->token == TAG(TK_NAME) && std::next(first) != stmt.end() &&
+      std::next(first)->token == TAG(TK_COLON))
+    std::advance(first, 2);
+  if (first == stmt.end())
+    return 0;
+
+  if (first->token == TAG(KW_END)) {
+    if (std::next(first) == stmt.end()) {
+      syntag = TAG(PG_PROGRAM_UNIT);
+      return -1;
+    }
+    for (auto const &b : end_stmts)
+      if (matches(b.f)) {
+        syntag = b.syntag;
+        return -1;
+      }
+    return 0;
+  }
+  for (auto const &b : block_stmts)
+    if (b.keyword == first->token && matches(b.f)) {
+      syntag = b.syntag;
+      return 1;
+    }
+  for (auto const &tok : stmt) {
+    if (tok.token == TAG(KW_SUBROUTINE)) {
+      syntag = TAG(PG_SUBROUTINE_SUBPROGRAM);
+      return matches(Stmt::subroutine_stmt) ? 1 : 0;
+    }
+    if (tok.token == TAG(KW_FUNCTION)) {
+      syntag = TAG(PG_FUNCTION_SUBPROGRAM);
+      return matches(Stmt::function_stmt) ? 1 : 0;
+    }
+  }
+  return 0;
+}
+
+/* Return true if an end statement classified as end_syntag by
+   block_nesting_() closes the block opened as open_syntag */
+template <typename Node_Data>
+constexpr bool Parsers<Node_Data>::closes_(int const end_syntag,
+                                           int const open_syntag) noexcept {
+  if (end_syntag == open_syntag)
+    return true;
+  switch (end_syntag) {
+  case TAG(PG_CASE_CONSTRUCT):
+    return open_syntag == TAG(PG_SELECT_TYPE_CONSTRUCT) ||
+           open_syntag == TAG(PG_SELECT_RANK_CONSTRUCT);
+  case TAG(PG_PROGRAM_UNIT):
+    return open_syntag == TAG(PG_SUBROUTINE_SUBPROGRAM) ||
+           open_syntag == TAG(PG_FUNCTION_SUBPROGRAM) ||
+           open_syntag == TAG(PG_SEPARATE_MODULE_SUBPROGRAM) ||
+           open_syntag == TAG(PG_MODULE) ||
+           open_syntag == TAG(PG_MAIN_PROGRAM);
+  default:
+    break;
+  }
+  return false;
+}
+
 //! R502: program-unit (5.1)
 PPARSER(program_unit) {
   RULE(PG_PROGRAM_UNIT);
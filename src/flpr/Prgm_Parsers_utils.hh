@@ -79,21 +79,139 @@ static void cover_branches(typename Prgm_Tree::reference node) {
   }
 }
 
+/*************************** RECOGNIZE-THEN-BUILD ****************************/
+
+//! The trace used by the Prgm recognizer pass
+/*! The only cached entries are Prgm_Trees for parser functions (which are
+    opaque to the recognizer) and for matched statements. */
+using PP_Trace = FLPR::details_::Parser_Trace<Prgm_Tree>;
+
+//! Return the (per-thread) trace for the Prgm recognizer pass
+static PP_Trace &pp_trace() {
+  static thread_local PP_Trace trace;
+  return trace;
+}
+
+//! Eagerly apply parser p, which may be a combinator or parser function
+template <typename P> static PP_Result parse_(P const &p, State &state) {
+  if constexpr (std::is_class_v<P>)
+    return p.parse(state);
+  else
+    return p(state);
+}
+
+//! Run the recognizer pass of parser p
+/*! Parser functions are evaluated directly, and their (already built) result
+    is stashed in the trace. */
+template <typename P>
+static bool recognize_(P const &p, State &state, PP_Trace &trace) {
+  if constexpr (std::is_class_v<P>) {
+    return p.recognize(state, trace);
+  } else {
+    auto [pt, match] = p(state);
+    if (match)
+      trace.push_cached(std::move(pt));
+    return match;
+  }
+}
+
+//! Run the build pass of parser p
+template <typename P> static Prgm_Tree build_(P const &p, PP_Trace &trace) {
+  if constexpr (std::is_class_v<P>)
+    return p.build(trace);
+  else
+    return trace.next_cached();
+}
+
+//! Run the recognizer pass of p, then build along the winning path
+/*! Note that, as with the eager parsers, the Prgm parsers do not rewind the
+    statement stream on failure: the recognizer pass leaves state.ss where
+    parse() would have. */
+template <typename P>
+static PP_Result recognize_then_build(P const &p, State &state) {
+  PP_Trace &trace = pp_trace();
+  auto const frame = trace.mark();
+  if (!p.recognize(state, trace)) {
+    trace.rewind(frame);
+    return PP_Result{};
+  }
+  auto const hold = trace.replay_position();
+  trace.replay(frame);
+  Prgm_Tree pt = p.build(trace);
+  trace.replay(hold);
+  trace.rewind(frame);
+  return PP_Result{std::move(pt), true};
+}
+
+//! Run only the recognizer pass of p, returning an empty tree
+/*! This is used when state.check_only is set. */
+template <typename P>
+static PP_Result recognize_only(P const &p, State &state) {
+  PP_Trace &trace = pp_trace();
+  auto const frame = trace.mark();
+  bool const match = p.recognize(state, trace);
+  trace.rewind(frame);
+  return PP_Result{Prgm_Tree{}, match};
+}
+
+//! Attach a Stmt_Tree to its LL_Stmt, unless only checking syntax
+/*! If the State doesn't keep statement trees, only the classification (the
+    syntag) of the statement is retained, and a tree rebuilt later can be
+    released again (see LL_Stmt::release_stmt_tree()). */
+static void attach_stmt_tree(State const &state,
+                             FLPR::LL_STMT_SEQ::iterator ll_stmt_it,
+                             FLPR::Stmt::Stmt_Tree &&st) {
+  if (state.check_only)
+    return;
+  ll_stmt_it->set_stmt_tree(std::move(st));
+  ll_stmt_it->set_keep_stmt_tree(state.keep_stmt_trees);
+  if (!state.keep_stmt_trees)
+    ll_stmt_it->drop_stmt_tree();
+}
+
+//! Report that the current statement doesn't fit the construct syntag
+static void report_failure(State &state, int const syntag) {
+  state.note_failure(syntag);
+  if (state.check_only || state.quiet || state.budget_exhausted)
+    return;
+  std::cerr << "Unrecognized statement\n";
+  state.ss->print_me(std::cerr, false) << "\nwhile parsing ";
+  FLPR::Syntax_Tags::print(std::cerr, syntag) << std::endl;
+}
+
+//! Common base for the combinators
+/*! Each combinator provides parse(state), recognize(state, trace), and
+    build(trace), with the same meaning as in Stmt::SP_Combinator. */
+template <typename Derived> class PP_Combinator {
+public:
+  PP_Result operator()(State &state) const {
+    Derived const &self = static_cast<Derived const &>(*this);
+    if (state.check_only)
+      return recognize_only(self, state);
+    if (two_pass_parsing().load(std::memory_order_relaxed))
+      return recognize_then_build(self, state);
+    return self.parse(state);
+  }
+};
+
 /******************************* COMBINATORS **********************************/
 
 //! Return a result if any of the alternatives match
 /*! This "covers" the result of a matching parser with a new syntag node */
-template <typename... Ps> class Alternatives_Parser {
+template <typename... Ps>
+class Alternatives_Parser : public PP_Combinator<Alternatives_Parser<Ps...>> {
 public:
   Alternatives_Parser(Alternatives_Parser const &) = default;
   constexpr explicit Alternatives_Parser(int const syntag, Ps &&... ps) noexcept
       : syntag_{syntag}, parsers_{std::forward<Ps>(ps)...} {}
-  PP_Result operator()(State &state) const noexcept {
+  PP_Result parse(State &state) const {
     Prgm_Tree root;
     auto assign_if = [&state, &root ](auto const &p) constexpr {
-      auto [pt, match] = p(state);
+      auto [pt, match] = parse_(p, state);
       if (match) {
         root = std::move(pt);
+      } else {
+        state.charge_backtrack();
       }
       return match;
     };
@@ -112,6 +230,36 @@ public:
       cover_branches(*root);
     return PP_Result{std::move(root), false};
   }
+  bool recognize(State &state, PP_Trace &trace) const {
+    auto const slot = trace.push_decision();
+    auto const trace_rewind_point = trace.mark();
+    int idx = 0;
+    auto try_alt = [&state, &trace, &trace_rewind_point, &idx](auto const &p) {
+      if (recognize_(p, state, trace))
+        return true;
+      state.charge_backtrack();
+      trace.rewind(trace_rewind_point);
+      idx += 1;
+      return false;
+    };
+    auto fold = [&try_alt](auto const &... as) {
+      return FLPR::details_::or_fold(try_alt, as...);
+    };
+    bool const match = std::apply(fold, parsers_);
+    trace.set_decision(slot, idx);
+    return match;
+  }
+  Prgm_Tree build(PP_Trace &trace) const {
+    Prgm_Tree root;
+    FLPR::details_::visit_at(
+        parsers_, trace.next_decision(),
+        [&trace, &root](auto const &p) { root = build_(p, trace); });
+    Prgm_Tree new_root{this->syntag_};
+    hoist_back(new_root, std::move(root));
+    if (new_root)
+      cover_branches(*new_root);
+    return new_root;
+  }
 
 private:
   int const syntag_;
@@ -126,16 +274,29 @@ static constexpr Alternatives_Parser<Ps...> alts(int const syntag,
 }
 
 //! Returns true if the end of the statement stream has been reached
-class End_Of_Stream_Parser {
+class End_Of_Stream_Parser : public PP_Combinator<End_Of_Stream_Parser> {
 public:
-  PP_Result operator()(State &state) const noexcept {
+  PP_Result parse(State &state) const {
+    return PP_Result{Prgm_Tree{}, at_end_(state)};
+  }
+  bool recognize(State &state, PP_Trace &) const noexcept {
+    return at_end_(state);
+  }
+  Prgm_Tree build(PP_Trace &) const { return Prgm_Tree{}; }
+
+private:
+  bool at_end_(State &state) const noexcept {
     if (state.ss) {
+      /* Anything left over must have failed to start a new program-unit */
+      state.note_failure(Syntax_Tags::PG_PROGRAM_UNIT);
+      if (state.check_only || state.quiet || state.budget_exhausted)
+        return false;
       std::cerr << "Unrecognized statement\n";
       state.ss->print_me(std::cerr, false)
           << "\nwhen expecting end-of-stream " << std::endl;
-      return PP_Result{Prgm_Tree{}, false};
+      return false;
     }
-    return PP_Result{Prgm_Tree{}, true};
+    return true;
   }
 };
 
@@ -143,18 +304,37 @@ public:
 static constexpr auto end_stream() { return End_Of_Stream_Parser{}; }
 
 //! Forwards the Prgm_Tree of parser_, always setting match to true
-template <typename P> class Optional_Parser {
+template <typename P>
+class Optional_Parser : public PP_Combinator<Optional_Parser<P>> {
 public:
   Optional_Parser(Optional_Parser const &) = default;
   constexpr explicit Optional_Parser(P &&p) noexcept
       : parser_{std::forward<P>(p)} {}
-  PP_Result operator()(State &state) const noexcept {
-    auto [pt, match] = parser_(state);
+  PP_Result parse(State &state) const {
+    auto [pt, match] = parse_(parser_, state);
     if (pt) {
       cover_branches(*pt);
     }
     return PP_Result{std::move(pt), true};
   }
+  bool recognize(State &state, PP_Trace &trace) const {
+    auto const slot = trace.push_decision();
+    auto const trace_rewind_point = trace.mark();
+    bool const match = recognize_(parser_, state, trace);
+    if (!match)
+      trace.rewind(trace_rewind_point);
+    trace.set_decision(slot, match);
+    return true;
+  }
+  Prgm_Tree build(PP_Trace &trace) const {
+    if (!trace.next_decision())
+      return Prgm_Tree{};
+    Prgm_Tree pt = build_(parser_, trace);
+    if (pt) {
+      cover_branches(*pt);
+    }
+    return pt;
+  }
 
 private:
   P const parser_;
@@ -168,15 +348,16 @@ template <typename P> static constexpr Optional_Parser<P> opt(P &&p) noexcept {
 //! Match if all specified parsers match
 /*! On match, this returns a Stmt_Tree with a root \c syntag that covers all the
   Stmt_Trees from the sub parsers */
-template <typename... Ps> class Opt_Sequence_Parser {
+template <typename... Ps>
+class Opt_Sequence_Parser : public PP_Combinator<Opt_Sequence_Parser<Ps...>> {
 public:
   Opt_Sequence_Parser(Opt_Sequence_Parser const &) = default;
   constexpr explicit Opt_Sequence_Parser(int const syntag, Ps &&... ps) noexcept
       : syntag_{syntag}, parsers_{std::forward<Ps>(ps)...} {}
-  PP_Result operator()(State &state) const noexcept {
+  PP_Result parse(State &state) const {
     Prgm_Tree root(syntag_);
     auto attach_if = [&state, &root ](auto const &p) constexpr {
-      auto [pt, match] = p(state);
+      auto [pt, match] = parse_(p, state);
       if (pt) {
         hoist_back(root, std::move(pt));
       }
@@ -190,6 +371,46 @@ public:
       cover_branches(*root);
     return PP_Result{std::move(root), true};
   }
+  /* The decision is the number of leading parsers that matched */
+  bool recognize(State &state, PP_Trace &trace) const {
+    auto const slot = trace.push_decision();
+    int count = 0;
+    auto recognize_each = [&state, &trace, &count](auto const &p) {
+      auto const trace_rewind_point = trace.mark();
+      if (!recognize_(p, state, trace)) {
+        trace.rewind(trace_rewind_point);
+        return false;
+      }
+      count += 1;
+      return true;
+    };
+    auto fold = [&recognize_each](auto const &... as) {
+      return FLPR::details_::and_fold(recognize_each, as...);
+    };
+    std::apply(fold, parsers_);
+    trace.set_decision(slot, count);
+    return true;
+  }
+  Prgm_Tree build(PP_Trace &trace) const {
+    Prgm_Tree root(syntag_);
+    int count = trace.next_decision();
+    auto attach = [&trace, &root, &count](auto const &p) {
+      if (count-- <= 0)
+        return false;
+      Prgm_Tree pt = build_(p, trace);
+      if (pt) {
+        hoist_back(root, std::move(pt));
+      }
+      return true;
+    };
+    auto fold = [&attach](auto const &... as) {
+      return FLPR::details_::and_fold(attach, as...);
+    };
+    std::apply(fold, parsers_);
+    if (root)
+      cover_branches(*root);
+    return root;
+  }
 
 private:
   int const syntag_;
@@ -211,15 +432,15 @@ static constexpr Opt_Sequence_Parser<Ps...> h_opt_seq(Ps &&... ps) noexcept {
 }
 
 //! Kleene plus: One or more matches of the parser
-template <typename P> class Plus_Parser {
+template <typename P> class Plus_Parser : public PP_Combinator<Plus_Parser<P>> {
 public:
   Plus_Parser(Plus_Parser const &) = default;
   constexpr explicit Plus_Parser(int const syntag, P &&p) noexcept
       : syntag_{syntag}, parser_{std::forward<P>(p)} {}
-  PP_Result operator()(State &state) const noexcept {
+  PP_Result parse(State &state) const {
     Prgm_Tree root(syntag_);
     auto attach_if = [&state, &root ](auto const &p) constexpr {
-      auto [pt, match] = p(state);
+      auto [pt, match] = parse_(p, state);
       if (pt) {
         hoist_back(root, std::move(pt));
       }
@@ -233,6 +454,34 @@ public:
       cover_branches(*root);
     return PP_Result{std::move(root), true};
   }
+  bool recognize(State &state, PP_Trace &trace) const {
+    auto const slot = trace.push_decision();
+    int count = 0;
+    for (;;) {
+      if (!state.ss)
+        break;
+      auto const trace_rewind_point = trace.mark();
+      if (!recognize_(parser_, state, trace)) {
+        trace.rewind(trace_rewind_point);
+        break;
+      }
+      count += 1;
+    }
+    trace.set_decision(slot, count);
+    return count > 0;
+  }
+  Prgm_Tree build(PP_Trace &trace) const {
+    Prgm_Tree root(syntag_);
+    for (int count = trace.next_decision(); count > 0; --count) {
+      Prgm_Tree pt = build_(parser_, trace);
+      if (pt) {
+        hoist_back(root, std::move(pt));
+      }
+    }
+    if (root)
+      cover_branches(*root);
+    return root;
+  }
 
 private:
   int const syntag_;
@@ -248,15 +497,16 @@ static constexpr Plus_Parser<P> plus(int const syntag, P &&p) noexcept {
 //! Match if all specified parsers match
 /*! On match, this returns a Stmt_Tree with a root \c syntag that covers all the
  * Stmt_Trees from the sub parsers */
-template <typename... Ps> class Sequence_Parser {
+template <typename... Ps>
+class Sequence_Parser : public PP_Combinator<Sequence_Parser<Ps...>> {
 public:
   Sequence_Parser(Sequence_Parser const &) = default;
   constexpr explicit Sequence_Parser(int const syntag, Ps &&... ps) noexcept
       : syntag_{syntag}, parsers_{std::forward<Ps>(ps)...} {}
-  PP_Result operator()(State &state) const noexcept {
+  PP_Result parse(State &state) const {
     Prgm_Tree root(syntag_);
     auto attach_if = [&state, &root ](auto const &p) constexpr {
-      auto [pt, match] = p(state);
+      auto [pt, match] = parse_(p, state);
       if (pt) {
         hoist_back(root, std::move(pt));
       }
@@ -267,17 +517,42 @@ public:
     };
     bool const match = std::apply(fold, parsers_);
     if (!match) {
-      std::cerr << "Unrecognized statement\n";
-      state.ss->print_me(std::cerr, false) << "\nwhile parsing ";
-      FLPR::Syntax_Tags::print(std::cerr, syntag_) << std::endl;
+      report_failure_(state);
       return PP_Result{};
     }
     if (root)
       cover_branches(*root);
     return PP_Result{std::move(root), match};
   }
+  bool recognize(State &state, PP_Trace &trace) const {
+    auto recognize_each = [&state, &trace](auto const &p) {
+      return recognize_(p, state, trace);
+    };
+    auto fold = [&recognize_each](auto const &... as) {
+      return FLPR::details_::and_fold(recognize_each, as...);
+    };
+    bool const match = std::apply(fold, parsers_);
+    if (!match)
+      report_failure_(state);
+    return match;
+  }
+  Prgm_Tree build(PP_Trace &trace) const {
+    Prgm_Tree root(syntag_);
+    auto attach = [&trace, &root](auto const &p) {
+      Prgm_Tree pt = build_(p, trace);
+      if (pt) {
+        hoist_back(root, std::move(pt));
+      }
+    };
+    std::apply([&attach](auto const &... as) { (attach(as), ...); }, parsers_);
+    if (root)
+      cover_branches(*root);
+    return root;
+  }
 
 private:
+  void report_failure_(State &state) const { report_failure(state, syntag_); }
+
   int const syntag_;
   std::tuple<Ps...> const parsers_;
 };
@@ -296,19 +571,21 @@ static constexpr Sequence_Parser<Ps...> h_seq(Ps &&... ps) noexcept {
 }
 
 //! If the first parser matches, all specified parsers must match
-template <typename P0, typename... Ps> class Sequence_If_Parser {
+template <typename P0, typename... Ps>
+class Sequence_If_Parser
+    : public PP_Combinator<Sequence_If_Parser<P0, Ps...>> {
 public:
   Sequence_If_Parser(Sequence_If_Parser const &) = default;
   constexpr explicit Sequence_If_Parser(int const syntag, P0 &&p0,
                                         Ps &&... ps) noexcept
       : syntag_{syntag}, parser0_{p0}, rest_{std::forward<Ps>(ps)...} {}
 
-  PP_Result operator()(State &state) const noexcept {
+  PP_Result parse(State &state) const {
     Prgm_Tree root(syntag_);
 
     /* define a functor to attach the parse tree if a parser matches */
     auto attach_if = [&state, &root ](auto const &p) constexpr {
-      auto [pt, match] = p(state);
+      auto [pt, match] = parse_(p, state);
       if (pt) {
         hoist_back(root, std::move(pt));
       }
@@ -323,9 +600,7 @@ public:
     if (attach_if(parser0_)) {
       bool const match = std::apply(fold, rest_);
       if (!match) {
-        std::cerr << "Unrecognized statement\n";
-        state.ss->print_me(std::cerr, false) << "\nwhile parsing ";
-        FLPR::Syntax_Tags::print(std::cerr, syntag_) << std::endl;
+        report_failure_(state);
         return PP_Result{};
       }
       if (root)
@@ -334,8 +609,38 @@ public:
     }
     return PP_Result{};
   }
+  bool recognize(State &state, PP_Trace &trace) const {
+    if (!recognize_(parser0_, state, trace))
+      return false;
+    auto recognize_each = [&state, &trace](auto const &p) {
+      return recognize_(p, state, trace);
+    };
+    auto fold = [&recognize_each](auto const &... as) {
+      return FLPR::details_::and_fold(recognize_each, as...);
+    };
+    bool const match = std::apply(fold, rest_);
+    if (!match)
+      report_failure_(state);
+    return match;
+  }
+  Prgm_Tree build(PP_Trace &trace) const {
+    Prgm_Tree root(syntag_);
+    auto attach = [&trace, &root](auto const &p) {
+      Prgm_Tree pt = build_(p, trace);
+      if (pt) {
+        hoist_back(root, std::move(pt));
+      }
+    };
+    attach(parser0_);
+    std::apply([&attach](auto const &... as) { (attach(as), ...); }, rest_);
+    if (root)
+      cover_branches(*root);
+    return root;
+  }
 
 private:
+  void report_failure_(State &state) const { report_failure(state, syntag_); }
+
   int const syntag_;
   P0 parser0_;
   std::tuple<Ps...> const rest_;
@@ -355,15 +660,15 @@ static constexpr Sequence_If_Parser<Ps...> h_seq_if(Ps &&... ps) noexcept {
 }
 
 //! Kleene star: Zero or more matches of the parser
-template <typename P> class Star_Parser {
+template <typename P> class Star_Parser : public PP_Combinator<Star_Parser<P>> {
 public:
   Star_Parser(Star_Parser const &) = default;
   constexpr explicit Star_Parser(P &&p) noexcept
       : parser_{std::forward<P>(p)} {}
-  PP_Result operator()(State &state) const noexcept {
+  PP_Result parse(State &state) const {
     Prgm_Tree root(Syntax_Tags::HOIST);
     auto attach_if = [&state, &root ](auto const &p) constexpr {
-      auto [pt, match] = p(state);
+      auto [pt, match] = parse_(p, state);
       if (pt) {
         hoist_back(root, std::move(pt));
       }
@@ -376,6 +681,32 @@ public:
     // The list root may have no children, but this always matches
     return PP_Result{std::move(root), true};
   }
+  bool recognize(State &state, PP_Trace &trace) const {
+    auto const slot = trace.push_decision();
+    int count = 0;
+    while (state.ss) {
+      auto const trace_rewind_point = trace.mark();
+      if (!recognize_(parser_, state, trace)) {
+        trace.rewind(trace_rewind_point);
+        break;
+      }
+      count += 1;
+    }
+    trace.set_decision(slot, count);
+    return true;
+  }
+  Prgm_Tree build(PP_Trace &trace) const {
+    Prgm_Tree root(Syntax_Tags::HOIST);
+    for (int count = trace.next_decision(); count > 0; --count) {
+      Prgm_Tree pt = build_(parser_, trace);
+      if (pt) {
+        hoist_back(root, std::move(pt));
+      }
+    }
+    if (root)
+      cover_branches(*root);
+    return root;
+  }
 
 private:
   P const parser_;
@@ -387,22 +718,37 @@ template <typename P> static constexpr Star_Parser<P> star(P &&p) noexcept {
 }
 
 //! Return the Stmt_Tree generated by a function, match means tree is good
-class Statement_Parser {
+/*! The recognizer pass attaches the Stmt_Tree to the LL_Stmt and stashes the
+    Prgm_Tree leaf in the trace.  A statement that the recognizer matches always
+    ends up in the final Prgm_Tree (or the parse fails), as the Prgm parsers
+    don't backtrack over statements. */
+class Statement_Parser : public PP_Combinator<Statement_Parser> {
 public:
   using parser_function = FLPR::Stmt::Stmt_Tree (*)(FLPR::TT_Stream &ts);
   Statement_Parser(Statement_Parser const &) = default;
   constexpr explicit Statement_Parser(parser_function f) noexcept : f_{f} {}
-  PP_Result operator()(State &state) const noexcept {
-    FLPR::TT_Stream tts(*(state.ss));
-    FLPR::Stmt::Stmt_Tree st = f_(tts);
+  PP_Result parse(State &state) const {
+    if (!state.charge_work())
+      return PP_Result{};
+    FLPR::Stmt::Stmt_Tree st =
+        FLPR::Stmt::parse_with_cache(f_, *(state.ss), state.parser_exts);
     if (!st)
       return PP_Result{};
     int const tag = (*st)->syntag;
     FLPR::LL_STMT_SEQ::iterator ll_stmt_it{state.ss};
     state.ss.advance();
-    ll_stmt_it->set_stmt_tree(std::move(st));
+    if (state.check_only)
+      return PP_Result{Prgm_Tree{}, true};
+    attach_stmt_tree(state, ll_stmt_it, std::move(st));
     return PP_Result{Prgm_Tree{tag, ll_stmt_it}, true};
   }
+  bool recognize(State &state, PP_Trace &trace) const {
+    auto [pt, match] = parse(state);
+    if (match)
+      trace.push_cached(std::move(pt));
+    return match;
+  }
+  Prgm_Tree build(PP_Trace &trace) const { return trace.next_cached(); }
 
 private:
   parser_function const f_;
@@ -414,24 +760,37 @@ static constexpr auto stmt(typename Statement_Parser::parser_function f) {
 };
 
 //! "Tag" a Prgm_Tree with a new root
-template <typename P> class Tag_Parser {
+template <typename P> class Tag_Parser : public PP_Combinator<Tag_Parser<P>> {
 public:
   Tag_Parser(Tag_Parser const &) = default;
   constexpr explicit Tag_Parser(int const syntag, P &&p) noexcept
       : syntag_{syntag}, parser_{std::forward<P>(p)} {}
-  PP_Result operator()(State &state) const noexcept {
-    PP_Result res = parser_(state);
+  PP_Result parse(State &state) const {
+    PP_Result res = parse_(parser_, state);
     if (res.parse_tree) {
-      Prgm_Tree new_root{syntag_};
-      hoist_back(new_root, std::move(res.parse_tree));
-      if (new_root)
-        cover_branches(*new_root);
-      return PP_Result{std::move(new_root), res.match};
+      return PP_Result{tag_(std::move(res.parse_tree)), res.match};
     }
     return res;
   }
+  bool recognize(State &state, PP_Trace &trace) const {
+    return recognize_(parser_, state, trace);
+  }
+  Prgm_Tree build(PP_Trace &trace) const {
+    Prgm_Tree pt = build_(parser_, trace);
+    if (pt)
+      return tag_(std::move(pt));
+    return pt;
+  }
 
 private:
+  Prgm_Tree tag_(Prgm_Tree &&pt) const {
+    Prgm_Tree new_root{syntag_};
+    hoist_back(new_root, std::move(pt));
+    if (new_root)
+      cover_branches(*new_root);
+    return new_root;
+  }
+
   int const syntag_;
   P const parser_;
 };
@@ -491,15 +850,28 @@ static constexpr Tag_Parser<P> tag_if(int const syntag, P &&p) noexcept {
 */
 
 //! Match a Fortran 2008 do-construct
+/*! This parser commits as soon as it sees a do-stmt, so it is always evaluated
+    eagerly.  The recognizer pass just stashes the result. */
 class Legacy_Do_Construct_Parser {
 public:
   constexpr Legacy_Do_Construct_Parser() = default;
-  PP_Result operator()(State &state) const noexcept {
+  PP_Result operator()(State &state) const { return parse(state); }
+  bool recognize(State &state, PP_Trace &trace) const {
+    auto [pt, match] = parse(state);
+    if (match)
+      trace.push_cached(std::move(pt));
+    return match;
+  }
+  Prgm_Tree build(PP_Trace &trace) const { return trace.next_cached(); }
+  PP_Result parse(State &state) const {
 
     /****************************** DO-STMT ***********************************/
+    if (!state.charge_work())
+      return PP_Result{};
     FLPR::Stmt::Stmt_Tree do_stmt_tree;
     {
       FLPR::TT_Stream tts(*(state.ss));
+      tts.set_parser_exts(state.parser_exts);
       do_stmt_tree = FLPR::Stmt::do_stmt(tts);
     }
     if (!do_stmt_tree)
@@ -515,7 +887,7 @@ public:
 
     /* attach the Stmt_Tree to the LL_Stmt */
     FLPR::LL_STMT_SEQ::iterator do_stmt_it{state.ss};
-    do_stmt_it->set_stmt_tree(std::move(do_stmt_tree));
+    attach_stmt_tree(state, do_stmt_it, std::move(do_stmt_tree));
 
     state.ss.advance();
 
@@ -536,14 +908,19 @@ public:
       auto [pt, match] = execution_part_construct(state);
       if (pt) {
         hoist_back(block_pg_tree, std::move(pt));
-      } else {
+      } else if (!match) {
+        /* (a match without a tree only happens when checking syntax) */
         in_do_block = false;
       }
     } while (in_do_block);
 
     /*********************** TERMINATING STATEMENT ****************************/
 
+    if (!state.charge_work())
+      return PP_Result{};
+
     FLPR::TT_Stream tts(*(state.ss));
+    tts.set_parser_exts(state.parser_exts);
     FLPR::LL_STMT_SEQ::iterator end_stmt_it{state.ss};
     int end_stmt_pg_tag{TAG(UNKNOWN)};
     int end_stmt_sg_tag{TAG(UNKNOWN)};
@@ -556,7 +933,7 @@ public:
       end_stmt_sg_tag = (*end_stmt_tree)->syntag;
       end_stmt_pg_tag = TAG(HOIST);
       do_construct_tag = TAG(PG_DO_CONSTRUCT);
-      end_stmt_it->set_stmt_tree(std::move(end_stmt_tree));
+      attach_stmt_tree(state, end_stmt_it, std::move(end_stmt_tree));
       state.ss.advance();
     } else {
       /* So, we've got a label. Let NL be the number of instances of this
@@ -594,7 +971,7 @@ public:
            next do-construct termination.  */
         if (level == 1) {
           /* just attach the statement tree once, on the outer end_stmt */
-          end_stmt_it->set_stmt_tree(std::move(end_stmt_tree));
+          attach_stmt_tree(state, end_stmt_it, std::move(end_stmt_tree));
           do_construct_tag = TAG(PG_OUTER_SHARED_DO_CONSTRUCT);
           state.ss.advance();
         } else {
@@ -618,12 +995,16 @@ public:
         if (!end_stmt_tree)
           return PP_Result{};
         end_stmt_sg_tag = (*end_stmt_tree)->syntag;
-        end_stmt_it->set_stmt_tree(std::move(end_stmt_tree));
+        attach_stmt_tree(state, end_stmt_it, std::move(end_stmt_tree));
         state.ss.advance();
       }
       state.do_label_stack.pop();
     }
 
+    /* When checking syntax, the (empty) block has nothing to cover */
+    if (state.check_only)
+      return PP_Result{Prgm_Tree{}, true};
+
     /*************************** CONSTRUCT RESULT *****************************/
 
     /* The non-block forms need another node under the PG_NONBLOCK_DO_CONSTRUCT
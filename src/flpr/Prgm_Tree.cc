@@ -14,6 +14,7 @@
 
 #include "flpr/Prgm_Tree.hh"
 #include "flpr/Prgm_Parsers.hh"
+#include <string>
 
 namespace FLPR {
 namespace Prgm {
@@ -29,6 +30,28 @@ std::ostream &operator<<(std::ostream &os, Prgm_Node_Data const &pn) {
   return os;
 }
 
+namespace {
+/* FNV-1a, for stability across platforms */
+constexpr std::uint64_t fnv_basis = 14695981039346656037ULL;
+constexpr std::uint64_t fnv_prime = 1099511628211ULL;
+std::uint64_t fnv1a(std::uint64_t h, std::string const &text) noexcept {
+  for (unsigned char const c : text) {
+    h ^= c;
+    h *= fnv_prime;
+  }
+  return h;
+}
+} // namespace
+
+std::uint64_t stmt_hash(LL_Stmt const &stmt) noexcept {
+  std::uint64_t h = hash_combine(fnv_basis, stmt.label());
+  for (auto const &tt : stmt) {
+    h = hash_combine(h, static_cast<std::uint64_t>(tt.token));
+    h = hash_combine(h, fnv1a(fnv_basis, tt.text()));
+  }
+  return h;
+}
+
 // do an explicit instantiation of the default Prgm::Parsers
 template struct Parsers<>;
 
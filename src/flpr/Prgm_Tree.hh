@@ -15,12 +15,16 @@
 #define FLPR_PRGM_TREE_HH 1
 
 #include "flpr/LL_Stmt.hh"
+#include "flpr/Lazy_Flag.hh"
 #include "flpr/Stmt_Tree.hh"
 #include "flpr/Syntax_Tags.hh"
 #include "flpr/Tree.hh"
 
+#include <atomic>
+#include <cstdint>
 #include <optional>
 #include <ostream>
+#include <vector>
 
 namespace FLPR {
 namespace Prgm {
@@ -45,7 +49,10 @@ public:
         stmt_data_(std::in_place, ll_stmt_it) {}
 
   constexpr int syntag() const { return syntag_; }
-  constexpr void syntag(int const newval) { syntag_ = newval; }
+  void syntag(int const newval) {
+    syntag_ = newval;
+    has_hash_ = false;
+  }
   Stmt_Range &stmt_range() noexcept { return stmt_range_; }
 
   constexpr bool is_stmt() const noexcept { return stmt_data_.has_value(); }
@@ -57,6 +64,19 @@ public:
     return stmt_data_->ll_stmt_iter();
   }
 
+  //! True if the subtree hash is cached (see subtree_hash())
+  bool has_hash() const noexcept { return has_hash_; }
+  std::uint64_t hash() const noexcept {
+    return hash_.load(std::memory_order_relaxed);
+  }
+  //! Cache the subtree hash, publishing it to other threads
+  void set_hash(std::uint64_t const h) const noexcept {
+    hash_.store(h, std::memory_order_relaxed);
+    has_hash_ = true;
+  }
+  //! Forget the cached subtree hash
+  void clear_hash() const noexcept { has_hash_ = false; }
+
 private:
   //! The Syntax_Tags::Tags associated with this (sub)tree
   int syntag_;
@@ -85,9 +105,111 @@ private:
 
   //! Data for leaf-nodes associated with statements
   std::optional<Stmt_Data> stmt_data_;
+
+  //! Cached structural hash of the subtree rooted here
+  /*! Threads that compute it at the same time store the same value, and
+      has_hash_ publishes it. */
+  mutable std::atomic<std::uint64_t> hash_{0};
+  mutable Publish_Flag has_hash_{false};
 };
 
 std::ostream &operator<<(std::ostream &os, Prgm_Node_Data const &pn);
+
+//! Mix the value v into the hash h
+constexpr std::uint64_t hash_combine(std::uint64_t const h,
+                                     std::uint64_t const v) noexcept {
+  return h ^ (v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+}
+
+//! Hash the label, token kinds and token text of a statement
+/*! This is stable across runs and platforms, so it can be saved. */
+std::uint64_t stmt_hash(LL_Stmt const &stmt) noexcept;
+
+//! Return the structural (Merkle) hash of the subtree rooted at n
+/*! The hash combines the syntag of n, the stmt_hash() of a statement leaf,
+    and the hashes of the branches, in order.  Hashes are cached in the
+    nodes, and computed on demand, so after the first call this is O(1) for
+    any unchanged subtree.  Any number of threads may call this on the same
+    tree (for example from Procedure_Visitor::visit_parallel()), as long as
+    none of them is changing it.
+
+    Parsed_File::reparse_dirty() (and rollback()) clear the cached hashes of
+    the nodes that they change and of their ancestors, so edits made through
+    Logical_File are reflected once the tree has been brought up to date.
+    Clients that change a tree by other means must call clear_hash() on the
+    changed nodes and their ancestors. */
+template <typename Node> std::uint64_t subtree_hash(Node const &n) {
+  if (n->has_hash())
+    return n->hash();
+  std::uint64_t h = hash_combine(0, static_cast<std::uint64_t>(n->syntag()));
+  if (n->is_stmt())
+    h = hash_combine(h, stmt_hash(n->ll_stmt()));
+  for (auto const &b : n.branches())
+    h = hash_combine(h, subtree_hash(b));
+  n->set_hash(h);
+  return h;
+}
+
+//! A pair of corresponding subtrees that differ (see diff())
+template <typename Node> struct Subtree_Diff {
+  Node const *a; //!< nullptr if the subtree was added in b
+  Node const *b; //!< nullptr if the subtree was removed from a
+};
+
+namespace details_ {
+template <typename Node>
+void diff_recurse(Node const &a, Node const &b,
+                  std::vector<Subtree_Diff<Node>> &result) {
+  if (subtree_hash(a) == subtree_hash(b))
+    return;
+  if (a->syntag() != b->syntag() || a.is_leaf() || b.is_leaf()) {
+    result.push_back(Subtree_Diff<Node>{&a, &b});
+    return;
+  }
+  /* Skip the matching branches at the front and back, then pair up what is
+     left in order */
+  auto a_beg = a.branches().begin(), a_end = a.branches().end();
+  auto b_beg = b.branches().begin(), b_end = b.branches().end();
+  while (a_beg != a_end && b_beg != b_end &&
+         subtree_hash(*a_beg) == subtree_hash(*b_beg)) {
+    ++a_beg;
+    ++b_beg;
+  }
+  while (a_beg != a_end && b_beg != b_end &&
+         subtree_hash(*std::prev(a_end)) == subtree_hash(*std::prev(b_end))) {
+    --a_end;
+    --b_end;
+  }
+  for (; a_beg != a_end && b_beg != b_end; ++a_beg, ++b_beg)
+    diff_recurse(*a_beg, *b_beg, result);
+  for (; a_beg != a_end; ++a_beg)
+    result.push_back(Subtree_Diff<Node>{&*a_beg, nullptr});
+  for (; b_beg != b_end; ++b_beg)
+    result.push_back(Subtree_Diff<Node>{nullptr, &*b_beg});
+}
+} // namespace details_
+
+//! Find the smallest subtrees where two Prgm_Trees differ
+/*! Subtrees with the same subtree_hash() are skipped without being visited,
+    so the cost is proportional to the size of the differences (plus the first
+    hash computation).  Corresponding nodes with different syntags, or where
+    either is a statement, are reported as a pair.  Within a node, the
+    branches that match at the front and back are skipped, and the rest are
+    compared in order, with any excess reported as added or removed. */
+template <typename Tree>
+std::vector<Subtree_Diff<typename Tree::node>> diff(Tree const &a,
+                                                   Tree const &b) {
+  std::vector<Subtree_Diff<typename Tree::node>> result;
+  if (a.empty() || b.empty()) {
+    if (!a.empty())
+      result.push_back({&*a, nullptr});
+    if (!b.empty())
+      result.push_back({nullptr, &*b});
+    return result;
+  }
+  details_::diff_recurse(*a, *b, result);
+  return result;
+}
 } // namespace Prgm
 } // namespace FLPR
 
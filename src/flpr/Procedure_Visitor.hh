@@ -14,7 +14,16 @@
 #ifndef FLPR_PROCEDURE_VISITOR_HH
 #define FLPR_PROCEDURE_VISITOR_HH 1
 
+#include "flpr/Logical_Line.hh"
+#include "flpr/Parallel_For.hh"
 #include "flpr/Syntax_Tags.hh"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
 
 namespace FLPR {
 
@@ -30,21 +39,70 @@ namespace FLPR {
        module: true if c is in a module
 
      the return value will be ||'d together and returned from visit()
+
+   If the file was parsed without keeping its Stmt_Trees (see
+   Parsed_File::set_keep_stmt_trees()), the trees that Action rebuilds are
+   released after each procedure, so a pass over the whole file only holds
+   the trees of the procedure it is working on.
+
+   visit_parallel() calls Action on several procedures at once (see Access).
 */
 template <typename PFile_T, typename Action> class Procedure_Visitor {
 public:
   using Cursor = typename PFile_T::Parse_Tree::cursor_t;
 
+  //! What Action may do in visit_parallel()
+  enum class Access {
+    READ_ONLY,  //!< nothing is modified
+    LOCAL_EDITS //!< only the text of the procedure's own Logical_Lines changes
+  };
+
 public:
   Procedure_Visitor(PFile_T &file, Action &a) : file_{file}, action_{a} {}
   bool visit();
 
+  //! Like visit(), but run Action on up to num_threads procedures at once
+  /*! The procedures are collected first, then grouped so that procedures
+      that share a Logical_Line (such as a host and its internal subprograms,
+      or two procedures on one line) are in the same group.  The groups run
+      concurrently, and the procedures in a group run in visit() order, so no
+      Logical_Line is touched by two threads.
+
+      With LOCAL_EDITS, Action may change the text of its procedure's
+      Logical_Lines, but must not add or remove Logical_Lines or LL_Stmts, or
+      change the parse tree, as those structures are shared by the whole file.
+      If a Logical_File snapshot is open, the edits have to be recorded in
+      order, so the procedures are visited serially.
+
+      Action must not modify anything with READ_ONLY.  Any exception thrown
+      by Action is rethrown after all of the groups finish. */
+  bool visit_parallel(unsigned const num_threads, Access const access);
+
 private:
+  struct Visit_ {
+    Cursor c;
+    bool internal, module;
+  };
   bool visit_module_(Cursor c, bool const submodule);
   bool visit_procedure_(Cursor c, bool const internal, bool const module);
+  bool call_(Cursor c, bool const internal, bool const module) {
+    if (collect_) {
+      collect_->push_back(Visit_{c, internal, module});
+      return false;
+    }
+    return act_(c, internal, module);
+  }
+  bool act_(Cursor c, bool const internal, bool const module) {
+    bool const retval = action_(file_, c, internal, module);
+    for (auto &stmt : c->stmt_range())
+      stmt.release_stmt_tree();
+    return retval;
+  }
+  std::vector<std::vector<Visit_>> group_(std::vector<Visit_> &&visits);
   inline Cursor down_copy_(Cursor c) { return c.down(); }
   PFile_T &file_;
   Action &action_;
+  std::vector<Visit_> *collect_{nullptr};
 };
 
 #define TAG(T) FLPR::Syntax_Tags::T
@@ -87,7 +145,7 @@ bool Procedure_Visitor<PFile_T, Action>::visit_procedure_(Cursor c,
                                                           bool const internal,
                                                           bool const module) {
   /* Call the visit function on this one */
-  bool retval = action_(file_, c, internal, module);
+  bool retval = call_(c, internal, module);
 
   if (internal) // can't have internal subprograms
     return retval;
@@ -153,6 +211,75 @@ bool Procedure_Visitor<PFile_T, Action>::visit_module_(Cursor c,
   return retval;
 }
 
+template <typename PFile_T, typename Action>
+bool Procedure_Visitor<PFile_T, Action>::visit_parallel(
+    unsigned const num_threads, Access const access) {
+  if (num_threads < 2 || (access == Access::LOCAL_EDITS &&
+                          file_.logical_file().has_snapshot()))
+    return visit();
+
+  std::vector<Visit_> visits;
+  collect_ = &visits;
+  visit();
+  collect_ = nullptr;
+  std::vector<std::vector<Visit_>> const groups{group_(std::move(visits))};
+
+  std::vector<char> results(groups.size(), 0);
+  std::vector<std::exception_ptr> errors(groups.size());
+  parallel_for(groups.size(), num_threads, [&](std::size_t const g) {
+    try {
+      bool retval = false;
+      for (auto const &v : groups[g])
+        retval |= act_(v.c, v.internal, v.module);
+      results[g] = retval;
+    } catch (...) {
+      errors[g] = std::current_exception();
+    }
+  });
+  for (auto const &e : errors)
+    if (e)
+      std::rethrow_exception(e);
+  return std::find(results.begin(), results.end(), 1) != results.end();
+}
+
+/* Merge the procedures whose Logical_Line spans overlap, keeping visit()
+   order within each group */
+template <typename PFile_T, typename Action>
+auto Procedure_Visitor<PFile_T, Action>::group_(std::vector<Visit_> &&visits)
+    -> std::vector<std::vector<Visit_>> {
+  std::unordered_map<Logical_Line const *, std::size_t> line_num;
+  std::size_t n{0};
+  for (auto const &ll : file_.logical_lines())
+    line_num.emplace(&ll, n++);
+
+  struct Span {
+    std::size_t first, last, visit;
+  };
+  std::vector<Span> spans;
+  for (std::size_t i = 0; i < visits.size(); ++i) {
+    auto const &range = visits[i].c->stmt_range();
+    assert(!range.empty());
+    spans.push_back(Span{line_num[&*(range.begin()->it())],
+                         line_num[&*(std::prev(range.end())->it())], i});
+  }
+  std::stable_sort(
+      spans.begin(), spans.end(),
+      [](Span const &a, Span const &b) { return a.first < b.first; });
+
+  std::vector<std::vector<Visit_>> groups;
+  std::size_t group_last{0};
+  for (auto const &s : spans) {
+    if (groups.empty() || s.first > group_last) {
+      groups.emplace_back();
+      group_last = s.last;
+    } else {
+      group_last = std::max(group_last, s.last);
+    }
+    groups.back().push_back(std::move(visits[s.visit]));
+  }
+  return groups;
+}
+
 #undef TAG
 } // namespace FLPR
 #endif
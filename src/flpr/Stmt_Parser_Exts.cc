@@ -13,6 +13,8 @@
 */
 
 #include "flpr/Stmt_Parser_Exts.hh"
+#include <iostream>
+#include <sstream>
 
 namespace FLPR {
 namespace Stmt {
@@ -21,15 +23,48 @@ Parser_Exts &get_parser_exts() noexcept {
   return the_parser_exts;
 }
 
-void Parser_Exts::register_action_stmt(stmt_parser ext) noexcept {
+bool Parser_Exts::register_action_stmt(stmt_parser ext, char const *id) {
+  if (!check_mutable_("register_action_stmt"))
+    return false;
   action_exts_.push_back(ext);
+  action_ids_.emplace_back(id ? id : "");
+  generation_ = next_generation_();
+  return true;
 }
 
-void Parser_Exts::register_other_specification_stmt(stmt_parser ext) noexcept {
+bool Parser_Exts::register_other_specification_stmt(stmt_parser ext,
+                                                    char const *id) {
+  if (!check_mutable_("register_other_specification_stmt"))
+    return false;
   other_specification_exts_.push_back(ext);
+  other_specification_ids_.emplace_back(id ? id : "");
+  generation_ = next_generation_();
+  return true;
 }
 
-SP_Result Parser_Exts::parse_action_stmt(TT_Stream &ts) {
+std::string Parser_Exts::identity() const {
+  std::ostringstream os;
+  auto const describe = [&os](char const *const kind,
+                              std::vector<stmt_parser> const &exts,
+                              std::vector<std::string> const &ids) {
+    for (std::size_t i = 0; i < exts.size(); ++i) {
+      os << kind << ':';
+      if (ids[i].empty())
+        os << '@' << reinterpret_cast<void const *>(exts[i]);
+      else
+        os << ids[i].size() << ':' << ids[i];
+      os << ';';
+    }
+  };
+  describe("action", action_exts_, action_ids_);
+  describe("other-specification", other_specification_exts_,
+           other_specification_ids_);
+  return os.str();
+}
+
+SP_Result Parser_Exts::parse_action_stmt(TT_Stream &ts) const {
+  if (!action_exts_.empty())
+    note_text_dependence(); // client parsers may look at token text
   auto ts_rewind_point = ts.mark();
   for (auto parser : action_exts_) {
     Stmt_Tree st{parser(ts)};
@@ -44,7 +79,9 @@ SP_Result Parser_Exts::parse_action_stmt(TT_Stream &ts) {
   return SP_Result{Stmt_Tree{}, false};
 }
 
-SP_Result Parser_Exts::parse_other_specification_stmt(TT_Stream &ts) {
+SP_Result Parser_Exts::parse_other_specification_stmt(TT_Stream &ts) const {
+  if (!other_specification_exts_.empty())
+    note_text_dependence(); // client parsers may look at token text
   auto ts_rewind_point = ts.mark();
   for (auto parser : other_specification_exts_) {
     Stmt_Tree st{parser(ts)};
@@ -60,9 +97,29 @@ SP_Result Parser_Exts::parse_other_specification_stmt(TT_Stream &ts) {
   return SP_Result{Stmt_Tree{}, false};
 }
 
-void Parser_Exts::clear() noexcept {
+bool Parser_Exts::clear() noexcept {
+  if (!check_mutable_("clear"))
+    return false;
   action_exts_.clear();
   other_specification_exts_.clear();
+  action_ids_.clear();
+  other_specification_ids_.clear();
+  generation_ = next_generation_();
+  return true;
+}
+
+std::uint64_t Parser_Exts::next_generation_() noexcept {
+  static std::atomic<std::uint64_t> next{0};
+  return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool Parser_Exts::check_mutable_(char const *const what) const noexcept {
+  if (frozen_) {
+    std::cerr << "Parser_Exts::" << what
+              << ": the extensions have been frozen" << std::endl;
+    return false;
+  }
+  return true;
 }
 
 } // namespace Stmt
@@ -17,6 +17,10 @@
 
 #include "flpr/Stmt_Parsers.hh"
 #include "flpr/Stmt_Tree.hh"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
 #include <vector>
 
 namespace FLPR {
@@ -24,7 +28,21 @@ namespace Stmt {
 //! Manage extensions for the statement parsers
 /*! The Parser_Exts class is (optionally) used to provide application-specific
     statement parsers.  This allows the client application to extend the
-    language being recognized in Prgm::Parsers */
+    language being recognized in Prgm::Parsers
+
+    The registry returned by get_parser_exts() is used by default.  A
+    different set can be given to a single parse through
+    TT_Stream::set_parser_exts() (or Parsed_File::set_parser_exts()).
+
+    Registration is meant to happen during setup.  Once freeze() is called,
+    the set is immutable, so any number of threads can parse with it without
+    locking, and further attempts to change it fail with a message.
+
+    Each extension may be registered with an id that names it (and its
+    version, if it changes).  The ids make up identity(), which tells sets of
+    extensions apart for caches that outlive the process (see Parse_Cache).
+    Within a process, generation() does the same job more cheaply (see
+    Shape_Cache). */
 class Parser_Exts {
 public:
   //! The statement parser function signature
@@ -32,22 +50,62 @@ public:
   using stmt_parser = Stmt_Tree (*)(TT_Stream &ts);
 
 public:
-  //! Register an action-stmt extension
-  void register_action_stmt(stmt_parser ext) noexcept;
-  //! Register an other-specification-stmt extension
-  void register_other_specification_stmt(stmt_parser ext) noexcept;
-  //! Clear all registered extensions
-  void clear() noexcept;
+  Parser_Exts() = default;
+  //! Copy the registered extensions.  The copy is not frozen.
+  Parser_Exts(Parser_Exts const &src)
+      : action_exts_{src.action_exts_},
+        other_specification_exts_{src.other_specification_exts_},
+        action_ids_{src.action_ids_},
+        other_specification_ids_{src.other_specification_ids_},
+        generation_{src.generation_} {}
+  Parser_Exts &operator=(Parser_Exts const &) = delete;
+
+  //! Register an action-stmt extension.  Returns false if frozen.
+  bool register_action_stmt(stmt_parser ext, char const *id = nullptr);
+  //! Register an other-specification-stmt extension.  Returns false if frozen.
+  bool register_other_specification_stmt(stmt_parser ext,
+                                         char const *id = nullptr);
+  //! Clear all registered extensions.  Returns false if frozen.
+  bool clear() noexcept;
+  //! Disallow any further changes
+  void freeze() noexcept { frozen_ = true; }
+  bool frozen() const noexcept { return frozen_; }
+  //! Return true if no extensions are registered
+  bool empty() const noexcept {
+    return action_exts_.empty() && other_specification_exts_.empty();
+  }
+  std::size_t num_action_stmts() const noexcept { return action_exts_.size(); }
+  std::size_t num_other_specification_stmts() const noexcept {
+    return other_specification_exts_.size();
+  }
+  //! Describe the registered extensions, in order
+  /*! An extension registered without an id is described by its address,
+      which only identifies it within this process. */
+  std::string identity() const;
+  //! A number that changes whenever the registered extensions change
+  /*! Generations are unique within the process, so two sets with the same
+      generation have the same extensions. */
+  std::uint64_t generation() const noexcept { return generation_; }
 
   //@{
   /*! This is called by a driver routine in parse_stmt.cc and is not intended
-      for client use */
-  SP_Result parse_action_stmt(TT_Stream &ts);
-  SP_Result parse_other_specification_stmt(TT_Stream &ts);
+      for client use.  These only read the registered extensions, so they may
+      be called concurrently, as long as no extensions are being registered
+      at the same time (which freeze() guarantees). */
+  SP_Result parse_action_stmt(TT_Stream &ts) const;
+  SP_Result parse_other_specification_stmt(TT_Stream &ts) const;
   //@}
+private:
+  bool check_mutable_(char const *const what) const noexcept;
+  static std::uint64_t next_generation_() noexcept;
+
 private:
   std::vector<stmt_parser> action_exts_;
   std::vector<stmt_parser> other_specification_exts_;
+  std::vector<std::string> action_ids_;
+  std::vector<std::string> other_specification_ids_;
+  std::uint64_t generation_{next_generation_()};
+  std::atomic<bool> frozen_{false};
 };
 
 //! Access the Parser_Exts singleton
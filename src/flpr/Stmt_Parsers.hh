@@ -14,11 +14,17 @@
 #ifndef FLPR_STMT_PARSERS_HH
 #define FLPR_STMT_PARSERS_HH 1
 
+#include "flpr/Alt_Profile.hh"
 #include "flpr/Parser_Result.hh"
+#include "flpr/Parser_Trace.hh"
+#include "flpr/Stmt_Shape_Cache.hh"
 #include "flpr/Stmt_Tree.hh"
 #include "flpr/TT_Stream.hh"
 #include "flpr/utils.hh"
+#include <array>
+#include <cassert>
 #include <tuple>
+#include <utility>
 
 #define TRACE_TOKEN_PARSER 0
 
@@ -32,17 +38,78 @@ namespace Stmt {
 //! The result from each parser in Stmt
 using SP_Result = FLPR::details_::Parser_Result<Stmt_Tree>;
 
+//! The result of a Rule_Parser, as stashed by the recognizer pass
+struct SP_Rule_Match {
+  Stmt_Tree tree;
+  TT_Range::iterator end;
+};
+
+//! The trace used by the Stmt recognizer pass
+using SP_Trace = FLPR::details_::Parser_Trace<SP_Rule_Match>;
+
+//! Return the (per-thread) trace for the Stmt recognizer pass
+inline SP_Trace &sp_trace() {
+  static thread_local SP_Trace trace;
+  return trace;
+}
+
+//! Run the recognizer pass of p, then build along the winning path
+template <typename P>
+SP_Result recognize_then_build(P const &p, TT_Stream &ts) {
+  SP_Trace &trace = sp_trace();
+  auto const frame = trace.mark();
+  auto const ts_begin = ts.mark();
+  if (!p.recognize(ts, trace)) {
+    trace.rewind(frame);
+    return SP_Result{Stmt_Tree{}, false};
+  }
+  [[maybe_unused]] auto const ts_end = ts.mark();
+  auto const hold = trace.replay_position();
+  ts.rewind(ts_begin);
+  trace.replay(frame);
+  Stmt_Tree st = p.build(ts, trace);
+  assert(ts.mark() == ts_end);
+  trace.replay(hold);
+  trace.rewind(frame);
+  return SP_Result{std::move(st), true};
+}
+
+//! Common base for the combinators
+/*! Each combinator provides three member functions:
+
+      - parse(ts): eagerly build the Stmt_Tree while matching
+      - recognize(ts, trace): match, recording decisions in trace.  The
+        combinators themselves build nothing, and neither do the parser
+        functions that take the Rule_Request (see Rule_Parser).  Opaque
+        parser functions build their trees, and the results are stashed in
+        trace.  On failure, ts and trace are left as parse() would leave ts.
+      - build(ts, trace): replay the decisions from trace, building the tree.
+        This is only called along a path that recognize() matched.
+
+    The function call operator selects between parse() and
+    recognize_then_build(), depending on two_pass_parsing(). */
+template <typename Derived> class SP_Combinator {
+public:
+  SP_Result operator()(TT_Stream &ts) const {
+    Derived const &self = static_cast<Derived const &>(*this);
+    if (two_pass_parsing().load(std::memory_order_relaxed))
+      return recognize_then_build(self, ts);
+    return self.parse(ts);
+  }
+};
+
 //! Return a  Stmt::Stmt_Tree with syntag if any of the alternatives match
 /*! This "covers" the result of a matching parser with a new syntag node */
-template <typename... Ps> class Alternatives_Parser {
+template <typename... Ps>
+class Alternatives_Parser : public SP_Combinator<Alternatives_Parser<Ps...>> {
 public:
   Alternatives_Parser(Alternatives_Parser const &) = default;
   constexpr explicit Alternatives_Parser(int const syntag, Ps &&... ps) noexcept
       : syntag_{syntag}, parsers_{std::forward<Ps>(ps)...} {}
-  SP_Result operator()(TT_Stream &ts) const noexcept {
+  SP_Result parse(TT_Stream &ts) const {
     Stmt_Tree root;
     auto assign_if = [&ts, &root ](auto const &p) constexpr {
-      auto [st, match] = p(ts);
+      auto [st, match] = p.parse(ts);
       if (match) {
         root = std::move(st);
       }
@@ -60,6 +127,35 @@ public:
     }
     return SP_Result{std::move(root), false};
   }
+  bool recognize(TT_Stream &ts, SP_Trace &trace) const {
+    auto const slot = trace.push_decision();
+    auto const trace_rewind_point = trace.mark();
+    int idx = 0;
+    auto try_alt = [&ts, &trace, &trace_rewind_point, &idx](auto const &p) {
+      if (p.recognize(ts, trace))
+        return true;
+      trace.rewind(trace_rewind_point);
+      idx += 1;
+      return false;
+    };
+    auto fold = [&try_alt](auto const &... as) {
+      return FLPR::details_::or_fold(try_alt, as...);
+    };
+    bool const match = std::apply(fold, parsers_);
+    trace.set_decision(slot, idx);
+    return match;
+  }
+  Stmt_Tree build(TT_Stream &ts, SP_Trace &trace) const {
+    Stmt_Tree root;
+    FLPR::details_::visit_at(parsers_, trace.next_decision(),
+                             [&ts, &trace, &root](auto const &p) {
+                               root = p.build(ts, trace);
+                             });
+    Stmt_Tree new_root{this->syntag_};
+    hoist_back(new_root, std::move(root));
+    cover_branches(*new_root);
+    return new_root;
+  }
 
 private:
   int const syntag_;
@@ -80,35 +176,178 @@ inline constexpr Alternatives_Parser<Ps...> h_alts(Ps &&... ps) noexcept {
                                     std::forward<Ps>(ps)...};
 }
 
+//! Alternatives that may be probed in any order
+/*! This behaves like Alternatives_Parser, but is only for sites where at most
+    one alternative can match any input, so that the probe order does not
+    affect the result.  When adaptive_alternatives() is set, the probe order
+    follows the hit counts recorded for \c site in alt_profile(), so the most
+    frequent winners are tried first.  The site is usually the rule tag, which
+    allows a hoisted (\c syntag of HOIST) set of alternatives to be profiled
+    under the name of the enclosing rule. */
+template <typename... Ps>
+class Adaptive_Alternatives_Parser
+    : public SP_Combinator<Adaptive_Alternatives_Parser<Ps...>> {
+public:
+  Adaptive_Alternatives_Parser(Adaptive_Alternatives_Parser const &) = default;
+  constexpr explicit Adaptive_Alternatives_Parser(int const site,
+                                                  int const syntag,
+                                                  Ps &&... ps) noexcept
+      : site_{site}, syntag_{syntag}, parsers_{std::forward<Ps>(ps)...} {}
+  SP_Result parse(TT_Stream &ts) const {
+    constexpr auto table = parse_table_(std::index_sequence_for<Ps...>{});
+    Alt_Profile::Site *const site = profile_site_();
+    for (int pos = 0; pos < num_alts_; ++pos) {
+      int const idx = site ? site->probe(pos) : pos;
+      auto [st, match] = table[idx](parsers_, ts);
+      if (match) {
+        if (site)
+          site->hit(idx);
+        return SP_Result{cover_(std::move(st)), true};
+      }
+    }
+    return SP_Result{Stmt_Tree{}, false};
+  }
+  bool recognize(TT_Stream &ts, SP_Trace &trace) const {
+    constexpr auto table = recognize_table_(std::index_sequence_for<Ps...>{});
+    Alt_Profile::Site *const site = profile_site_();
+    auto const slot = trace.push_decision();
+    auto const trace_rewind_point = trace.mark();
+    for (int pos = 0; pos < num_alts_; ++pos) {
+      int const idx = site ? site->probe(pos) : pos;
+      if (table[idx](parsers_, ts, trace)) {
+        if (site)
+          site->hit(idx);
+        trace.set_decision(slot, idx);
+        return true;
+      }
+      trace.rewind(trace_rewind_point);
+    }
+    return false;
+  }
+  Stmt_Tree build(TT_Stream &ts, SP_Trace &trace) const {
+    Stmt_Tree root;
+    FLPR::details_::visit_at(parsers_, trace.next_decision(),
+                             [&ts, &trace, &root](auto const &p) {
+                               root = p.build(ts, trace);
+                             });
+    return cover_(std::move(root));
+  }
+
+private:
+  using Tuple_ = std::tuple<Ps...>;
+  using Parse_Fn_ = SP_Result (*)(Tuple_ const &, TT_Stream &);
+  using Recognize_Fn_ = bool (*)(Tuple_ const &, TT_Stream &, SP_Trace &);
+  static constexpr int num_alts_ = static_cast<int>(sizeof...(Ps));
+
+  template <std::size_t I>
+  static SP_Result parse_at_(Tuple_ const &t, TT_Stream &ts) {
+    return std::get<I>(t).parse(ts);
+  }
+  template <std::size_t I>
+  static bool recognize_at_(Tuple_ const &t, TT_Stream &ts, SP_Trace &trace) {
+    return std::get<I>(t).recognize(ts, trace);
+  }
+  template <std::size_t... I>
+  static constexpr std::array<Parse_Fn_, sizeof...(Ps)>
+  parse_table_(std::index_sequence<I...>) noexcept {
+    return {{&parse_at_<I>...}};
+  }
+  template <std::size_t... I>
+  static constexpr std::array<Recognize_Fn_, sizeof...(Ps)>
+  recognize_table_(std::index_sequence<I...>) noexcept {
+    return {{&recognize_at_<I>...}};
+  }
+
+  Alt_Profile::Site *profile_site_() const {
+    if (!adaptive_alternatives().load(std::memory_order_relaxed))
+      return nullptr;
+    return &alt_profile().site(site_, num_alts_);
+  }
+  Stmt_Tree cover_(Stmt_Tree &&st) const {
+    Stmt_Tree new_root{syntag_};
+    hoist_back(new_root, std::move(st));
+    cover_branches(*new_root);
+    return new_root;
+  }
+
+  int const site_;
+  int const syntag_;
+  Tuple_ const parsers_;
+};
+
+//! Generate an Adaptive_Alternatives_Parser profiled under syntag
+template <typename... Ps>
+inline constexpr Adaptive_Alternatives_Parser<Ps...>
+adaptive_alts(int const syntag, Ps &&... ps) noexcept {
+  return Adaptive_Alternatives_Parser<Ps...>{syntag, syntag,
+                                             std::forward<Ps>(ps)...};
+}
+
+//! Generate a hoisted Adaptive_Alternatives_Parser profiled under site
+template <typename... Ps>
+inline constexpr Adaptive_Alternatives_Parser<Ps...>
+h_adaptive_alts(int const site, Ps &&... ps) noexcept {
+  return Adaptive_Alternatives_Parser<Ps...>{site, Syntax_Tags::HOIST,
+                                             std::forward<Ps>(ps)...};
+}
+
 //! Match a TK_NAME that is one character long
-class Letter_Parser {
+class Letter_Parser : public SP_Combinator<Letter_Parser> {
 public:
-  SP_Result operator()(TT_Stream &ts) const noexcept {
-    if (!Syntax_Tags::is_name(ts.peek()))
-      return SP_Result{Stmt_Tree{}, false};
-    if (ts.peek_tt().text().size() != 1)
+  SP_Result parse(TT_Stream &ts) const {
+    if (!matches_(ts))
       return SP_Result{Stmt_Tree{}, false};
     return SP_Result{Stmt_Tree{Syntax_Tags::TK_NAME, ts.digest(1)}, true};
   }
+  bool recognize(TT_Stream &ts, SP_Trace &) const {
+    if (!matches_(ts))
+      return false;
+    ts.consume(1);
+    return true;
+  }
+  Stmt_Tree build(TT_Stream &ts, SP_Trace &) const {
+    return Stmt_Tree{Syntax_Tags::TK_NAME, ts.digest(1)};
+  }
+
+private:
+  bool matches_(TT_Stream const &ts) const noexcept {
+    if (!Syntax_Tags::is_name(ts.peek()))
+      return false;
+    note_text_dependence();
+    return ts.peek_tt().text().size() == 1;
+  }
 };
 
 //! Generate a Letter_Parser
 inline constexpr Letter_Parser letter() noexcept { return Letter_Parser{}; }
 
 //! Match a TK_NAME with a particular string value
-class Literal_Parser {
+class Literal_Parser : public SP_Combinator<Literal_Parser> {
 public:
   Literal_Parser(Literal_Parser const &) = default;
   Literal_Parser(char const *const s) : lc_text_{s} { tolower(lc_text_); }
-  SP_Result operator()(TT_Stream &ts) const noexcept {
-    if (!Syntax_Tags::is_name(ts.peek()))
-      return SP_Result{Stmt_Tree{}, false};
-    if (ts.peek_tt().lower() != lc_text_)
+  SP_Result parse(TT_Stream &ts) const {
+    if (!matches_(ts))
       return SP_Result{Stmt_Tree{}, false};
     return SP_Result{Stmt_Tree{Syntax_Tags::TK_NAME, ts.digest(1)}, true};
   }
+  bool recognize(TT_Stream &ts, SP_Trace &) const {
+    if (!matches_(ts))
+      return false;
+    ts.consume(1);
+    return true;
+  }
+  Stmt_Tree build(TT_Stream &ts, SP_Trace &) const {
+    return Stmt_Tree{Syntax_Tags::TK_NAME, ts.digest(1)};
+  }
 
 private:
+  bool matches_(TT_Stream const &ts) const noexcept {
+    if (!Syntax_Tags::is_name(ts.peek()))
+      return false;
+    note_text_dependence();
+    return ts.peek_tt().lower() == lc_text_;
+  }
   std::string lc_text_;
 };
 
@@ -116,9 +355,9 @@ private:
 inline auto literal(char const *const s) { return Literal_Parser{s}; }
 
 //! Match a Fortran \<name\>, converting keywords if necessary
-class Name_Parser {
+class Name_Parser : public SP_Combinator<Name_Parser> {
 public:
-  SP_Result operator()(TT_Stream &ts) const noexcept {
+  SP_Result parse(TT_Stream &ts) const {
 #if TRACE_TOKEN_PARSER
     std::cerr << "TP: match <name> vs. ";
     Syntax_Tags::print(std::cerr, ts.peek()) << "?\n";
@@ -129,21 +368,38 @@ public:
     // any stream rewinds.
     return SP_Result{Stmt_Tree{Syntax_Tags::TK_NAME, ts.digest(1)}, true};
   }
+  bool recognize(TT_Stream &ts, SP_Trace &) const {
+    if (!Syntax_Tags::is_name(ts.peek()))
+      return false;
+    ts.consume(1);
+    return true;
+  }
+  Stmt_Tree build(TT_Stream &ts, SP_Trace &) const {
+    return Stmt_Tree{Syntax_Tags::TK_NAME, ts.digest(1)};
+  }
 };
 
 //! Generate a Name_Parser
 inline constexpr auto name() { return Name_Parser{}; }
 
 //! Flips the match of the given parser
-template <typename P> class Negated_Parser {
+template <typename P>
+class Negated_Parser : public SP_Combinator<Negated_Parser<P>> {
 public:
   Negated_Parser(Negated_Parser const &) = default;
   constexpr explicit Negated_Parser(P &&p) noexcept
       : parser_{std::forward<P>(p)} {}
-  SP_Result operator()(TT_Stream &ts) const noexcept {
-    auto [st, match] = parser_(ts);
+  SP_Result parse(TT_Stream &ts) const {
+    auto [st, match] = parser_.parse(ts);
     return SP_Result{std::move(st), !match};
   }
+  bool recognize(TT_Stream &ts, SP_Trace &trace) const {
+    auto const trace_rewind_point = trace.mark();
+    bool const match = parser_.recognize(ts, trace);
+    trace.rewind(trace_rewind_point);
+    return !match;
+  }
+  Stmt_Tree build(TT_Stream &, SP_Trace &) const { return Stmt_Tree{}; }
 
 private:
   P const parser_;
@@ -155,15 +411,30 @@ template <typename P> inline constexpr Negated_Parser<P> neg(P &&p) noexcept {
 }
 
 //! Forwards the Stmt_Tree of a parser, always setting match to true
-template <typename P> class Optional_Parser {
+template <typename P>
+class Optional_Parser : public SP_Combinator<Optional_Parser<P>> {
 public:
   Optional_Parser(Optional_Parser const &) = default;
   constexpr explicit Optional_Parser(P &&p) noexcept
       : parser_{std::forward<P>(p)} {}
-  SP_Result operator()(TT_Stream &ts) const noexcept {
-    auto [st, match] = parser_(ts);
+  SP_Result parse(TT_Stream &ts) const {
+    auto [st, match] = parser_.parse(ts);
     return SP_Result{std::move(st), true};
   }
+  bool recognize(TT_Stream &ts, SP_Trace &trace) const {
+    auto const slot = trace.push_decision();
+    auto const trace_rewind_point = trace.mark();
+    bool const match = parser_.recognize(ts, trace);
+    if (!match)
+      trace.rewind(trace_rewind_point);
+    trace.set_decision(slot, match);
+    return true;
+  }
+  Stmt_Tree build(TT_Stream &ts, SP_Trace &trace) const {
+    if (trace.next_decision())
+      return parser_.build(ts, trace);
+    return Stmt_Tree{};
+  }
 
 private:
   P const parser_;
@@ -175,14 +446,18 @@ template <typename P> inline constexpr Optional_Parser<P> opt(P &&p) noexcept {
 }
 
 //! Returns true if the next token in the stream matches (not consumed)
-class Peek_Parser {
+class Peek_Parser : public SP_Combinator<Peek_Parser> {
 public:
   Peek_Parser(Peek_Parser const &) = default;
   constexpr explicit Peek_Parser(int const token_tag) noexcept
       : token_tag_{token_tag} {}
-  SP_Result operator()(TT_Stream &ts) const noexcept {
+  SP_Result parse(TT_Stream &ts) const {
     return SP_Result{Stmt_Tree{}, token_tag_ == ts.peek()};
   }
+  bool recognize(TT_Stream &ts, SP_Trace &) const {
+    return token_tag_ == ts.peek();
+  }
+  Stmt_Tree build(TT_Stream &, SP_Trace &) const { return Stmt_Tree{}; }
 
 private:
   int const token_tag_;
@@ -200,19 +475,119 @@ inline constexpr Peek_Parser eol() noexcept {
   return Peek_Parser{Syntax_Tags::BAD};
 }
 
+//! The pass that a Rule_Parser asks of the parser function that it calls
+enum class Rule_Mode { EAGER, RECOGNIZE, BUILD };
+
+//! A request from a Rule_Parser to its parser function
+/*! A parser function defined with the RULE() and EVAL() macros of
+    parse_stmt.cc takes the request on entry (see take_rule_request()), and
+    runs the requested pass of its combinator.  It reports back in \c handled
+    and, for a RECOGNIZE pass, \c match.  Any other parser function builds its
+    tree eagerly, and the Rule_Parser stashes the tree in the trace. */
+struct Rule_Request {
+  Rule_Mode mode{Rule_Mode::EAGER};
+  SP_Trace *trace{nullptr};
+  bool handled{false};
+  bool match{false};
+};
+
+//! Return the (per-thread) pending Rule_Request
+inline Rule_Request &rule_request() noexcept {
+  static thread_local Rule_Request request;
+  return request;
+}
+
+//! Take the pending request
+/*! This leaves an EAGER request behind, so that any parser function that the
+    caller calls directly builds its tree.  A parser function that is given to
+    rule() must take the request before calling any other parser function. */
+inline Rule_Request take_rule_request() noexcept {
+  Rule_Request &pending = rule_request();
+  Rule_Request const taken{pending.mode, pending.trace};
+  pending.mode = Rule_Mode::EAGER;
+  return taken;
+}
+
+//! Evaluate the combinator of a parser function as requested
+template <typename Derived>
+Stmt_Tree eval_rule(Rule_Request const &request,
+                    SP_Combinator<Derived> const &combinator, TT_Stream &ts) {
+  Derived const &p = static_cast<Derived const &>(combinator);
+  switch (request.mode) {
+  case Rule_Mode::RECOGNIZE: {
+    bool const match = p.recognize(ts, *request.trace);
+    Rule_Request &pending = rule_request();
+    pending.handled = true;
+    pending.match = match;
+    return Stmt_Tree{};
+  }
+  case Rule_Mode::BUILD: {
+    Stmt_Tree st = p.build(ts, *request.trace);
+    rule_request().handled = true;
+    return st;
+  }
+  default:
+    return p(ts);
+  }
+}
+
+//! A parser function that built its tree some other way
+inline Stmt_Tree eval_rule(Rule_Request const &, Stmt_Tree st, TT_Stream &) {
+  return st;
+}
+
 //! Return the Stmt_Tree generated by a function, match means tree is good
-class Rule_Parser {
+/*! In the recognizer pass, a parser function that takes the Rule_Request
+    (see take_rule_request()) recognizes with its own combinator, building
+    nothing, and the build pass calls it again to build along the recorded
+    path.  Any other parser function is opaque: it is evaluated during the
+    recognizer pass, and the resulting tree is stashed in the trace for the
+    build pass. */
+class Rule_Parser : public SP_Combinator<Rule_Parser> {
 public:
   using parser_function = Stmt_Tree (*)(TT_Stream &ts);
   Rule_Parser(Rule_Parser const &) = default;
   constexpr explicit Rule_Parser(parser_function f) noexcept : f_{f} {}
-  SP_Result operator()(TT_Stream &ts) const noexcept {
+  SP_Result parse(TT_Stream &ts) const {
     auto ts_rewind_point = ts.mark();
     Stmt_Tree st = f_(ts);
     if (!st)
       ts.rewind(ts_rewind_point);
     return SP_Result{std::move(st), static_cast<bool>(st)};
   }
+  bool recognize(TT_Stream &ts, SP_Trace &trace) const {
+    auto ts_rewind_point = ts.mark();
+    auto const trace_rewind_point = trace.mark();
+    auto const slot = trace.push_decision();
+    Rule_Request &request = rule_request();
+    request = Rule_Request{Rule_Mode::RECOGNIZE, &trace};
+    Stmt_Tree st = f_(ts);
+    bool const handled = request.handled;
+    bool const match = handled ? request.match : static_cast<bool>(st);
+    request = Rule_Request{};
+    if (!match) {
+      ts.rewind(ts_rewind_point);
+      trace.rewind(trace_rewind_point);
+      return false;
+    }
+    if (!handled)
+      trace.push_cached(SP_Rule_Match{std::move(st), ts.mark()});
+    trace.set_decision(slot, handled);
+    return true;
+  }
+  Stmt_Tree build(TT_Stream &ts, SP_Trace &trace) const {
+    if (!trace.next_decision()) {
+      SP_Rule_Match m = trace.next_cached();
+      ts.rewind(m.end);
+      return std::move(m.tree);
+    }
+    Rule_Request &request = rule_request();
+    request = Rule_Request{Rule_Mode::BUILD, &trace};
+    Stmt_Tree st = f_(ts);
+    assert(request.handled);
+    request = Rule_Request{};
+    return st;
+  }
 
 private:
   parser_function const f_;
@@ -226,16 +601,17 @@ inline constexpr auto rule(Rule_Parser::parser_function f) {
 //! Match if all specified parsers match
 /*! On match, this returns a Stmt_Tree with a root \c syntag that covers all the
  * Stmt_Trees from the sub parsers */
-template <typename... Ps> class Sequence_Parser {
+template <typename... Ps>
+class Sequence_Parser : public SP_Combinator<Sequence_Parser<Ps...>> {
 public:
   Sequence_Parser(Sequence_Parser const &) = default;
   constexpr explicit Sequence_Parser(int const syntag, Ps &&... ps) noexcept
       : syntag_{syntag}, parsers_{std::forward<Ps>(ps)...} {}
-  SP_Result operator()(TT_Stream &ts) const noexcept {
+  SP_Result parse(TT_Stream &ts) const {
     auto ts_rewind_point = ts.mark();
     Stmt_Tree root(true);
     auto attach_if = [&ts, &root ](auto const &p) constexpr {
-      auto [st, match] = p(ts);
+      auto [st, match] = p.parse(ts);
       if (st) {
         hoist_back(root, std::move(st));
       }
@@ -254,6 +630,35 @@ public:
     }
     return SP_Result{std::move(root), match};
   }
+  bool recognize(TT_Stream &ts, SP_Trace &trace) const {
+    auto ts_rewind_point = ts.mark();
+    auto const trace_rewind_point = trace.mark();
+    auto recognize_each = [&ts, &trace](auto const &p) {
+      return p.recognize(ts, trace);
+    };
+    auto fold = [&recognize_each](auto const &... as) {
+      return FLPR::details_::and_fold(recognize_each, as...);
+    };
+    bool const match = std::apply(fold, parsers_);
+    if (!match) {
+      ts.rewind(ts_rewind_point);
+      trace.rewind(trace_rewind_point);
+    }
+    return match;
+  }
+  Stmt_Tree build(TT_Stream &ts, SP_Trace &trace) const {
+    Stmt_Tree root(true);
+    auto attach = [&ts, &trace, &root](auto const &p) {
+      Stmt_Tree st = p.build(ts, trace);
+      if (st) {
+        hoist_back(root, std::move(st));
+      }
+    };
+    std::apply([&attach](auto const &... as) { (attach(as), ...); }, parsers_);
+    (*root)->syntag = syntag_;
+    cover_branches(*root);
+    return root;
+  }
 
 private:
   int const syntag_;
@@ -276,15 +681,15 @@ inline constexpr Sequence_Parser<Ps...> h_seq(Ps &&... ps) noexcept {
 }
 
 //! Kleene star: Zero or more matches of the parser
-template <typename P> class Star_Parser {
+template <typename P> class Star_Parser : public SP_Combinator<Star_Parser<P>> {
 public:
   Star_Parser(Star_Parser const &) = default;
   constexpr explicit Star_Parser(P &&p) noexcept
       : parser_{std::forward<P>(p)} {}
-  SP_Result operator()(TT_Stream &ts) const noexcept {
+  SP_Result parse(TT_Stream &ts) const {
     Stmt_Tree root(Syntax_Tags::HOIST);
     auto attach_if = [&ts, &root ](auto const &p) constexpr {
-      auto [st, match] = p(ts);
+      auto [st, match] = p.parse(ts);
       if (st) {
         hoist_back(root, std::move(st));
       }
@@ -296,6 +701,31 @@ public:
     // The list root may have no children, but this always matches
     return SP_Result{std::move(root), true};
   }
+  bool recognize(TT_Stream &ts, SP_Trace &trace) const {
+    auto const slot = trace.push_decision();
+    int count = 0;
+    for (;;) {
+      auto const trace_rewind_point = trace.mark();
+      if (!parser_.recognize(ts, trace)) {
+        trace.rewind(trace_rewind_point);
+        break;
+      }
+      count += 1;
+    }
+    trace.set_decision(slot, count);
+    return true;
+  }
+  Stmt_Tree build(TT_Stream &ts, SP_Trace &trace) const {
+    Stmt_Tree root(Syntax_Tags::HOIST);
+    for (int count = trace.next_decision(); count > 0; --count) {
+      Stmt_Tree st = parser_.build(ts, trace);
+      if (st) {
+        hoist_back(root, std::move(st));
+      }
+    }
+    cover_branches(*root);
+    return root;
+  }
 
 private:
   P const parser_;
@@ -312,23 +742,35 @@ template <typename P> inline constexpr Star_Parser<P> star(P &&p) noexcept {
   is used to give a different context for the result tree.  For example, a \c
   name can be tagged with \c dummy-arg to indicate that it is a dummy argument,
   not just some arbitrary \c name. */
-template <typename P> class Tag_Parser {
+template <typename P> class Tag_Parser : public SP_Combinator<Tag_Parser<P>> {
 public:
   Tag_Parser(Tag_Parser const &) = default;
   constexpr explicit Tag_Parser(int const syntag, P &&p) noexcept
       : syntag_{syntag}, parser_{std::forward<P>(p)} {}
-  SP_Result operator()(TT_Stream &ts) const noexcept {
-    SP_Result res = parser_(ts);
+  SP_Result parse(TT_Stream &ts) const {
+    SP_Result res = parser_.parse(ts);
     if (res.parse_tree) {
-      Stmt_Tree new_root{syntag_, (*(res.parse_tree))->token_range};
-      hoist_back(new_root, std::move(res.parse_tree));
-      cover_branches(*new_root);
-      return SP_Result{std::move(new_root), res.match};
+      return SP_Result{tag_(std::move(res.parse_tree)), res.match};
     }
     return res;
   }
+  bool recognize(TT_Stream &ts, SP_Trace &trace) const {
+    return parser_.recognize(ts, trace);
+  }
+  Stmt_Tree build(TT_Stream &ts, SP_Trace &trace) const {
+    Stmt_Tree st = parser_.build(ts, trace);
+    if (st)
+      return tag_(std::move(st));
+    return st;
+  }
 
 private:
+  Stmt_Tree tag_(Stmt_Tree &&st) const {
+    Stmt_Tree new_root{syntag_, (*st)->token_range};
+    hoist_back(new_root, std::move(st));
+    cover_branches(*new_root);
+    return new_root;
+  }
   int const syntag_;
   P const parser_;
 };
@@ -340,12 +782,12 @@ inline constexpr Tag_Parser<P> tag_if(int const syntag, P &&p) noexcept {
 }
 
 //! Match a token with the given Syntax_Tags::Tags value
-class Token_Parser {
+class Token_Parser : public SP_Combinator<Token_Parser> {
 public:
   Token_Parser(Token_Parser const &) = default;
   constexpr explicit Token_Parser(int const token_tag) noexcept
       : token_tag_{token_tag} {}
-  SP_Result operator()(TT_Stream &ts) const noexcept {
+  SP_Result parse(TT_Stream &ts) const {
 #if TRACE_TOKEN_PARSER
     Syntax_Tags::print(std::cerr << "TP: match ", token_tag_) << " vs. ";
     Syntax_Tags::print(std::cerr, ts.peek()) << "?\n";
@@ -354,6 +796,15 @@ public:
       return SP_Result{Stmt_Tree{}, false};
     return SP_Result{Stmt_Tree{token_tag_, ts.digest(1)}, true};
   }
+  bool recognize(TT_Stream &ts, SP_Trace &) const {
+    if (token_tag_ != ts.peek())
+      return false;
+    ts.consume(1);
+    return true;
+  }
+  Stmt_Tree build(TT_Stream &ts, SP_Trace &) const {
+    return Stmt_Tree{token_tag_, ts.digest(1)};
+  }
 
 private:
   int const token_tag_;
@@ -368,20 +819,28 @@ inline constexpr auto tok(int const token_tag) {
 
 //! R401: xyz-list (4.1.3)
 /*! This is a parser for the assumed syntax rule "xyz (, xyz)*" */
-template <typename P> class List_Parser {
+template <typename P> class List_Parser : public SP_Combinator<List_Parser<P>> {
 public:
   List_Parser(List_Parser const &) = default;
   constexpr explicit List_Parser(int const syntag, P &&p) noexcept
       : syntag_{syntag}, parser_{std::forward<P>(p)} {}
-  SP_Result operator()(TT_Stream &ts) const noexcept {
-    auto p =
-        seq(syntag_, parser_,
-            star(seq(Syntax_Tags::HOIST, tok(Syntax_Tags::TK_COMMA), parser_)));
+  SP_Result parse(TT_Stream &ts) const {
     // The cover_branches was provided by seq
-    return p(ts);
+    return expand_().parse(ts);
+  }
+  bool recognize(TT_Stream &ts, SP_Trace &trace) const {
+    return expand_().recognize(ts, trace);
+  }
+  Stmt_Tree build(TT_Stream &ts, SP_Trace &trace) const {
+    return expand_().build(ts, trace);
   }
 
 private:
+  auto expand_() const noexcept {
+    return seq(syntag_, parser_,
+               star(seq(Syntax_Tags::HOIST, tok(Syntax_Tags::TK_COMMA),
+                        parser_)));
+  }
   int const syntag_;
   P const parser_;
 };
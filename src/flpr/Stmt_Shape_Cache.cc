@@ -0,0 +1,165 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+/*!
+  \file Stmt_Shape_Cache.cc
+*/
+
+#include "flpr/Stmt_Shape_Cache.hh"
+#include "flpr/Stmt_Parser_Exts.hh"
+#include <cassert>
+#include <functional>
+#include <utility>
+
+namespace FLPR {
+namespace Stmt {
+
+std::size_t Shape_Cache::Key_Hash_::
+operator()(std::vector<int> const &kinds) const noexcept {
+  // FNV-1a over the token syntags
+  std::size_t h = 14695981039346656037ULL;
+  for (int const k : kinds) {
+    h ^= static_cast<std::size_t>(k);
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+std::size_t Shape_Cache::Rule_Hash_::operator()(Rule_ const &rule) const
+    noexcept {
+  return std::hash<parser_function>{}(rule.f) ^
+         (std::hash<std::uint64_t>{}(rule.generation) * 1099511628211ULL);
+}
+
+Stmt_Tree Shape_Cache::parse(parser_function f, LL_TT_Range &stmt,
+                             Parser_Exts const *exts) {
+  Rule_ const rule{f, (exts ? *exts : get_parser_exts()).generation()};
+  key_.clear();
+  toks_.clear();
+  for (auto it = stmt.begin(); it != stmt.end(); ++it) {
+    key_.push_back(it->token);
+    toks_.push_back(it);
+  }
+  toks_.push_back(stmt.end());
+
+  auto rule_shapes = shapes_.find(rule);
+  if (rule_shapes != shapes_.end()) {
+    auto found = rule_shapes->second.find(key_);
+    if (found != rule_shapes->second.end()) {
+      hits_ += 1;
+      if (!found->second.match)
+        return Stmt_Tree{};
+      return instantiate_(found->second, stmt);
+    }
+  }
+
+  misses_ += 1;
+  bool &text_dependent = details_::text_dependence_flag();
+  bool const outer_text_dependent = text_dependent;
+  text_dependent = false;
+  Stmt_Tree st;
+  {
+    TT_Stream ts(stmt);
+    if (exts)
+      ts.set_parser_exts(exts);
+    st = f(ts);
+  }
+  if (!text_dependent && capacity_ > 0) {
+    if (size_ >= capacity_) {
+      shapes_.clear();
+      size_ = 0;
+      evictions_ += 1;
+    }
+    Shape_ shape{static_cast<bool>(st), {}};
+    if (st)
+      flatten_(*st, shape.nodes);
+    shapes_[rule].emplace(key_, std::move(shape));
+    size_ += 1;
+  }
+  text_dependent = outer_text_dependent || text_dependent;
+  return st;
+}
+
+void Shape_Cache::clear() noexcept {
+  shapes_.clear();
+  hits_ = misses_ = size_ = evictions_ = 0;
+}
+
+void Shape_Cache::flatten_(Stmt_Tree::const_reference st,
+                           std::vector<Node_> &nodes) const {
+  LL_TT_Range const &r = st->token_range;
+  Node_ n{st->syntag, -1, 0, static_cast<int>(st.num_branches()), r.has_it()};
+  if (!r.empty()) {
+    int offset = 0;
+    while (toks_[offset] != r.begin())
+      offset += 1;
+    n.begin = offset;
+    n.size = static_cast<int>(r.size());
+  }
+  nodes.push_back(n);
+  for (auto const &b : st.branches())
+    flatten_(b, nodes);
+}
+
+ST_Node_Data Shape_Cache::node_data_(Node_ const &n,
+                                     LL_TT_Range const &stmt) const {
+  if (n.begin < 0) {
+    ST_Node_Data nd{n.syntag};
+    if (n.has_it)
+      nd.token_range.set_it(stmt.it());
+    return nd;
+  }
+  return ST_Node_Data{n.syntag,
+                      LL_TT_Range{stmt.it(), toks_[n.begin],
+                                  toks_[n.begin + n.size]}};
+}
+
+Stmt_Tree Shape_Cache::instantiate_(Shape_ const &shape,
+                                    LL_TT_Range const &stmt) const {
+  assert(!shape.nodes.empty());
+  Stmt_Tree st{node_data_(shape.nodes.front(), stmt)};
+  std::size_t const next = fill_(*st, shape.nodes, 0, stmt);
+  assert(next == shape.nodes.size());
+  (void)next;
+  return st;
+}
+
+/* Attach the branches of nodes[idx] to st, returning the index following the
+   subtree rooted at nodes[idx] */
+std::size_t Shape_Cache::fill_(Stmt_Tree::reference st,
+                               std::vector<Node_> const &nodes,
+                               std::size_t const idx,
+                               LL_TT_Range const &stmt) const {
+  std::size_t next = idx + 1;
+  for (int b = 0; b < nodes[idx].num_branches; ++b) {
+    auto branch =
+        st.emplace_back(Stmt_Tree::node{node_data_(nodes[next], stmt)});
+    next = fill_(*branch, nodes, next, stmt);
+  }
+  return next;
+}
+
+Shape_Cache &shape_cache() noexcept {
+  static thread_local Shape_Cache the_shape_cache;
+  return the_shape_cache;
+}
+
+Stmt_Tree parse_with_cache(Shape_Cache::parser_function f, LL_TT_Range &stmt,
+                           Parser_Exts const *exts) {
+  if (stmt_shape_caching())
+    return shape_cache().parse(f, stmt, exts);
+  TT_Stream ts(stmt);
+  if (exts)
+    ts.set_parser_exts(exts);
+  return f(ts);
+}
+
+} // namespace Stmt
+} // namespace FLPR
@@ -0,0 +1,160 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+/*!
+  \file Stmt_Shape_Cache.hh
+*/
+
+#ifndef FLPR_STMT_SHAPE_CACHE_HH
+#define FLPR_STMT_SHAPE_CACHE_HH 1
+
+#include "flpr/LL_TT_Range.hh"
+#include "flpr/Stmt_Tree.hh"
+#include "flpr/TT_Stream.hh"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace FLPR {
+namespace Stmt {
+
+//! Select caching of statement parse results by token-kind sequence
+/*! When true, the program parsers look up each statement in the (per-thread)
+    Shape_Cache before running a statement parser.  The default is false. */
+inline bool &stmt_shape_caching() noexcept {
+  static bool enabled{false};
+  return enabled;
+}
+
+namespace details_ {
+inline bool &text_dependence_flag() noexcept {
+  static thread_local bool flag{false};
+  return flag;
+}
+} // namespace details_
+
+//! Note that the current statement parse depends on token text
+/*! Statement parsers that look at the spelling of a token, rather than just
+    its syntag, must call this so that the Shape_Cache does not reuse their
+    result for a different statement with the same token kinds. */
+inline void note_text_dependence() noexcept {
+  details_::text_dependence_flag() = true;
+}
+
+//! Statement parse results keyed by rule and token-kind sequence
+/*! Most statement rules only look at the token syntags, so two statements
+    with the same sequence of token kinds parse to trees of the same shape.
+    The cache stores that shape once, as a preorder list of nodes whose token
+    ranges are offsets into the statement, and instantiates a Stmt_Tree for a
+    new statement by binding those offsets to its Token_Texts.  Failed parses
+    are cached too.
+
+    Shapes are also keyed on the Parser_Exts::generation() of the extensions
+    in effect, so registering an extension (or parsing with a different set)
+    never reuses a result computed without it.  Parses that consult token text
+    (see note_text_dependence()) are never stored.  Note that empty token
+    ranges are instantiated as cleared ranges on the statement's Logical_Line.
+
+    When capacity() shapes are stored, the next new shape empties the cache
+    before it is stored, so a long run keeps caching its current working set.
+
+    Each thread has its own cache, accessed through shape_cache(). */
+class Shape_Cache {
+public:
+  using parser_function = Stmt_Tree (*)(TT_Stream &ts);
+
+  //! Parse stmt with f, using and updating the cache
+  /*! A nullptr exts means Stmt::get_parser_exts(). */
+  Stmt_Tree parse(parser_function f, LL_TT_Range &stmt,
+                  Parser_Exts const *exts = nullptr);
+
+  //! The number of parses answered from the cache
+  std::size_t hits() const noexcept { return hits_; }
+  //! The number of parses that ran the statement parser
+  std::size_t misses() const noexcept { return misses_; }
+  //! The number of cached shapes
+  std::size_t size() const noexcept { return size_; }
+
+  //! The number of times the cache was emptied to make room
+  std::size_t evictions() const noexcept { return evictions_; }
+
+  //! Limit the number of cached shapes
+  void set_capacity(std::size_t const capacity) noexcept {
+    capacity_ = capacity;
+  }
+  std::size_t capacity() const noexcept { return capacity_; }
+
+  //! Forget all shapes and reset the counters
+  void clear() noexcept;
+
+private:
+  struct Node_ {
+    int syntag;
+    int begin;        //!< offset of the first token, or -1 if empty
+    int size;         //!< number of tokens
+    int num_branches; //!< number of children, which follow in preorder
+    bool has_it;      //!< empty range still refers to the Logical_Line
+  };
+  struct Shape_ {
+    bool match;
+    std::vector<Node_> nodes;
+  };
+  struct Key_Hash_ {
+    std::size_t operator()(std::vector<int> const &kinds) const noexcept;
+  };
+  using Shape_Map_ = std::unordered_map<std::vector<int>, Shape_, Key_Hash_>;
+  //! A statement rule, parsing with a particular generation of extensions
+  struct Rule_ {
+    parser_function f;
+    std::uint64_t generation;
+    bool operator==(Rule_ const &other) const noexcept {
+      return f == other.f && generation == other.generation;
+    }
+  };
+  struct Rule_Hash_ {
+    std::size_t operator()(Rule_ const &rule) const noexcept;
+  };
+
+  void flatten_(Stmt_Tree::const_reference st, std::vector<Node_> &nodes) const;
+  Stmt_Tree instantiate_(Shape_ const &shape, LL_TT_Range const &stmt) const;
+  std::size_t fill_(Stmt_Tree::reference st, std::vector<Node_> const &nodes,
+                    std::size_t idx, LL_TT_Range const &stmt) const;
+  ST_Node_Data node_data_(Node_ const &n, LL_TT_Range const &stmt) const;
+
+private:
+  std::unordered_map<Rule_, Shape_Map_, Rule_Hash_> shapes_;
+  std::vector<int> key_;                  //!< scratch token-kind sequence
+  std::vector<TT_Range::iterator> toks_;  //!< scratch token offsets
+  std::size_t hits_{0}, misses_{0}, size_{0}, evictions_{0};
+  std::size_t capacity_{1 << 16};
+};
+
+//! Return the (per-thread) Shape_Cache
+Shape_Cache &shape_cache() noexcept;
+
+//! Parse stmt with f, through the Shape_Cache if stmt_shape_caching() is set
+inline Stmt_Tree parse_with_cache(Shape_Cache::parser_function f,
+                                  LL_TT_Range &stmt) {
+  if (stmt_shape_caching())
+    return shape_cache().parse(f, stmt);
+  TT_Stream ts(stmt);
+  return f(ts);
+}
+
+//! Parse stmt with f, using exts for the extension statements
+/*! A nullptr exts means Stmt::get_parser_exts(). */
+Stmt_Tree parse_with_cache(Shape_Cache::parser_function f, LL_TT_Range &stmt,
+                           Parser_Exts const *exts);
+
+} // namespace Stmt
+} // namespace FLPR
+
+#endif
@@ -1,8 +1,10 @@
 #include "Syntax_Tags.hh"
 #include <cassert>
+#include <iostream>
 
-/* Declare the static member variable */
+/* Declare the static member variables */
 std::vector<FLPR::Syntax_Tags::Ext_Record> FLPR::Syntax_Tags::extensions_;
+std::atomic<bool> FLPR::Syntax_Tags::extensions_frozen_{false};
 
 std::string FLPR::Syntax_Tags::label(int const syntag) {
   const int ext_idx = get_ext_idx_(syntag);
@@ -27,6 +29,11 @@ int FLPR::Syntax_Tags::type(int const syntag) {
 
 bool FLPR::Syntax_Tags::register_ext(int const tag_idx, char const *const label,
                                      int const type) {
+  if (extensions_frozen_) {
+    std::cerr << "Syntax_Tags::register_ext: the extensions have been frozen"
+              << std::endl;
+    return false;
+  }
   assert(tag_idx >= CLIENT_EXTENSION);
   const size_t ext_idx = static_cast<size_t>(tag_idx - CLIENT_EXTENSION);
   if (extensions_.size() <= ext_idx) {
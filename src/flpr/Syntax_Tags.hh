@@ -18,6 +18,7 @@
 #define FLPR_SYNTAX_TAGS_HH 1
 
 #include "flpr/Syntax_Tags_Defs.hh"
+#include <atomic>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -43,8 +44,18 @@ public:
     return os << label(syntag);
   }
   static bool is_keyword(int const syntag) { return type(syntag) == 4; }
+  //! Register a client syntag.  Returns false if the extensions are frozen.
   static bool register_ext(int const tag_idx, char const *const label,
                            int const type);
+  //! Disallow further register_ext() calls
+  /*! After this, label() and type() can be called from any thread without
+      locking. */
+  static void freeze_extensions() noexcept { extensions_frozen_ = true; }
+  static bool extensions_frozen() noexcept { return extensions_frozen_; }
+  //! One more than the largest registered ext index (tag - CLIENT_EXTENSION)
+  static int num_extensions() noexcept {
+    return static_cast<int>(extensions_.size());
+  }
 
 public:
   struct Ext_Record {
@@ -57,6 +68,7 @@ private:
   static constexpr char const *const strings_[] = {MAP(STRINGIZE)};
   static constexpr int types_[] = {MAP(TYPIZE)};
   static std::vector<Ext_Record> extensions_;
+  static std::atomic<bool> extensions_frozen_;
   static int get_ext_idx_(int const syntag) {
     if (syntag < CLIENT_EXTENSION)
       return -2;
@@ -253,6 +253,7 @@
   X(PG_SPECIFICATION_PART, "specification-part", 1)                     \
   X(PG_SUBMODULE, "submodule", 1)                                       \
   X(PG_SUBROUTINE_SUBPROGRAM, "subroutine-subprogram", 1)               \
+  X(PG_SYNTAX_ERROR, "syntax-error", 1)                                 \
   X(PG_TYPE_BOUND_PROCEDURE_PART, "type-bound-procedure-part", 1)       \
   X(PG_WHERE_BODY_CONSTRUCT, "where-body-construct", 1)                 \
   X(PG_WHERE_CONSTRUCT, "where-construct", 1)                           \
@@ -266,7 +267,12 @@
   X(SG_ACTUAL_ARG, "actual-arg", 1)                                     \
   X(SG_ACTUAL_ARG_SPEC, "actual-arg-spec", 1)                           \
   X(SG_ACTUAL_ARG_SPEC_LIST, "actual-arg-spec-list", 1)                 \
+  X(SG_AC_IMPLIED_DO, "ac-implied-do", 1)                               \
+  X(SG_AC_IMPLIED_DO_CONTROL, "ac-implied-do-control", 1)               \
+  X(SG_AC_VALUE, "ac-value", 1)                                         \
+  X(SG_AC_VALUE_LIST, "ac-value-list", 1)                               \
   X(SG_ADD_OP, "add-op", 1)                                             \
+  X(SG_ADD_OPERAND, "add-operand", 1)                                   \
   X(SG_ALLOCATABLE_DECL, "allocatable-decl", 1)                         \
   X(SG_ALLOCATABLE_DECL_LIST, "allocatable-decl-list", 1)               \
   X(SG_ALLOCATABLE_STMT, "allocatable-stmt", 5)                         \
@@ -282,7 +288,10 @@
   X(SG_ALLOCATION_LIST, "allocation-list", 1)                           \
   X(SG_ALLOC_OPT, "alloc-opt", 1)                                       \
   X(SG_ALLOC_OPT_LIST, "alloc-opt-list", 1)                             \
+  X(SG_AND_OP, "and-op", 1)                                             \
+  X(SG_AND_OPERAND, "and-operand", 1)                                   \
   X(SG_ARITHMETIC_IF_STMT, "arithmetic-if-stmt", 5)                     \
+  X(SG_ARRAY_CONSTRUCTOR, "array-constructor", 1)                       \
   X(SG_ARRAY_ELEMENT, "array-element", 1)                               \
   X(SG_ARRAY_SPEC, "array-spec", 1)                                     \
   X(SG_ASSIGNMENT_STMT, "assignment-stmt", 5)                           \
@@ -326,6 +335,7 @@
   X(SG_COMMON_BLOCK_OBJECT, "common-block-object", 1)                   \
   X(SG_COMMON_BLOCK_OBJECT_LIST, "common-block-object-list", 1)         \
   X(SG_COMMON_STMT, "common-stmt", 5)                                   \
+  X(SG_COMPLEX_LITERAL_CONSTANT, "complex-literal-constant", 1)         \
   X(SG_COMPONENT_ARRAY_SPEC, "component-array-spec", 1)                 \
   X(SG_COMPONENT_ATTR_SPEC, "component-attr-spec", 1)                   \
   X(SG_COMPONENT_ATTR_SPEC_LIST, "component-attr-spec-list", 1)         \
@@ -337,6 +347,7 @@
   X(SG_COMPONENT_SPEC, "component-spec", 1)                             \
   X(SG_COMPONENT_SPEC_LIST, "component-spec-list", 1)                   \
   X(SG_COMPUTED_GOTO_STMT, "computed-goto-stmt", 5)                     \
+  X(SG_CONCAT_OP, "concat-op", 1)                                       \
   X(SG_CONCURRENT_CONTROL, "concurrent-control", 1)                     \
   X(SG_CONCURRENT_CONTROL_LIST, "concurrent-control-list", 1)           \
   X(SG_CONCURRENT_HEADER, "concurrent-header", 1)                       \
@@ -372,8 +383,10 @@
   X(SG_DEFERRED_COSHAPE_SPEC_LIST, "deferred-coshape-spec-list", 1)     \
   X(SG_DEFERRED_SHAPE_SPEC, "deferred-shape-spec", 1)                   \
   X(SG_DEFERRED_SHAPE_SPEC_LIST, "deferred-shape-spec-list", 1)         \
+  X(SG_DEFINED_BINARY_OP, "defined-binary-op", 1)                       \
   X(SG_DEFINED_IO_GENERIC_SPEC, "defined-io-generic-spec", 1)           \
   X(SG_DEFINED_OPERATOR, "defined-operator", 1)                         \
+  X(SG_DEFINED_UNARY_OP, "defined-unary-op", 1)                         \
   X(SG_DERIVED_TYPE_SPEC, "derived-type-spec", 1)                       \
   X(SG_DERIVED_TYPE_STMT, "derived-type-stmt", 5)                       \
   X(SG_DESIGNATOR, "designator", 1)                                     \
@@ -419,6 +432,7 @@
   X(SG_EQUIVALENCE_SET_LIST, "equivalence-set-list", 1)                 \
   X(SG_EQUIVALENCE_STMT, "equivalence-stmt", 5)                         \
   X(SG_EQUIV_OP, "equiv-op", 1)                                         \
+  X(SG_EQUIV_OPERAND, "equiv-operand", 1)                               \
   X(SG_ERROR_STOP_STMT, "error-stop-stmt", 5)                           \
   X(SG_EVENT_POST_STMT, "event-post-stmt", 5)                           \
   X(SG_EVENT_WAIT_STMT, "event-wait-stmt", 5)                           \
@@ -492,6 +506,11 @@
   X(SG_LENGTH_SELECTOR, "length-selector", 1)                           \
   X(SG_LETTER_SPEC, "letter-spec", 1)                                   \
   X(SG_LETTER_SPEC_LIST, "letter-spec-list", 1)                         \
+  X(SG_LEVEL_1_EXPR, "level-1-expr", 1)                                 \
+  X(SG_LEVEL_2_EXPR, "level-2-expr", 1)                                 \
+  X(SG_LEVEL_3_EXPR, "level-3-expr", 1)                                 \
+  X(SG_LEVEL_4_EXPR, "level-4-expr", 1)                                 \
+  X(SG_LEVEL_5_EXPR, "level-5-expr", 1)                                 \
   X(SG_LOCALITY_SPEC, "locality-spec", 1)                               \
   X(SG_LOCK_STMT, "lock-stmt", 5)                                       \
   X(SG_LOGICAL_EXPR, "logical-expr", 1)                                 \
@@ -504,11 +523,13 @@
   X(SG_MODULE_STMT, "module-stmt", 5)                                   \
   X(SG_MP_SUBPROGRAM_STMT, "mp-subprogram-stmt", 5)                     \
   X(SG_MULT_OP, "mult-op", 1)                                           \
+  X(SG_MULT_OPERAND, "mult-operand", 1)                                 \
   X(SG_NAMED_CONSTANT_DEF, "named-constant-def", 1)                     \
   X(SG_NAMED_CONSTANT_DEF_LIST, "named-constant-def-list", 1)           \
   X(SG_NAMELIST_GROUP_OBJECT_LIST, "namelist-group-object-list", 1)     \
   X(SG_NAMELIST_STMT, "namelist-stmt", 5)                               \
   X(SG_NONLABEL_DO_STMT, "nonlabel-do-stmt", 5)                         \
+  X(SG_NOT_OP, "not-op", 1)                                             \
   X(SG_NULLIFY_STMT, "nullify-stmt", 5)                                 \
   X(SG_NULL_INIT, "null-init", 1)                                       \
   X(SG_OBJECT_NAME_LIST, "object-name-list", 1)                         \
@@ -516,6 +537,8 @@
   X(SG_ONLY_LIST, "only-list", 1)                                       \
   X(SG_OPEN_STMT, "open-stmt", 5)                                       \
   X(SG_OPTIONAL_STMT, "optional-stmt", 5)                               \
+  X(SG_OR_OP, "or-op", 1)                                               \
+  X(SG_OR_OPERAND, "or-operand", 1)                                     \
   X(SG_OTHER_SPECIFICATION_STMT, "other-specification-stmt", 5)         \
   X(SG_OUTPUT_ITEM, "output-item", 1)                                   \
   X(SG_OUTPUT_ITEM_LIST, "output-item-list", 1)                         \
@@ -528,8 +551,10 @@
   X(SG_POINTER_OBJECT, "pointer-object", 1)                             \
   X(SG_POINTER_OBJECT_LIST, "pointer-object-list", 1)                   \
   X(SG_POINTER_STMT, "pointer-stmt", 5)                                 \
+  X(SG_POWER_OP, "power-op", 1)                                         \
   X(SG_PREFIX, "prefix", 1)                                             \
   X(SG_PREFIX_SPEC, "prefix-spec", 1)                                   \
+  X(SG_PRIMARY, "primary", 1)                                           \
   X(SG_PRINT_STMT, "print-stmt", 5)                                     \
   X(SG_PRIVATE_COMPONENTS_STMT, "private-components-stmt", 5)           \
   X(SG_PRIVATE_OR_SEQUENCE, "private-or-sequence", 1)                   \
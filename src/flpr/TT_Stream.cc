@@ -13,12 +13,17 @@
 */
 
 #include "flpr/TT_Stream.hh"
+#include "flpr/Stmt_Parser_Exts.hh"
 #include <iostream>
 #include <stdexcept>
 
 #define ll_ ll_tt_range_.ll()
 
 namespace FLPR {
+Stmt::Parser_Exts const &TT_Stream::parser_exts() const noexcept {
+  return parser_exts_ ? *parser_exts_ : Stmt::get_parser_exts();
+}
+
 void TT_Stream::e_expect_tok(int tok_found, int tok_expect) const {
   std::string filename;
   if (!ll_.file_info)
@@ -17,10 +17,15 @@
 
 #include "flpr/LL_TT_Range.hh"
 #include "flpr/Syntax_Tags.hh"
+#include <cstddef>
 #include <string>
 
 namespace FLPR {
 
+namespace Stmt {
+class Parser_Exts;
+}
+
 //! Represent a stream of Token_Text
 class TT_Stream {
 public:
@@ -136,7 +141,29 @@ public:
   void debug_print(std::ostream &os) const;
   constexpr LL_TT_Range const &source() const { return ll_tt_range_; }
 
+  //! Use exts in place of Stmt::get_parser_exts() for this stream
+  /*! exts must outlive the stream.  nullptr restores the default. */
+  void set_parser_exts(Stmt::Parser_Exts const *exts) noexcept {
+    parser_exts_ = exts;
+  }
+  //! The extension parsers in effect for this stream
+  Stmt::Parser_Exts const &parser_exts() const noexcept;
+  //! The Parser_Exts given to set_parser_exts(), else nullptr
+  Stmt::Parser_Exts const *parser_exts_override() const noexcept {
+    return parser_exts_;
+  }
+
+  //! The number of rewinds done by the TT_Streams of this thread
+  /*! This counts the backtracking inside the statement parsers, which is
+      charged against the work budget of the program parsers. */
+  static std::size_t num_rewinds() noexcept { return rewinds_(); }
+
 private:
+  static std::size_t &rewinds_() noexcept {
+    static thread_local std::size_t rewinds{0};
+    return rewinds;
+  }
+
   /* ------------  Error reporting functions ----------------------- */
   void e_expect_tok(int tok_found, int tok_expect) const;
   void e_expect_eol() const;
@@ -145,6 +172,7 @@ private:
 private:
   LL_TT_Range ll_tt_range_;
   TT_Range::iterator next_tok_;
+  Stmt::Parser_Exts const *parser_exts_{nullptr};
 };
 
 inline TT_Stream::Capture TT_Stream::capture_begin() const {
@@ -244,9 +272,15 @@ inline void TT_Stream::put_back() {
     next_tok_--;
 }
 
-inline void TT_Stream::rewind() { next_tok_ = ll_tt_range_.begin(); }
+inline void TT_Stream::rewind() {
+  rewinds_() += 1;
+  next_tok_ = ll_tt_range_.begin();
+}
 
-inline void TT_Stream::rewind(TT_Range::iterator it) { next_tok_ = it; }
+inline void TT_Stream::rewind(TT_Range::iterator it) {
+  rewinds_() += 1;
+  next_tok_ = it;
+}
 
 inline TT_Range::iterator TT_Stream::mark() { return next_tok_; }
 
@@ -23,6 +23,7 @@
 namespace FLPR {
 class Logical_Line;
 class Logical_File;
+class File_Image;
 
 //! A token, and it's corresponding text, as discovered by the lexer.
 /*!
@@ -39,6 +40,7 @@ class Token_Text {
 public:
   friend class Logical_Line;
   friend class Logical_File;
+  friend class File_Image;
   Token_Text();
   Token_Text(std::string &&txti, int toki, int sli, int spi)
       : token(toki), start_line(sli), start_pos(spi), text_(std::move(txti)) {}
@@ -16,6 +16,8 @@ The master high-level include file for FLPR applications
 #ifndef FLPR_FLPR_HH
 #define FLPR_FLPR_HH 1
 
+#include "flpr/Batch_Parser.hh"
+#include "flpr/File_Pipeline.hh"
 #include "flpr/Parsed_File.hh"
 #include "flpr/Procedure.hh"
 #include "flpr/Procedure_Visitor.hh"
@@ -31,13 +31,18 @@ namespace Stmt {
 
 #define INIT_FAIL auto ts_rewind_mark = ts.mark()
 
+/* RULE() takes the Rule_Request of the calling Rule_Parser, and EVAL() runs
+   the requested pass.  E is either the combinator of the rule, or a tree that
+   was built some other way.  Parser functions that don't use RULE() start
+   with OPAQUE_RULE instead, so that they build their trees eagerly. */
 #if TRACE_SG
 #define RULE(T)                                                                \
   constexpr auto rule_tag{Syntax_Tags::T};                                     \
+  Rule_Request const rule_request_{take_rule_request()};                       \
   Syntax_Tags::print(std::cerr << "SGTRACE >  ", Syntax_Tags::T) << '\n'
 
 #define EVAL(T, E)                                                             \
-  Stmt_Tree res_ = E;                                                          \
+  Stmt_Tree res_ = eval_rule(rule_request_, E, ts);                            \
   if (!res_.tree_initialized())                                                \
     Syntax_Tags::print(std::cerr << "SGTRACE <! ", Syntax_Tags::T) << '\n';    \
   else                                                                         \
@@ -45,10 +50,13 @@ namespace Stmt {
   return res_;
 #else
 #define RULE(T)                                                                \
-  constexpr auto rule_tag { Syntax_Tags::T }
-#define EVAL(T, E) return E
+  constexpr auto rule_tag{Syntax_Tags::T};                                     \
+  Rule_Request const rule_request_ { take_rule_request() }
+#define EVAL(T, E) return eval_rule(rule_request_, E, ts)
 #endif
 
+#define OPAQUE_RULE take_rule_request()
+
 #define TAG(X) Syntax_Tags::X
 #define TOK(X) tok(Syntax_Tags::X)
 
@@ -103,6 +111,7 @@ Stmt_Tree consume_until_break(TT_Stream &ts, int const rule_tag) {
 
 //! helper function to consume until the matching PARENR
 Stmt_Tree consume_parens(TT_Stream &ts) {
+  OPAQUE_RULE;
   int nesting_depth = 1;
   if (Syntax_Tags::TK_PARENL != ts.peek())
     return Stmt_Tree{};
@@ -131,6 +140,7 @@ Stmt_Tree consume_parens(TT_Stream &ts) {
   matches "<name>[',',')','=>',<eol>]"
 */
 Stmt_Tree list_name(TT_Stream &ts) {
+  OPAQUE_RULE;
   if (Syntax_Tags::is_name(ts.peek(1))) {
     int const next = ts.peek(2);
     if (TAG(BAD) == next || TAG(TK_ARROW) == next || TAG(TK_COLON) == next ||
@@ -141,8 +151,41 @@ Stmt_Tree list_name(TT_Stream &ts) {
   return Stmt_Tree{};
 }
 
+//! helper for primary: "( expr )" or complex-literal-constant
+/*! These share a prefix, so they are parsed together to avoid parsing the
+    first expr twice.  The parts of a complex-literal-constant (R718) are
+    accepted as any expr. */
+Stmt_Tree parens_or_complex(TT_Stream &ts) {
+  OPAQUE_RULE;
+  INIT_FAIL;
+  if (Syntax_Tags::TK_PARENL != ts.peek())
+    return Stmt_Tree{};
+  Stmt_Tree root{Syntax_Tags::HOIST};
+  root.graft_back(Stmt_Tree{ts.peek(), ts.digest(1)});
+  Stmt_Tree part = structured_expr(ts);
+  if (!part)
+    FAIL;
+  root.graft_back(std::move(part));
+  bool const is_complex = (Syntax_Tags::TK_COMMA == ts.peek());
+  if (is_complex) {
+    root.graft_back(Stmt_Tree{ts.peek(), ts.digest(1)});
+    part = structured_expr(ts);
+    if (!part)
+      FAIL;
+    root.graft_back(std::move(part));
+  }
+  if (Syntax_Tags::TK_PARENR != ts.peek())
+    FAIL;
+  root.graft_back(Stmt_Tree{ts.peek(), ts.digest(1)});
+  if (is_complex)
+    (*root)->syntag = Syntax_Tags::SG_COMPLEX_LITERAL_CONSTANT;
+  cover_branches(*root);
+  return root;
+}
+
 //! helper: bind_c (local)
 Stmt_Tree bind_c(TT_Stream &ts) {
+  OPAQUE_RULE;
   auto p = h_seq(TOK(KW_BIND), TOK(TK_PARENL), literal("c"), TOK(TK_PARENR));
   return p(ts);
 }
@@ -161,14 +204,14 @@ Stmt_Tree access_id(TT_Stream &ts) {
          rule(generic_spec),
          name()   // access-name
          );
-  EVAL(SG_ACCESS_ID, p(ts));
+  EVAL(SG_ACCESS_ID, p);
 }
 
 //! R807: access-spec (8.5.2)
 Stmt_Tree access_spec(TT_Stream &ts) {
   RULE(SG_ACCESS_SPEC);
   constexpr auto p = alts(rule_tag, TOK(KW_PUBLIC), TOK(KW_PRIVATE));
-  EVAL(SG_ACCESS_SPEC, p(ts));
+  EVAL(SG_ACCESS_SPEC, p);
 }
 
 //! R827: access-stmt (8.6.1)
@@ -181,7 +224,7 @@ Stmt_Tree access_stmt(TT_Stream &ts) {
                   list(TAG(SG_ACCESS_ID_LIST),
                        rule(access_id)))),
         eol());
-  EVAL(SG_ACCESS_STMT, p(ts));
+  EVAL(SG_ACCESS_STMT, p);
 }
 
 //! R515: action-stmt (5.1)
@@ -190,51 +233,54 @@ Stmt_Tree access_stmt(TT_Stream &ts) {
     sync with this. */
 Stmt_Tree action_stmt(TT_Stream &ts) {
   RULE(SG_ACTION_STMT);
+  /* At most one of the statements in the adaptive set can match, but
+     macro-stmt overlaps with several of them, so it must be tried last */
   constexpr auto p =
     alts(rule_tag,
-         rule(allocate_stmt),
-         rule(assignment_stmt),
-         rule(backspace_stmt),
-         rule(call_stmt),
-         rule(close_stmt),
-         rule(continue_stmt),
-         rule(cycle_stmt),
-         rule(deallocate_stmt),
-         rule(endfile_stmt),
-         rule(error_stop_stmt),
-         rule(event_post_stmt),
-         rule(event_wait_stmt),
-         rule(exit_stmt),
-         rule(fail_image_stmt),
-         rule(flush_stmt),
-         rule(form_team_stmt),
-         rule(goto_stmt),
-         rule(if_stmt),
-         rule(inquire_stmt),
-         rule(lock_stmt),
-         rule(nullify_stmt),
-         rule(open_stmt),
-         rule(pointer_assignment_stmt),
-         rule(print_stmt),
-         rule(read_stmt),
-         rule(return_stmt),
-         rule(rewind_stmt),
-         rule(stop_stmt),
-         rule(sync_all_stmt),
-         rule(sync_images_stmt),
-         rule(sync_memory_stmt),
-         rule(sync_team_stmt),
-         rule(unlock_stmt),
-         rule(wait_stmt),
-         rule(where_stmt),
-         rule(write_stmt),
-         rule(computed_goto_stmt),
-         rule(arithmetic_if_stmt),
-         rule(forall_stmt),
+         h_adaptive_alts(rule_tag,
+                         rule(allocate_stmt),
+                         rule(assignment_stmt),
+                         rule(backspace_stmt),
+                         rule(call_stmt),
+                         rule(close_stmt),
+                         rule(continue_stmt),
+                         rule(cycle_stmt),
+                         rule(deallocate_stmt),
+                         rule(endfile_stmt),
+                         rule(error_stop_stmt),
+                         rule(event_post_stmt),
+                         rule(event_wait_stmt),
+                         rule(exit_stmt),
+                         rule(fail_image_stmt),
+                         rule(flush_stmt),
+                         rule(form_team_stmt),
+                         rule(goto_stmt),
+                         rule(if_stmt),
+                         rule(inquire_stmt),
+                         rule(lock_stmt),
+                         rule(nullify_stmt),
+                         rule(open_stmt),
+                         rule(pointer_assignment_stmt),
+                         rule(print_stmt),
+                         rule(read_stmt),
+                         rule(return_stmt),
+                         rule(rewind_stmt),
+                         rule(stop_stmt),
+                         rule(sync_all_stmt),
+                         rule(sync_images_stmt),
+                         rule(sync_memory_stmt),
+                         rule(sync_team_stmt),
+                         rule(unlock_stmt),
+                         rule(wait_stmt),
+                         rule(where_stmt),
+                         rule(write_stmt),
+                         rule(computed_goto_stmt),
+                         rule(arithmetic_if_stmt),
+                         rule(forall_stmt)),
          rule(macro_stmt));
   auto res = p(ts);
   if(!res.match) {
-    res = get_parser_exts().parse_action_stmt(ts);
+    res = ts.parser_exts().parse_action_stmt(ts);
   }
   EVAL(SG_ACTION_STMT, res);
 }
@@ -247,7 +293,7 @@ Stmt_Tree actual_arg(TT_Stream &ts) {
     seq(rule_tag,
         rule(expr)
         );
-  EVAL(SG_ACTUAL_ARG, p(ts));
+  EVAL(SG_ACTUAL_ARG, p);
 }
 
 //! R1523: actual-arg-spec (15.5.1)
@@ -257,7 +303,45 @@ Stmt_Tree actual_arg_spec(TT_Stream &ts) {
     seq(rule_tag,
         opt(h_seq(name(), TOK(TK_EQUAL))),
         rule(actual_arg));
-  EVAL(SG_ACTUAL_ARG_SPEC, p(ts));
+  EVAL(SG_ACTUAL_ARG_SPEC, p);
+}
+
+//! R774: ac-implied-do (7.8)
+Stmt_Tree ac_implied_do(TT_Stream &ts) {
+  RULE(SG_AC_IMPLIED_DO);
+  /* The ac-value-list is consumed up to the comma that precedes the
+     ac-implied-do-control, so the list keeps its trailing comma */
+  constexpr auto p =
+    seq(rule_tag,
+        TOK(TK_PARENL),
+        tag_if(TAG(SG_AC_VALUE_LIST),
+               h_seq(rule(ac_value), TOK(TK_COMMA),
+                     star(h_seq(rule(ac_value), TOK(TK_COMMA))))),
+        rule(ac_implied_do_control),
+        TOK(TK_PARENR));
+  EVAL(SG_AC_IMPLIED_DO, p);
+}
+
+//! R775: ac-implied-do-control (7.8)
+Stmt_Tree ac_implied_do_control(TT_Stream &ts) {
+  RULE(SG_AC_IMPLIED_DO_CONTROL);
+  constexpr auto p =
+    seq(rule_tag,
+        opt(h_seq(rule(integer_type_spec), TOK(TK_DBL_COLON))),
+        name(), TOK(TK_EQUAL),
+        rule(structured_expr), TOK(TK_COMMA), rule(structured_expr),
+        opt(h_seq(TOK(TK_COMMA), rule(structured_expr))));
+  EVAL(SG_AC_IMPLIED_DO_CONTROL, p);
+}
+
+//! R773: ac-value (7.8)
+Stmt_Tree ac_value(TT_Stream &ts) {
+  RULE(SG_AC_VALUE);
+  constexpr auto p =
+    alts(rule_tag,
+         rule(ac_implied_do),
+         rule(structured_expr));
+  EVAL(SG_AC_VALUE, p);
 }
 
 //! R1009: add-op (6.2.4)
@@ -267,7 +351,7 @@ Stmt_Tree add_op(TT_Stream &ts) {
     alts(rule_tag,
          TOK(TK_PLUS),
          TOK(TK_MINUS));
-  EVAL(SG_ADD_OP, p(ts));
+  EVAL(SG_ADD_OP, p);
 }
 
 //! R928: alloc-opt (9.7.1.1)
@@ -279,7 +363,7 @@ Stmt_Tree alloc_opt(TT_Stream &ts) {
          h_seq(TOK(KW_MOLD), TOK(TK_EQUAL), rule(expr)),
          h_seq(TOK(KW_SOURCE), TOK(TK_EQUAL), rule(expr)),
          h_seq(TOK(KW_STAT), TOK(TK_EQUAL), rule(variable)));
-  EVAL(SG_ALLOC_OPT, p(ts));
+  EVAL(SG_ALLOC_OPT, p);
 }
 
 //! R829: allocatable-stmt (8.6.2)
@@ -292,7 +376,7 @@ Stmt_Tree allocatable_stmt(TT_Stream &ts) {
         list(TAG(SG_ALLOCATABLE_DECL_LIST),
              rule(allocatable_decl)),
         eol());
-  EVAL(SG_ALLOCATABLE_STMT, p(ts));
+  EVAL(SG_ALLOCATABLE_STMT, p);
 }
 
 //! R830: allocatable-decl (8.6.2)
@@ -302,7 +386,7 @@ Stmt_Tree allocatable_decl(TT_Stream &ts) {
     seq(rule_tag, name(),
         opt(h_parens(rule(array_spec))),
         opt(h_brackets(rule(coarray_spec))));
-  EVAL(SG_ALLOCATABLE_DECL, p(ts));
+  EVAL(SG_ALLOCATABLE_DECL, p);
 }
 
 //! R936: allocate-coarray-spec (9.7.1.1)
@@ -316,7 +400,7 @@ Stmt_Tree allocate_coarray_spec(TT_Stream &ts) {
         opt(h_seq(rule(lower_bound_expr),
                   TOK(TK_COLON))),
         TOK(TK_ASTERISK));
-  EVAL(SG_ALLOCATE_COARRAY_SPEC, p(ts));
+  EVAL(SG_ALLOCATE_COARRAY_SPEC, p);
 }
 
 //! R937: allocate-coshape-spec (9.7.1.1)
@@ -326,7 +410,7 @@ Stmt_Tree allocate_coshape_spec(TT_Stream &ts) {
     seq(rule_tag,
         opt(h_seq(rule(lower_bound_expr), TOK(TK_COLON))),
         rule(upper_bound_expr));
-  EVAL(SG_ALLOCATE_COSHAPE_SPEC, p(ts));
+  EVAL(SG_ALLOCATE_COSHAPE_SPEC, p);
 }
 
 //! R932: allocate-object (9.7.1.1)
@@ -337,7 +421,7 @@ Stmt_Tree allocate_object(TT_Stream &ts) {
          rule(structure_component),  // check the longer form first
          h_seq(name(), neg(peek(TAG(TK_EQUAL)))) // don't eat options
          );
-  EVAL(SG_ALLOCATE_OBJECT, p(ts));
+  EVAL(SG_ALLOCATE_OBJECT, p);
 }
 
 //! R933: allocate-shape-spec (9.7.1.1)
@@ -347,7 +431,7 @@ Stmt_Tree allocate_shape_spec(TT_Stream &ts) {
     seq(rule_tag,
         opt(h_seq(rule(lower_bound_expr), TOK(TK_COLON))),
         rule(upper_bound_expr));
-  EVAL(SG_ALLOCATE_SHAPE_SPEC, p(ts));
+  EVAL(SG_ALLOCATE_SHAPE_SPEC, p);
 }
 
 //! R927: allocate-stmt (9.7.1.1)
@@ -363,7 +447,7 @@ Stmt_Tree allocate_stmt(TT_Stream &ts) {
                                  list(TAG(SG_ALLOC_OPT_LIST),
                                       rule(alloc_opt)))))),
         eol());
-  EVAL(SG_ALLOCATE_STMT, p(ts));
+  EVAL(SG_ALLOCATE_STMT, p);
 }
 
 //! R931: allocation (9.7.1.1)
@@ -376,7 +460,7 @@ Stmt_Tree allocation(TT_Stream &ts) {
                           rule(allocate_shape_spec)))),
         opt(h_brackets(rule(allocate_coarray_spec)))
         );
-  EVAL(SG_ALLOCATION, p(ts));
+  EVAL(SG_ALLOCATION, p);
 }
 
 //! DELETED FEATURE: arithmetic-if-stmt (B.2)
@@ -390,7 +474,22 @@ Stmt_Tree arithmetic_if_stmt(TT_Stream &ts) {
         rule(label), TOK(TK_COMMA),
         rule(label),
         eol());
-  EVAL(SG_ARITHMETIC_IF_STMT, p(ts));
+  EVAL(SG_ARITHMETIC_IF_STMT, p);
+}
+
+//! R769: array-constructor (7.8)
+Stmt_Tree array_constructor(TT_Stream &ts) {
+  RULE(SG_ARRAY_CONSTRUCTOR);
+  /* R770: ac-spec is [type-spec ::] ac-value-list */
+  constexpr auto p =
+    alts(rule_tag,
+         h_seq(TOK(TK_PARENL), TOK(TK_SLASHF),
+               opt(h_seq(rule(type_spec), TOK(TK_DBL_COLON))),
+               opt(list(TAG(SG_AC_VALUE_LIST), rule(ac_value))),
+               TOK(TK_SLASHF), TOK(TK_PARENR)),
+         h_brackets(opt(h_seq(rule(type_spec), TOK(TK_DBL_COLON))),
+                    opt(list(TAG(SG_AC_VALUE_LIST), rule(ac_value)))));
+  EVAL(SG_ARRAY_CONSTRUCTOR, p);
 }
 
 //! R917: array-element (9.5.3.1)
@@ -417,7 +516,7 @@ Stmt_Tree array_element(TT_Stream &ts) {
         h_parens(list(TAG(SG_SECTION_SUBSCRIPT_LIST), rule(expr))),
         opt(rule(image_selector))
         );
-  EVAL(SG_ARRAY_ELEMENT, p(ts));
+  EVAL(SG_ARRAY_ELEMENT, p);
 }
 
 //! R807: array-spec (8.5.8)
@@ -438,7 +537,7 @@ Stmt_Tree array_spec(TT_Stream &ts) {
          rule(implied_shape_or_assumed_size_spec),
          tag_if(TAG(SG_ASSUMED_RANK_SPEC), TOK(TK_DBL_DOT))
          );
-  EVAL(SG_ARRAY_SPEC, p(ts));
+  EVAL(SG_ARRAY_SPEC, p);
 }
 
 //! R1032: assignment-stmt (10.2.1.1)
@@ -446,7 +545,7 @@ Stmt_Tree assignment_stmt(TT_Stream &ts) {
   RULE(SG_ASSIGNMENT_STMT);
   constexpr auto p =
     seq(rule_tag, rule(variable), TOK(TK_EQUAL), rule(expr), eol());
-  EVAL(SG_ASSIGNMENT_STMT, p(ts));
+  EVAL(SG_ASSIGNMENT_STMT, p);
 }
 
 //! R1103: associate-stmt (11.1.3.1)
@@ -459,7 +558,7 @@ Stmt_Tree associate_stmt(TT_Stream &ts) {
         h_parens(list(TAG(SG_ASSOCIATION_LIST),
                       rule(association))),
         eol());
-  EVAL(SG_ASSOCIATE_STMT, p(ts));
+  EVAL(SG_ASSOCIATE_STMT, p);
 }
 
 //! R1104: association (11.1.3.1)
@@ -470,7 +569,7 @@ Stmt_Tree association(TT_Stream &ts) {
         name(),  // associate-name
         TOK(TK_ARROW),
         rule(selector));
-  EVAL(SG_ASSOCIATION, p(ts));
+  EVAL(SG_ASSOCIATION, p);
 }
 
 //! R821: assumed-implied-spec (8.5.8.5)
@@ -480,7 +579,7 @@ Stmt_Tree assumed_implied_spec(TT_Stream &ts) {
     seq(rule_tag,
         opt(h_seq(rule(expr), TOK(TK_COLON))),
         TOK(TK_ASTERISK));
-  EVAL(SG_ASSUMED_IMPLIED_SPEC, p(ts));
+  EVAL(SG_ASSUMED_IMPLIED_SPEC, p);
 }
 
 //! R819: assumed-shape-spec (8.5.8.3)
@@ -494,7 +593,7 @@ Stmt_Tree assumed_shape_spec(TT_Stream &ts) {
                peek(TAG(TK_COMMA)))
                     
         );
-  EVAL(SG_ASSUMED_SHAPE_SPEC, p(ts));
+  EVAL(SG_ASSUMED_SHAPE_SPEC, p);
 }
 
 //! R822: assumed-size-spec (8.5.8.5)
@@ -505,7 +604,7 @@ Stmt_Tree assumed_size_spec(TT_Stream &ts) {
         list(TAG(SG_EXPLICIT_SHAPE_SPEC_LIST), rule(explicit_shape_spec)),
         TOK(TK_COMMA),
         rule(assumed_implied_spec));
-  EVAL(SG_ASSUMED_SIZE_SPEC, p(ts));
+  EVAL(SG_ASSUMED_SIZE_SPEC, p);
 }
 
 //! R831: asynchronous-stmt (8.6.3)
@@ -517,7 +616,7 @@ Stmt_Tree asynchronous_stmt(TT_Stream &ts) {
         opt(TOK(TK_DBL_COLON)),
         h_list(name()), // object-name-list
         eol());
-  EVAL(SG_ASYNCHRONOUS_STMT, p(ts));
+  EVAL(SG_ASYNCHRONOUS_STMT, p);
 }
 
 //! R802: attr-spec (8.2)
@@ -543,7 +642,7 @@ Stmt_Tree attr_spec(TT_Stream &ts) {
          TOK(KW_TARGET),
          TOK(KW_VALUE),
          TOK(KW_VOLATILE));
-  EVAL(SG_ATTR_SPEC, p(ts));
+  EVAL(SG_ATTR_SPEC, p);
 }
 
 /* I:B */
@@ -557,7 +656,7 @@ Stmt_Tree backspace_stmt(TT_Stream &ts) {
         h_alts(rule(int_expr),
                rule(consume_parens)),
         eol());
-  EVAL(SG_BACKSPACE_STMT, p(ts));
+  EVAL(SG_BACKSPACE_STMT, p);
 }
 
 //! R833: bind-entity (8.6.4)
@@ -569,7 +668,7 @@ Stmt_Tree bind_entity(TT_Stream &ts) {
                name(),             // common-block-name
                TOK(TK_SLASHF)),
          name());                  // entity-name
-  EVAL(SG_BIND_ENTITY, p(ts));
+  EVAL(SG_BIND_ENTITY, p);
 }
 
 //! R832: bind-stmt (8.6.4)
@@ -581,7 +680,7 @@ Stmt_Tree bind_stmt(TT_Stream &ts) {
         opt(TOK(TK_DBL_COLON)),
         h_list(rule(bind_entity)),
         eol());
-  EVAL(SG_BIND_STMT, p(ts));
+  EVAL(SG_BIND_STMT, p);
 }
 
 //! R752: binding-attr (7.5.5)
@@ -595,7 +694,7 @@ Stmt_Tree binding_attr(TT_Stream &ts) {
          TOK(KW_NOPASS),
          h_seq(TOK(KW_PASS), opt(h_parens(name()))) // arg-name
          );
-  EVAL(SG_BINDING_ATTR, p(ts));
+  EVAL(SG_BINDING_ATTR, p);
 }
 
 //! R747: binding-private-stmt (7.5.5)
@@ -605,7 +704,7 @@ Stmt_Tree binding_private_stmt(TT_Stream &ts) {
     seq(rule_tag,
         TOK(KW_PRIVATE),
         eol());
-  EVAL(SG_BINDING_PRIVATE_STMT, p(ts));
+  EVAL(SG_BINDING_PRIVATE_STMT, p);
 }
 
 //! R1108: block-stmt (11.1.4)
@@ -616,7 +715,7 @@ Stmt_Tree block_stmt(TT_Stream &ts) {
         opt(h_seq(name(), TOK(TK_COLON))),
         TOK(KW_BLOCK),
         eol());
-  EVAL(SG_BLOCK_STMT, p(ts));
+  EVAL(SG_BLOCK_STMT, p);
 }
 
 //! R1036: bounds-remapping (10.2.2.2)
@@ -627,7 +726,7 @@ Stmt_Tree bounds_remapping(TT_Stream &ts) {
         rule(lower_bound_expr),
         TOK(TK_COLON),
         rule(upper_bound_expr));
-  EVAL(SG_BOUNDS_REMAPPING, p(ts));
+  EVAL(SG_BOUNDS_REMAPPING, p);
 }
 
 //! R1035: bounds-spec (R1034)
@@ -637,7 +736,7 @@ Stmt_Tree bounds_spec(TT_Stream &ts) {
     seq(rule_tag,
         rule(lower_bound_expr),
         TOK(TK_COLON));
-  EVAL(SG_BOUNDS_SPEC, p(ts));
+  EVAL(SG_BOUNDS_SPEC, p);
 }
 
 /* I:C */
@@ -653,7 +752,7 @@ Stmt_Tree call_stmt(TT_Stream &ts) {
                               rule(actual_arg_spec))))),
         eol()
         );
-  EVAL(SG_CALL_STMT, p(ts));
+  EVAL(SG_CALL_STMT, p);
 }
 
 //! R1145: case-selector (11.1.9.1)
@@ -664,7 +763,7 @@ Stmt_Tree case_selector(TT_Stream &ts) {
          h_parens(list(TAG(SG_CASE_VALUE_RANGE_LIST),
                        rule(case_value_range))),
          TOK(KW_DEFAULT));
-  EVAL(SG_CASE_SELECTOR, p(ts));
+  EVAL(SG_CASE_SELECTOR, p);
 }
 
 //! R1142: case-stmt (11.1.9.1)
@@ -676,7 +775,7 @@ Stmt_Tree case_stmt(TT_Stream &ts) {
         rule(case_selector),
         opt(name()), // case-construct-name
         eol());
-  EVAL(SG_CASE_STMT, p(ts));
+  EVAL(SG_CASE_STMT, p);
 }
 
 //! R1146: case-value-range (11.1.9.1)
@@ -688,7 +787,7 @@ Stmt_Tree case_value_range(TT_Stream &ts) {
          h_seq(rule(expr), TOK(TK_COLON)),
          h_seq(TOK(TK_COLON), rule(expr)),
          h_seq(rule(expr)));
-  EVAL(SG_CASE_VALUE_RANGE, p(ts));
+  EVAL(SG_CASE_VALUE_RANGE, p);
 }
 
 //! R723: char-length (7.4.4.2)
@@ -700,7 +799,7 @@ Stmt_Tree char_length(TT_Stream &ts) {
          TOK(SG_INT_LITERAL_CONSTANT),
          /* this is an extension! */
          name());
-  EVAL(SG_CHAR_LENGTH, p(ts));
+  EVAL(SG_CHAR_LENGTH, p);
 }
 
 //! R721: char-selector (7.4.4.2)
@@ -719,7 +818,7 @@ Stmt_Tree char_selector(TT_Stream &ts) {
                  opt(h_seq(TOK(TK_COMMA),
                            TOK(KW_LEN), TOK(TK_EQUAL), rule(type_param_value))))
          );
-  EVAL(SG_CHAR_SELECTOR, p(ts));
+  EVAL(SG_CHAR_SELECTOR, p);
 }
 
 //! TRUNCATED R1208: close-stmt (12.5.7.2)
@@ -730,7 +829,7 @@ Stmt_Tree close_stmt(TT_Stream &ts) {
         TOK(KW_CLOSE),
         rule(consume_parens),
         eol());
-  EVAL(SG_CLOSE_STMT, p(ts));
+  EVAL(SG_CLOSE_STMT, p);
 }
 
 //! R809: coarray-spec (8.5.6)
@@ -742,7 +841,7 @@ Stmt_Tree coarray_spec(TT_Stream &ts) {
          list(TAG(SG_DEFERRED_COSHAPE_SPEC_LIST),
               tag_if(TAG(SG_DEFERRED_COSHAPE_SPEC), TOK(TK_COLON)))
          );
-  EVAL(SG_COARRAY_SPEC, p(ts));
+  EVAL(SG_COARRAY_SPEC, p);
 }
 
 //! R835: codimension-decl (8.6.5)
@@ -752,7 +851,7 @@ Stmt_Tree codimension_decl(TT_Stream &ts) {
     seq(rule_tag,
         name(), // coarray-name
         h_brackets(rule(coarray_spec)));
-  EVAL(SG_CODIMENSION_DECL, p(ts));
+  EVAL(SG_CODIMENSION_DECL, p);
 }
 
 //! R834: codimension-stmt (8.6.5)
@@ -764,7 +863,7 @@ Stmt_Tree codimension_stmt(TT_Stream &ts) {
         opt(TOK(TK_DBL_COLON)),
         h_list(rule(codimension_decl)),
         eol());
-  EVAL(SG_CODIMENSION_STMT, p(ts));
+  EVAL(SG_CODIMENSION_STMT, p);
 }
 
 //! R914: coindexed-named-object (9.4.3)
@@ -780,7 +879,7 @@ Stmt_Tree coindexed_named_object(TT_Stream &ts) {
                           rule(section_subscript)))),
         rule(image_selector),
         neg(peek(TAG(TK_PERCENT))));
-  EVAL(SG_COINDEXED_NAMED_OBJECT, p(ts));
+  EVAL(SG_COINDEXED_NAMED_OBJECT, p);
 }
 
 //! R874: common-block-object (8.10.2.1)
@@ -788,7 +887,7 @@ Stmt_Tree common_block_object(TT_Stream &ts) {
   RULE(SG_COMMON_BLOCK_OBJECT);
   constexpr auto p =
     seq(rule_tag, name(), opt(h_parens(rule(array_spec))));
-  EVAL(SG_COMMON_BLOCK_OBJECT, p(ts));
+  EVAL(SG_COMMON_BLOCK_OBJECT, p);
 }
 
 //! R873: common-stmt (8.10.2.1)
@@ -806,7 +905,7 @@ Stmt_Tree common_stmt(TT_Stream &ts) {
                         rule(common_block_object)))),
         eol()
         );
-  EVAL(SG_COMMON_STMT, p(ts));
+  EVAL(SG_COMMON_STMT, p);
 }
 
 //! R740: component-array-spec (7.5.4.1)
@@ -817,7 +916,7 @@ Stmt_Tree component_array_spec(TT_Stream &ts) {
          list(TAG(SG_EXPLICIT_SHAPE_SPEC_LIST), rule(explicit_shape_spec)),
          list(TAG(SG_DEFERRED_SHAPE_SPEC_LIST), rule(deferred_shape_spec))
          );
-  EVAL(SG_COMPONENT_ARRAY_SPEC, p(ts));
+  EVAL(SG_COMPONENT_ARRAY_SPEC, p);
 }
 
 //! R738: component-attr-spec (7.5.4.1)
@@ -831,7 +930,7 @@ Stmt_Tree component_attr_spec(TT_Stream &ts) {
          TOK(KW_CONTIGUOUS),
          h_seq(TOK(KW_DIMENSION), h_parens(rule(component_array_spec))),
          TOK(KW_POINTER));
-  EVAL(SG_COMPONENT_ATTR_SPEC, p(ts));
+  EVAL(SG_COMPONENT_ATTR_SPEC, p);
 }
 
 //! R758: component-data-source (7.5.10)
@@ -843,7 +942,7 @@ Stmt_Tree component_data_source(TT_Stream &ts) {
   */
   constexpr auto p =
     tag_if(rule_tag, rule(proc_target));
-  EVAL(SG_COMPONENT_DATA_SOURCE, p(ts));
+  EVAL(SG_COMPONENT_DATA_SOURCE, p);
 }
 
 //! R739: component-decl (7.5.4.1)
@@ -856,7 +955,7 @@ Stmt_Tree component_decl(TT_Stream &ts) {
         opt(h_parens(rule(coarray_spec))),
         opt(h_seq(TOK(TK_ASTERISK), rule(char_length))),
         opt(rule(component_initialization)));
-  EVAL(SG_COMPONENT_DECL, p(ts));
+  EVAL(SG_COMPONENT_DECL, p);
 }
 
 //! R736: component-def-stmt (7.5.4.1)
@@ -866,7 +965,7 @@ Stmt_Tree component_def_stmt(TT_Stream &ts) {
     alts(rule_tag,
          rule(data_component_def_stmt),
          rule(proc_component_def_stmt));
-  EVAL(SG_COMPONENT_DEF_STMT, p(ts));
+  EVAL(SG_COMPONENT_DEF_STMT, p);
 }
 
 //! TRUNCATED R743: component-initialization (7.5.4.6)
@@ -876,7 +975,7 @@ Stmt_Tree component_initialization(TT_Stream &ts) {
     alts(rule_tag,
          h_seq(TOK(TK_EQUAL), rule(expr)),
          h_seq(TOK(TK_ARROW), rule(expr)));
-  EVAL(SG_COMPONENT_INITIALIZATION, p(ts));
+  EVAL(SG_COMPONENT_INITIALIZATION, p);
 }
 
 //! R757: component-spec (7.5.10)
@@ -886,7 +985,7 @@ Stmt_Tree component_spec(TT_Stream &ts) {
     seq(rule_tag,
         opt(h_seq(name(), TOK(TK_EQUAL))),
         rule(component_data_source));
-  EVAL(SG_COMPONENT_SPEC, p(ts));
+  EVAL(SG_COMPONENT_SPEC, p);
 }
 
 //! R1158: computed-goto-stmt (11.2.3)
@@ -900,7 +999,7 @@ Stmt_Tree computed_goto_stmt(TT_Stream &ts) {
         opt(TOK(TK_COMMA)),
         rule(expr),
         eol());
-  EVAL(SG_COMPUTED_GOTO_STMT, p(ts));
+  EVAL(SG_COMPUTED_GOTO_STMT, p);
 }
 
 //! R1126: concurrent-control (11.1.7.2)
@@ -916,7 +1015,7 @@ Stmt_Tree concurrent_control(TT_Stream &ts) {
         opt(h_seq(TOK(TK_COLON),
                   tag_if(TAG(SG_CONCURRENT_STEP), rule(int_expr))))
         );
-  EVAL(SG_CONCURRENT_CONTROL, p(ts));
+  EVAL(SG_CONCURRENT_CONTROL, p);
 }
 
 //! R1125: concurrent-header (11.1.7.2)
@@ -930,7 +1029,7 @@ Stmt_Tree concurrent_header(TT_Stream &ts) {
            opt(h_seq(TOK(TK_COMMA),
                      rule(logical_expr)))
            );
-  EVAL(SG_CONCURRENT_HEADER, p(ts));
+  EVAL(SG_CONCURRENT_HEADER, p);
 }
 
 //! R1129: concurrent-locality (11.1.7.2)
@@ -940,14 +1039,14 @@ Stmt_Tree concurrent_locality(TT_Stream &ts) {
     seq(rule_tag, 
         star(rule(locality_spec))
         );
-  EVAL(SG_CONCURRENT_LOCALITY, p(ts));
+  EVAL(SG_CONCURRENT_LOCALITY, p);
 }
 
 //! R1543: contains-stmt (15.6.2.8)
 Stmt_Tree contains_stmt(TT_Stream &ts) {
   RULE(SG_CONTAINS_STMT);
   constexpr auto p = seq(rule_tag, TOK(KW_CONTAINS), eol());
-  EVAL(SG_CONTAINS_STMT, p(ts));
+  EVAL(SG_CONTAINS_STMT, p);
 }
 
 //! R1159: continue-stmt (11.3)
@@ -955,7 +1054,7 @@ Stmt_Tree continue_stmt(TT_Stream &ts) {
   RULE(SG_CONTINUE_STMT);
   constexpr auto p =
     seq(rule_tag, TOK(KW_CONTINUE), eol());
-  EVAL(SG_CONTINUE_STMT, p(ts));
+  EVAL(SG_CONTINUE_STMT, p);
 }
 
 //! R925: cosubscript (9.6)
@@ -963,7 +1062,7 @@ Stmt_Tree cosubscript(TT_Stream &ts) {
   RULE(SG_COSUBSCRIPT);
   constexpr auto p =
     tag_if(rule_tag, rule(int_expr));
-  EVAL(SG_COSUBSCRIPT, p(ts));
+  EVAL(SG_COSUBSCRIPT, p);
 }
 
 //! R1133: cycle-stmt (11.1.7.4.4)
@@ -971,7 +1070,7 @@ Stmt_Tree cycle_stmt(TT_Stream &ts) {
   RULE(SG_CYCLE_STMT);
   constexpr auto p =
     seq(rule_tag, TOK(KW_CYCLE), opt(name()), eol());
-  EVAL(SG_CYCLE_STMT, p(ts));
+  EVAL(SG_CYCLE_STMT, p);
 }
 
 /* I:D */
@@ -988,7 +1087,7 @@ Stmt_Tree data_component_def_stmt(TT_Stream &ts) {
                   TOK(TK_DBL_COLON))),
         list(TAG(SG_COMPONENT_DECL_LIST), rule(component_decl)),
         eol());
-  EVAL(SG_DATA_COMPONENT_DEF_STMT, p(ts));
+  EVAL(SG_DATA_COMPONENT_DEF_STMT, p);
 }
 
 //! TRUNCATED: R840: data-implied-do (8.6.7)
@@ -996,7 +1095,7 @@ Stmt_Tree data_implied_do(TT_Stream &ts) {
   RULE(SG_DATA_IMPLIED_DO);
   constexpr auto p =
     tag_if(rule_tag, rule(consume_parens));
-  EVAL(SG_DATA_IMPLIED_DO, p(ts));
+  EVAL(SG_DATA_IMPLIED_DO, p);
 }
 
 //! R1034: data-pointer-object (10.2.2.2)
@@ -1014,7 +1113,7 @@ Stmt_Tree data_pointer_object(TT_Stream &ts) {
          //     tag_if(TAG(SG_DATA_POINTER_COMPONENT_NAME), name())),
          tag_if(TAG(SG_VARIABLE_NAME), h_seq(name(), neg(TOK(TK_PERCENT))))
          );
-  EVAL(SG_DATA_POINTER_OBJECT, p(ts));
+  EVAL(SG_DATA_POINTER_OBJECT, p);
 }
 
 //! R911: data-ref (9.4.2)
@@ -1025,7 +1124,7 @@ Stmt_Tree data_ref(TT_Stream &ts) {
         rule(part_ref),
         star(h_seq(TOK(TK_PERCENT), rule(part_ref)))
         );
-  EVAL(SG_DATA_REF, p(ts));
+  EVAL(SG_DATA_REF, p);
 }
 
 //! R837: data-stmt (8.6.7)
@@ -1038,7 +1137,7 @@ Stmt_Tree data_stmt(TT_Stream &ts) {
              rule(data_stmt_set)),
         eol()
         );
-  EVAL(SG_DATA_STMT, p(ts));
+  EVAL(SG_DATA_STMT, p);
 }
 
 //! R845: data-stmt-constant (8.6.7)
@@ -1054,7 +1153,7 @@ Stmt_Tree data_stmt_constant(TT_Stream &ts) {
          tag_if(TAG(SG_INITIAL_DATA_TARGET), rule(designator)),
          rule(structure_constructor)
          );
-  EVAL(SG_DATA_STMT_CONSTANT, p(ts));
+  EVAL(SG_DATA_STMT_CONSTANT, p);
 }
 
 //! R838: data-stmt-object (8.6.7)
@@ -1064,7 +1163,7 @@ Stmt_Tree data_stmt_object(TT_Stream &ts) {
     alts(rule_tag,
          rule(data_implied_do),
          rule(variable));
-  EVAL(SG_DATA_STMT_OBJECT, p(ts));
+  EVAL(SG_DATA_STMT_OBJECT, p);
 }
 
 //! R844: data-stmt-repeat (8.6.7)
@@ -1076,7 +1175,7 @@ Stmt_Tree data_stmt_repeat(TT_Stream &ts) {
          name(),
          rule(designator)  // int-constant-subobject
          );
-  EVAL(SG_DATA_STMT_REPEAT, p(ts));
+  EVAL(SG_DATA_STMT_REPEAT, p);
 }
 
 //! R837: data-stmt-set (8.6.7)
@@ -1091,7 +1190,7 @@ Stmt_Tree data_stmt_set(TT_Stream &ts) {
              rule(data_stmt_value)),
         TOK(TK_SLASHF)
         );
-  EVAL(SG_DATA_STMT_SET, p(ts));
+  EVAL(SG_DATA_STMT_SET, p);
 }
 
 //! R843: data-stmt-value (8.6.7)
@@ -1102,7 +1201,7 @@ Stmt_Tree data_stmt_value(TT_Stream &ts) {
         opt(h_seq(rule(data_stmt_repeat),
                   TOK(TK_ASTERISK))),
         rule(data_stmt_constant));
-  EVAL(SG_DATA_STMT_VALUE, p(ts));
+  EVAL(SG_DATA_STMT_VALUE, p);
 }
 
 //! R941: dealloc-opt (9.7.3.1)
@@ -1112,7 +1211,7 @@ Stmt_Tree dealloc_opt(TT_Stream &ts) {
     alts(rule_tag,
          h_seq(TOK(KW_ERRMSG), TOK(TK_EQUAL), rule(variable)),
          h_seq(TOK(KW_STAT), TOK(TK_EQUAL), rule(variable)));
-  EVAL(SG_DEALLOC_OPT, p(ts));
+  EVAL(SG_DEALLOC_OPT, p);
 }
 
 //! R940: deallocate-stmt (9.7.3.1)
@@ -1128,7 +1227,7 @@ Stmt_Tree deallocate_stmt(TT_Stream &ts) {
                  ),
         eol()
         );
-  EVAL(SG_DEALLOCATE_STMT, p(ts));
+  EVAL(SG_DEALLOCATE_STMT, p);
 }
 
 //! R703: declaration-type-spec (7.3.2.1)
@@ -1143,7 +1242,7 @@ Stmt_Tree declaration_type_spec(TT_Stream &ts) {
          h_seq(TOK(KW_CLASS), h_parens(TOK(TK_ASTERISK))),
          h_seq(TOK(KW_TYPE),  h_parens(TOK(TK_ASTERISK)))
          );
-  EVAL(SG_DECLARATION_TYPE_SPEC, p(ts));
+  EVAL(SG_DECLARATION_TYPE_SPEC, p);
 }
 
 //! Special version that doesn't allow kind parameters on intrinsic types
@@ -1158,21 +1257,21 @@ Stmt_Tree declaration_type_spec_no_kind(TT_Stream &ts) {
          h_seq(TOK(KW_CLASS), h_parens(TOK(TK_ASTERISK))),
          h_seq(TOK(KW_TYPE),  h_parens(TOK(TK_ASTERISK)))
          );
-  EVAL(SG_DECLARATION_TYPE_SPEC, p(ts));
+  EVAL(SG_DECLARATION_TYPE_SPEC, p);
 }
 
 //! R1025: default-char-expr (10.1.9.1)
 Stmt_Tree default_char_expr(TT_Stream &ts) {
   RULE(SG_DEFAULT_CHAR_EXPR);
   constexpr auto p = tag_if(rule_tag, rule(expr));
-  EVAL(SG_DEFAULT_CHAR_EXPR, p(ts));
+  EVAL(SG_DEFAULT_CHAR_EXPR, p);
 }
 
 //! R820: deferred-shape-spec (8.5.8.4)
 Stmt_Tree deferred_shape_spec(TT_Stream &ts) {
   RULE(SG_DEFERRED_SHAPE_SPEC);
   constexpr auto p = tag_if(rule_tag, TOK(TK_COLON));
-  EVAL(SG_DEFERRED_SHAPE_SPEC, p(ts));
+  EVAL(SG_DEFERRED_SHAPE_SPEC, p);
 }
 
 //! R1509: defined-io-generic-spec (15.4.3.2)
@@ -1185,7 +1284,7 @@ Stmt_Tree defined_io_generic_spec(TT_Stream &ts) {
          h_seq(TOK(KW_WRITE), h_parens(TOK(KW_FORMATTED))),
          h_seq(TOK(KW_WRITE), h_parens(TOK(KW_UNFORMATTED)))
          );
-  EVAL(SG_DEFINED_IO_GENERIC_SPEC, p(ts));
+  EVAL(SG_DEFINED_IO_GENERIC_SPEC, p);
 }
 
 //! R609: defined-operator (6.2.4)
@@ -1195,7 +1294,7 @@ Stmt_Tree defined_operator(TT_Stream &ts) {
     alts(rule_tag,
          TOK(TK_DEF_OP),  // can't tell diff. here between unary/binary
          rule(extended_intrinsic_op));
-  EVAL(SG_DEFINED_OPERATOR, p(ts));
+  EVAL(SG_DEFINED_OPERATOR, p);
 }
 
 //! R754: derived-type-spec (7.5.9)
@@ -1207,7 +1306,7 @@ Stmt_Tree derived_type_spec(TT_Stream &ts) {
         opt(h_parens(list(TAG(SG_TYPE_PARAM_SPEC_LIST),
                          rule(type_param_spec))))
         );
-  EVAL(SG_DERIVED_TYPE_SPEC, p(ts));
+  EVAL(SG_DERIVED_TYPE_SPEC, p);
 }
 
 //! R727: derived-type-stmt (7.5.2.1)
@@ -1224,7 +1323,7 @@ Stmt_Tree derived_type_stmt(TT_Stream &ts) {
         opt(h_parens(list(TAG(SG_TYPE_PARAM_NAME_LIST),
                           tag_if(TAG(SG_TYPE_PARAM_NAME), name())))),
         eol());
-  EVAL(SG_DERIVED_TYPE_STMT, p(ts));
+  EVAL(SG_DERIVED_TYPE_STMT, p);
 }
 
 //! R901: designator (9.1)
@@ -1243,7 +1342,7 @@ Stmt_Tree designator(TT_Stream &ts) {
         rule(data_ref),
         opt(h_parens(rule(substring_range)))
         );
-  EVAL(SG_DESIGNATOR, p(ts));
+  EVAL(SG_DESIGNATOR, p);
 }
 
 //! R848: dimension-stmt (8.6.8)
@@ -1262,7 +1361,7 @@ Stmt_Tree dimension_stmt(TT_Stream &ts) {
                ),
         eol()
         );
-  EVAL(SG_DIMENSION_STMT, p(ts));
+  EVAL(SG_DIMENSION_STMT, p);
 }
 
 //! R1120: do-stmt (11.1.7.2)
@@ -1273,7 +1372,7 @@ Stmt_Tree do_stmt(TT_Stream &ts) {
         h_alts(rule(label_do_stmt),
                rule(nonlabel_do_stmt)),
         eol());
-  EVAL(SG_DO_STMT, p(ts));
+  EVAL(SG_DO_STMT, p);
 }
 
 
@@ -1284,7 +1383,7 @@ Stmt_Tree dummy_arg(TT_Stream &ts) {
     alts(rule_tag,
          name(), // dummy-arg-name
          TOK(TK_ASTERISK));
-  EVAL(SG_DUMMY_ARG, p(ts));
+  EVAL(SG_DUMMY_ARG, p);
 }
 
 /* I:E */
@@ -1297,7 +1396,7 @@ Stmt_Tree else_stmt(TT_Stream &ts) {
         TOK(KW_ELSE),
         opt(name()),
         eol());
-  EVAL(SG_ELSE_STMT, p(ts));
+  EVAL(SG_ELSE_STMT, p);
 }
 
 //! R1136: else-if-stmt (11.1.8.1)
@@ -1311,7 +1410,7 @@ Stmt_Tree else_if_stmt(TT_Stream &ts) {
         TOK(KW_THEN),
         opt(name()),
         eol());
-  EVAL(SG_ELSE_IF_STMT, p(ts));
+  EVAL(SG_ELSE_IF_STMT, p);
 }
 
 //! R1048: elsewhere-stmt (10.2.3.1)
@@ -1320,7 +1419,7 @@ Stmt_Tree elsewhere_stmt(TT_Stream &ts) {
   constexpr auto p =
     seq(rule_tag,
         TOK(KW_ELSE), TOK(KW_WHERE), opt(name()), eol());
-  EVAL(SG_ELSEWHERE_STMT, p(ts));
+  EVAL(SG_ELSEWHERE_STMT, p);
 }
 
 //! R1106: end-associate-stmt (11.1.3.2)
@@ -1332,7 +1431,7 @@ Stmt_Tree end_associate_stmt(TT_Stream &ts) {
         TOK(KW_ASSOCIATE),
         opt(name()),
         eol());
-  EVAL(SG_END_ASSOCIATE_STMT, p(ts));
+  EVAL(SG_END_ASSOCIATE_STMT, p);
 }
 
 //! R1108: end-block-stmt (11.1.4)
@@ -1344,7 +1443,7 @@ Stmt_Tree end_block_stmt(TT_Stream &ts) {
         TOK(KW_BLOCK),
         opt(name()),
         eol());
-  EVAL(SG_END_BLOCK_STMT, p(ts));
+  EVAL(SG_END_BLOCK_STMT, p);
 }
 
 //! R1131: end-do (11.1.7.2)
@@ -1354,7 +1453,7 @@ Stmt_Tree end_do(TT_Stream &ts) {
     alts(rule_tag,
          rule(end_do_stmt),
          rule(continue_stmt));
-  EVAL(SG_END_DO, p(ts));
+  EVAL(SG_END_DO, p);
 }
 
 //! R1132: end-do-stmt (11.1.7.2)
@@ -1362,7 +1461,7 @@ Stmt_Tree end_do_stmt(TT_Stream &ts) {
   RULE(SG_END_DO_STMT);
   constexpr auto p =
     seq(rule_tag, TOK(KW_END), TOK(KW_DO), opt(name()), eol());
-  EVAL(SG_END_DO_STMT, p(ts));
+  EVAL(SG_END_DO_STMT, p);
 }
 
 //! R763: end-enum-stmt (7.6)
@@ -1370,7 +1469,7 @@ Stmt_Tree end_enum_stmt(TT_Stream &ts) {
   RULE(SG_END_ENUM_STMT);
   constexpr auto p =
     seq(rule_tag, TOK(KW_END), TOK(KW_ENUM), eol());
-  EVAL(SG_END_ENUM_STMT, p(ts));
+  EVAL(SG_END_ENUM_STMT, p);
 }
 
 //! R1054: end-forall-stmt (10.2.4.1)
@@ -1379,7 +1478,7 @@ Stmt_Tree end_forall_stmt(TT_Stream &ts) {
   constexpr auto p =
     seq(rule_tag, TOK(KW_END), TOK(KW_FORALL),
         opt(name()), eol());
-  EVAL(SG_END_FORALL_STMT, p(ts));
+  EVAL(SG_END_FORALL_STMT, p);
 }
 
 //! R1533: end-function-stmt (15.6.2.2)
@@ -1392,7 +1491,7 @@ Stmt_Tree end_function_stmt(TT_Stream &ts) {
                   opt(name())) ),
         eol()
         );
-  EVAL(SG_END_FUNCTION_STMT, p(ts));
+  EVAL(SG_END_FUNCTION_STMT, p);
 }
 
 //! R1138: end-if-stmt (11.1.8.1)
@@ -1400,7 +1499,7 @@ Stmt_Tree end_if_stmt(TT_Stream &ts) {
   RULE(SG_END_IF_STMT);
   constexpr auto p =
     seq(rule_tag, TOK(KW_END), TOK(KW_IF), opt(name()), eol());
-  EVAL(SG_END_IF_STMT, p(ts));
+  EVAL(SG_END_IF_STMT, p);
 }
 
 //! R1504: end-interface-stmt (15.4.3.2)
@@ -1409,7 +1508,7 @@ Stmt_Tree end_interface_stmt(TT_Stream &ts) {
   constexpr auto p =
     seq(rule_tag, TOK(KW_END), TOK(KW_INTERFACE),
         opt(rule(generic_spec)), eol());
-  EVAL(SG_END_INTERFACE_STMT, p(ts));
+  EVAL(SG_END_INTERFACE_STMT, p);
 }
 
 //! R1406: end-module-stmt (14.2.1)
@@ -1421,7 +1520,7 @@ Stmt_Tree end_module_stmt(TT_Stream &ts) {
         opt(h_seq(TOK(KW_MODULE),  opt(name())) ),
         eol()
         );
-  EVAL(SG_END_MODULE_STMT, p(ts));
+  EVAL(SG_END_MODULE_STMT, p);
 }
 
 //! R1540: end-mp-subprogram-stmt (15.6.2.5)
@@ -1434,7 +1533,7 @@ Stmt_Tree end_mp_subprogram_stmt(TT_Stream &ts) {
                   opt(name())) ),
         eol()
         );
-  EVAL(SG_END_MP_SUBPROGRAM_STMT, p(ts));
+  EVAL(SG_END_MP_SUBPROGRAM_STMT, p);
 }
 
 //! R1403: end-program-stmt (14.1)
@@ -1446,7 +1545,7 @@ Stmt_Tree end_program_stmt(TT_Stream &ts) {
         opt(h_seq(TOK(KW_PROGRAM),  opt(name())) ),
         eol()
         );
-  EVAL(SG_END_PROGRAM_STMT, p(ts));
+  EVAL(SG_END_PROGRAM_STMT, p);
 }
 
 //! R1143: end-select-stmt (11.1.9.1)
@@ -1457,7 +1556,7 @@ Stmt_Tree end_select_stmt(TT_Stream &ts) {
         TOK(KW_END), TOK(KW_SELECT),
         opt(name()), // case-constuct-name
         eol());
-  EVAL(SG_END_SELECT_STMT, p(ts));
+  EVAL(SG_END_SELECT_STMT, p);
 }
 
 //! R1151: end-select-rank-stmt (11.1.10.1)
@@ -1468,7 +1567,7 @@ Stmt_Tree end_select_rank_stmt(TT_Stream &ts) {
         TOK(KW_END), TOK(KW_SELECT),
         opt(name()), // select-construct-name
         eol());
-  EVAL(SG_END_SELECT_RANK_STMT, p(ts));
+  EVAL(SG_END_SELECT_RANK_STMT, p);
 }
 
 //! R1155: end-select-type-stmt (11.1.11.1)
@@ -1479,7 +1578,7 @@ Stmt_Tree end_select_type_stmt(TT_Stream &ts) {
         TOK(KW_END), TOK(KW_SELECT),
         opt(name()), // select-construct-name
         eol());
-  EVAL(SG_END_SELECT_TYPE_STMT, p(ts));
+  EVAL(SG_END_SELECT_TYPE_STMT, p);
 }
 
 //! R1419: end-submodule-stmt (14.2.3)
@@ -1492,7 +1591,7 @@ Stmt_Tree end_submodule_stmt(TT_Stream &ts) {
                   opt(name())) ),
         eol()
         );
-  EVAL(SG_END_SUBMODULE_STMT, p(ts));
+  EVAL(SG_END_SUBMODULE_STMT, p);
 }
 
 //! R1537: end-subroutine-stmt (15.6.2.3)
@@ -1505,7 +1604,7 @@ Stmt_Tree end_subroutine_stmt(TT_Stream &ts) {
                   opt(name())) ),
         eol()
         );
-  EVAL(SG_END_SUBROUTINE_STMT, p(ts));
+  EVAL(SG_END_SUBROUTINE_STMT, p);
 }
 
 //! R730: end-type-stmt (7.5.2.1)
@@ -1517,7 +1616,7 @@ Stmt_Tree end_type_stmt(TT_Stream &ts) {
         TOK(KW_TYPE),
         opt(name()),  // type-name
         eol());
-  EVAL(SG_END_TYPE_STMT, p(ts));
+  EVAL(SG_END_TYPE_STMT, p);
 }
 
 //! R1049: end-where-stmt (10.2.3.1)
@@ -1526,7 +1625,7 @@ Stmt_Tree end_where_stmt(TT_Stream &ts) {
   constexpr auto p =
     seq(rule_tag,
         TOK(KW_END), TOK(KW_WHERE), opt(name()), eol());
-  EVAL(SG_END_WHERE_STMT, p(ts));
+  EVAL(SG_END_WHERE_STMT, p);
 }
 
 //! TRUNCATED R1225: endfile-stmt (12.8.1)
@@ -1538,7 +1637,7 @@ Stmt_Tree endfile_stmt(TT_Stream &ts) {
         h_alts(rule(int_expr),
                rule(consume_parens)),
         eol());
-  EVAL(SG_ENDFILE_STMT, p(ts));
+  EVAL(SG_ENDFILE_STMT, p);
 }
 
 //! R803: entity-decl (8.2)
@@ -1551,7 +1650,7 @@ Stmt_Tree entity_decl(TT_Stream &ts) {
         opt(h_brackets(rule(coarray_spec))),
         opt(h_seq(TOK(TK_ASTERISK), rule(char_length))),
         opt(rule(initialization)));
-  EVAL(SG_ENTITY_DECL, p(ts));
+  EVAL(SG_ENTITY_DECL, p);
 }
 
 //! R1541: entry-stmt (15.6.2.6)
@@ -1564,7 +1663,7 @@ Stmt_Tree entry_stmt(TT_Stream &ts) {
         opt(h_seq(h_parens(opt(h_list(rule(dummy_arg)))),
                   opt(rule(suffix)))),
         eol());
-  EVAL(SG_ENTRY_STMT, p(ts));
+  EVAL(SG_ENTRY_STMT, p);
 }
 
 //! R762: enumerator (7.6)
@@ -1575,7 +1674,7 @@ Stmt_Tree enumerator(TT_Stream &ts) {
         name(), // named-constant
         opt(h_seq(TOK(TK_EQUAL), rule(int_expr)))
         );
-  EVAL(SG_ENUMERATOR, p(ts));
+  EVAL(SG_ENUMERATOR, p);
 }
 
 //! R760: enumerator-def-stmt (7.6)
@@ -1588,7 +1687,7 @@ Stmt_Tree enumerator_def_stmt(TT_Stream &ts) {
         list(TAG(SG_ENUMERATOR_LIST),
              rule(enumerator)),
         eol());
-  EVAL(SG_ENUMERATOR_DEF_STMT, p(ts));
+  EVAL(SG_ENUMERATOR_DEF_STMT, p);
 }
 
 //! R759: enum-def-stmt (7.6)
@@ -1597,7 +1696,7 @@ Stmt_Tree enum_def_stmt(TT_Stream &ts) {
   auto p =
     seq(rule_tag,
         TOK(KW_ENUM), TOK(TK_COMMA), rule(bind_c), eol());
-  EVAL(SG_ENUM_DEF_STMT, p(ts));
+  EVAL(SG_ENUM_DEF_STMT, p);
 }
 
 //! R1021: equiv-op (6.2.4)
@@ -1607,7 +1706,7 @@ Stmt_Tree equiv_op(TT_Stream &ts) {
     alts(rule_tag,
          TOK(TK_REL_EQ),   // the lexer merges ".EQ." and "=="
          TOK(TK_REL_NE));
-  EVAL(SG_EQUIV_OP, p(ts));
+  EVAL(SG_EQUIV_OP, p);
 }
 
 //! R872: equivalence-object (8.10.1.1)
@@ -1618,7 +1717,7 @@ Stmt_Tree equivalence_object(TT_Stream &ts) {
          rule(array_element),
          rule(substring),
          tag_if(TAG(SG_VARIABLE_NAME), name()));
-  EVAL(SG_EQUIVALENCE_OBJECT, p(ts));
+  EVAL(SG_EQUIVALENCE_OBJECT, p);
 }
 
 //! R871: equivalence-set (8.10.1.1)
@@ -1630,7 +1729,7 @@ Stmt_Tree equivalence_set(TT_Stream &ts) {
            TOK(TK_COMMA),
            list(TAG(SG_EQUIVALENCE_OBJECT_LIST),
                 rule(equivalence_object)));
-  EVAL(SG_EQUIVALENCE_SET, p(ts));
+  EVAL(SG_EQUIVALENCE_SET, p);
 }
 
 //! R870: equivalence-stmt (8.10.1.1)
@@ -1642,7 +1741,7 @@ Stmt_Tree equivalence_stmt(TT_Stream &ts) {
         list(TAG(SG_EQUIVALENCE_SET_LIST),
              rule(equivalence_set)),
         eol());
-  EVAL(SG_EQUIVALENCE_STMT, p(ts));
+  EVAL(SG_EQUIVALENCE_STMT, p);
 }
 
 //! R1161: error-stop-stmt (11.4)
@@ -1658,7 +1757,7 @@ Stmt_Tree error_stop_stmt(TT_Stream &ts) {
                    TOK(TK_EQUAL),
                    rule(logical_expr))),
          eol());
-  EVAL(SG_ERROR_STOP_STMT, p(ts));
+  EVAL(SG_ERROR_STOP_STMT, p);
 }
 
 //! R1170: event-post-stmt (11.6.7)
@@ -1672,7 +1771,7 @@ Stmt_Tree event_post_stmt(TT_Stream &ts) {
                  opt(h_seq(TOK(TK_COMMA),
                            h_list(rule(sync_stat))))),
         eol());
-  EVAL(SG_EVENT_POST_STMT, p(ts));
+  EVAL(SG_EVENT_POST_STMT, p);
 }
 
 //! R1172: event-wait-stmt (11.6.8)
@@ -1689,7 +1788,7 @@ Stmt_Tree event_wait_stmt(TT_Stream &ts) {
                                                rule(expr)), 
                                          rule(sync_stat)))))),
         eol());
-  EVAL(SG_EVENT_WAIT_STMT, p(ts));
+  EVAL(SG_EVENT_WAIT_STMT, p);
 }
 
 //! R811: explicit-coshape-spec (8.5.6.3)
@@ -1704,7 +1803,7 @@ Stmt_Tree explicit_coshape_spec(TT_Stream &ts) {
         h_seq(opt(h_seq(rule(expr), TOK(TK_COLON))),
               TOK(TK_ASTERISK))
         );
-  EVAL(SG_EXPLICIT_COSHAPE_SPEC, p(ts));
+  EVAL(SG_EXPLICIT_COSHAPE_SPEC, p);
 }
 
 //! R816: explicit-shape-spec (8.5.8.2)
@@ -1714,7 +1813,7 @@ Stmt_Tree explicit_shape_spec(TT_Stream &ts) {
     seq(rule_tag,
         opt(h_seq(rule(expr), TOK(TK_COLON))),
         rule(expr));
-  EVAL(SG_EXPLICIT_SHAPE_SPEC, p(ts));
+  EVAL(SG_EXPLICIT_SHAPE_SPEC, p);
 }
 
 //! R1156: exit-stmt (11.1.12)
@@ -1722,7 +1821,7 @@ Stmt_Tree exit_stmt(TT_Stream &ts) {
   RULE(SG_EXIT_STMT);
   constexpr auto p =
     seq(rule_tag, TOK(KW_EXIT), opt(name()), eol());
-  EVAL(SG_EXIT_STMT, p(ts));
+  EVAL(SG_EXIT_STMT, p);
 }
 
 //! TRUNCATED R1022: expr (10.1.2.8)
@@ -1734,13 +1833,217 @@ Stmt_Tree expr(TT_Stream &ts) {
   EVAL(SG_EXPR, consume_until_break(ts, rule_tag));
 }
 
+/* The operator precedence of 10.1.2 (Table 10.2), from weakest to strongest
+   binding.  The not-op, the unary add-op and the defined-unary-op are prefix
+   operators, handled in expr_operand. */
+namespace {
+enum Expr_Prec_ {
+  PREC_DEFINED_BINARY = 1,
+  PREC_EQUIV,
+  PREC_OR,
+  PREC_AND,
+  PREC_NOT,
+  PREC_REL,
+  PREC_CONCAT,
+  PREC_ADD,
+  PREC_MULT,
+  PREC_POWER,
+  PREC_DEFINED_UNARY
+};
+
+//! How a token behaves as a binary operator
+struct Binary_Op {
+  int prec;      //!< binding strength, or zero if not a binary operator
+  int node_tag;  //!< syntag of the node that applies the operator
+  int op_tag;    //!< syntag of the operator node
+  bool right_assoc;
+};
+
+Binary_Op binary_op(int const token) {
+  switch (token) {
+  case TAG(TK_DEF_OP):
+    return {PREC_DEFINED_BINARY, TAG(SG_EXPR), TAG(SG_DEFINED_BINARY_OP),
+            false};
+  case TAG(TK_EQV_OP):
+  case TAG(TK_NEQV_OP):
+    return {PREC_EQUIV, TAG(SG_LEVEL_5_EXPR), TAG(SG_EQUIV_OP), false};
+  case TAG(TK_OR_OP):
+    return {PREC_OR, TAG(SG_EQUIV_OPERAND), TAG(SG_OR_OP), false};
+  case TAG(TK_AND_OP):
+    return {PREC_AND, TAG(SG_OR_OPERAND), TAG(SG_AND_OP), false};
+  case TAG(TK_REL_EQ):
+  case TAG(TK_REL_NE):
+  case TAG(TK_REL_LT):
+  case TAG(TK_REL_LE):
+  case TAG(TK_REL_GT):
+  case TAG(TK_REL_GE):
+    return {PREC_REL, TAG(SG_LEVEL_4_EXPR), TAG(SG_REL_OP), false};
+  case TAG(TK_CONCAT):
+    return {PREC_CONCAT, TAG(SG_LEVEL_3_EXPR), TAG(SG_CONCAT_OP), false};
+  case TAG(TK_PLUS):
+  case TAG(TK_MINUS):
+    return {PREC_ADD, TAG(SG_LEVEL_2_EXPR), TAG(SG_ADD_OP), false};
+  case TAG(TK_ASTERISK):
+  case TAG(TK_SLASHF):
+    return {PREC_MULT, TAG(SG_ADD_OPERAND), TAG(SG_MULT_OP), false};
+  case TAG(TK_POWER_OP):
+    return {PREC_POWER, TAG(SG_MULT_OPERAND), TAG(SG_POWER_OP), true};
+  default:
+    break;
+  }
+  return {0, TAG(UNKNOWN), TAG(UNKNOWN), false};
+}
+
+//! Consume one operator token, covering it with an op_tag node
+Stmt_Tree operator_node(TT_Stream &ts, int const op_tag) {
+  LL_TT_Range const op_range{ts.digest(1)};
+  Stmt_Tree op{op_tag, op_range};
+  op.graft_back(Stmt_Tree{op_range.front().token, op_range});
+  return op;
+}
+
+//! Build a node_tag node over the non-empty trees in parts
+template <typename... Ts>
+Stmt_Tree apply_operator(int const node_tag, Ts &&... parts) {
+  Stmt_Tree root{node_tag};
+  (hoist_back(root, std::forward<Ts>(parts)), ...);
+  cover_branches(*root);
+  return root;
+}
+
+Stmt_Tree climb_expr(TT_Stream &ts, int const min_prec);
+
+//! A prefix operator applied to an operand of at least operand_prec
+Stmt_Tree prefix_operation(TT_Stream &ts, int const node_tag,
+                           int const op_tag, int const operand_prec) {
+  INIT_FAIL;
+  Stmt_Tree op = operator_node(ts, op_tag);
+  Stmt_Tree operand = climb_expr(ts, operand_prec);
+  if (!operand)
+    FAIL;
+  return apply_operator(node_tag, std::move(op), std::move(operand));
+}
+
+/* An operand, with any prefix operators.  The unary add-op is also accepted
+   after a binary operator (e.g. "a * -b"), which is a common extension. */
+Stmt_Tree expr_operand(TT_Stream &ts) {
+  switch (ts.peek()) {
+  case TAG(TK_NOT_OP):
+    return prefix_operation(ts, TAG(SG_AND_OPERAND), TAG(SG_NOT_OP),
+                            PREC_NOT + 1);
+  case TAG(TK_PLUS):
+  case TAG(TK_MINUS):
+    return prefix_operation(ts, TAG(SG_LEVEL_2_EXPR), TAG(SG_ADD_OP),
+                            PREC_ADD + 1);
+  case TAG(TK_DEF_OP):
+    return prefix_operation(ts, TAG(SG_LEVEL_1_EXPR),
+                            TAG(SG_DEFINED_UNARY_OP), PREC_DEFINED_UNARY);
+  default:
+    break;
+  }
+  return primary(ts);
+}
+
+//! Precedence climbing over the binary operators of strength >= min_prec
+Stmt_Tree climb_expr(TT_Stream &ts, int const min_prec) {
+  Stmt_Tree lhs = expr_operand(ts);
+  if (!lhs)
+    return lhs;
+  int last_prec = 0;
+  for (;;) {
+    Binary_Op const op = binary_op(ts.peek());
+    if (op.prec < min_prec)
+      break;
+    /* The relational operators do not associate: "a < b < c" is an error */
+    if (PREC_REL == op.prec && PREC_REL == last_prec)
+      break;
+    /* If the right operand doesn't parse (e.g. the "/" in "/)" that closes an
+       array-constructor), this isn't a binary operator after all */
+    auto const op_mark = ts.mark();
+    Stmt_Tree op_tree = operator_node(ts, op.op_tag);
+    Stmt_Tree rhs = climb_expr(ts, op.right_assoc ? op.prec : op.prec + 1);
+    if (!rhs) {
+      ts.rewind(op_mark);
+      break;
+    }
+    lhs = apply_operator(op.node_tag, std::move(lhs), std::move(op_tree),
+                         std::move(rhs));
+    last_prec = op.prec;
+  }
+  return lhs;
+}
+
+//! The operator tree of a whole expr
+Stmt_Tree operator_tree(TT_Stream &ts) {
+  OPAQUE_RULE;
+  return climb_expr(ts, PREC_DEFINED_BINARY);
+}
+
+//! Return true if syntag is the root of an operator tree or primary
+bool is_expr_structure(int const syntag) {
+  switch (syntag) {
+  case TAG(SG_EXPR):
+  case TAG(SG_LEVEL_5_EXPR):
+  case TAG(SG_EQUIV_OPERAND):
+  case TAG(SG_OR_OPERAND):
+  case TAG(SG_AND_OPERAND):
+  case TAG(SG_LEVEL_4_EXPR):
+  case TAG(SG_LEVEL_3_EXPR):
+  case TAG(SG_LEVEL_2_EXPR):
+  case TAG(SG_ADD_OPERAND):
+  case TAG(SG_MULT_OPERAND):
+  case TAG(SG_LEVEL_1_EXPR):
+  case TAG(SG_PRIMARY):
+    return true;
+  default:
+    break;
+  }
+  return false;
+}
+} // namespace
+
+//! R1022: expr (10.1.2.8), with the full operator structure
+Stmt_Tree structured_expr(TT_Stream &ts) {
+  RULE(SG_EXPR);
+  constexpr auto p = seq(rule_tag, rule(operator_tree));
+  EVAL(SG_EXPR, p);
+}
+
+bool is_expanded_expr(Stmt_Tree::const_reference expr) {
+  return expr->syntag == TAG(SG_EXPR) && expr.num_branches() == 1 &&
+         is_expr_structure(expr.branches().front()->syntag);
+}
+
+bool expand_expr(Stmt_Tree::reference expr) {
+  if (expr->syntag != TAG(SG_EXPR))
+    return false;
+  if (is_expanded_expr(expr))
+    return true;
+  if (expr->token_range.empty())
+    return false;
+  TT_Stream ts{LL_TT_Range{expr->token_range}};
+  Stmt_Tree st = structured_expr(ts);
+  if (!st || !ts.is_eol())
+    return false;
+  expr.branches().clear();
+  expr.emplace_back(std::move(st->branches().front()));
+  return true;
+}
+
+void expand_exprs(Stmt_Tree::reference st) {
+  expand_expr(st);
+  if (st.is_fork())
+    for (auto &b : st.branches())
+      expand_exprs(b);
+}
+
 //! R610: extended-intrinsic-op (6.2.4)
 Stmt_Tree extended_intrinsic_op(TT_Stream &ts) {
   RULE(SG_EXTENDED_INTRINSIC_OP);
   constexpr auto p =
     tag_if(rule_tag,
            rule(intrinsic_operator));
-  EVAL(SG_EXTENDED_INTRINSIC_OP, p(ts));
+  EVAL(SG_EXTENDED_INTRINSIC_OP, p);
 }
 
 //! R1511: external-stmt (15.4.3.5)
@@ -1751,7 +2054,7 @@ Stmt_Tree external_stmt(TT_Stream &ts) {
         TOK(KW_EXTERNAL), opt(TOK(TK_DBL_COLON)),
         list(TAG(SG_EXTERNAL_NAME_LIST), name()),
         eol());
-  EVAL(SG_EXTERNAL_STMT, p(ts));
+  EVAL(SG_EXTERNAL_STMT, p);
 }
 
 /* I:F */
@@ -1764,7 +2067,7 @@ Stmt_Tree fail_image_stmt(TT_Stream &ts) {
         TOK(KW_FAIL),
         TOK(KW_IMAGE),
         eol());
-  EVAL(SG_FAIL_IMAGE_STMT, p(ts));
+  EVAL(SG_FAIL_IMAGE_STMT, p);
 }
 
 //! R1175: form-team-stmt (11.6.9)
@@ -1787,7 +2090,7 @@ Stmt_Tree form_team_stmt(TT_Stream &ts) {
                        )
                  ),
         eol());
-  EVAL(SG_FORM_TEAM_STMT, p(ts));
+  EVAL(SG_FORM_TEAM_STMT, p);
 }
 
 //! R753: final-procedure-stmt (7.5.6.1)
@@ -1799,7 +2102,7 @@ Stmt_Tree final_procedure_stmt(TT_Stream &ts) {
         opt(TOK(TK_DBL_COLON)),
         list(TAG(SG_FINAL_SUBROUTINE_NAME_LIST), name()),
         eol());
-  EVAL(SG_FINAL_PROCEDURE_STMT, p(ts));
+  EVAL(SG_FINAL_PROCEDURE_STMT, p);
 }
 
 //! TRUNCATED R1228: flush-stmt (12.9)
@@ -1811,7 +2114,7 @@ Stmt_Tree flush_stmt(TT_Stream &ts) {
         h_alts(rule(int_expr),
                rule(consume_parens)),
         eol());
-  EVAL(SG_FLUSH_STMT, p(ts));
+  EVAL(SG_FLUSH_STMT, p);
 }
 
 //! R1053: forall-assignment-stmt (10.2.4.1)
@@ -1822,7 +2125,7 @@ Stmt_Tree forall_assignment_stmt(TT_Stream &ts) {
          rule(assignment_stmt),
          rule(pointer_assignment_stmt));
   // no eol() here as the alternatives are both full statements
-  EVAL(SG_FORALL_ASSIGNMENT_STMT, p(ts));
+  EVAL(SG_FORALL_ASSIGNMENT_STMT, p);
 }
 
 //! R1051: forall-construct-stmt (10.2.4.1)
@@ -1835,7 +2138,7 @@ Stmt_Tree forall_construct_stmt(TT_Stream &ts) {
         TOK(KW_FORALL),
         rule(concurrent_header),
         eol());
-  EVAL(SG_FORALL_CONSTRUCT_STMT, p(ts));
+  EVAL(SG_FORALL_CONSTRUCT_STMT, p);
 }
 
 //! R1055: forall-stmt (10.2.4.3)
@@ -1847,7 +2150,7 @@ Stmt_Tree forall_stmt(TT_Stream &ts) {
         rule(concurrent_header),
         rule(forall_assignment_stmt),
         eol());
-  EVAL(SG_FORALL_STMT, p(ts));
+  EVAL(SG_FORALL_STMT, p);
 }
 
 //! R1215: format (12.6.2.2)
@@ -1858,7 +2161,7 @@ Stmt_Tree format(TT_Stream &ts) {
          h_seq(rule(expr), neg(peek(TAG(TK_EQUAL)))),
          // label: handled by the expr above
          TOK(TK_ASTERISK));
-  EVAL(SG_FORMAT, p(ts));
+  EVAL(SG_FORMAT, p);
 }
 
 //! TRUNCATED R1302: format-specification (13.2.1)
@@ -1866,7 +2169,7 @@ Stmt_Tree format_specification(TT_Stream &ts) {
   RULE(SG_FORMAT_SPECIFICATION);
   constexpr auto p =
     tag_if(rule_tag, rule(consume_parens));
-  EVAL(SG_FORMAT_SPECIFICATION, p(ts));
+  EVAL(SG_FORMAT_SPECIFICATION, p);
 }
 
 //! R1301: format-stmt (13.2.1)
@@ -1874,7 +2177,7 @@ Stmt_Tree format_stmt(TT_Stream &ts) {
   RULE(SG_FORMAT_STMT);
   constexpr auto p =
     seq(rule_tag, TOK(KW_FORMAT), rule(format_specification), eol());
-  EVAL(SG_FORMAT_STMT, p(ts));
+  EVAL(SG_FORMAT_STMT, p);
 }
 
 //! R1520: function-reference (15.5.1)
@@ -1886,7 +2189,7 @@ Stmt_Tree function_reference(TT_Stream &ts) {
         h_parens(opt(list(TAG(SG_ACTUAL_ARG_SPEC_LIST),
                           rule(actual_arg_spec))))
         );
-  EVAL(SG_FUNCTION_REFERENCE, p(ts));
+  EVAL(SG_FUNCTION_REFERENCE, p);
 }
 
 //! R1530: function-stmt (15.6.2.2)
@@ -1905,7 +2208,7 @@ Stmt_Tree function_stmt(TT_Stream &ts) {
         opt(rule(suffix)),
         eol()
         );
-  EVAL(SG_FUNCTION_STMT, p(ts));
+  EVAL(SG_FUNCTION_STMT, p);
 }
 
 /* I:G */
@@ -1920,7 +2223,7 @@ Stmt_Tree generic_spec(TT_Stream &ts) {
          h_seq(TOK(KW_ASSIGNMENT), h_parens(TOK(TK_EQUAL))),
          rule(defined_io_generic_spec)
          );  
-  EVAL(SG_GENERIC_SPEC, p(ts));
+  EVAL(SG_GENERIC_SPEC, p);
 }
 
 //! R1510: generic-stmt (15.4.3.3)
@@ -1935,7 +2238,7 @@ Stmt_Tree generic_stmt(TT_Stream &ts) {
         TOK(TK_ARROW),
         h_list(name()), // specific-procedure-list
         eol());
-  EVAL(SG_GENERIC_STMT, p(ts));
+  EVAL(SG_GENERIC_STMT, p);
 }       
 
 //! R1157: goto-stmt (11.2.2)
@@ -1944,7 +2247,7 @@ Stmt_Tree goto_stmt(TT_Stream &ts) {
   constexpr auto p =
     seq(rule_tag,
         TOK(KW_GO), TOK(KW_TO), rule(label), eol());
-  EVAL(SG_GOTO_STMT, p(ts));
+  EVAL(SG_GOTO_STMT, p);
 }
 /* I:H */
 
@@ -1959,7 +2262,7 @@ Stmt_Tree if_stmt(TT_Stream &ts) {
         h_parens(rule(logical_expr)),
         rule(action_stmt),
         eol());
-  EVAL(SG_IF_STMT, p(ts));
+  EVAL(SG_IF_STMT, p);
 }
 
 //! R1135: if-then-stmt (11.1.8.1)
@@ -1972,7 +2275,7 @@ Stmt_Tree if_then_stmt(TT_Stream &ts) {
         h_parens(rule(logical_expr)),
         TOK(KW_THEN),
         eol());
-  EVAL(SG_IF_THEN_STMT, p(ts));
+  EVAL(SG_IF_THEN_STMT, p);
 }
 
 //! R924: image-selector (9.6)
@@ -1986,7 +2289,7 @@ Stmt_Tree image_selector(TT_Stream &ts) {
                        list(TAG(SG_IMAGE_SELECTOR_SPEC_LIST),
                             rule(image_selector_spec))))
              );
-  EVAL(SG_IMAGE_SELECTOR, p(ts));
+  EVAL(SG_IMAGE_SELECTOR, p);
 }
 
 //! R926: image-selector-spec (9.6)
@@ -1998,7 +2301,7 @@ Stmt_Tree image_selector_spec(TT_Stream &ts) {
          h_seq(TOK(KW_TEAM), TOK(TK_EQUAL), rule(expr)),
          h_seq(TOK(KW_TEAM_NUMBER), TOK(TK_EQUAL), rule(expr))
          );
-  EVAL(SG_IMAGE_SELECTOR_SPEC, p(ts));
+  EVAL(SG_IMAGE_SELECTOR_SPEC, p);
 }
 
 //! R866: implicit-none-spec (8.7)
@@ -2009,7 +2312,7 @@ Stmt_Tree implicit_none_spec(TT_Stream &ts) {
          TOK(KW_EXTERNAL),
          TOK(KW_TYPE)
          );
-  EVAL(SG_IMPLICIT_NONE_SPEC, p(ts));
+  EVAL(SG_IMPLICIT_NONE_SPEC, p);
 }
 
 //! R864: implicit-spec (8.7)
@@ -2026,7 +2329,7 @@ Stmt_Tree implicit_spec(TT_Stream &ts) {
          h_seq(rule(declaration_type_spec_no_kind),
                h_parens(list(TAG(SG_LETTER_SPEC_LIST), rule(letter_spec))))
          );
-  EVAL(SG_IMPLICIT_SPEC, p(ts));
+  EVAL(SG_IMPLICIT_SPEC, p);
 }
 
 //! R863: implicit-stmt (8.7)
@@ -2042,7 +2345,7 @@ Stmt_Tree implicit_stmt(TT_Stream &ts) {
                                       rule(implicit_spec)),
                eol())
          );
-  EVAL(SG_IMPLICIT_STMT, p(ts));
+  EVAL(SG_IMPLICIT_STMT, p);
 }
 
 //! R823: implied-shape-or-assumed-size-spec (8.5.8.5)
@@ -2052,7 +2355,7 @@ Stmt_Tree implied_shape_or_assumed_size_spec(TT_Stream &ts) {
     seq(rule_tag,
         rule(assumed_implied_spec)
         );
-  EVAL(SG_IMPLIED_SHAPE_SPEC, p(ts));
+  EVAL(SG_IMPLIED_SHAPE_SPEC, p);
 }
 
 //! R824: implied-shape-spec (8.5.8.5)
@@ -2067,7 +2370,7 @@ Stmt_Tree implied_shape_spec(TT_Stream &ts) {
         TOK(TK_COMMA),
         list(TAG(SG_ASSUMED_IMPLIED_SPEC_LIST), rule(assumed_implied_spec))
         );
-  EVAL(SG_IMPLIED_SHAPE_SPEC, p(ts));
+  EVAL(SG_IMPLIED_SHAPE_SPEC, p);
 }
 
 //! R867: import-stmt (8.8)
@@ -2082,7 +2385,7 @@ Stmt_Tree import_stmt(TT_Stream &ts) {
                list(TAG(SG_IMPORT_NAME_LIST), name()), eol()),
          h_seq(TOK(KW_IMPORT), TOK(TK_COMMA),
                h_alts(TOK(KW_NONE), TOK(KW_ALL))), eol());
-  EVAL(SG_IMPORT_STMT, p(ts));
+  EVAL(SG_IMPORT_STMT, p);
 }
 
 //! TRUNCATED R805: initialization (8.2)
@@ -2092,7 +2395,7 @@ Stmt_Tree initialization(TT_Stream &ts) {
     alts(rule_tag,
          h_seq(TOK(TK_EQUAL), rule(expr)),
          h_seq(TOK(TK_ARROW), rule(expr)));
-  EVAL(SG_INITIALIZATION, p(ts));
+  EVAL(SG_INITIALIZATION, p);
 }
 
 //! R1216: input-item (12.6.3)
@@ -2102,7 +2405,7 @@ Stmt_Tree input_item(TT_Stream &ts) {
     alts(rule_tag,
          rule(io_implied_do),
          rule(variable));
-  EVAL(SG_INPUT_ITEM, p(ts));
+  EVAL(SG_INPUT_ITEM, p);
 }
 
 //! TRUNCATED R1230: inquire-stmt (12.10.1)
@@ -2114,21 +2417,21 @@ Stmt_Tree inquire_stmt(TT_Stream &ts) {
         rule(consume_parens),
         opt(list(TAG(SG_OUTPUT_ITEM_LIST), rule(output_item))),
         eol());
-  EVAL(SG_INQUIRE_STMT, p(ts));
+  EVAL(SG_INQUIRE_STMT, p);
 }
 
 //! R1031: int-constant-expr (10.1.12)
 Stmt_Tree int_constant_expr(TT_Stream &ts) {
   RULE(SG_INT_CONSTANT_EXPR);
   constexpr auto p = tag_if(rule_tag, rule(int_expr));
-  EVAL(SG_INT_CONSTANT_EXPR, p(ts));
+  EVAL(SG_INT_CONSTANT_EXPR, p);
 }
 
 //! R1026: int-expr (10.1.9.1)
 Stmt_Tree int_expr(TT_Stream &ts) {
   RULE(SG_INT_EXPR);
   constexpr auto p = tag_if(rule_tag, rule(expr));
-  EVAL(SG_INT_EXPR, p(ts));
+  EVAL(SG_INT_EXPR, p);
 }
 
 //! R705: integer-type-spec (7.4.1)
@@ -2136,7 +2439,7 @@ Stmt_Tree integer_type_spec(TT_Stream &ts) {
   RULE(SG_INTEGER_TYPE_SPEC);
   constexpr auto p =
     seq(rule_tag, TOK(KW_INTEGER), opt(rule(kind_selector)));
-  EVAL(SG_INTEGER_TYPE_SPEC, p(ts));
+  EVAL(SG_INTEGER_TYPE_SPEC, p);
 }
 
 //! R826: intent-spec (8.5.10)
@@ -2148,7 +2451,7 @@ Stmt_Tree intent_spec(TT_Stream &ts) {
          TOK(KW_IN),
          TOK(KW_OUT),
          TOK(KW_INOUT));
-  EVAL(SG_INTENT_SPEC, p(ts));
+  EVAL(SG_INTENT_SPEC, p);
 }
 
 //! R849: intent-stmt (8.6.9)
@@ -2162,7 +2465,7 @@ Stmt_Tree intent_stmt(TT_Stream &ts) {
         list(TAG(SG_DUMMY_ARG_NAME_LIST),
              name()),
         eol());
-  EVAL(SG_INTENT_STMT, p(ts));
+  EVAL(SG_INTENT_STMT, p);
 }
 
 //! R1503: interface-stmt (15.4.3.2)
@@ -2172,7 +2475,7 @@ Stmt_Tree interface_stmt(TT_Stream &ts) {
     alts(rule_tag,
          h_seq(TOK(KW_INTERFACE), opt(rule(generic_spec)), eol()),
          h_seq(TOK(KW_ABSTRACT), TOK(KW_INTERFACE)), eol());
-  EVAL(SG_INTERFACE_STMT, p(ts));
+  EVAL(SG_INTERFACE_STMT, p);
 }
 
 //! R608: intrinsic-operator (6.2.4)
@@ -2189,7 +2492,7 @@ Stmt_Tree intrinsic_operator(TT_Stream &ts) {
          TOK(TK_AND_OP),
          TOK(TK_OR_OP),
          rule(equiv_op));
-  EVAL(SG_INTRINSIC_OPERATOR, p(ts));
+  EVAL(SG_INTRINSIC_OPERATOR, p);
 }
 
 //! R1519: intrinsic-stmt (15.4.3.7)
@@ -2202,7 +2505,7 @@ Stmt_Tree intrinsic_stmt(TT_Stream &ts) {
         list(TAG(SG_INTRINSIC_PROCEDURE_NAME_LIST),
              name()),
         eol());
-  EVAL(SG_INTRINSIC_STMT, p(ts));
+  EVAL(SG_INTRINSIC_STMT, p);
 }
 
 //! R704: intrinsic-type-spec (7.4.1)
@@ -2218,7 +2521,7 @@ Stmt_Tree intrinsic_type_spec(TT_Stream &ts) {
          TOK(KW_DOUBLEPRECISION),
          h_seq(TOK(KW_CHARACTER), opt(rule(char_selector)))
          );
-  EVAL(SG_INTRINSIC_TYPE_SPEC, p(ts));
+  EVAL(SG_INTRINSIC_TYPE_SPEC, p);
 }
 
 //! Special version that doesn't consume a trailing paren expression
@@ -2234,7 +2537,7 @@ Stmt_Tree intrinsic_type_spec_no_kind(TT_Stream &ts) {
          TOK(KW_DOUBLEPRECISION),
          TOK(KW_CHARACTER)
          );
-  EVAL(SG_INTRINSIC_TYPE_SPEC, p(ts));
+  EVAL(SG_INTRINSIC_TYPE_SPEC, p);
 }
 
 //! R1218: io-implied-do (12.6.3)
@@ -2247,7 +2550,7 @@ Stmt_Tree io_implied_do(TT_Stream &ts) {
                  TOK(TK_COMMA),
                  rule(io_implied_do_control))
            );
-  EVAL(SG_IO_IMPLIED_DO, p(ts));
+  EVAL(SG_IO_IMPLIED_DO, p);
 }
 
 //! R1220: io-implied-do-control (12.6.3)
@@ -2259,7 +2562,7 @@ Stmt_Tree io_implied_do_control(TT_Stream &ts) {
         rule(expr), TOK(TK_COMMA), rule(expr), 
         opt(h_seq(TOK(TK_COMMA), rule(expr)))
         );
-  EVAL(SG_IO_IMPLIED_DO_CONTROL, p(ts));
+  EVAL(SG_IO_IMPLIED_DO_CONTROL, p);
 }
 
 //! R1219: io-implied-do-object (12.6.3)
@@ -2270,7 +2573,7 @@ Stmt_Tree io_implied_do_object(TT_Stream &ts) {
          h_seq(rule(input_item), neg(peek(TAG(TK_EQUAL)))),
          h_seq(rule(output_item), neg(peek(TAG(TK_EQUAL))))
          );
-  EVAL(SG_IO_IMPLIED_DO_OBJECT, p(ts));
+  EVAL(SG_IO_IMPLIED_DO_OBJECT, p);
 }
 
 /* I:J */
@@ -2287,7 +2590,7 @@ Stmt_Tree kind_selector(TT_Stream &ts) {
          // obsolete F77 style
          h_seq(TOK(TK_ASTERISK), TOK(SG_INT_LITERAL_CONSTANT))
          );
-  EVAL(SG_KIND_SELECTOR, p(ts));
+  EVAL(SG_KIND_SELECTOR, p);
 }
 
 /* I:L */
@@ -2299,7 +2602,7 @@ Stmt_Tree label(TT_Stream &ts) {
      actual rule is "digit [digit [digit [ digit [ digit ] ] ] ]" */
   constexpr auto p =
     tag_if(rule_tag, TOK(SG_INT_LITERAL_CONSTANT));
-  EVAL(SG_LABEL, p(ts));
+  EVAL(SG_LABEL, p);
 }
 
 //! R1121: label-do-stmt (11.1.7.2)
@@ -2311,7 +2614,7 @@ Stmt_Tree label_do_stmt(TT_Stream &ts) {
         TOK(KW_DO), rule(label),
         opt(rule(loop_control)),
         eol());
-  EVAL(SG_LABEL_DO_STMT, p(ts));
+  EVAL(SG_LABEL_DO_STMT, p);
 }
 
 //! R808: language-binding-spec (8.5.5)
@@ -2327,7 +2630,7 @@ Stmt_Tree language_binding_spec(TT_Stream &ts) {
             ),
         TOK(TK_PARENR)
         );
-  EVAL(SG_LANGUAGE_BINDING_SPEC, p(ts));
+  EVAL(SG_LANGUAGE_BINDING_SPEC, p);
 }
 
 //! R722: length-selector (7.4.4.2)
@@ -2338,7 +2641,7 @@ Stmt_Tree length_selector(TT_Stream &ts) {
          h_parens(opt(h_seq(TOK(KW_LEN), TOK(TK_EQUAL))),
                  rule(type_param_value)),
          h_seq(TOK(TK_ASTERISK), rule(char_length)));
-  EVAL(SG_LENGTH_SELECTOR, p(ts));
+  EVAL(SG_LENGTH_SELECTOR, p);
 }
 
 //! R865: letter_spec (8.7)
@@ -2348,7 +2651,7 @@ Stmt_Tree letter_spec(TT_Stream &ts) {
     seq(rule_tag,
         letter(), opt(h_seq(TOK(TK_MINUS), letter()))
         );
-  EVAL(SG_LETTER_SPEC, p(ts));
+  EVAL(SG_LETTER_SPEC, p);
 }
 
 //! R1130: locality-spec (11.1.7.2)
@@ -2367,7 +2670,7 @@ Stmt_Tree locality_spec(TT_Stream &ts) {
                              tag_if(TAG(SG_VARIABLE_NAME), name())))),
          h_seq(TOK(KW_DEFAULT), TOK(TK_PARENL), TOK(KW_NONE), TOK(TK_PARENR))
          );
-  EVAL(SG_LOCALITY_SPEC, p(ts));
+  EVAL(SG_LOCALITY_SPEC, p);
 }
 
 //! R1179: lock-stmt (11.6.10)
@@ -2383,7 +2686,7 @@ Stmt_Tree lock_stmt(TT_Stream &ts) {
                                                rule(variable)),
                                          rule(sync_stat)))))),
         eol());
-  EVAL(SG_LOCK_STMT, p(ts));
+  EVAL(SG_LOCK_STMT, p);
 }
 
 //! R1024: logical-expr (10.1.9.1)
@@ -2391,7 +2694,7 @@ Stmt_Tree logical_expr(TT_Stream &ts) {
   RULE(SG_LOGICAL_EXPR);
   constexpr auto p =
     tag_if(rule_tag, rule(expr));
-  EVAL(SG_LOGICAL_EXPR, p(ts));
+  EVAL(SG_LOGICAL_EXPR, p);
 }
 
 //! R725: logical-literal-constant (7.4.5)
@@ -2401,7 +2704,7 @@ Stmt_Tree logical_literal_constant(TT_Stream &ts) {
     alts(rule_tag,
          TOK(TK_FALSE_CONSTANT),
          TOK(TK_TRUE_CONSTANT));
-  EVAL(SG_LOGICAL_LITERAL_CONSTANT, p(ts));
+  EVAL(SG_LOGICAL_LITERAL_CONSTANT, p);
 }
  
 //! R1123: loop-control (11.1.7.1)
@@ -2425,7 +2728,7 @@ Stmt_Tree loop_control(TT_Stream &ts) {
                      opt(rule(concurrent_locality)))
                )
         );
-  EVAL(SG_LOOP_CONTROL, p(ts));
+  EVAL(SG_LOOP_CONTROL, p);
 }
 
 //! R934: lower-bound-expr (9.7.1.1)
@@ -2433,7 +2736,7 @@ Stmt_Tree lower_bound_expr(TT_Stream &ts) {
   RULE(SG_LOWER_BOUND_EXPR);
   constexpr auto p =
     tag_if(rule_tag, rule(expr));
-  EVAL(SG_LOWER_BOUND_EXPR, p(ts));
+  EVAL(SG_LOWER_BOUND_EXPR, p);
 }
 
 /* I:M */
@@ -2452,7 +2755,7 @@ Stmt_Tree macro_stmt(TT_Stream &ts) {
         name(),
         rule(consume_parens),
         eol());
-  EVAL(SG_MACRO_STMT, p(ts));
+  EVAL(SG_MACRO_STMT, p);
 }
 
 //! R1047: masked-elsewhere-stmt (10.2.3.1)
@@ -2464,7 +2767,7 @@ Stmt_Tree masked_elsewhere_stmt(TT_Stream &ts) {
         h_parens(rule(logical_expr)),
         opt(name()),
         eol());
-  EVAL(SG_MASKED_ELSEWHERE_STMT, p(ts));
+  EVAL(SG_MASKED_ELSEWHERE_STMT, p);
 }
 
 //! R1410: module-nature (14.2.2)
@@ -2472,7 +2775,7 @@ Stmt_Tree module_nature(TT_Stream &ts) {
   RULE(SG_MODULE_NATURE);
   constexpr auto p =
     alts(rule_tag, TOK(KW_INTRINSIC), TOK(KW_NON_INTRINSIC));
-  EVAL(SG_MODULE_NATURE, p(ts));
+  EVAL(SG_MODULE_NATURE, p);
 }
 
 //! R1405: module-stmt (14.2.1)
@@ -2480,7 +2783,7 @@ Stmt_Tree module_stmt(TT_Stream &ts) {
   RULE(SG_MODULE_STMT);
   constexpr auto p =
     seq(rule_tag, TOK(KW_MODULE), name(), eol());
-  EVAL(SG_MODULE_STMT, p(ts));
+  EVAL(SG_MODULE_STMT, p);
 }
 
 //! R1539: mp-subprogram-stmt (15.6.2.5)
@@ -2490,7 +2793,7 @@ Stmt_Tree mp_subprogram_stmt(TT_Stream &ts) {
     seq(rule_tag,
         TOK(KW_MODULE), TOK(KW_PROCEDURE),
         name(), eol());
-  EVAL(SG_MP_SUBPROGRAM_STMT, p(ts));
+  EVAL(SG_MP_SUBPROGRAM_STMT, p);
 }
 
 //! R1008: mult-op (6.2.4)
@@ -2500,7 +2803,7 @@ Stmt_Tree mult_op(TT_Stream &ts) {
     alts(rule_tag,
          TOK(TK_ASTERISK),
          TOK(TK_SLASHF));
-  EVAL(SG_MULT_OP, p(ts));
+  EVAL(SG_MULT_OP, p);
 }
 
 /* I:N */
@@ -2510,7 +2813,7 @@ Stmt_Tree named_constant_def(TT_Stream &ts) {
   RULE(SG_NAMED_CONSTANT_DEF);
   constexpr auto p =
     seq(rule_tag, name(), TOK(TK_EQUAL), rule(expr));
-  EVAL(SG_NAMED_CONSTANT_DEF, p(ts));
+  EVAL(SG_NAMED_CONSTANT_DEF, p);
 }
 
 //! R868: namelist-stmt (8.9)
@@ -2530,7 +2833,7 @@ Stmt_Tree namelist_stmt(TT_Stream &ts) {
                    list(TAG(SG_NAMELIST_GROUP_OBJECT_LIST),
                         name()))), // namelist-group-object
         eol());
-  EVAL(SG_NAMELIST_STMT, p(ts));
+  EVAL(SG_NAMELIST_STMT, p);
 }
 
 //! R1122: nonlabel-do-stmt (11.1.7.2)
@@ -2542,7 +2845,7 @@ Stmt_Tree nonlabel_do_stmt(TT_Stream &ts) {
         TOK(KW_DO),
         opt(rule(loop_control)),
         eol());
-  EVAL(SG_NONLABEL_DO_STMT, p(ts));
+  EVAL(SG_NONLABEL_DO_STMT, p);
 }
 
 //! R938: nullify-stmt (9.7.2)
@@ -2554,7 +2857,7 @@ Stmt_Tree nullify_stmt(TT_Stream &ts) {
         h_parens(list(TAG(SG_POINTER_OBJECT_LIST),
                       rule(pointer_object))),
         eol());
-  EVAL(SG_NULLIFY_STMT, p(ts));
+  EVAL(SG_NULLIFY_STMT, p);
 }
 
 /* I:O */
@@ -2567,7 +2870,7 @@ Stmt_Tree only(TT_Stream &ts) {
          rule(rename), // this should be first to get the long sequence
          rule(generic_spec),
          rule(list_name));
-  EVAL(SG_ONLY, p(ts));
+  EVAL(SG_ONLY, p);
 }
 
 //! TRUNCATED R1204: open-stmt (12.5.6.2)
@@ -2578,7 +2881,7 @@ Stmt_Tree open_stmt(TT_Stream &ts) {
         TOK(KW_OPEN),
         rule(consume_parens),
         eol());
-  EVAL(SG_OPEN_STMT, p(ts));
+  EVAL(SG_OPEN_STMT, p);
 }
 
 //! R850: optional-stmt (8.6.10)
@@ -2589,14 +2892,14 @@ Stmt_Tree optional_stmt(TT_Stream &ts) {
         TOK(KW_OPTIONAL), opt(TOK(TK_DBL_COLON)),
         list(TAG(SG_DUMMY_ARG_NAME_LIST), name()),
         eol());
-  EVAL(SG_OPTIONAL_STMT, p(ts));
+  EVAL(SG_OPTIONAL_STMT, p);
 }
 
 //! R513: other-specification-stmt (5.1)
 Stmt_Tree other_specification_stmt(TT_Stream &ts) {
   RULE(SG_OTHER_SPECIFICATION_STMT);
   constexpr auto p =
-    alts(rule_tag,
+    adaptive_alts(rule_tag,
          rule(access_stmt),
          rule(allocatable_stmt),
          rule(asynchronous_stmt),
@@ -2619,7 +2922,7 @@ Stmt_Tree other_specification_stmt(TT_Stream &ts) {
          );
   auto res = p(ts);
   if(!res.match) {
-    res = get_parser_exts().parse_other_specification_stmt(ts);
+    res = ts.parser_exts().parse_other_specification_stmt(ts);
   }
 
   EVAL(SG_OTHER_SPECIFICATION_STMT, res);
@@ -2632,7 +2935,7 @@ Stmt_Tree output_item(TT_Stream &ts) {
     alts(rule_tag,
          rule(io_implied_do),
          rule(expr));
-  EVAL(SG_OUTPUT_ITEM, p(ts));
+  EVAL(SG_OUTPUT_ITEM, p);
 }
 
 /* I:P */
@@ -2646,7 +2949,7 @@ Stmt_Tree parameter_stmt(TT_Stream &ts) {
                      rule(named_constant_def))),
         eol()
         );
-  EVAL(SG_PARAMETER_STMT, p(ts));
+  EVAL(SG_PARAMETER_STMT, p);
 }
 
 //! R909: parent-string (9.4.1)
@@ -2660,7 +2963,7 @@ Stmt_Tree parent_string(TT_Stream &ts) {
          TOK(SG_CHAR_LITERAL_CONSTANT),
          name()  // scalar-variable-name
          );
-  EVAL(SG_PARENT_STRING, p(ts));
+  EVAL(SG_PARENT_STRING, p);
 }
 
 //! R912: part-ref (9.4.2)
@@ -2673,7 +2976,7 @@ Stmt_Tree part_ref(TT_Stream &ts) {
                           rule(section_subscript)))),
         opt(rule(image_selector))
         );
-  EVAL(SG_PART_REF, p(ts));
+  EVAL(SG_PART_REF, p);
 }
 
 //! R1033: pointer-assignment-stmt (10.2.2.2)
@@ -2698,7 +3001,7 @@ Stmt_Tree pointer_assignment_stmt(TT_Stream &ts) {
                rule(proc_target),
                eol())
          );
-  EVAL(SG_POINTER_ASSIGNMENT_STMT, p(ts));
+  EVAL(SG_POINTER_ASSIGNMENT_STMT, p);
 }
 
 //! R854: pointer-decl (8.6.12)
@@ -2709,7 +3012,7 @@ Stmt_Tree pointer_decl(TT_Stream &ts) {
         name(),  // object-name or proc-entity-name
         opt(h_parens(h_list(TOK(TK_COLON)))) // deferred-shape-spec-list
         );
-  EVAL(SG_POINTER_DECL, p(ts));
+  EVAL(SG_POINTER_DECL, p);
 }
 
 //! R939: pointer-object (9.7.2)
@@ -2721,7 +3024,7 @@ Stmt_Tree pointer_object(TT_Stream &ts) {
          name()  // variable-name
          // proc-pointer-name (equiv to previous alt)
          );
-  EVAL(SG_POINTER_OBJECT, p(ts));
+  EVAL(SG_POINTER_OBJECT, p);
 }
 
 //! R853: pointer-stmt (8.6.12)
@@ -2735,7 +3038,7 @@ Stmt_Tree pointer_stmt(TT_Stream &ts) {
              rule(pointer_decl)),
         eol()
         );
-  EVAL(SG_POINTER_STMT, p(ts));
+  EVAL(SG_POINTER_STMT, p);
 }
 
 //! R1526: prefix (15.6.2.1)
@@ -2743,7 +3046,7 @@ Stmt_Tree prefix(TT_Stream &ts) {
   RULE(SG_PREFIX);
   constexpr auto p =
     tag_if(rule_tag, star(rule(prefix_spec)));
-  EVAL(SG_PREFIX, p(ts));
+  EVAL(SG_PREFIX, p);
 }
 
 //! R1527: prefix-spec (15.6.2.1)
@@ -2759,7 +3062,31 @@ Stmt_Tree prefix_spec(TT_Stream &ts) {
          TOK(KW_RECURSIVE),
          rule(declaration_type_spec)
          );
-  EVAL(SG_PREFIX_SPEC, p(ts));
+  EVAL(SG_PREFIX_SPEC, p);
+}
+
+//! R1001: primary (10.1.2.2)
+Stmt_Tree primary(TT_Stream &ts) {
+  RULE(SG_PRIMARY);
+  /* A designator followed by an open paren is taken to be a
+     function-reference with an actual-arg-spec-list that isn't a valid
+     section-subscript-list (e.g. keyword arguments, or empty parens).  The
+     type-param-inquiry and structure-constructor forms reduce syntactically to
+     designator or function-reference. */
+  constexpr auto p =
+    alts(rule_tag,
+         rule(real_literal_constant),
+         TOK(SG_INT_LITERAL_CONSTANT),
+         TOK(SG_CHAR_LITERAL_CONSTANT),
+         rule(logical_literal_constant),
+         rule(array_constructor),
+         rule(parens_or_complex),
+         h_seq(rule(designator), neg(peek(TAG(TK_PARENL)))),
+         tag_if(TAG(SG_FUNCTION_REFERENCE),
+                h_seq(tag_if(TAG(SG_PROCEDURE_DESIGNATOR), rule(data_ref)),
+                      h_parens(opt(list(TAG(SG_ACTUAL_ARG_SPEC_LIST),
+                                        rule(actual_arg_spec)))))));
+  EVAL(SG_PRIMARY, p);
 }
 
 //! R1212: print-stmt (12.6.1)
@@ -2770,7 +3097,7 @@ Stmt_Tree print_stmt(TT_Stream &ts) {
         opt(h_seq(TOK(TK_COMMA), list(TAG(SG_OUTPUT_ITEM_LIST),
                                       rule(output_item)))),
         eol());
-  EVAL(SG_PRINT_STMT, p(ts));
+  EVAL(SG_PRINT_STMT, p);
 }
 
 //! R745: private-components-stmt (7.5.4)
@@ -2780,7 +3107,7 @@ Stmt_Tree private_components_stmt(TT_Stream &ts) {
     seq(rule_tag,
         TOK(KW_PRIVATE),
         eol());
-  EVAL(SG_PRIVATE_COMPONENTS_STMT, p(ts));
+  EVAL(SG_PRIVATE_COMPONENTS_STMT, p);
 }
 
 //! R729: private-or-sequence (7.5.2.1)
@@ -2790,7 +3117,7 @@ Stmt_Tree private_or_sequence(TT_Stream &ts) {
     alts(rule_tag,
          rule(private_components_stmt),
          rule(sequence_stmt));
-  EVAL(SG_PRIVATE_OR_SEQUENCE, p(ts));
+  EVAL(SG_PRIVATE_OR_SEQUENCE, p);
 }
 
 //! R1514: proc-attr-spec (15.4.3.6)
@@ -2805,7 +3132,7 @@ Stmt_Tree proc_attr_spec(TT_Stream &ts) {
          TOK(KW_POINTER),
          TOK(KW_PROTECTED),
          TOK(KW_SAVE));
-  EVAL(SG_PROC_ATTR_SPEC, p(ts));
+  EVAL(SG_PROC_ATTR_SPEC, p);
 }
 
 //! R742: proc-component-attr-spec (7.5.4.1)
@@ -2817,7 +3144,7 @@ Stmt_Tree proc_component_attr_spec(TT_Stream &ts) {
          TOK(KW_NOPASS),
          h_seq(TOK(KW_PASS), opt(h_parens(name()))), // arg-name
          TOK(KW_POINTER));
-  EVAL(SG_PROC_COMPONENT_ATTR_SPEC, p(ts));
+  EVAL(SG_PROC_COMPONENT_ATTR_SPEC, p);
 }
 
 //! R741: proc-component-def-stmt (7.5.4.1)
@@ -2834,7 +3161,7 @@ Stmt_Tree proc_component_def_stmt(TT_Stream &ts) {
         list(TAG(SG_PROC_DECL_LIST),
              rule(proc_decl)),
         eol());
-  EVAL(SG_PROC_COMPONENT_DEF_STMT, p(ts));
+  EVAL(SG_PROC_COMPONENT_DEF_STMT, p);
 }
 
 //! R1039: proc-component-ref (10.2.2.2)
@@ -2851,7 +3178,7 @@ Stmt_Tree proc_component_ref(TT_Stream &ts) {
         // TOK(TK_PERCENT),
         // procedure-component-name
         );
-  EVAL(SG_PROC_COMPONENT_REF, p(ts));
+  EVAL(SG_PROC_COMPONENT_REF, p);
 }
 
 //! R1515: proc-decl (15.4.3.6)
@@ -2863,7 +3190,7 @@ Stmt_Tree proc_decl(TT_Stream &ts) {
         opt(h_seq(TOK(TK_ARROW),
                   rule(proc_pointer_init)))
         );
-  EVAL(SG_PROC_DECL, p(ts));
+  EVAL(SG_PROC_DECL, p);
 }
 
 //! R1513: proc-interface (15.4.3.6)
@@ -2873,7 +3200,7 @@ Stmt_Tree proc_interface(TT_Stream &ts) {
     alts(rule_tag,
          name(), // interface-name
          rule(declaration_type_spec));
-  EVAL(SG_PROC_INTERFACE, p(ts));
+  EVAL(SG_PROC_INTERFACE, p);
 }
 
 //! R1528: proc-language-binding-spec (15.6.2.1)
@@ -2881,7 +3208,7 @@ Stmt_Tree proc_language_binding_spec(TT_Stream &ts) {
   RULE(SG_PROC_LANGUAGE_BINDING_SPEC);
   constexpr auto p =
     tag_if(rule_tag, rule(language_binding_spec));
-  EVAL(SG_PROC_LANGUAGE_BINDING_SPEC, p(ts));
+  EVAL(SG_PROC_LANGUAGE_BINDING_SPEC, p);
 }
 
 //! R1517: proc-pointer-init (15.4.3.6)
@@ -2892,7 +3219,7 @@ Stmt_Tree proc_pointer_init(TT_Stream &ts) {
          tag_if(TAG(SG_NULL_INIT), rule(function_reference)),
          name() // initial-proc-target
          );
-  EVAL(SG_PROC_POINTER_INIT, p(ts));
+  EVAL(SG_PROC_POINTER_INIT, p);
 }
 
 //! R1038: proc-pointer-object (10.2.2.2)
@@ -2903,7 +3230,7 @@ Stmt_Tree proc_pointer_object(TT_Stream &ts) {
          tag_if(TAG(SG_PROC_POINTER_NAME),
                 h_seq(name(), neg(TOK(TK_PERCENT)))),
          rule(proc_component_ref));
-  EVAL(SG_PROC_POINTER_OBJECT, p(ts));
+  EVAL(SG_PROC_POINTER_OBJECT, p);
 }
 
 //! R1040: proc-target (10.2.2.2)
@@ -2914,7 +3241,7 @@ Stmt_Tree proc_target(TT_Stream &ts) {
          rule(expr),
          name(), // procedure-name
          rule(proc_component_ref));
-  EVAL(SG_PROC_TARGET, p(ts));
+  EVAL(SG_PROC_TARGET, p);
 }
 
 //! R1512: procedure-declaration-stmt (15.4.3.6)
@@ -2931,7 +3258,7 @@ Stmt_Tree procedure_declaration_stmt(TT_Stream &ts) {
              rule(proc_decl)),
         eol()
         );
-  EVAL(SG_PROCEDURE_DECLARATION_STMT, p(ts));
+  EVAL(SG_PROCEDURE_DECLARATION_STMT, p);
 }
 
 //! R1520: procedure-designator (15.5.1)
@@ -2991,7 +3318,7 @@ Stmt_Tree procedure_stmt(TT_Stream &ts) {
         list(TAG(SG_SPECIFIC_PROCEDURE_LIST),
              tag_if(TAG(SG_SPECIFIC_PROCEDURE), name())),
         eol());
-  EVAL(SG_PROCEDURE_STMT, p(ts));
+  EVAL(SG_PROCEDURE_STMT, p);
 }
 
 //! R1401: program-stmt (14.1)
@@ -3002,7 +3329,7 @@ Stmt_Tree program_stmt(TT_Stream &ts) {
         TOK(KW_PROGRAM),
         name(),  // program-name
         eol());
-  EVAL(SG_PROGRAM_STMT, p(ts));
+  EVAL(SG_PROGRAM_STMT, p);
 }
 
 //! R855: protected-stmt (8.6.13)
@@ -3014,7 +3341,7 @@ Stmt_Tree protected_stmt(TT_Stream &ts) {
         opt(TOK(TK_DBL_COLON)),
         h_list(name()),
         eol());
-  EVAL(SG_PROTECTED_STMT, p(ts));
+  EVAL(SG_PROTECTED_STMT, p);
 }
 
 /* I:Q */
@@ -3038,7 +3365,7 @@ Stmt_Tree read_stmt(TT_Stream &ts) {
                             list(TAG(SG_INPUT_ITEM_LIST),
                                  rule(input_item)))))),
         eol());
-  EVAL(SG_READ_STMT, p(ts));
+  EVAL(SG_READ_STMT, p);
 }
 
 //! R714: real-literal-constant (7.4.3.2)
@@ -3052,7 +3379,7 @@ Stmt_Tree real_literal_constant(TT_Stream &ts) {
         opt(h_seq(TOK(TK_UNDERSCORE),
                   TOK(SG_KIND_PARAM)))
         );
-  EVAL(SG_REAL_LITERAL_CONSTANT, p(ts));
+  EVAL(SG_REAL_LITERAL_CONSTANT, p);
 }
 
 //! R1031: rel-op (6.2.4)
@@ -3064,7 +3391,7 @@ Stmt_Tree rel_op(TT_Stream &ts) {
          TOK(TK_REL_LE),  // similar for the rest of these
          TOK(TK_REL_GT),
          TOK(TK_REL_GE));
-  EVAL(SG_REL_OP, p(ts));
+  EVAL(SG_REL_OP, p);
 }
 
 //! R1411: rename (14.2.2)
@@ -3076,7 +3403,7 @@ Stmt_Tree rename(TT_Stream &ts) {
          h_seq(TOK(KW_OPERATOR), h_parens(TOK(TK_DEF_OP)),
                TOK(TK_ARROW),
                TOK(KW_OPERATOR), h_parens(TOK(TK_DEF_OP)) ));
-  EVAL(SG_RENAME, p(ts));
+  EVAL(SG_RENAME, p);
 }
 
 //! R1542: return-stmt (15.6.2.7)
@@ -3084,7 +3411,7 @@ Stmt_Tree return_stmt(TT_Stream &ts) {
   RULE(SG_RETURN_STMT);
   constexpr auto p =
     seq(rule_tag, TOK(KW_RETURN), opt(rule(int_expr)), eol());
-  EVAL(SG_RETURN_STMT, p(ts));
+  EVAL(SG_RETURN_STMT, p);
 }
 
 //! TRUNCATED R1226: rewind-stmt (12.8.1)
@@ -3096,7 +3423,7 @@ Stmt_Tree rewind_stmt(TT_Stream &ts) {
         h_alts(rule(int_expr),
                rule(consume_parens)),
         eol());
-  EVAL(SG_REWIND_STMT, p(ts));
+  EVAL(SG_REWIND_STMT, p);
 }
 
 /* I:S */
@@ -3112,7 +3439,7 @@ Stmt_Tree save_stmt(TT_Stream &ts) {
                        rule(saved_entity)))),
         eol()
         );
-  EVAL(SG_SAVE_STMT, p(ts));
+  EVAL(SG_SAVE_STMT, p);
 }
 
 //! R857: saved-entity (8.6.14)
@@ -3124,7 +3451,7 @@ Stmt_Tree saved_entity(TT_Stream &ts) {
          // proc-pointer-name,
          h_seq(TOK(TK_SLASHF), name(), TOK(TK_SLASHF)) /* /common-block-name/ */
          );
-  EVAL(SG_SAVED_ENTITY, p(ts));
+  EVAL(SG_SAVED_ENTITY, p);
 }
 
 //! R920: section-subscript (9.5.3.1)
@@ -3137,7 +3464,7 @@ Stmt_Tree section_subscript(TT_Stream &ts) {
                opt(rule(int_expr)),
                opt(h_seq(TOK(TK_COLON), rule(int_expr)))),
          rule(int_expr));
-  EVAL(SG_SECTION_SUBSCRIPT, p(ts));
+  EVAL(SG_SECTION_SUBSCRIPT, p);
 }
 
 //! R1141: select-case-stmt (11.1.9.1)
@@ -3150,7 +3477,7 @@ Stmt_Tree select_case_stmt(TT_Stream &ts) {
         h_parens(tag_if(TAG(SG_CASE_EXPR), rule(expr))),
         eol()
         );
-  EVAL(SG_SELECT_CASE_STMT, p(ts));
+  EVAL(SG_SELECT_CASE_STMT, p);
 }
 
 //! R1149: select-rank-stmt (11.1.10.1)
@@ -3163,7 +3490,7 @@ Stmt_Tree select_rank_stmt(TT_Stream &ts) {
         h_parens(h_seq(opt(h_seq(name(), TOK(TK_ARROW))), // associate-name
                        rule(selector))),
         eol());
-  EVAL(SG_SELECT_RANK_STMT, p(ts));
+  EVAL(SG_SELECT_RANK_STMT, p);
 }
 
 //! R1150: select-rank-case-stmt (11.1.10.1)
@@ -3176,7 +3503,7 @@ Stmt_Tree select_rank_case_stmt(TT_Stream &ts) {
                h_parens(TOK(TK_ASTERISK)),
                h_parens(rule(int_constant_expr))),
         eol());
-  EVAL(SG_SELECT_RANK_CASE_STMT, p(ts));
+  EVAL(SG_SELECT_RANK_CASE_STMT, p);
 }
 
 //! R1152: select-type-stmt (11.1.11.1)
@@ -3189,7 +3516,7 @@ Stmt_Tree select_type_stmt(TT_Stream &ts) {
         h_parens(h_seq(opt(h_seq(name(), TOK(TK_ARROW))), // associate-name
                        rule(selector))),
         eol());
-  EVAL(SG_SELECT_TYPE_STMT, p(ts));
+  EVAL(SG_SELECT_TYPE_STMT, p);
 }
 
 //! R1105: selector (11.1.3.1)
@@ -3199,7 +3526,7 @@ Stmt_Tree selector(TT_Stream &ts) {
     alts(rule_tag,
          rule(expr),      // do the long one first
          rule(variable));
-  EVAL(SG_SELECTOR, p(ts));
+  EVAL(SG_SELECTOR, p);
 }
 
 //! R731: sequence-stmt (7.6.2.3)
@@ -3209,7 +3536,7 @@ Stmt_Tree sequence_stmt(TT_Stream &ts) {
     seq(rule_tag,
         TOK(KW_SEQUENCE),
         eol());
-  EVAL(SG_SEQUENCE_STMT, p(ts));
+  EVAL(SG_SEQUENCE_STMT, p);
 }
 
 //! R712: sign (7.4.3.1)
@@ -3219,7 +3546,7 @@ Stmt_Tree sign(TT_Stream &ts) {
     alts(rule_tag,
          TOK(TK_PLUS),
          TOK(TK_MINUS));
-  EVAL(SG_SIGN, p(ts));
+  EVAL(SG_SIGN, p);
 }
 
 //! R713: signed-real-literal-constant (7.4.3.2)
@@ -3229,7 +3556,7 @@ Stmt_Tree signed_real_literal_constant(TT_Stream &ts) {
     seq(rule_tag,
         opt(rule(sign)),
         rule(real_literal_constant));
-  EVAL(SG_SIGNED_REAL_LITERAL_CONSTANT, p(ts));
+  EVAL(SG_SIGNED_REAL_LITERAL_CONSTANT, p);
 }
 
 //! R1160: stop-stmt (11.4)
@@ -3244,7 +3571,7 @@ Stmt_Tree stop_stmt(TT_Stream &ts) {
                    TOK(TK_EQUAL),
                    rule(logical_expr))),
          eol());
-  EVAL(SG_STOP_STMT, p(ts));
+  EVAL(SG_STOP_STMT, p);
 }
 
 //! R913: structure-component (9.4.2)
@@ -3258,7 +3585,7 @@ Stmt_Tree structure_component(TT_Stream &ts) {
         star(h_seq(rule(part_ref), TOK(TK_PERCENT))),
         name(),
         opt(rule(image_selector)));
-  EVAL(SG_STRUCTURE_COMPONENT, p(ts));
+  EVAL(SG_STRUCTURE_COMPONENT, p);
 }
 
 //! R756: structure-constructor (7.5.10)
@@ -3269,7 +3596,7 @@ Stmt_Tree structure_constructor(TT_Stream &ts) {
         rule(derived_type_spec),
         h_parens(opt(list(TAG(SG_COMPONENT_SPEC_LIST),
                           rule(component_spec)))));
-  EVAL(SG_STRUCTURE_CONSTRUCTOR, p(ts));
+  EVAL(SG_STRUCTURE_CONSTRUCTOR, p);
 }
 
 //! R1416: submodule-stmt (14.2.3)
@@ -3280,7 +3607,7 @@ Stmt_Tree submodule_stmt(TT_Stream &ts) {
         name(), opt(h_seq(TOK(TK_COLON), name())),
         TOK(TK_PARENR),
         eol());
-  EVAL(SG_SUBMODULE_STMT, p(ts));
+  EVAL(SG_SUBMODULE_STMT, p);
 }
 
 //! R1535: subroutine-stmt (15.6.2.3)
@@ -3298,7 +3625,7 @@ Stmt_Tree subroutine_stmt(TT_Stream &ts) {
         opt(rule(proc_language_binding_spec)),
         eol()
         );
-  EVAL(SG_SUBROUTINE_STMT, p(ts));
+  EVAL(SG_SUBROUTINE_STMT, p);
 }
 
 //! R908: substring (9.4.1)
@@ -3307,7 +3634,7 @@ Stmt_Tree substring(TT_Stream &ts) {
   constexpr auto p =
     seq(rule_tag,
         rule(parent_string), h_parens(rule(substring_range)));
-  EVAL(SG_SUBSTRING, p(ts));
+  EVAL(SG_SUBSTRING, p);
 }
 
 //! R910: substring-range (9.4.1)
@@ -3318,7 +3645,7 @@ Stmt_Tree substring_range(TT_Stream &ts) {
         opt(rule(int_expr)),
         TOK(TK_COLON),
         opt(rule(int_expr)));
-  EVAL(SG_SUBSTRING_RANGE, p(ts));
+  EVAL(SG_SUBSTRING_RANGE, p);
 }
 
 //! R1532: suffix (15.6.2.2)
@@ -3330,7 +3657,7 @@ Stmt_Tree suffix(TT_Stream &ts) {
          h_seq(rule(proc_language_binding_spec), opt(RESULT)),
          h_seq(RESULT, opt(rule(proc_language_binding_spec)))
          );
-  EVAL(SG_SUFFIX, p(ts));
+  EVAL(SG_SUFFIX, p);
 #undef RESULT
 }
 
@@ -3343,7 +3670,7 @@ Stmt_Tree sync_all_stmt(TT_Stream &ts) {
         TOK(KW_ALL),
         opt(h_parens(opt(h_list(rule(sync_stat))))),
         eol());
-  EVAL(SG_SYNC_ALL_STMT, p(ts));
+  EVAL(SG_SYNC_ALL_STMT, p);
 }
 
 //! R1164: sync-images-stmt (11.6.3)
@@ -3360,7 +3687,7 @@ Stmt_Tree sync_images_stmt(TT_Stream &ts) {
                  ),
         eol()
         );
-  EVAL(SG_SYNC_IMAGES_STMT, p(ts));
+  EVAL(SG_SYNC_IMAGES_STMT, p);
 }
 
 //! R1168: sync-memory-stmt (11.6.5)
@@ -3372,7 +3699,7 @@ Stmt_Tree sync_memory_stmt(TT_Stream &ts) {
         TOK(KW_MEMORY),
         opt(h_parens(opt(h_list(rule(sync_stat))))),
         eol());
-  EVAL(SG_SYNC_ALL_STMT, p(ts));
+  EVAL(SG_SYNC_ALL_STMT, p);
 }
 
 //! R1165: sync-stat (11.6.3)
@@ -3383,7 +3710,7 @@ Stmt_Tree sync_stat(TT_Stream &ts) {
          h_seq(TOK(KW_STAT), TOK(TK_EQUAL), rule(variable)),
          h_seq(TOK(KW_ERRMSG), TOK(TK_EQUAL), rule(variable))
          );
-  EVAL(SG_SYNC_STAT, p(ts));
+  EVAL(SG_SYNC_STAT, p);
 }
 
 //! R1169: sync-team-stmt (11.6.6)
@@ -3399,7 +3726,7 @@ Stmt_Tree sync_team_stmt(TT_Stream &ts) {
                  ),
         eol()
         );
-  EVAL(SG_SYNC_TEAM_STMT, p(ts));
+  EVAL(SG_SYNC_TEAM_STMT, p);
 }
 
 
@@ -3413,7 +3740,7 @@ Stmt_Tree target_decl(TT_Stream &ts) {
         name(),  // object-name
         opt(h_parens(rule(array_spec))),
         opt(h_brackets(rule(coarray_spec))));
-  EVAL(SG_TARGET_DECL, p(ts));
+  EVAL(SG_TARGET_DECL, p);
 }
 
 //! R859: target-stmt (8.6.15)
@@ -3425,7 +3752,7 @@ Stmt_Tree target_stmt(TT_Stream &ts) {
         opt(TOK(TK_DBL_COLON)),
         list(TAG(SG_TARGET_DECL_LIST), rule(target_decl)),
         eol());
-  EVAL(SG_TARGET_STMT, p(ts));
+  EVAL(SG_TARGET_STMT, p);
 }
 
 //! R728: type-attr-spec (7.5.2)
@@ -3438,7 +3765,7 @@ Stmt_Tree type_attr_spec(TT_Stream &ts) {
          rule(bind_c),
          h_seq(TOK(KW_EXTENDS), h_parens(name())) // parent-type-name
          );
-  EVAL(SG_TYPE_ATTR_SPEC, p(ts));
+  EVAL(SG_TYPE_ATTR_SPEC, p);
 }
 
 //! R751: type-bound-generic-stmt (7.5.5)
@@ -3454,7 +3781,7 @@ Stmt_Tree type_bound_generic_stmt(TT_Stream &ts) {
         list(TAG(SG_BINDING_NAME_LIST),
              name()),
         eol());
-  EVAL(SG_TYPE_BOUND_GENERIC_STMT, p(ts));
+  EVAL(SG_TYPE_BOUND_GENERIC_STMT, p);
 }
 
 //! R748: type-bound-proc-binding (7.5.5)
@@ -3465,7 +3792,7 @@ Stmt_Tree type_bound_proc_binding(TT_Stream &ts) {
          rule(type_bound_procedure_stmt),
          rule(type_bound_generic_stmt),
          rule(final_procedure_stmt));
-  EVAL(SG_TYPE_BOUND_PROC_BINDING, p(ts));
+  EVAL(SG_TYPE_BOUND_PROC_BINDING, p);
 }
 
 //! R750: type-bound-proc-decl (7.5.5)
@@ -3477,7 +3804,7 @@ Stmt_Tree type_bound_proc_decl(TT_Stream &ts) {
         opt(h_seq(TOK(TK_ARROW),
                   name())) // procedure-name
         );
-  EVAL(SG_TYPE_BOUND_PROC_DECL, p(ts));
+  EVAL(SG_TYPE_BOUND_PROC_DECL, p);
 }
 
 //! R749: type-bound-procedure-stmt (7.5.5)
@@ -3504,7 +3831,7 @@ Stmt_Tree type_bound_procedure_stmt(TT_Stream &ts) {
                     name()),
                eol())
          );
-  EVAL(SG_TYPE_BOUND_PROCEDURE_STMT, p(ts));
+  EVAL(SG_TYPE_BOUND_PROCEDURE_STMT, p);
 }
 
 //! R801 (local mod 1): type-decl-attr-seq
@@ -3523,7 +3850,7 @@ Stmt_Tree type_decl_attr_seq1(TT_Stream &ts) {
         rule(declaration_type_spec),
         opt(h_seq(star(h_seq(TOK(TK_COMMA), rule(attr_spec))),
                   TOK(TK_DBL_COLON))));
-  EVAL(SG_TYPE_DECL_ATTR_SEQ, p(ts));
+  EVAL(SG_TYPE_DECL_ATTR_SEQ, p);
 }
 
 //! R801 (local mod 2): type-decl-attr-seq
@@ -3551,7 +3878,7 @@ Stmt_Tree type_decl_attr_seq2(TT_Stream &ts) {
                     seq(TAG(SG_LENGTH_SELECTOR),
                         TOK(TK_ASTERISK), rule(char_length), TOK(TK_COMMA)))))
         );
-  EVAL(SG_TYPE_DECL_ATTR_SEQ, p(ts));
+  EVAL(SG_TYPE_DECL_ATTR_SEQ, p);
 }
 
 //! R801: type-declaration-stmt (8.2)
@@ -3568,7 +3895,7 @@ Stmt_Tree type_declaration_stmt(TT_Stream &ts) {
          /* R722 + C725 and C726 */
          h_seq(rule(type_decl_attr_seq2),
                list(TAG(SG_ENTITY_DECL_LIST), rule(entity_decl)), eol()));
-  EVAL(SG_TYPE_DECLARATION_STMT, p(ts));
+  EVAL(SG_TYPE_DECLARATION_STMT, p);
 }
 
 //! R1154: type-guard-stmt (11.1.11.1)
@@ -3583,7 +3910,7 @@ Stmt_Tree type_guard_stmt(TT_Stream &ts) {
          h_seq(TOK(KW_CLASS), TOK(KW_DEFAULT),
                opt(name()), eol())   // select-construct-name
          );
-  EVAL(SG_TYPE_GUARD_STMT, p(ts));
+  EVAL(SG_TYPE_GUARD_STMT, p);
 }
 
 //! R734: type-param-attr-spec (7.5.3.1)
@@ -3593,7 +3920,7 @@ Stmt_Tree type_param_attr_spec(TT_Stream &ts) {
     alts(rule_tag,
          TOK(KW_KIND),
          TOK(KW_LEN));
-  EVAL(SG_TYPE_PARAM_ATTR_SPEC, p(ts));
+  EVAL(SG_TYPE_PARAM_ATTR_SPEC, p);
 }
 
 //! R733: type-param-decl (7.5.3.1)
@@ -3605,7 +3932,7 @@ Stmt_Tree type_param_decl(TT_Stream &ts) {
         opt(h_seq(TOK(TK_EQUAL),
                   rule(int_expr)))
         );
-  EVAL(SG_TYPE_PARAM_DECL, p(ts));
+  EVAL(SG_TYPE_PARAM_DECL, p);
 }
 
 //! R732: type-param-def-stmt (7.5.3.1)
@@ -3619,7 +3946,7 @@ Stmt_Tree type_param_def_stmt(TT_Stream &ts) {
         TOK(TK_DBL_COLON),
         list(TAG(SG_TYPE_PARAM_DECL_LIST), rule(type_param_decl)),
         eol());
-  EVAL(SG_TYPE_PARAM_DEF_STMT, p(ts));
+  EVAL(SG_TYPE_PARAM_DEF_STMT, p);
 }
     
 //! R755: type-param-spec (7.5.9)
@@ -3630,7 +3957,7 @@ Stmt_Tree type_param_spec(TT_Stream &ts) {
         opt(h_seq(name(), TOK(TK_EQUAL))),
         rule(type_param_value)
         );
-  EVAL(SG_TYPE_PARAM_SPEC, p(ts));
+  EVAL(SG_TYPE_PARAM_SPEC, p);
 }
 
 //! R701: type-param-value (7.2)
@@ -3642,7 +3969,7 @@ Stmt_Tree type_param_value(TT_Stream &ts) {
          TOK(TK_COLON),
          rule(int_expr)
          );
-  EVAL(SG_TYPE_PARAM_VALUE, p(ts));
+  EVAL(SG_TYPE_PARAM_VALUE, p);
 }
 
 //! R702: type-spec (7.3.2.1)
@@ -3652,7 +3979,7 @@ Stmt_Tree type_spec(TT_Stream &ts) {
     alts(rule_tag,
          rule(intrinsic_type_spec),
          rule(derived_type_spec));
-  EVAL(SG_TYPE_SPEC, p(ts));
+  EVAL(SG_TYPE_SPEC, p);
 }
 
 /* I:U */
@@ -3667,7 +3994,7 @@ Stmt_Tree unlock_stmt(TT_Stream &ts) {
                  opt(h_seq(TOK(TK_COMMA),
                            h_list(rule(sync_stat))))),
         eol());
-  EVAL(SG_UNLOCK_STMT, p(ts));
+  EVAL(SG_UNLOCK_STMT, p);
 }
 
 //! R935: upper-bound-expr (9.7.1.1)
@@ -3675,7 +4002,7 @@ Stmt_Tree upper_bound_expr(TT_Stream &ts) {
   RULE(SG_UPPER_BOUND_EXPR);
   constexpr auto p =
     tag_if(rule_tag, rule(expr));
-  EVAL(SG_UPPER_BOUND_EXPR, p(ts));
+  EVAL(SG_UPPER_BOUND_EXPR, p);
 }
 
 //! R1409: use-stmt (14.2.2)
@@ -3698,7 +4025,7 @@ Stmt_Tree use_stmt(TT_Stream &ts) {
                opt(list(TAG(SG_ONLY_LIST), rule(only))),
                eol())
          );
-  EVAL(SG_USE_STMT, p(ts));
+  EVAL(SG_USE_STMT, p);
 }
 
 /* I:V */
@@ -3712,7 +4039,7 @@ Stmt_Tree value_stmt(TT_Stream &ts) {
         opt(TOK(TK_DBL_COLON)),
         h_list(name()), // dummy-arg-name-list
         eol());
-  EVAL(SG_VALUE_STMT, p(ts));
+  EVAL(SG_VALUE_STMT, p);
 }
 
 //! R902: variable (9.2)
@@ -3724,7 +4051,7 @@ Stmt_Tree variable(TT_Stream &ts) {
          rule(function_reference),
          rule(designator)
          );
-  EVAL(SG_VARIABLE, p(ts));
+  EVAL(SG_VARIABLE, p);
 }
 
 
@@ -3738,7 +4065,7 @@ Stmt_Tree volatile_stmt(TT_Stream &ts) {
         list(TAG(SG_OBJECT_NAME_LIST),
              name()),
         eol());
-  EVAL(SG_VOLATILE_STMT, p(ts));
+  EVAL(SG_VOLATILE_STMT, p);
 }
 
 /* I:W */
@@ -3758,7 +4085,7 @@ Stmt_Tree wait_spec(TT_Stream &ts) {
          // do the least-specific entry last: the optional unit=expr
          rule(expr));
 
-  EVAL(SG_WAIT_SPEC, p(ts));
+  EVAL(SG_WAIT_SPEC, p);
 }
 
 //! R1222: wait-stmt (12.7.2)
@@ -3769,7 +4096,7 @@ Stmt_Tree wait_stmt(TT_Stream &ts) {
         TOK(KW_WAIT),
         h_parens(h_list(rule(wait_spec))),
         eol());
-  EVAL(SG_WAIT_STMT, p(ts));
+  EVAL(SG_WAIT_STMT, p);
 }
 
 //! R1043: where-construct-stmt (10.2.3.1)
@@ -3781,7 +4108,7 @@ Stmt_Tree where_construct_stmt(TT_Stream &ts) {
         TOK(KW_WHERE),
         h_parens(rule(logical_expr)),
         eol());
-  EVAL(SG_WHERE_CONSTRUCT_STMT, p(ts));
+  EVAL(SG_WHERE_CONSTRUCT_STMT, p);
 }
 
 //! R1041: where-stmt (10.2.3.1)
@@ -3793,7 +4120,7 @@ Stmt_Tree where_stmt(TT_Stream &ts) {
            syntactically equivalent */
         TOK(KW_WHERE), h_parens(rule(logical_expr)),
         rule(assignment_stmt), eol());
-  EVAL(SG_WHERE_STMT, p(ts));
+  EVAL(SG_WHERE_STMT, p);
 }
 
 //! R1211: write-stmt (12.6.1)
@@ -3808,7 +4135,7 @@ Stmt_Tree write_stmt(TT_Stream &ts) {
         opt(list(TAG(SG_OUTPUT_ITEM_LIST),
                  rule(output_item))),
         eol());
-  EVAL(SG_WRITE_STMT, p(ts));
+  EVAL(SG_WRITE_STMT, p);
 }
 
 /* I:X */
@@ -3919,6 +4246,9 @@ Stmt_Tree parse_stmt_dispatch(int stmt_tag, TT_Stream &ts) {
   case TAG(SG_END_BLOCK_STMT):
     return end_block_stmt(ts);
     break;
+  case TAG(SG_END_DO):
+    return end_do(ts);
+    break;
   case TAG(SG_END_DO_STMT):
     return end_do_stmt(ts);
     break;
@@ -4108,6 +4438,9 @@ Stmt_Tree parse_stmt_dispatch(int stmt_tag, TT_Stream &ts) {
   case TAG(SG_PRIVATE_COMPONENTS_STMT):
     return private_components_stmt(ts);
     break;
+  case TAG(SG_PRIVATE_OR_SEQUENCE):
+    return private_or_sequence(ts);
+    break;
   case TAG(SG_PROC_COMPONENT_DEF_STMT):
     return proc_component_def_stmt(ts);
     break;
@@ -4174,6 +4507,9 @@ Stmt_Tree parse_stmt_dispatch(int stmt_tag, TT_Stream &ts) {
   case TAG(SG_TARGET_STMT):
     return target_stmt(ts);
     break;
+  case TAG(SG_TYPE_BOUND_PROC_BINDING):
+    return type_bound_proc_binding(ts);
+    break;
   case TAG(SG_TYPE_BOUND_GENERIC_STMT):
     return type_bound_generic_stmt(ts);
     break;
@@ -168,10 +168,14 @@ Stmt_Tree write_stmt(TT_Stream &ts);
 /*! \defgroup StmtParsers Parsers for portions of Fortran statements
   @{ */
 Stmt_Tree actual_arg_spec(TT_Stream &ts);
+Stmt_Tree ac_implied_do(TT_Stream &ts);
+Stmt_Tree ac_implied_do_control(TT_Stream &ts);
+Stmt_Tree ac_value(TT_Stream &ts);
 Stmt_Tree allocatable_decl(TT_Stream &ts);
 Stmt_Tree allocate_coarray_spec(TT_Stream &ts);
 Stmt_Tree allocate_coshape_spec(TT_Stream &ts);
 Stmt_Tree allocation(TT_Stream &ts);
+Stmt_Tree array_constructor(TT_Stream &ts);
 Stmt_Tree array_element(TT_Stream &ts);
 Stmt_Tree array_spec(TT_Stream &ts);
 Stmt_Tree association(TT_Stream &ts);
@@ -237,6 +241,7 @@ Stmt_Tree part_ref(TT_Stream &ts);
 Stmt_Tree pointer_object(TT_Stream &ts);
 Stmt_Tree prefix(TT_Stream &ts);
 Stmt_Tree prefix_spec(TT_Stream &ts);
+Stmt_Tree primary(TT_Stream &ts);
 Stmt_Tree proc_component_attr_spec(TT_Stream &ts);
 Stmt_Tree proc_component_ref(TT_Stream &ts);
 Stmt_Tree proc_decl(TT_Stream &ts);
@@ -256,6 +261,7 @@ Stmt_Tree sign(TT_Stream &ts);
 Stmt_Tree signed_real_literal_constant(TT_Stream &ts);
 Stmt_Tree structure_component(TT_Stream &ts);
 Stmt_Tree structure_constructor(TT_Stream &ts);
+Stmt_Tree structured_expr(TT_Stream &ts);
 Stmt_Tree substring(TT_Stream &ts);
 Stmt_Tree substring_range(TT_Stream &ts);
 Stmt_Tree suffix(TT_Stream &ts);
@@ -273,6 +279,40 @@ Stmt_Tree consume_parens(TT_Stream &ts);
 
 /*! @} */
 
+/*! \defgroup StmtExprs Expanding expressions
+  The statement parsers leave each expr as a truncated SG_EXPR node, whose
+  branches are just the tokens of the expression (see expr()).  This is cheap,
+  and is all that most clients need.  The operator structure of an SG_EXPR can
+  be built on demand with expand_expr(), which replaces the token branches with
+  the tree produced by structured_expr(): a single branch holding the operator
+  nodes (e.g. SG_LEVEL_2_EXPR for add-op), down to SG_PRIMARY nodes.
+
+  Expressions nested in a primary (subscripts and actual arguments) are
+  themselves truncated SG_EXPR nodes, so expansion only does the work for the
+  levels that a client actually visits.
+  @{ */
+
+//! Return true if expr is an SG_EXPR that has been expanded
+bool is_expanded_expr(Stmt_Tree::const_reference expr);
+
+//! Build the operator structure of an SG_EXPR node in place
+/*! Returns true if expr is (now) expanded.  Returns false, leaving expr
+    unchanged, if expr is not an SG_EXPR or its tokens are not a single
+    expression that structured_expr() understands.  Note that expanding
+    invalidates any iterators or cursors to the old token branches. */
+bool expand_expr(Stmt_Tree::reference expr);
+
+//! Expand every SG_EXPR in the subtree rooted at st, recursively
+void expand_exprs(Stmt_Tree::reference st);
+
+//! Expand the SG_EXPR under cursor c (if it is on one), then move down
+inline Stmt_Tree::cursor_t &expand_down(Stmt_Tree::cursor_t &c) {
+  expand_expr(c.node());
+  return c.down();
+}
+
+/*! @} */
+
 } // namespace Stmt
 } // namespace FLPR
 
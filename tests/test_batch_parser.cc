@@ -0,0 +1,108 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+#include "flpr/Batch_Parser.hh"
+#include "flpr/Stmt_Parser_Exts.hh"
+#include "test_helpers.hh"
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace FLPR;
+
+bool batch_parser() {
+  /* Files of different sizes, one of which doesn't parse, plus one that
+     doesn't exist */
+  std::vector<std::string> const names{
+      "batch_0.f90", "batch_1.f90", "batch_2.f90", "batch_bad.f90",
+      "batch_missing.f90"};
+  for (int i = 0; i < 3; ++i) {
+    std::ofstream os(names[i]);
+    os << "subroutine s" << i << "\n";
+    for (int j = 0; j < 10 * i; ++j)
+      os << "  print *, " << j << "\n";
+    os << "end subroutine s" << i << "\n";
+  }
+  std::ofstream{names[3]} << "subroutine s\nend select\n";
+
+  Batch_Parser<> batch(3);
+  std::mutex m;
+  std::vector<int> seen(names.size(), 0);
+  batch.set_callback(
+      [&](std::size_t const index, Parsed_File<> &file, bool const ok) {
+        std::lock_guard<std::mutex> const lock{m};
+        seen[index] += 1;
+        if (ok)
+          seen[index] += file.statements().size() > 0 ? 10 : 0;
+      });
+  TEST_FALSE(batch.run(names));
+  for (auto const &n : names)
+    std::remove(n.c_str());
+
+  std::vector<int> const expected{11, 11, 11, 1, 1};
+  TEST_TRUE(seen == expected);
+  auto const &stats = batch.stats();
+  TEST_INT(stats.num_files, 5);
+  TEST_INT(stats.num_failed, 2);
+  TEST_INT(stats.stmts.count, 2 + 12 + 22 + 2);
+  TEST_INT(stats.parse.count, 2 + 12 + 22);
+  for (std::size_t i = 0; i < 3; ++i) {
+    TEST_TRUE(batch.ok(i));
+    TEST_TRUE(batch.files()[i] != nullptr);
+    TEST_TRUE(batch.files()[i]->parse_tree());
+  }
+  TEST_FALSE(batch.ok(3));
+  TEST_FALSE(batch.ok(4));
+
+  /* An exception only fails its own file */
+  {
+    Batch_Parser<> throwing(3);
+    std::vector<std::string> good;
+    for (std::size_t i = 0; i < 3; ++i)
+      good.push_back(names[i]);
+    for (std::size_t i = 0; i < 3; ++i) {
+      std::ofstream os(good[i]);
+      os << "subroutine s" << i << "\nend subroutine s" << i << "\n";
+    }
+    throwing.set_callback([](std::size_t const index, Parsed_File<> &, bool) {
+      if (index == 1)
+        throw std::runtime_error("callback failed");
+    });
+    TEST_FALSE(throwing.run(good));
+    for (auto const &n : good)
+      std::remove(n.c_str());
+    TEST_INT(throwing.stats().num_failed, 1);
+    TEST_TRUE(throwing.ok(0));
+    TEST_FALSE(throwing.ok(1));
+    TEST_TRUE(throwing.ok(2));
+  }
+
+  /* The batch parses with a copy, so the registered extensions stay open */
+  TEST_FALSE(Stmt::get_parser_exts().frozen());
+  TEST_FALSE(Syntax_Tags::extensions_frozen());
+  TEST_TRUE(batch.files()[0]->parser_exts() == nullptr);
+
+  /* Released files aren't kept */
+  batch.set_keep_policy(Batch_Parser<>::Keep_Policy::RELEASE);
+  batch.set_callback(nullptr);
+  TEST_FALSE(batch.run({"batch_missing.f90"}));
+  TEST_INT(batch.files().size(), 1);
+  TEST_TRUE(batch.files()[0] == nullptr);
+  return true;
+}
+
+int main() {
+  TEST_MAIN_DECL;
+  TEST(batch_parser);
+  TEST_MAIN_REPORT;
+}
@@ -0,0 +1,234 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+#include "flpr/File_Image.hh"
+#include "flpr/Parsed_File.hh"
+#include "test_helpers.hh"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace FLPR;
+
+namespace {
+Logical_File::Line_Buf const free_lines{
+    "module m",
+    "  implicit none",
+    "  ! a comment before the contains",
+    "contains",
+    "  subroutine s(a, n)",
+    "    integer, intent(in) :: n",
+    "    real :: a(n) ; integer :: i",
+    "#ifdef DEBUG",
+    "    print *, 'debug'",
+    "#endif",
+    "    do 10 i = 1, n",
+    "      a(i) = a(i) + &",
+    "           & 2.0 * i  ! trailing",
+    "      if (a(i) > 5.0) a(i) = 'x'; a(i) = 0",
+    "10  continue",
+    "",
+    "  end subroutine s",
+    "end module m"};
+
+Logical_File::Line_Buf const fixed_lines{
+    "C     a fixed-format comment",
+    "      program p",
+    "      integer i, j",
+    "      do 20 i = 1,",
+    "     &  10",
+    "         j = i",
+    "   20 continue",
+    "      end"};
+
+/* Everything that should survive a round trip, as printed by operator<< */
+std::string describe(Parsed_File<> &f) {
+  std::ostringstream os;
+  os << f.logical_file().file_info->file_type << '\n';
+  for (auto const &l : f.logical_file().original_lines())
+    os << l << '\n';
+  for (auto const &ll : f.logical_lines()) {
+    os << ll << '\n';
+    ll.dump(os);
+  }
+  for (auto const &stmt : f.statements()) {
+    os << stmt << ' ' << stmt.syntax_tag() << ' ' << stmt.label() << ' '
+       << stmt.is_compound() << ' ' << stmt.prefix_size() << '\n'
+       << stmt.stmt_tree() << '\n';
+  }
+  os << f.parse_tree() << '\n' << f.logical_file().render();
+  return os.str();
+}
+
+bool all_stmt_trees_built(Parsed_File<> &f) {
+  for (auto const &stmt : f.statements())
+    if (!stmt.has_stmt_tree())
+      return false;
+  return true;
+}
+
+/* Parse lines, save the image, then map it and read it back */
+bool round_trip(Logical_File::Line_Buf const &lines, std::string const &name,
+                File_Type const type) {
+  std::string const image_file{name + ".fli"};
+  std::string expected;
+  {
+    Parsed_File<> f;
+    f.set_keep_original_lines(true);
+    TEST_FALSE(f.scan_lines(Logical_File::Line_Buf{lines}, name, 0, type));
+    TEST_TRUE(f.materialize_stmt_trees());
+    expected = describe(f);
+    std::string const image{f.write_image()};
+    TEST_FALSE(image.empty());
+    TEST_TRUE(File_Image::save(image_file, image));
+  }
+
+  File_Image::Mapping mapping{image_file};
+  TEST_TRUE(static_cast<bool>(mapping));
+  Parsed_File<> g;
+  g.set_keep_original_lines(true);
+  TEST_TRUE(g.read_image(mapping.view(), name));
+  TEST_TRUE(static_cast<bool>(g));
+  TEST_FALSE(g.from_cache());
+  /* The Stmt_Trees come from the image, rather than being re-parsed */
+  TEST_TRUE(all_stmt_trees_built(g));
+  TEST_TRUE(g.logical_file().original_lines() == lines);
+  TEST_EQ_NODISPLAY(describe(g), expected);
+  std::remove(image_file.c_str());
+  return true;
+}
+} // namespace
+
+bool free_format_round_trip() {
+  return round_trip(free_lines, "image_free.f90", File_Type::FREEFMT);
+}
+
+bool fixed_format_round_trip() {
+  return round_trip(fixed_lines, "image_fixed.f", File_Type::FIXEDFMT);
+}
+
+bool without_stmt_trees() {
+  Parsed_File<> f;
+  TEST_FALSE(f.scan_lines(Logical_File::Line_Buf{free_lines}, "nost.f90", 0));
+  TEST_TRUE(f.materialize_stmt_trees());
+  std::string const expected{describe(f)};
+  std::string const full{f.write_image()};
+  std::string const image{f.write_image(false)};
+  TEST_TRUE(image.size() < full.size());
+
+  File_Image::View const view{image.data(), image.size()};
+  TEST_TRUE(static_cast<bool>(view));
+  TEST_INT(view.count(File_Image::STMT_NODES), 0);
+  /* The original lines weren't kept, so they aren't in the image either */
+  TEST_INT(view.count(File_Image::ORIGINAL_LINES), 0);
+  Parsed_File<> g;
+  g.set_keep_original_lines(true);
+  TEST_TRUE(g.read_image(view, "nost.f90"));
+  TEST_TRUE(g.logical_file().original_lines().empty());
+  TEST_FALSE(g.statements().front().has_stmt_tree());
+  /* describe() rebuilds them from the syntags */
+  TEST_EQ_NODISPLAY(describe(g), expected);
+  return true;
+}
+
+/* Read the statements and trees straight out of the image */
+bool walk_in_place() {
+  Parsed_File<> f;
+  f.set_keep_original_lines(true);
+  TEST_FALSE(f.scan_lines(Logical_File::Line_Buf{free_lines}, "walk.f90", 0));
+  TEST_TRUE(f.materialize_stmt_trees());
+  std::string const image{f.write_image()};
+  File_Image::View const view{image.data(), image.size()};
+  TEST_TRUE(static_cast<bool>(view));
+  TEST_STR("walk.f90", std::string{view.string(view.file().filename)});
+  TEST_INT(view.count(File_Image::LINES), f.logical_lines().size());
+  TEST_INT(view.count(File_Image::STMTS), f.statements().size());
+  TEST_INT(view.count(File_Image::ORIGINAL_LINES), free_lines.size());
+
+  File_Image::Stmt_Rec const *s = view.stmts();
+  for (auto const &stmt : f.statements()) {
+    File_Image::Line_Rec const &l = view.lines()[s->line];
+    File_Image::Token_Rec const *tok =
+        view.tokens() + l.first_token + s->first_token;
+    TEST_INT(s->num_tokens, stmt.size());
+    for (auto const &tt : stmt) {
+      TEST_TRUE(view.string(tok->text) == tt.text());
+      TEST_INT(tok->token, tt.token);
+      ++tok;
+    }
+    TEST_INT(s->syntag, stmt.syntax_tag());
+    TEST_TRUE(s->num_stmt_nodes > 0);
+    TEST_INT(view.stmt_nodes()[s->first_stmt_node].syntag,
+             (*stmt.stmt_tree())->syntag);
+    ++s;
+  }
+
+  File_Image::Prgm_Node const *root = view.prgm_nodes();
+  TEST_INT(root->syntag, (*f.parse_tree())->syntag());
+  TEST_INT(root->num_branches, f.parse_tree()->num_branches());
+  TEST_INT(root->parent, -1);
+  return true;
+}
+
+bool bad_images() {
+  Parsed_File<> f;
+  TEST_FALSE(f.scan_lines(Logical_File::Line_Buf{fixed_lines}, "bad.f", 0));
+  std::string const image{f.write_image()};
+
+  /* Truncated */
+  std::string const truncated{image.substr(0, image.size() / 2)};
+  TEST_FALSE(static_cast<bool>(
+      File_Image::View{truncated.data(), truncated.size()}));
+
+  /* A different version */
+  std::string versioned{image};
+  std::uint32_t const old_version = File_Image::version - 1;
+  std::memcpy(&versioned[offsetof(File_Image::Header, version)], &old_version,
+              sizeof(old_version));
+  TEST_FALSE(static_cast<bool>(
+      File_Image::View{versioned.data(), versioned.size()}));
+
+  /* A statement that refers past the end of the lines */
+  std::string corrupt{image};
+  File_Image::View const view{image.data(), image.size()};
+  std::size_t const stmt_offset =
+      reinterpret_cast<char const *>(view.stmts()) - image.data();
+  std::uint32_t const bad_line = 1000;
+  std::memcpy(&corrupt[stmt_offset + offsetof(File_Image::Stmt_Rec, line)],
+              &bad_line, sizeof(bad_line));
+  File_Image::View const corrupt_view{corrupt.data(), corrupt.size()};
+  TEST_TRUE(static_cast<bool>(corrupt_view));
+  Parsed_File<> g;
+  TEST_FALSE(g.read_image(corrupt_view, "corrupt.f"));
+  TEST_FALSE(static_cast<bool>(g));
+
+  /* Something that isn't an image at all */
+  {
+    std::ofstream os("not_an_image.fli");
+    os << "program p\nend program p\n";
+  }
+  File_Image::Mapping mapping{"not_an_image.fli"};
+  TEST_FALSE(static_cast<bool>(mapping));
+  std::remove("not_an_image.fli");
+  TEST_FALSE(static_cast<bool>(File_Image::Mapping{"no_such_image.fli"}));
+  return true;
+}
+
+int main() {
+  TEST_MAIN_DECL;
+  TEST(free_format_round_trip);
+  TEST(fixed_format_round_trip);
+  TEST(without_stmt_trees);
+  TEST(walk_in_place);
+  TEST(bad_images);
+  TEST_MAIN_REPORT;
+}
@@ -0,0 +1,124 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+#include "flpr/File_Pipeline.hh"
+#include "test_helpers.hh"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace FLPR;
+
+bool file_pipeline() {
+  std::vector<std::string> names;
+  for (int i = 0; i < 8; ++i) {
+    names.push_back("pipeline_" + std::to_string(i) + ".f90");
+    std::ofstream os(names.back());
+    os << "subroutine s" << i << "\n";
+    for (int j = 0; j < i; ++j)
+      os << "  print *, " << j << "\n";
+    os << "end subroutine s" << i << "\n";
+  }
+  names.push_back("pipeline_missing.f90");
+
+  using Pipeline = File_Pipeline<>;
+  Pipeline pipeline;
+  pipeline.set_queue_capacity(1); /* force backpressure */
+  pipeline.set_threads(Pipeline::SCAN, 3);
+  pipeline.set_threads(Pipeline::PARSE, 2);
+  pipeline.set_threads(Pipeline::TRANSFORM, 3);
+  pipeline.set_ordered_writes(true);
+  pipeline.set_transform([](Pipeline::Item &item) {
+    if (item.index == 5)
+      throw std::runtime_error("transform threw");
+    if (item.index == 6)
+      throw 6;
+    item.output = std::to_string(item.file->statements().size());
+    return static_cast<bool>(item.file->parse_tree());
+  });
+  std::vector<std::size_t> written;
+  std::vector<std::string> outputs;
+  pipeline.set_writer([&](Pipeline::Item &item) {
+    written.push_back(item.index);
+    outputs.push_back(item.ok ? item.output : item.error);
+    return true;
+  });
+  TEST_FALSE(pipeline.run(names));
+  for (auto const &n : names)
+    std::remove(n.c_str());
+
+  /* Every file reaches the writer, in order, and failures are isolated */
+  std::vector<std::size_t> order(names.size());
+  std::iota(order.begin(), order.end(), 0);
+  TEST_TRUE(written == order);
+  for (std::size_t i = 0; i < 8; ++i) {
+    std::string const expected{i == 5   ? "transform threw"
+                               : i == 6 ? "unknown exception"
+                                        : std::to_string(i + 2)};
+    TEST_EQ_NODISPLAY(outputs[i], expected);
+  }
+  TEST_EQ_NODISPLAY(outputs[8], std::string{"unable to read the file"});
+
+  TEST_INT(pipeline.stats(Pipeline::READ).items, 9);
+  TEST_INT(pipeline.stats(Pipeline::WRITE).items, 9);
+  TEST_INT(pipeline.stats(Pipeline::WRITE).threads, 1);
+  TEST_INT(pipeline.stats(Pipeline::SCAN).threads, 3);
+  TEST_TRUE(pipeline.stats(Pipeline::SCAN).max_queue_depth <= 1);
+
+  /* A slow first file holds back at most the reorder window of others */
+  std::vector<std::string> slow_names;
+  for (int i = 0; i < 12; ++i) {
+    slow_names.push_back("pipeline_slow_" + std::to_string(i) + ".f90");
+    std::ofstream os(slow_names.back());
+    os << "subroutine s" << i << "\nend subroutine s" << i << "\n";
+  }
+  Pipeline windowed;
+  windowed.set_threads(Pipeline::TRANSFORM, 4);
+  windowed.set_ordered_writes(true);
+  windowed.set_reorder_window(3);
+  std::atomic<std::size_t> max_started{0};
+  windowed.set_transform([&max_started](Pipeline::Item &item) {
+    if (item.index == 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    std::size_t seen = max_started;
+    while (item.index > seen &&
+           !max_started.compare_exchange_weak(seen, item.index))
+      ;
+    return true;
+  });
+  std::size_t started_before_first{0};
+  std::vector<std::size_t> slow_written;
+  windowed.set_writer([&](Pipeline::Item &item) {
+    if (item.index == 0)
+      started_before_first = max_started;
+    slow_written.push_back(item.index);
+    return true;
+  });
+  TEST_TRUE(windowed.run(slow_names));
+  for (auto const &n : slow_names)
+    std::remove(n.c_str());
+  TEST_INT(slow_written.size(), slow_names.size());
+  TEST_TRUE(std::is_sorted(slow_written.begin(), slow_written.end()));
+  TEST_TRUE(started_before_first < 3);
+  return true;
+}
+
+int main() {
+  TEST_MAIN_DECL;
+  TEST(file_pipeline);
+  TEST_MAIN_REPORT;
+}
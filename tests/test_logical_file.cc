@@ -11,6 +11,7 @@
 #include "LL_Helper.hh"
 #include "flpr/Logical_File.hh"
 #include "test_helpers.hh"
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -37,8 +38,295 @@ bool replace_stmt_text_1() {
   return true;
 }
 
+/* Make the same edits one at a time and as an Edit_Batch */
+bool edit_batch_matches_sequential() {
+  // clang-format off
+  LL_Helper::Raw_Lines const lines{"x = 1; y = 2",
+                                   "call foo(a, b)",
+                                   "z = a + b"};
+  // clang-format on
+  std::string result[2];
+  for (int batched = 0; batched < 2; ++batched) {
+    LL_Helper helper{LL_Helper::Raw_Lines{lines}};
+    Logical_File &file = helper.logical_file();
+    TEST_INT(file.ll_stmts.size(), 4);
+    auto const x_stmt = file.ll_stmts.begin();
+    auto const y_stmt = std::next(x_stmt);
+    auto const call_stmt = std::next(y_stmt);
+    auto const z_stmt = std::next(call_stmt);
+    auto tok = [](LL_STMT_SEQ::iterator stmt, int const idx) {
+      return std::next(stmt->begin(), idx);
+    };
+    auto range = [&tok](LL_STMT_SEQ::iterator stmt, int const idx) {
+      return FLPR::LL_TT_Range{stmt->it(), tok(stmt, idx), tok(stmt, idx + 1)};
+    };
+
+    if (batched) {
+      Logical_File::Edit_Batch batch;
+      batch.replace_stmt_substr(x_stmt, range(x_stmt, 2), "10");
+      batch.append_stmt_text(y_stmt, " + 3");
+      batch.replace_stmt_substr(call_stmt, range(call_stmt, 5), "c");
+      batch.insert_text_after(call_stmt, tok(call_stmt, 3), ", q");
+      batch.append_stmt_text(y_stmt, " * 4");
+      batch.set_stmt_label(z_stmt, 100);
+      TEST_INT(batch.size(), 6);
+      TEST_TRUE(file.apply(batch));
+      TEST_TRUE(batch.empty());
+    } else {
+      file.replace_stmt_substr(x_stmt, range(x_stmt, 2), "10");
+      file.append_stmt_text(y_stmt, " + 3");
+      file.replace_stmt_substr(call_stmt, range(call_stmt, 5), "c");
+      file.insert_text_after(call_stmt, tok(call_stmt, 3), ", q");
+      file.append_stmt_text(y_stmt, " * 4");
+      file.set_stmt_label(z_stmt, 100);
+    }
+
+    TEST_INT(file.ll_stmts.size(), 4);
+    TEST_INT(x_stmt->size(), 3);
+    TEST_INT(y_stmt->size(), 7);
+    TEST_INT(call_stmt->size(), 9);
+    TEST_INT(z_stmt->label(), 100);
+    std::ostringstream os;
+    for (auto const &ll : file.lines)
+      ll.print(os) << '\n';
+    result[batched] = os.str();
+  }
+  TEST_EQ_NODISPLAY(result[0], result[1]);
+  return true;
+}
+
+/* A replacement can't be mixed with other text edits of the statement */
+bool edit_batch_rejects_mixed_replace() {
+  LL_Helper helper({"x = 1; y = 2", "z = 3"});
+  Logical_File &file = helper.logical_file();
+  auto const x_stmt = file.ll_stmts.begin();
+  auto const y_stmt = std::next(x_stmt);
+  auto const z_stmt = std::next(y_stmt);
+  auto print = [&file]() {
+    std::ostringstream os;
+    for (auto const &ll : file.lines)
+      ll.print(os) << '\n';
+    return os.str();
+  };
+  std::string const orig{print()};
+
+  Logical_File::Edit_Batch batch;
+  batch.append_stmt_text(x_stmt, " + 1");
+  batch.replace_stmt_text(y_stmt, {"y = 4"},
+                          FLPR::Syntax_Tags::SG_ASSIGNMENT_STMT);
+  batch.append_stmt_text(y_stmt, " + 1");
+  TEST_FALSE(file.apply(batch));
+  TEST_INT(batch.size(), 3);
+  TEST_EQ_NODISPLAY(print(), orig);
+
+  /* A label still goes with a replacement */
+  batch.clear();
+  batch.replace_stmt_text(z_stmt, {"z = 4"},
+                          FLPR::Syntax_Tags::SG_ASSIGNMENT_STMT);
+  batch.set_stmt_label(z_stmt, 20);
+  TEST_TRUE(file.apply(batch));
+  TEST_INT(z_stmt->label(), 20);
+  TEST_TRUE(batch.empty());
+  return true;
+}
+
+/* Roll back nested snapshots of a sequence of edits */
+bool snapshot_rollback() {
+  // clang-format off
+  LL_Helper helper({"x = 1; y = 2",
+                    "call foo(a, b)",
+                    "z = a + b"});
+  // clang-format on
+  Logical_File &file = helper.logical_file();
+  auto const print = [&file]() {
+    std::ostringstream os;
+    for (auto const &ll : file.lines)
+      ll.print(os) << '\n';
+    for (auto const &stmt : file.ll_stmts)
+      os << stmt.label() << ' ' << stmt.is_compound() << ' ' << stmt << '\n';
+    return os.str();
+  };
+  auto const x_stmt = file.ll_stmts.begin();
+  auto const y_stmt = std::next(x_stmt);
+  auto const call_stmt = std::next(y_stmt);
+  auto const z_stmt = std::next(call_stmt);
+  std::string const orig{print()};
+
+  auto const outer = file.snapshot();
+  TEST_TRUE(file.has_snapshot());
+  file.replace_stmt_substr(
+      x_stmt,
+      FLPR::LL_TT_Range{x_stmt->it(), std::next(x_stmt->begin(), 2),
+                        x_stmt->end()},
+      "10");
+  file.append_stmt_text(y_stmt, " + 3");
+  file.emplace_ll_stmt(call_stmt, FLPR::Logical_Line{"w = 5"},
+                       FLPR::Syntax_Tags::SG_ASSIGNMENT_STMT);
+  TEST_INT(file.ll_stmts.size(), 5);
+  TEST_INT(file.lines.size(), 5);
+  std::string const middle{print()};
+
+  auto const inner = file.snapshot();
+  file.replace_stmt_text(z_stmt, {"z = 0"},
+                         FLPR::Syntax_Tags::SG_ASSIGNMENT_STMT);
+  file.set_stmt_label(y_stmt, 20);
+  file.rollback(inner);
+  TEST_TRUE(file.has_snapshot());
+  TEST_EQ_NODISPLAY(print(), middle);
+
+  auto const released = file.snapshot();
+  file.set_stmt_label(z_stmt, 30);
+  file.release(released);
+
+  file.rollback(outer);
+  TEST_FALSE(file.has_snapshot());
+  TEST_EQ_NODISPLAY(print(), orig);
+  TEST_INT(file.ll_stmts.size(), 4);
+  TEST_INT(file.lines.size(), 3);
+  TEST_TRUE(x_stmt->it() == y_stmt->it());
+  TEST_INT(y_stmt->is_compound(), 2);
+  TEST_INT(z_stmt->label(), 0);
+
+  /* The restored statements refer to the restored Logical_Lines */
+  for (auto const &stmt : file.ll_stmts) {
+    auto const &ll_stmts = stmt.ll().stmts();
+    int const idx = std::max(stmt.is_compound(), 1) - 1;
+    TEST_TRUE(stmt.begin() == ll_stmts[idx].begin());
+    TEST_TRUE(stmt.end() == ll_stmts[idx].end());
+  }
+  return true;
+}
+
+/* Dirty tracking, changed line ranges and unified diff output */
+bool changed_lines() {
+  // clang-format off
+  Logical_File::Line_Buf const text{"program p",
+                                    "x = 1",
+                                    "! note",
+                                    "y = 2",
+                                    "z = 3",
+                                    "w = 4",
+                                    "v = 5",
+                                    "u = 6",
+                                    "t = 7",
+                                    "end program p"};
+  // clang-format on
+  Logical_File file;
+  file.set_keep_original_lines(true);
+  TEST_TRUE(file.scan_free(text));
+  file.make_stmts();
+  TEST_TRUE(file.original_lines() == text);
+  TEST_FALSE(file.has_dirty_lines());
+  TEST_TRUE(file.changed_line_ranges().empty());
+  std::ostringstream none;
+  TEST_FALSE(file.write_diff(none));
+  TEST_TRUE(none.str().empty());
+
+  auto const snap = file.snapshot();
+  auto const y_stmt = std::next(file.ll_stmts.begin(), 2);
+  auto const t_stmt = std::next(y_stmt, 5);
+  file.replace_stmt_substr(
+      y_stmt,
+      FLPR::LL_TT_Range{y_stmt->it(), std::next(y_stmt->begin(), 2),
+                        y_stmt->end()},
+      "20");
+  file.emplace_ll_stmt(t_stmt, FLPR::Logical_Line{"q = 0"},
+                       FLPR::Syntax_Tags::SG_ASSIGNMENT_STMT);
+  TEST_TRUE(file.has_dirty_lines());
+  TEST_FALSE(t_stmt->ll().dirty);
+
+  auto const changes = file.changed_line_ranges();
+  TEST_INT(changes.size(), 2);
+  TEST_INT(changes[0].old_begin, 4);
+  TEST_INT(changes[0].old_end, 5);
+  TEST_INT(changes[0].new_begin, 4);
+  TEST_INT(changes[0].new_end, 5);
+  TEST_INT(changes[1].old_begin, 9);
+  TEST_INT(changes[1].old_end, 9);
+  TEST_INT(changes[1].new_begin, 9);
+  TEST_INT(changes[1].new_end, 10);
+
+  std::ostringstream diff;
+  TEST_TRUE(file.write_diff(diff, 1));
+  std::string const expected{"--- -\n"
+                             "+++ -\n"
+                             "@@ -3,3 +3,3 @@\n"
+                             " ! note\n"
+                             "-y = 2\n"
+                             "+y = 20\n"
+                             " z = 3\n"
+                             "@@ -8,2 +8,3 @@\n"
+                             " u = 6\n"
+                             "+q = 0\n"
+                             " t = 7\n"};
+  TEST_EQ_NODISPLAY(diff.str(), expected);
+
+  file.rollback(snap);
+  TEST_FALSE(file.has_dirty_lines());
+  TEST_TRUE(file.changed_line_ranges().empty());
+
+  /* Without the original lines, the ranges are still found, but there is no
+     diff */
+  Logical_File unkept;
+  TEST_TRUE(unkept.scan_free(text));
+  unkept.make_stmts();
+  TEST_TRUE(unkept.original_lines().empty());
+  auto const x_stmt = std::next(unkept.ll_stmts.begin());
+  unkept.replace_stmt_substr(
+      x_stmt,
+      FLPR::LL_TT_Range{x_stmt->it(), std::next(x_stmt->begin(), 2),
+                        x_stmt->end()},
+      "10");
+  auto const unkept_changes = unkept.changed_line_ranges();
+  TEST_INT(unkept_changes.size(), 1);
+  TEST_INT(unkept_changes[0].old_begin, 2);
+  TEST_INT(unkept_changes[0].old_end, 3);
+  std::ostringstream no_diff;
+  TEST_FALSE(unkept.write_diff(no_diff));
+  TEST_TRUE(no_diff.str().empty());
+  return true;
+}
+
+bool render_matches_print() {
+  // clang-format off
+  Logical_File::Line_Buf const fixed{
+    "      program p",
+    "c     a comment",
+    "",
+    "10    x = 1 +",
+    "     &    2",
+    "#ifdef FOO",
+    "  100 continue",
+    "      end"};
+  // clang-format on
+  Logical_File file;
+  TEST_TRUE(file.scan_fixed(fixed, 72));
+  /* a suppressed line prints nothing */
+  std::next(file.lines.begin(), 2)->suppress = true;
+  for (int pass = 0; pass < 2; ++pass) {
+    std::ostringstream printed;
+    for (auto const &ll : file.lines)
+      printed << ll;
+    TEST_FALSE(printed.str().empty());
+    for (unsigned const num_threads : {1u, 4u}) {
+      TEST_EQ_NODISPLAY(file.render(num_threads), printed.str());
+      std::ostringstream written;
+      TEST_TRUE(file.write(written, num_threads));
+      TEST_EQ_NODISPLAY(written.str(), printed.str());
+    }
+    /* and again, with the text in free form */
+    file.convert_fixed_to_free();
+  }
+  return true;
+}
+
 int main() {
   TEST_MAIN_DECL;
   TEST(replace_stmt_text_1);
+  TEST(edit_batch_matches_sequential);
+  TEST(edit_batch_rejects_mixed_replace);
+  TEST(snapshot_rollback);
+  TEST(changed_lines);
+  TEST(render_matches_print);
   TEST_MAIN_REPORT;
 }
@@ -10,9 +10,12 @@
 
 #include "LL_Helper.hh"
 #include "flpr/Logical_Line.hh"
+#include "flpr/Parallel_For.hh"
 #include "test_helpers.hh"
 #include <iostream>
 #include <sstream>
+#include <string>
+#include <vector>
 
 using FLPR::Logical_Line;
 
@@ -615,6 +618,34 @@ bool continued_if_fixed_trunc_string() {
   return true;
 }
 
+/* Each thread has its own scanner, so tokenizing in parallel gives the same
+   fragments as tokenizing serially */
+bool concurrent_tokenize() {
+  std::vector<std::string> const lines{
+      "subroutine foo(a, b)",
+      "x = 1.5e-3_rk + 2d0 * y**3",
+      "if (a .eq. .true._lk) b = 'it''s'",
+      "z = 12_ik + 3.e+2 - .5d1_8",
+      "call bar(kind_'str', 1.0_8)"};
+  auto describe = [&lines](std::size_t const i) {
+    Logical_Line const ll(lines[i % lines.size()]);
+    std::ostringstream os;
+    ll.dump(os);
+    return os.str();
+  };
+
+  std::size_t const N = 64 * lines.size();
+  std::vector<std::string> serial(N), parallel(N);
+  for (std::size_t i = 0; i < N; ++i)
+    serial[i] = describe(i);
+  FLPR::parallel_for(N, 4, [&](std::size_t const i) {
+    parallel[i] = describe(i);
+  });
+  for (std::size_t i = 0; i < N; ++i)
+    TEST_EQ_NODISPLAY(parallel[i], serial[i]);
+  return true;
+}
+
 int main() {
   TEST_MAIN_DECL;
   TEST(test_default_ctor);
@@ -642,5 +673,6 @@ int main() {
   TEST(continued_if);
   TEST(continued_if_fixed_string);
   TEST(continued_if_fixed_trunc_string);
+  TEST(concurrent_tokenize);
   TEST_MAIN_REPORT;
 }
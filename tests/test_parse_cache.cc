@@ -0,0 +1,139 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+#include "flpr/Parse_Cache.hh"
+#include "flpr/Parsed_File.hh"
+#include "flpr/Stmt_Parser_Exts.hh"
+#include "flpr/parse_stmt.hh"
+#include "test_helpers.hh"
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace FLPR;
+
+bool parse_cache() {
+  std::string const dir{"parse_cache_test"};
+  Logical_File::Line_Buf const lines{
+      "module m",         "! a comment",   "integer :: i; real :: x",
+      "contains",         "subroutine s(a)", "  real a",
+      "  do 10 i = 1, 3", "  a = a + &",   "    1",
+      "10 continue",      "end subroutine s", "end module m"};
+  /* Everything that the cache has to reproduce, including the Stmt_Trees,
+     which are rebuilt on demand */
+  auto const describe = [](Parsed_File<> &f) {
+    std::ostringstream os;
+    for (auto const &ll : f.logical_lines())
+      ll.dump(os);
+    for (auto const &stmt : f.statements())
+      os << stmt << ' ' << stmt.syntax_tag() << ' ' << stmt.label() << ' '
+         << stmt.is_compound() << ' ' << stmt.prefix_size() << '\n';
+    os << f.parse_tree() << f.logical_file().render();
+    return os.str();
+  };
+  auto const parse = [&lines](Parse_Cache &cache) {
+    auto f = std::make_unique<Parsed_File<>>();
+    f->set_parse_cache(&cache);
+    f->set_keep_original_lines(true);
+    f->scan_lines(Logical_File::Line_Buf{lines}, "cache.f90", 0);
+    f->prefetch_parse_tree();
+    return f;
+  };
+
+  Parse_Cache cache{dir};
+  TEST_TRUE(static_cast<bool>(cache));
+  cache.clear();
+  auto missed = parse(cache);
+  TEST_FALSE(missed->from_cache());
+  std::string const expected{describe(*missed)};
+  TEST_INT(cache.stats().misses, 1);
+  TEST_INT(cache.stats().stores, 1);
+
+  /* The same text is a hit */
+  auto hit = parse(cache);
+  TEST_TRUE(hit->from_cache());
+  TEST_TRUE(static_cast<bool>(*hit));
+  TEST_EQ_NODISPLAY(describe(*hit), expected);
+  TEST_INT(cache.stats().hits, 1);
+  TEST_TRUE(hit->logical_file().original_lines() == lines);
+
+  /* A different last fixed column or set of extensions is a different key */
+  Stmt::Parser_Exts exts;
+  exts.register_action_stmt(Stmt::write_stmt);
+  TEST_TRUE(cache.key(lines, File_Type::FREEFMT, 0, nullptr) ==
+            cache.key(lines, File_Type::FREEFMT, 0, nullptr));
+  TEST_FALSE(cache.key(lines, File_Type::FREEFMT, 0, nullptr) ==
+             cache.key(lines, File_Type::FREEFMT, 0, &exts));
+  TEST_FALSE(cache.key(lines, File_Type::FREEFMT, 0, nullptr) ==
+             cache.key(lines, File_Type::FREEFMT, 72, nullptr));
+
+  /* Extensions are told apart by what they are, not how many there are */
+  Stmt::Parser_Exts print_exts, named, same_name;
+  print_exts.register_action_stmt(Stmt::print_stmt);
+  named.register_action_stmt(Stmt::write_stmt, "write-comma v1");
+  same_name.register_action_stmt(Stmt::print_stmt, "write-comma v1");
+  TEST_FALSE(cache.key(lines, File_Type::FREEFMT, 0, &exts) ==
+             cache.key(lines, File_Type::FREEFMT, 0, &print_exts));
+  TEST_FALSE(cache.key(lines, File_Type::FREEFMT, 0, &exts) ==
+             cache.key(lines, File_Type::FREEFMT, 0, &named));
+  TEST_TRUE(cache.key(lines, File_Type::FREEFMT, 0, &named) ==
+            cache.key(lines, File_Type::FREEFMT, 0, &same_name));
+  Stmt::Parser_Exts const copy{named};
+  TEST_TRUE(cache.key(lines, File_Type::FREEFMT, 0, &named) ==
+            cache.key(lines, File_Type::FREEFMT, 0, &copy));
+
+  /* A corrupt entry is a miss, and is replaced */
+  std::string const key{cache.key(lines, File_Type::FREEFMT, 0, nullptr)};
+  std::ofstream{dir + "/" + key + ".fli"} << "not an image";
+  auto corrupt = parse(cache);
+  TEST_FALSE(corrupt->from_cache());
+  TEST_EQ_NODISPLAY(describe(*corrupt), expected);
+  TEST_INT(cache.stats().errors, 1);
+  TEST_INT(cache.stats().stores, 2);
+
+  /* A file that is changed before it is parsed isn't stored */
+  {
+    Parsed_File<> f;
+    f.set_parse_cache(&cache);
+    Logical_File::Line_Buf changed{lines};
+    changed.back() = "end module n";
+    f.scan_lines(std::move(changed), "changed.f90", 0);
+    f.logical_file().replace_stmt_text(f.statements().begin(), {"module n"},
+                                       Syntax_Tags::SG_MODULE_STMT);
+    TEST_TRUE(f.prefetch_parse_tree() && f);
+  }
+  TEST_INT(cache.stats().stores, 2);
+
+  /* Going over the size limit evicts the least recently used entries */
+  std::size_t const evictions{cache.stats().evictions};
+  cache.set_max_bytes(1);
+  Logical_File::Line_Buf other{"program p", "end program p"};
+  Parsed_File<> p;
+  p.set_parse_cache(&cache);
+  p.scan_lines(std::move(other), "p.f90", 0);
+  TEST_TRUE(p.prefetch_parse_tree() && p);
+  TEST_INT(cache.stats().evictions - evictions, 2);
+  TEST_FALSE(parse(cache)->from_cache());
+  std::ostringstream stats;
+  cache.print_stats(stats);
+  TEST_TRUE(stats.str().find("parse cache: 1 hits") == 0);
+
+  cache.clear();
+  std::filesystem::remove_all(dir);
+  return true;
+}
+
+int main() {
+  TEST_MAIN_DECL;
+  TEST(parse_cache);
+  TEST_MAIN_REPORT;
+}
@@ -9,10 +9,20 @@
 */
 
 #include "LL_Helper.hh"
+#include "flpr/Parsed_File.hh"
 #include "flpr/Prgm_Parsers.hh"
 #include "flpr/Prgm_Tree.hh"
+#include "flpr/Procedure_Visitor.hh"
+#include "flpr/Stmt_Parser_Exts.hh"
+#include "flpr/parse_stmt.hh"
 #include "test_helpers.hh"
+#include <atomic>
 #include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 using namespace FLPR;
 
@@ -212,8 +222,852 @@ bool module_program() {
   return res.match;
 }
 
+bool two_pass_matches_eager() {
+  LL_Helper::Raw_Lines const lines{"module m",
+                                   "contains",
+                                   "subroutine foo(a, b)",
+                                   "integer, intent(in) :: a(:)",
+                                   "real*8 b",
+                                   "do 10 i = 1, size(a)",
+                                   "  if (a(i) > 0) b = b + a(i)**2",
+                                   "10 continue",
+                                   "select case (a(1))",
+                                   "case (1:3, 5)",
+                                   "  write(*,100) a(1), b",
+                                   "case default",
+                                   "  call bar(x=a(1), y=.not.b)",
+                                   "end select",
+                                   "100 format(i5, f8.3)",
+                                   "end subroutine foo",
+                                   "end module m"};
+  std::string result[2];
+  bool const default_mode = FLPR::two_pass_parsing();
+  for (int mode = 0; mode < 2; ++mode) {
+    FLPR::two_pass_parsing() = (mode == 1);
+    LL_Helper ls{LL_Helper::Raw_Lines{lines}};
+    PS::State state(ls.ll_stmts());
+    auto res = PS::program(state);
+    TEST_TRUE(res.match);
+    std::ostringstream os;
+    os << res.parse_tree << '\n';
+    for (auto const &stmt : ls.ll_stmts())
+      os << stmt.stmt_tree() << '\n';
+    result[mode] = os.str();
+  }
+  FLPR::two_pass_parsing() = default_mode;
+  TEST_EQ_NODISPLAY(result[0], result[1]);
+  return true;
+}
+
+bool classify_only() {
+  LL_Helper::Raw_Lines const lines{"program p",
+                                   "integer :: i, a(10)",
+                                   "do 10 i = 1, 10",
+                                   "  a(i) = i",
+                                   "10 continue",
+                                   "if (a(1) > 0) then",
+                                   "  call foo(a, n=10)",
+                                   "else",
+                                   "  print *, a",
+                                   "end if",
+                                   "end program p"};
+  std::string result[2];
+  for (int keep = 0; keep < 2; ++keep) {
+    LL_Helper ls{LL_Helper::Raw_Lines{lines}};
+    PS::State state(ls.ll_stmts());
+    state.keep_stmt_trees = (keep == 1);
+    auto res = PS::program(state);
+    TEST_TRUE(res.match);
+    std::ostringstream os;
+    for (auto const &stmt : ls.ll_stmts()) {
+      TEST_INT(stmt.has_stmt_tree(), (keep == 1));
+      TEST_TRUE(stmt.syntax_tag() != Syntax_Tags::UNKNOWN);
+    }
+    /* this rebuilds the Stmt_Trees if needed */
+    os << res.parse_tree << '\n';
+    for (auto const &stmt : ls.ll_stmts())
+      os << stmt.stmt_tree() << '\n';
+    result[keep] = os.str();
+  }
+  TEST_EQ_NODISPLAY(result[0], result[1]);
+  return true;
+}
+
+bool shape_cache_matches_parse() {
+  LL_Helper::Raw_Lines const lines{"program p",
+                                   "implicit real(a-h)",
+                                   "implicit real(o-z)",
+                                   "integer :: i, j, a(10)",
+                                   "do i = 1, 10",
+                                   "  a(i) = i",
+                                   "  a(j) = j",
+                                   "  a(i) = a(i) + 1",
+                                   "end do",
+                                   "end program p"};
+  std::string result[2];
+  Stmt::Shape_Cache &cache = Stmt::shape_cache();
+  for (int cached = 0; cached < 2; ++cached) {
+    cache.clear();
+    Stmt::stmt_shape_caching() = (cached == 1);
+    LL_Helper ls{LL_Helper::Raw_Lines{lines}};
+    PS::State state(ls.ll_stmts());
+    auto res = PS::program(state);
+    Stmt::stmt_shape_caching() = false;
+    TEST_TRUE(res.match);
+    std::ostringstream os;
+    os << res.parse_tree << '\n';
+    for (auto const &stmt : ls.ll_stmts())
+      os << stmt.stmt_tree() << '\n';
+    result[cached] = os.str();
+  }
+  TEST_TRUE(cache.hits() > 0);
+  TEST_EQ_NODISPLAY(result[0], result[1]);
+
+  /* implicit-stmt looks at the letters, so it is never cached */
+  cache.clear();
+  LL_Helper ls({"implicit real(a-h)", "x = 1"});
+  auto stmt = ls.ll_stmts().begin();
+  for (int i = 0; i < 2; ++i)
+    TEST_TRUE(Stmt::shape_cache().parse(Stmt::implicit_stmt, *stmt));
+  TEST_INT(cache.size(), 0);
+  TEST_INT(cache.hits(), 0);
+  ++stmt;
+  for (int i = 0; i < 2; ++i)
+    TEST_TRUE(Stmt::shape_cache().parse(Stmt::assignment_stmt, *stmt));
+  TEST_INT(cache.size(), 1);
+  TEST_INT(cache.hits(), 1);
+
+  /* A full cache starts over, rather than refusing new shapes */
+  cache.clear();
+  std::size_t const capacity = cache.capacity();
+  cache.set_capacity(2);
+  LL_Helper shapes({"x = 1", "x = y", "x = y + 1"});
+  for (auto &s : shapes.ll_stmts())
+    TEST_TRUE(cache.parse(Stmt::assignment_stmt, s));
+  TEST_INT(cache.evictions(), 1);
+  TEST_INT(cache.size(), 1);
+  TEST_TRUE(cache.parse(Stmt::assignment_stmt, shapes.ll_stmts().back()));
+  TEST_INT(cache.hits(), 1);
+  cache.set_capacity(capacity);
+  cache.clear();
+  return true;
+}
+
+namespace {
+Stmt::Stmt_Tree throwing_stmt(TT_Stream &) {
+  throw std::runtime_error("extension failed");
+}
+} // namespace
+
+bool parallel_program_units() {
+  LL_Helper::Raw_Lines const lines{"module m",
+                                   "interface",
+                                   "subroutine ext(x)",
+                                   "real :: x",
+                                   "end subroutine ext",
+                                   "end interface",
+                                   "contains",
+                                   "integer function f(i)",
+                                   "integer :: i",
+                                   "f = i",
+                                   "end function f",
+                                   "end module m",
+                                   "recursive subroutine s(n)",
+                                   "integer :: n",
+                                   "if (n > 0) call s(n-1)",
+                                   "end",
+                                   "program p",
+                                   "use m",
+                                   "call s(f(3))",
+                                   "contains",
+                                   "subroutine inner",
+                                   "end subroutine inner",
+                                   "end program p"};
+  {
+    LL_Helper ls{LL_Helper::Raw_Lines{lines}};
+    PS::State state(ls.ll_stmts());
+    std::vector<SL_Range<LL_Stmt>> units;
+    TEST_TRUE(PS::split_program_units(state, units));
+    TEST_INT(units.size(), 3);
+    TEST_INT(units[0].size(), 12);
+    TEST_INT(units[1].size(), 4);
+    TEST_INT(units[2].size(), 7);
+  }
+
+  std::string result[2];
+  std::size_t work[2];
+  for (int parallel = 0; parallel < 2; ++parallel) {
+    LL_Helper ls{LL_Helper::Raw_Lines{lines}};
+    PS::State state(ls.ll_stmts());
+    auto res = parallel ? PS::program_parallel(state, 3) : PS::program(state);
+    TEST_TRUE(res.match);
+    TEST_FALSE(static_cast<bool>(state.ss));
+    std::ostringstream os;
+    os << res.parse_tree << '\n';
+    for (auto const &stmt : ls.ll_stmts())
+      os << stmt.stmt_tree() << '\n';
+    result[parallel] = os.str();
+    work[parallel] = state.work_done;
+  }
+  TEST_EQ_NODISPLAY(result[0], result[1]);
+  TEST_TRUE(work[1] > 0);
+
+  /* A main-program without a program-stmt can't be split, and falls back to
+     the serial parse */
+  LL_Helper ls({"subroutine s", "end subroutine s", "x = 1", "end"});
+  PS::State state(ls.ll_stmts());
+  std::vector<SL_Range<LL_Stmt>> units;
+  TEST_FALSE(PS::split_program_units(state, units));
+  auto res = PS::program_parallel(state, 2);
+  TEST_TRUE(res.match);
+  TEST_INT(res.parse_tree->branches().size(), 2);
+
+  /* An exception in a worker thread comes back to the caller */
+  {
+    Stmt::Parser_Exts exts;
+    exts.register_action_stmt(throwing_stmt);
+    LL_Helper ls{LL_Helper::Raw_Lines{lines}};
+    PS::State state(ls.ll_stmts());
+    state.parser_exts = &exts;
+    bool threw{false};
+    try {
+      PS::program_parallel(state, 3);
+    } catch (std::runtime_error const &e) {
+      threw = (std::string{e.what()} == "extension failed");
+    }
+    TEST_TRUE(threw);
+  }
+  {
+    std::atomic<int> calls{0};
+    bool threw{false};
+    try {
+      parallel_for(100, 4, [&calls](std::size_t const i) {
+        calls += 1;
+        if (i == 10)
+          throw std::out_of_range("index");
+      });
+    } catch (std::out_of_range const &) {
+      threw = true;
+    }
+    TEST_TRUE(threw);
+    TEST_TRUE(calls < 100);
+  }
+  return true;
+}
+
+bool materialize_stmt_trees() {
+  std::string const src{"module m\n"
+                        "contains\n"
+                        "subroutine s(a, n)\n"
+                        "integer :: n, i, a(n)\n"
+                        "do i = 1, n\n"
+                        "  a(i) = i\n"
+                        "end do\n"
+                        "if (n > 1) call s(a, n-1)\n"
+                        "end subroutine s\n"
+                        "end module m\n"};
+  std::string result[2];
+  for (int keep = 0; keep < 2; ++keep) {
+    std::istringstream is{src};
+    Parsed_File<> f(is, "materialize.f90", 0);
+    f.set_keep_stmt_trees(keep == 1);
+    TEST_TRUE(f.prefetch_parse_tree());
+    if (keep == 0) {
+      for (auto const &stmt : f.statements())
+        TEST_FALSE(stmt.has_stmt_tree());
+    }
+    TEST_TRUE(f.materialize_stmt_trees(3));
+    std::ostringstream os;
+    for (auto const &stmt : f.statements()) {
+      TEST_TRUE(stmt.has_stmt_tree());
+      os << stmt.stmt_tree() << '\n';
+    }
+    result[keep] = os.str();
+  }
+  TEST_EQ_NODISPLAY(result[0], result[1]);
+  return true;
+}
+
+/* A consumer pass doesn't leave behind the trees it rebuilt */
+bool release_stmt_trees() {
+  std::string const src{"module m\n"
+                        "contains\n"
+                        "subroutine s(a, n)\n"
+                        "integer :: n, i, a(n)\n"
+                        "do i = 1, n\n"
+                        "  a(i) = i\n"
+                        "end do\n"
+                        "contains\n"
+                        "subroutine t\n"
+                        "end subroutine t\n"
+                        "end subroutine s\n"
+                        "end module m\n"
+                        "program p\n"
+                        "call s\n"
+                        "end program p\n"};
+  for (int keep = 0; keep < 2; ++keep) {
+    std::istringstream is{src};
+    Parsed_File<> f(is, "release.f90", 0);
+    f.set_keep_stmt_trees(keep == 1);
+    TEST_TRUE(f.prefetch_parse_tree());
+    int num_stmts{0};
+    auto look = [&num_stmts](Parsed_File<> &, auto c, bool, bool) {
+      for (auto const &stmt : c->stmt_range()) {
+        if (stmt.stmt_tree().empty())
+          return false;
+        num_stmts += 1;
+      }
+      return true;
+    };
+    Procedure_Visitor visitor(f, look);
+    TEST_TRUE(visitor.visit());
+    TEST_INT(num_stmts, 14);
+    for (auto const &stmt : f.statements())
+      TEST_INT(stmt.has_stmt_tree(), (keep == 1));
+
+    /* Explicitly rebuilt trees go the same way */
+    TEST_TRUE(f.materialize_stmt_trees());
+    f.release_stmt_trees();
+    for (auto const &stmt : f.statements())
+      TEST_INT(stmt.has_stmt_tree(), (keep == 1));
+  }
+  return true;
+}
+
+bool program_recover() {
+  LL_Helper ls({"subroutine a",
+                "end subroutine a",
+                "subroutine b",
+                "integer :: i",
+                "i = = 1",
+                "end subroutine b",
+                "module m",
+                "contains",
+                "subroutine c",
+                "end subroutine c",
+                "end module m"});
+  PS::State state(ls.ll_stmts());
+  auto res = PS::program_recover(state);
+  TEST_TRUE(res.match);
+  TEST_TRUE(state.failed());
+  auto c = res.parse_tree.ccursor();
+  TEST_INT(c->syntag(), Syntax_Tags::PG_PROGRAM);
+  TEST_INT(c.node().branches().size(), 3);
+  c.down();
+  TEST_INT(c->syntag(), Syntax_Tags::PG_PROGRAM_UNIT);
+  c.next();
+  TEST_INT(c->syntag(), Syntax_Tags::PG_SYNTAX_ERROR);
+  TEST_INT(c.node().branches().size(), 4);
+  c.next();
+  TEST_INT(c->syntag(), Syntax_Tags::PG_PROGRAM_UNIT);
+
+  TEST_INT(state.failed_ranges.size(), 1);
+  auto const &failure = state.failed_ranges.front();
+  TEST_INT(failure.stmts.size(), 4);
+  TEST_TRUE(&failure.stmts.front() == &*std::next(ls.ll_stmts().begin(), 2));
+  TEST_TRUE(failure.fail_stmt == &*std::next(ls.ll_stmts().begin(), 4));
+  TEST_TRUE(state.fail_stmt == failure.fail_stmt);
+  for (auto const &stmt : failure.stmts)
+    TEST_INT(stmt.syntax_tag(), Syntax_Tags::UNKNOWN);
+  return true;
+}
+
+template <typename Node> int count_syntax_errors(Node const &n) {
+  int count = (n->syntag() == Syntax_Tags::PG_SYNTAX_ERROR) ? 1 : 0;
+  for (auto const &b : n.branches())
+    count += count_syntax_errors(b);
+  return count;
+}
+
+/* Errors inside a construct or contained subprogram only skip that */
+bool program_recover_constructs() {
+  Logical_File::Line_Buf const lines{"module m",
+                "contains",
+                "subroutine c(x)",
+                "real :: x",
+                "if (x > 0) then",
+                "x = = 1",
+                "end if",
+                "x = 2",
+                "end subroutine c",
+                "subroutine d",
+                "integer :: i",
+                "i = = 2",
+                "end subroutine d",
+                "subroutine e",
+                "interface",
+                "subroutine g(x)",
+                "real :: = x",
+                "end subroutine g",
+                "end interface",
+                "end subroutine e",
+                "subroutine f",
+                "end subroutine f",
+                "end module m"};
+  LL_Helper ls(Logical_File::Line_Buf{lines});
+  auto const at = [&ls](int const i) {
+    return &*std::next(ls.ll_stmts().begin(), i);
+  };
+  PS::State state(ls.ll_stmts());
+  auto res = PS::program_recover(state);
+  TEST_TRUE(res.match);
+  TEST_TRUE(state.skip_regions.empty());
+  auto c = res.parse_tree.ccursor();
+  TEST_INT(c.node().branches().size(), 1);
+  TEST_INT(count_syntax_errors(*res.parse_tree), 3);
+  c.down();
+  TEST_INT(c->syntag(), Syntax_Tags::PG_PROGRAM_UNIT);
+
+  TEST_INT(state.failed_ranges.size(), 3);
+  auto const &if_failure = state.failed_ranges[0];
+  TEST_INT(if_failure.skipped_syntag, Syntax_Tags::PG_IF_CONSTRUCT);
+  TEST_TRUE(&if_failure.stmts.front() == at(4));
+  TEST_INT(if_failure.stmts.size(), 3);
+  TEST_TRUE(if_failure.fail_stmt == at(5));
+  TEST_TRUE(state.fail_stmt == at(5));
+  /* The if-construct is replaced, and the rest of c is parsed */
+  TEST_INT(at(4)->syntax_tag(), Syntax_Tags::UNKNOWN);
+  TEST_INT(at(7)->syntax_tag(), Syntax_Tags::SG_ASSIGNMENT_STMT);
+  TEST_INT(at(8)->syntax_tag(), Syntax_Tags::SG_END_SUBROUTINE_STMT);
+
+  auto const &d_failure = state.failed_ranges[1];
+  TEST_INT(d_failure.skipped_syntag, Syntax_Tags::PG_SUBROUTINE_SUBPROGRAM);
+  TEST_TRUE(&d_failure.stmts.front() == at(9));
+  TEST_INT(d_failure.stmts.size(), 4);
+  TEST_TRUE(d_failure.fail_stmt == at(11));
+
+  /* An interface body can't be skipped on its own, so the whole
+     interface-block is */
+  auto const &e_failure = state.failed_ranges[2];
+  TEST_INT(e_failure.skipped_syntag, Syntax_Tags::PG_INTERFACE_BLOCK);
+  TEST_TRUE(&e_failure.stmts.front() == at(14));
+  TEST_INT(e_failure.stmts.size(), 5);
+  TEST_TRUE(e_failure.fail_stmt == at(16));
+  TEST_INT(at(13)->syntax_tag(), Syntax_Tags::SG_SUBROUTINE_STMT);
+  TEST_INT(at(19)->syntax_tag(), Syntax_Tags::SG_END_SUBROUTINE_STMT);
+  TEST_INT(at(22)->syntax_tag(), Syntax_Tags::SG_END_MODULE_STMT);
+
+  /* Parsed_File reports them through recovered_errors() */
+  Parsed_File<> f;
+  TEST_FALSE(f.scan_lines(Logical_File::Line_Buf{lines}, "recover.f90", 0));
+  f.set_error_recovery(true);
+  TEST_TRUE(f.prefetch_parse_tree());
+  TEST_INT(f.failed_ranges().size(), 3);
+  auto const errors = f.recovered_errors();
+  TEST_INT(errors.size(), 3);
+  TEST_FALSE(errors[0].ok);
+  TEST_STR("recover.f90", errors[0].filename);
+  TEST_INT(errors[0].line, 6);
+  TEST_INT(errors[1].line, 12);
+  TEST_INT(errors[2].line, 17);
+  return true;
+}
+
+bool reparse_dirty() {
+  std::string const src{"subroutine s(i)\n"
+                        "integer :: i\n"
+                        "if (i > 0) then\n"
+                        "  i = 1\n"
+                        "end if\n"
+                        "end subroutine s\n"
+                        "subroutine t\n"
+                        "end subroutine t\n"};
+  std::istringstream is{src};
+  Parsed_File<> f(is, "reparse.f90", 0);
+  TEST_TRUE(f.prefetch_parse_tree());
+  auto &stmts = f.statements();
+  auto const assign_stmt = std::next(stmts.begin(), 3);
+  auto const end_if_stmt = std::next(assign_stmt);
+  auto const t_stmt = std::next(stmts.begin(), 6);
+  auto const *const t_node = t_stmt->get_hook();
+  TEST_TRUE(t_node != nullptr);
+
+  /* Turn the if-construct into a nested do-construct */
+  f.logical_file().replace_stmt_text(assign_stmt, {"do i = 1, 2"},
+                                     Syntax_Tags::UNKNOWN);
+  auto const print_stmt = f.logical_file().emplace_ll_stmt(
+      end_if_stmt, Logical_Line{"  print *, i"}, Syntax_Tags::UNKNOWN);
+  f.logical_file().emplace_ll_stmt(end_if_stmt, Logical_Line{"end do"},
+                                   Syntax_Tags::UNKNOWN);
+  TEST_FALSE(assign_stmt->has_hook());
+  TEST_TRUE(f.reparse_dirty());
+
+  for (auto const &stmt : stmts)
+    TEST_TRUE(stmt.has_hook());
+  /* only the if-construct was re-parsed */
+  TEST_TRUE(t_stmt->get_hook() == t_node);
+  TEST_INT(print_stmt->syntax_tag(), Syntax_Tags::SG_PRINT_STMT);
+  auto c = f.stmt_to_node_cursor(assign_stmt);
+  TEST_INT(c->syntag(), Syntax_Tags::SG_DO_STMT);
+
+  /* The updated tree is the same as a fresh parse of the edited text */
+  std::ostringstream edited, fresh;
+  edited << f.parse_tree();
+  for (auto const &ll : f.logical_lines())
+    ll.print(fresh) << '\n';
+  std::istringstream is2{fresh.str()};
+  Parsed_File<> f2(is2, "reparse.f90", 0);
+  TEST_TRUE(f2.prefetch_parse_tree());
+  std::ostringstream fresh_tree;
+  fresh_tree << f2.parse_tree();
+  TEST_EQ_NODISPLAY(edited.str(), fresh_tree.str());
+  return true;
+}
+
+/* A re-parse sees the same context as the full parse would */
+bool reparse_in_context() {
+  std::string const src{"subroutine s(a)\n"
+                        "integer :: a(10), i\n"
+                        "do 10 i = 1, 10\n"
+                        "  if (a(i) > 0) then\n"
+                        "    a(i) = 1\n"
+                        "  end if\n"
+                        "10 continue\n"
+                        "end subroutine s\n"};
+  {
+    /* A statement ending the label-do inside of the if-construct is an
+       error, so the if-construct doesn't re-parse on its own, and the
+       rebuilt tree fails as a fresh parse would */
+    std::istringstream is{src};
+    Parsed_File<> f(is, "context.f90", 0);
+    TEST_TRUE(f.prefetch_parse_tree());
+    auto const assign_stmt = std::next(f.statements().begin(), 4);
+    f.logical_file().replace_stmt_text(assign_stmt, {"10 a(i) = 2"},
+                                       Syntax_Tags::UNKNOWN);
+    TEST_FALSE(f.reparse_dirty());
+    TEST_FALSE(f.budget_exhausted());
+    TEST_FALSE(static_cast<bool>(f));
+  }
+  {
+    /* The re-parse is held to the work budget */
+    std::istringstream is{src};
+    Parsed_File<> f(is, "context.f90", 0);
+    TEST_TRUE(f.prefetch_parse_tree());
+    std::size_t const work = f.parse_work();
+    f.set_work_budget(1);
+    auto const assign_stmt = std::next(f.statements().begin(), 4);
+    f.logical_file().replace_stmt_text(assign_stmt, {"a(i) = 2"},
+                                       Syntax_Tags::UNKNOWN);
+    TEST_FALSE(f.reparse_dirty());
+    TEST_TRUE(f.budget_exhausted());
+    TEST_FALSE(assign_stmt->has_hook());
+
+    f.set_work_budget(0);
+    TEST_TRUE(f.reparse_dirty());
+    TEST_FALSE(f.budget_exhausted());
+    TEST_TRUE(assign_stmt->has_hook());
+    TEST_TRUE(f.parse_work() > work);
+  }
+  return true;
+}
+
+bool snapshot_rollback() {
+  std::string const src{"subroutine s(i)\n"
+                        "integer :: i\n"
+                        "if (i > 0) then\n"
+                        "  i = 1\n"
+                        "end if\n"
+                        "end subroutine s\n"
+                        "subroutine t\n"
+                        "end subroutine t\n"};
+  std::istringstream is{src};
+  Parsed_File<> f(is, "rollback.f90", 0);
+  TEST_TRUE(f.prefetch_parse_tree());
+  auto &stmts = f.statements();
+  auto const tree_text = [&f]() {
+    std::ostringstream os;
+    os << f.parse_tree();
+    return os.str();
+  };
+  auto const hooks_ok = [&f, &stmts]() {
+    for (auto it = stmts.begin(); it != stmts.end(); ++it) {
+      auto c = f.stmt_to_node_cursor(it);
+      if (!c || &(c->ll_stmt()) != &*it)
+        return false;
+    }
+    return true;
+  };
+  std::string const orig{tree_text()};
+  auto const assign_stmt = std::next(stmts.begin(), 3);
+  auto const end_if_stmt = std::next(assign_stmt);
+
+  auto const s1 = f.snapshot();
+  f.logical_file().replace_stmt_text(assign_stmt, {"do i = 1, 2"},
+                                     Syntax_Tags::UNKNOWN);
+  f.logical_file().emplace_ll_stmt(end_if_stmt, Logical_Line{"end do"},
+                                   Syntax_Tags::UNKNOWN);
+  TEST_TRUE(f.reparse_dirty());
+  std::string const edited{tree_text()};
+  TEST_TRUE(edited != orig);
+
+  /* A speculative edit that breaks the program, forcing a full rebuild */
+  auto const s2 = f.snapshot();
+  f.logical_file().replace_stmt_text(end_if_stmt, {"end select"},
+                                     Syntax_Tags::UNKNOWN);
+  TEST_FALSE(f.reparse_dirty());
+  TEST_FALSE(f);
+  f.rollback(s2);
+  TEST_TRUE(f);
+  TEST_EQ_NODISPLAY(tree_text(), edited);
+  TEST_TRUE(hooks_ok());
+
+  f.rollback(s1);
+  TEST_INT(stmts.size(), 8);
+  TEST_EQ_NODISPLAY(tree_text(), orig);
+  TEST_TRUE(hooks_ok());
+  TEST_INT(assign_stmt->stmt_tag(true), Syntax_Tags::SG_ASSIGNMENT_STMT);
+
+  /* Reindenting only changes the layout, which is rolled back too */
+  std::string const text{f.logical_file().render()};
+  auto const s3 = f.snapshot();
+  Indent_Table indents;
+  indents.apply_constant_indent(4);
+  TEST_TRUE(f.indent(indents));
+  TEST_TRUE(f.logical_file().render() != text);
+  f.rollback(s3);
+  TEST_EQ_NODISPLAY(f.logical_file().render(), text);
+  TEST_FALSE(f.logical_file().has_dirty_lines());
+  return true;
+}
+
+bool check_valid() {
+  LL_Helper ls({"subroutine foo",
+                "integer i",
+                "do 10 i = 1, 5",
+                "  print *, i",
+                "10 continue",
+                "end subroutine foo"});
+  PS::State state(ls.ll_stmts());
+  TEST_TRUE(PS::check(state));
+  TEST_FALSE(state.failed());
+  /* nothing should have been attached to the statements */
+  for (auto const &stmt : ls.ll_stmts())
+    TEST_INT(stmt.syntax_tag(), Syntax_Tags::UNKNOWN);
+  return true;
+}
+
+bool check_invalid() {
+  LL_Helper ls({"subroutine foo",
+                "integer i",
+                "if (i > 0) then",
+                "  i = 1",
+                "end do",
+                "end subroutine foo"});
+  PS::State state(ls.ll_stmts());
+  TEST_FALSE(PS::check(state));
+  TEST_TRUE(state.failed());
+  TEST_TRUE(state.fail_stmt != nullptr);
+  auto bad_stmt = std::next(ls.ll_stmts().begin(), 4);
+  TEST_TRUE(state.fail_stmt == &(*bad_stmt));
+  TEST_INT(state.fail_syntag, Syntax_Tags::PG_IF_CONSTRUCT);
+  return true;
+}
+
+bool work_budget() {
+  LL_Helper::Raw_Lines const lines{"subroutine foo",
+                                   "integer i, j",
+                                   "do 10 i = 1, 5",
+                                   "do 10 j = 1, 5",
+                                   "  if (i > j) then",
+                                   "    print *, i",
+                                   "  else if (i < j) then",
+                                   "    print *, j",
+                                   "  end if",
+                                   "10 continue",
+                                   "end subroutine foo"};
+  size_t needed;
+  {
+    LL_Helper ls{LL_Helper::Raw_Lines{lines}};
+    PS::State state(ls.ll_stmts());
+    TEST_TRUE(PS::program(state).match);
+    TEST_FALSE(state.budget_exhausted);
+    needed = state.work_done;
+    TEST_TRUE(needed >= lines.size());
+  }
+  {
+    LL_Helper ls{LL_Helper::Raw_Lines{lines}};
+    PS::State state(ls.ll_stmts());
+    state.work_budget = needed;
+    TEST_TRUE(PS::program(state).match);
+    TEST_INT(state.work_done, needed);
+  }
+  {
+    LL_Helper ls{LL_Helper::Raw_Lines{lines}};
+    PS::State state(ls.ll_stmts());
+    state.work_budget = needed / 2;
+    TEST_FALSE(PS::program(state).match);
+    TEST_TRUE(state.budget_exhausted);
+    TEST_INT(state.work_done, needed / 2);
+    TEST_TRUE(state.failed());
+    TEST_TRUE(state.fail_stmt != nullptr);
+  }
+  {
+    /* Backtracking is charged along with the next statement parse */
+    LL_Helper ls{LL_Helper::Raw_Lines{lines}};
+    PS::State state(ls.ll_stmts());
+    TEST_TRUE(state.charge_work());
+    TEST_INT(state.work_done, 1);
+    TT_Stream ts{ls.ll_stmts().front()};
+    ts.consume();
+    ts.rewind();
+    ts.rewind(ts.mark());
+    state.charge_backtrack();
+    TEST_INT(state.work_done, 1);
+    TEST_TRUE(state.charge_work());
+    TEST_INT(state.work_done, 5);
+    state.work_budget = 6;
+    state.charge_backtrack();
+    TEST_FALSE(state.charge_work());
+    TEST_TRUE(state.budget_exhausted);
+    TEST_INT(state.work_done, 6);
+  }
+  return true;
+}
+
 // clang-format on
 
+bool concurrent_lazy_builds() {
+  std::string src{"module m\ncontains\n"};
+  for (int i = 0; i < 20; ++i) {
+    std::string const n{std::to_string(i)};
+    src += "subroutine s" + n + "(a, n)\n"
+           "integer :: n, i, a(n)\n"
+           "do i = 1, n\n"
+           "  a(i) = i + " + n + "\n"
+           "end do\n"
+           "end subroutine s" + n + "\n";
+  }
+  src += "end module m\n";
+
+  std::ostringstream expected;
+  std::uint64_t expected_hash{0};
+  {
+    std::istringstream is{src};
+    Parsed_File<> f(is, "lazy.f90", 0);
+    TEST_TRUE(f.prefetch_parse_tree());
+    for (auto const &stmt : f.statements())
+      expected << stmt.stmt_tree() << '\n';
+    expected_hash = Prgm::subtree_hash(*f.parse_tree());
+  }
+
+  /* Every thread races to build the statements, the parse tree, the
+     dropped Stmt_Trees and the subtree hashes, and they must all see the
+     same result */
+  std::istringstream is{src};
+  Parsed_File<> f(is, "lazy.f90", 0);
+  f.set_keep_stmt_trees(false);
+  unsigned const num_threads = 4;
+  std::vector<std::string> seen(num_threads);
+  std::vector<char> ok(num_threads, 0);
+  std::vector<std::uint64_t> hashes(num_threads, 0);
+  parallel_for(num_threads, num_threads, [&](std::size_t const t) {
+    if (!f.prefetch_parse_tree() || !f || f.parse_tree().empty())
+      return;
+    hashes[t] = Prgm::subtree_hash(*f.parse_tree());
+    std::ostringstream os;
+    for (auto const &stmt : f.statements())
+      os << stmt.stmt_tree() << '\n';
+    seen[t] = os.str();
+    ok[t] = 1;
+  });
+  for (unsigned t = 0; t < num_threads; ++t) {
+    TEST_TRUE(ok[t]);
+    TEST_EQ_NODISPLAY(seen[t], expected.str());
+    TEST_TRUE(hashes[t] == expected_hash);
+  }
+  return true;
+}
+
+/* A write-stmt that accepts a comma after the io-control-spec-list (see
+   apps/ext_demo.cc) */
+namespace FLPR::Stmt {
+Stmt_Tree write_comma_stmt(TT_Stream &ts) {
+  constexpr auto p = seq(
+      Syntax_Tags::SG_WRITE_STMT, tok(Syntax_Tags::KW_WRITE),
+      tag_if(Syntax_Tags::SG_IO_CONTROL_SPEC_LIST, rule(consume_parens)),
+      tok(Syntax_Tags::TK_COMMA),
+      opt(list(Syntax_Tags::SG_OUTPUT_ITEM_LIST, rule(output_item))), eol());
+  return p(ts);
+}
+} // namespace FLPR::Stmt
+
+bool parser_exts() {
+  Stmt::Parser_Exts exts;
+  TEST_TRUE(exts.empty());
+  TEST_TRUE(exts.register_action_stmt(Stmt::write_comma_stmt));
+  TEST_FALSE(exts.empty());
+
+  LL_Helper::Raw_Lines const lines{"subroutine foo", "integer i",
+                                   "do i = 1, 5", "  write(*,100), i",
+                                   "end do", "end subroutine foo"};
+  auto const parse = [&lines](Stmt::Parser_Exts const *const e) {
+    LL_Helper ls{LL_Helper::Raw_Lines{lines}};
+    PS::State state(ls.ll_stmts());
+    state.quiet = true;
+    state.parser_exts = e;
+    return PS::program(state).match && !state.ss;
+  };
+  /* The extension only applies to the parse that it is given to, and the
+     shape cache doesn't carry results from one to the other */
+  TEST_FALSE(parse(nullptr));
+  TEST_TRUE(parse(&exts));
+  TEST_FALSE(parse(nullptr));
+  TEST_TRUE(parse(&exts));
+
+  /* A failure cached before an extension is registered isn't reused after */
+  {
+    Stmt::Shape_Cache &cache = Stmt::shape_cache();
+    cache.clear();
+    Stmt::Parser_Exts late;
+    LL_Helper ls({"write(*,100), i"});
+    auto &stmt = ls.ll_stmts().front();
+    TEST_FALSE(cache.parse(Stmt::action_stmt, stmt, &late));
+    TEST_INT(cache.size(), 1);
+    auto const generation = late.generation();
+    TEST_TRUE(late.register_action_stmt(Stmt::write_comma_stmt));
+    TEST_TRUE(late.generation() != generation);
+    TEST_TRUE(cache.parse(Stmt::action_stmt, stmt, &late));
+    TEST_INT(cache.hits(), 0);
+    cache.clear();
+  }
+
+  {
+    std::istringstream is{"subroutine foo\nwrite(*,100), 1\n"
+                          "end subroutine foo\n"};
+    Parsed_File<> file(is, "exts.f90", 0);
+    file.set_parser_exts(&exts);
+    TEST_TRUE(file.prefetch_parse_tree() && file);
+  }
+
+  /* Stmt_Trees rebuilt on demand use the extensions of the parse */
+  {
+    std::istringstream is{"subroutine foo\nwrite(*,100), 1\n"
+                          "end subroutine foo\n"};
+    Parsed_File<> file(is, "exts.f90", 0);
+    file.set_parser_exts(&exts);
+    file.set_keep_stmt_trees(false);
+    TEST_TRUE(file.prefetch_parse_tree() && file);
+    auto stmt = std::next(file.statements().begin());
+    TEST_FALSE(stmt->has_stmt_tree());
+    TEST_TRUE(stmt->build_stmt_tree());
+    TEST_TRUE(file.materialize_stmt_trees());
+    TEST_FALSE(stmt->stmt_tree().empty());
+  }
+
+  /* A frozen set can't be changed, but a copy of it can */
+  exts.freeze();
+  TEST_TRUE(exts.frozen());
+  TEST_FALSE(exts.register_other_specification_stmt(Stmt::write_comma_stmt));
+  TEST_FALSE(exts.clear());
+  TEST_FALSE(exts.empty());
+  Stmt::Parser_Exts copy{exts};
+  TEST_FALSE(copy.frozen());
+  TEST_TRUE(copy.clear());
+  TEST_TRUE(copy.empty());
+  TEST_TRUE(parse(&exts));
+  return true;
+}
+
 int main() {
   TEST_MAIN_DECL;
   TEST(test_instantiate);
@@ -230,5 +1084,21 @@ int main() {
   TEST(derived_type_def);
   TEST(do_select_construct);
   TEST(module_program);
+  TEST(two_pass_matches_eager);
+  TEST(classify_only);
+  TEST(check_valid);
+  TEST(check_invalid);
+  TEST(work_budget);
+  TEST(shape_cache_matches_parse);
+  TEST(parallel_program_units);
+  TEST(materialize_stmt_trees);
+  TEST(release_stmt_trees);
+  TEST(concurrent_lazy_builds);
+  TEST(program_recover);
+  TEST(program_recover_constructs);
+  TEST(reparse_dirty);
+  TEST(reparse_in_context);
+  TEST(snapshot_rollback);
+  TEST(parser_exts);
   TEST_MAIN_REPORT;
 }
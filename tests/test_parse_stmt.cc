@@ -12,8 +12,13 @@
   Tests for full statement parsers.
 */
 
+#include "flpr/Alt_Profile.hh"
+#include "flpr/Stmt_Parsers.hh"
 #include "flpr/parse_stmt.hh"
 #include "parse_helpers.hh"
+#include <sstream>
+#include <string>
+#include <vector>
 
 using namespace FLPR;
 using FLPR::Stmt::Stmt_Tree;
@@ -633,6 +638,90 @@ bool easy() {
   return true;
 }
 
+/* Parse each statement with action_stmt, returning the printed trees */
+std::string action_stmt_trees(std::vector<char const *> const &stmts) {
+  std::ostringstream os;
+  for (auto const s : stmts) {
+    LL_Helper l({s});
+    TT_Stream ts = l.stream1();
+    os << FLPR::Stmt::action_stmt(ts) << '\n';
+  }
+  return os.str();
+}
+
+bool adaptive_action_stmt() {
+  std::vector<char const *> const stmts{"a(i) = b(i) + 1",
+                                        "call foo(x, y=3)",
+                                        "read(10)",
+                                        "rewind(10)",
+                                        "foo(1)",
+                                        "if (i > 0) i = i - 1",
+                                        "if(i-j) 5000, 6000, 8000",
+                                        "p => q",
+                                        "x = y",
+                                        "print *, x",
+                                        "i = 2",
+                                        "write(*,*) x",
+                                        "j = 3",
+                                        "stop"};
+  FLPR::adaptive_alternatives() = false;
+  std::string const fixed = action_stmt_trees(stmts);
+
+  FLPR::alt_profile().clear();
+  FLPR::adaptive_alternatives() = true;
+  std::string adaptive;
+  for (int i = 0; i < 3; ++i)
+    adaptive = action_stmt_trees(stmts);
+  TEST_EQ_NODISPLAY(fixed, adaptive);
+
+  /* assignment-stmt (the second alternative) won most often, counting the
+     one nested in the if-stmt */
+  auto &site = FLPR::alt_profile().site(Syntax_Tags::SG_ACTION_STMT, 39);
+  TEST_INT(site.count(1), 15);
+  TEST_INT(site.probe(0), 1);
+
+  /* round-trip the profile */
+  std::ostringstream saved;
+  TEST_TRUE(FLPR::alt_profile().save(saved));
+  FLPR::alt_profile().clear();
+  std::istringstream is{saved.str()};
+  TEST_TRUE(FLPR::alt_profile().load(is));
+  std::ostringstream resaved;
+  TEST_TRUE(FLPR::alt_profile().save(resaved));
+  TEST_EQ_NODISPLAY(saved.str(), resaved.str());
+  TEST_EQ_NODISPLAY(fixed, action_stmt_trees(stmts));
+
+  FLPR::alt_profile().clear();
+  FLPR::adaptive_alternatives() = false;
+  return true;
+}
+
+/* A rule that recognizes with its own combinator stashes no trees in the
+   recognizer pass, and the build pass reproduces the eager parse */
+bool recognize_then_build() {
+  LL_Helper l({"allocatable :: a(:), b"});
+  std::ostringstream eager;
+  {
+    TT_Stream ts = l.stream1();
+    eager << FLPR::Stmt::allocatable_stmt(ts);
+  }
+  constexpr auto p = FLPR::Stmt::rule(FLPR::Stmt::allocatable_stmt);
+  FLPR::Stmt::SP_Trace trace;
+  {
+    TT_Stream ts = l.stream1();
+    TEST_TRUE(p.recognize(ts, trace));
+    TEST_TAG(ts.peek(), BAD);
+  }
+  TEST_INT(trace.mark().cached, 0);
+  TEST_TRUE(trace.mark().decision > 0);
+  TT_Stream ts = l.stream1();
+  trace.replay(FLPR::Stmt::SP_Trace::Mark{0, 0});
+  std::ostringstream built;
+  built << p.build(ts, trace);
+  TEST_EQ_NODISPLAY(eager.str(), built.str());
+  return true;
+}
+
 int main() {
   TEST_MAIN_DECL;
   TEST(easy);
@@ -708,6 +797,8 @@ int main() {
   TEST(where_construct_stmt);
   TEST(where_stmt);
   TEST(write_stmt);
+  TEST(adaptive_action_stmt);
+  TEST(recognize_then_build);
 
   TEST_MAIN_REPORT;
 }
@@ -76,6 +76,29 @@ bool expr() {
   return true;
 }
 
+bool structured_expr() {
+  TPS(structured_expr, "a", BAD);
+  TPS(structured_expr, "a + b * c", BAD);
+  TPS(structured_expr, "-a**2 / b", BAD);
+  TPS(structured_expr, "a .and. .not. b .or. c .eqv. d", BAD);
+  TPS(structured_expr, "x(1:n) // 'abc'", BAD);
+  TPS(structured_expr, "f(x, dim=1) + g()", BAD);
+  TPS(structured_expr, "a%b(3)%c * (d - e)", BAD);
+  TPS(structured_expr, "(/ 1, 2, 3 /) * a", BAD);
+  TPS(structured_expr, "[(i, i=1,n)]", BAD);
+  TPS(structured_expr, "[real :: a, b]", BAD);
+  TPS(structured_expr, "(a, 2.0e0_dp)", BAD);
+  TPS(structured_expr, "a .myop. .neg. b", BAD);
+  TPS(structured_expr, ".true. .neqv. b >= c", BAD);
+  TPS(structured_expr, "a+b, c", TK_COMMA);
+  TPS(structured_expr, "a(i)) = 3", TK_PARENR);
+  TPS(structured_expr, "a < b < c", TK_REL_LT);
+  TPS(structured_expr, "a * /)", TK_ASTERISK);
+  FPS(structured_expr, "* a", TK_ASTERISK);
+  FPS(structured_expr, ")", TK_PARENR);
+  return true;
+}
+
 bool generic_spec() {
   TSS(generic_spec, "foo");             // generic-name
   TSS(generic_spec, "write");           // generic-name
@@ -220,6 +243,7 @@ int main() {
   TEST(proc_component_ref);
   TEST(procedure_designator);
   TEST(signed_real_literal_constant);
+  TEST(structured_expr);
   TEST(variable);
   TEST(wait_spec);
   TEST_MAIN_REPORT;
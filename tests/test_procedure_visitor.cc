@@ -0,0 +1,78 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+#include "flpr/Parsed_File.hh"
+#include "flpr/Procedure_Visitor.hh"
+#include "test_helpers.hh"
+#include <mutex>
+#include <sstream>
+#include <string>
+
+using namespace FLPR;
+
+bool procedure_visitor_parallel() {
+  std::string const src{"module m\n"
+                        "contains\n"
+                        "subroutine a\n"
+                        "end subroutine a\n"
+                        "subroutine b\n"
+                        "call c\n"
+                        "contains\n"
+                        "subroutine c\n"
+                        "end subroutine c\n"
+                        "end subroutine b\n"
+                        "function d()\n"
+                        "d = 1\n"
+                        "end function d\n"
+                        "end module m\n"
+                        "subroutine e\n"
+                        "end subroutine e\n"};
+  std::istringstream is1{src}, is2{src};
+  Parsed_File<> serial(is1, "visit.f90", 0), parallel(is2, "visit.f90", 0);
+
+  /* Tag each procedure statement with its kind of procedure */
+  std::mutex m;
+  int num_calls{0};
+  auto tag = [&](Parsed_File<> &, auto c, bool const internal,
+                 bool const module) {
+    {
+      std::lock_guard<std::mutex> const lock{m};
+      num_calls += 1;
+    }
+    c->stmt_range().begin()->ll().append_comment(
+        std::string{internal ? "internal" : "external"} +
+        (module ? " module" : ""));
+    return c->syntag() == Syntax_Tags::PG_FUNCTION_SUBPROGRAM;
+  };
+  Procedure_Visitor sv(serial, tag);
+  TEST_TRUE(sv.visit());
+  TEST_INT(num_calls, 5);
+
+  num_calls = 0;
+  Procedure_Visitor pv(parallel, tag);
+  TEST_TRUE(pv.visit_parallel(3, decltype(pv)::Access::LOCAL_EDITS));
+  TEST_INT(num_calls, 5);
+  std::ostringstream s_text, p_text;
+  serial.logical_file().write(s_text);
+  parallel.logical_file().write(p_text);
+  TEST_EQ_NODISPLAY(s_text.str(), p_text.str());
+
+  /* The result is or-reduced over the procedures */
+  auto none = [](Parsed_File<> &, auto, bool, bool) { return false; };
+  Procedure_Visitor nv(parallel, none);
+  TEST_FALSE(nv.visit_parallel(3, decltype(nv)::Access::READ_ONLY));
+  return true;
+}
+
+int main() {
+  TEST_MAIN_DECL;
+  TEST(procedure_visitor_parallel);
+  TEST_MAIN_REPORT;
+}
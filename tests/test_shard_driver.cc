@@ -0,0 +1,131 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+#include "apps/Shard_Driver.hh"
+#include "test_helpers.hh"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+/* Write files of decreasing size, so that two workers get the shards
+   {0, 3} and {1, 2} */
+std::vector<std::string> make_files() {
+  std::vector<std::string> names;
+  for (int i = 0; i < 4; ++i) {
+    names.push_back("shard_" + std::to_string(i) + ".f90");
+    std::ofstream os(names.back());
+    os << std::string(400 - 100 * i, 'x') << '\n';
+  }
+  return names;
+}
+
+void remove_files(std::vector<std::string> const &names) {
+  for (auto const &n : names)
+    std::remove(n.c_str());
+}
+
+/* Redirect std::cout and std::cerr for the life of the object */
+struct Capture {
+  Capture() {
+    cout_buf = std::cout.rdbuf(out.rdbuf());
+    cerr_buf = std::cerr.rdbuf(err.rdbuf());
+  }
+  ~Capture() {
+    std::cout.rdbuf(cout_buf);
+    std::cerr.rdbuf(cerr_buf);
+  }
+  std::ostringstream out, err;
+  std::streambuf *cout_buf, *cerr_buf;
+};
+
+} // namespace
+
+bool merged_output() {
+  std::vector<std::string> const names{make_files()};
+  Shard_Driver driver{2, [](std::string const &filename) {
+                        std::cout << filename << '\n';
+                        std::cerr << "done " << filename << '\n';
+                        return true;
+                      }};
+  bool ok;
+  std::string out, err;
+  {
+    Capture c;
+    ok = driver.run(names);
+    out = c.out.str();
+    err = c.err.str();
+  }
+  remove_files(names);
+  TEST_TRUE(ok);
+  /* Written in file order, not in the order that the shards finished */
+  TEST_STR("shard_0.f90\nshard_1.f90\nshard_2.f90\nshard_3.f90\n", out);
+  TEST_STR("done shard_0.f90\ndone shard_1.f90\ndone shard_2.f90\n"
+           "done shard_3.f90\n",
+           err);
+  TEST_INT(driver.results().size(), 4);
+  for (auto const &r : driver.results()) {
+    TEST_TRUE(r.done);
+    TEST_TRUE(r.ok);
+    TEST_FALSE(r.crashed);
+  }
+  TEST_INT(driver.num_failed(), 0);
+  TEST_INT(driver.num_restarts(), 0);
+  return true;
+}
+
+/* A worker that dies costs the one file, and a new worker finishes its
+   shard */
+bool worker_restart() {
+  std::vector<std::string> const names{make_files()};
+  Shard_Driver driver{2, [](std::string const &filename) {
+                        std::cout << filename << '\n';
+                        if (filename == "shard_1.f90")
+                          _exit(7);
+                        return filename != "shard_3.f90";
+                      }};
+  bool ok;
+  std::string out, err;
+  {
+    Capture c;
+    ok = driver.run(names);
+    out = c.out.str();
+    err = c.err.str();
+  }
+  remove_files(names);
+  TEST_FALSE(ok);
+  /* The output of the file that crashed is lost */
+  TEST_STR("shard_0.f90\nshard_2.f90\nshard_3.f90\n", out);
+  TEST_STR("shard_1.f90: worker exited with status 7\n", err);
+  auto const &results = driver.results();
+  TEST_TRUE(results[0].ok);
+  TEST_FALSE(results[1].ok);
+  TEST_TRUE(results[1].crashed);
+  TEST_TRUE(results[2].done);
+  TEST_TRUE(results[2].ok);
+  TEST_FALSE(results[2].crashed);
+  TEST_FALSE(results[3].ok);
+  TEST_FALSE(results[3].crashed);
+  TEST_INT(driver.num_failed(), 2);
+  TEST_INT(driver.num_restarts(), 1);
+  return true;
+}
+
+int main() {
+  TEST_MAIN_DECL;
+  TEST(merged_output);
+  TEST(worker_restart);
+  TEST_MAIN_REPORT;
+}
@@ -501,6 +501,103 @@ bool real_literal_constant() {
   return true;
 }
 
+bool expand_expr() {
+  PARSE(assignment_stmt, "x = a(i) + b * c**2");
+  auto c{st.cursor()};
+  c.down();
+  c.next(2);
+  TEST_TAG(c->syntag, SG_EXPR);
+  /* Until it is expanded, the expr is just its tokens */
+  TEST_FALSE(Stmt::is_expanded_expr(c.node()));
+  TEST_INT(c.num_branches(), 10);
+  TEST_INT(c->token_range.size(), 10);
+  Stmt::expand_down(c);
+  TEST_TAG(c->syntag, SG_LEVEL_2_EXPR);
+  TEST_INT(c.num_branches(), 3);
+  TEST_INT(c->token_range.size(), 10);
+  TEST_FALSE(c.has_next());
+  c.down();
+  TEST_TAG(c->syntag, SG_PRIMARY);
+  TEST_INT(c->token_range.size(), 4);
+  c.next();
+  TEST_TAG(c->syntag, SG_ADD_OP);
+  c.down();
+  TEST_TAG(c->syntag, TK_PLUS);
+  c.up();
+  c.next();
+  TEST_TAG(c->syntag, SG_ADD_OPERAND);
+  c.down(); // b
+  TEST_TAG(c->syntag, SG_PRIMARY);
+  c.next();
+  TEST_TAG(c->syntag, SG_MULT_OP);
+  c.next();
+  TEST_TAG(c->syntag, SG_MULT_OPERAND);
+  TEST_INT(c->token_range.size(), 3);
+  c.down();
+  c.next();
+  TEST_TAG(c->syntag, SG_POWER_OP);
+  c.up(4);
+  TEST_TAG(c->syntag, SG_EXPR);
+  TEST_TRUE(Stmt::is_expanded_expr(c.node()));
+  /* expanding again is a no-op */
+  TEST_TRUE(Stmt::expand_expr(c.node()));
+  TEST_INT(c.num_branches(), 1);
+
+  /* The subscript is its own (unexpanded) expr */
+  c.down(); // level-2-expr
+  c.down(); // primary
+  c.down(); // designator
+  c.down(); // data-ref
+  c.down(); // part-ref
+  c.down(); // a
+  c.next(2);
+  TEST_TAG(c->syntag, SG_SECTION_SUBSCRIPT_LIST);
+  c.down(); // section-subscript
+  c.down(); // int-expr
+  c.down();
+  TEST_TAG(c->syntag, SG_EXPR);
+  TEST_FALSE(Stmt::is_expanded_expr(c.node()));
+  Stmt::expand_exprs(*st);
+  TEST_TRUE(Stmt::is_expanded_expr(c.node()));
+  return true;
+}
+
+bool expand_expr_left_right() {
+  {
+    /* add-op associates to the left */
+    PARSE(assignment_stmt, "x = a - b - c");
+    auto c{st.cursor()};
+    c.down().next(2);
+    Stmt::expand_down(c);
+    TEST_TAG(c->syntag, SG_LEVEL_2_EXPR);
+    c.down();
+    TEST_TAG(c->syntag, SG_LEVEL_2_EXPR);
+    TEST_INT(c->token_range.size(), 3);
+  }
+  {
+    /* power-op associates to the right, and binds tighter than unary minus */
+    PARSE(assignment_stmt, "x = -a ** b ** c");
+    auto c{st.cursor()};
+    c.down().next(2);
+    Stmt::expand_down(c);
+    TEST_TAG(c->syntag, SG_LEVEL_2_EXPR);
+    c.down().next();
+    TEST_TAG(c->syntag, SG_MULT_OPERAND);
+    c.down().next(2);
+    TEST_TAG(c->syntag, SG_MULT_OPERAND);
+    TEST_INT(c->token_range.size(), 3);
+  }
+  {
+    /* tokens that aren't a single expr are left alone */
+    PARSE(assignment_stmt, "x = a b");
+    auto c{st.cursor()};
+    c.down().next(2);
+    TEST_FALSE(Stmt::expand_expr(c.node()));
+    TEST_INT(c.num_branches(), 2);
+  }
+  return true;
+}
+
 int main() {
   TEST_MAIN_DECL;
   TEST(one_tok);
@@ -510,5 +607,7 @@ int main() {
   TEST(function_stmt);
   TEST(type_declaration_stmt);
   TEST(real_literal_constant);
+  TEST(expand_expr);
+  TEST(expand_expr_left_right);
   TEST_MAIN_REPORT;
 }
@@ -0,0 +1,106 @@
+/*
+   Copyright (c) 2019-2020, Triad National Security, LLC. All rights reserved.
+
+   This is open source software; you can redistribute it and/or modify it
+   under the terms of the BSD-3 License. If software is modified to produce
+   derivative works, such modified software should be clearly marked, so as
+   not to confuse it with the version available from LANL. Full text of the
+   BSD-3 License can be found in the LICENSE file of the repository.
+*/
+
+#include "flpr/Parsed_File.hh"
+#include "flpr/Prgm_Tree.hh"
+#include "test_helpers.hh"
+#include <iterator>
+#include <sstream>
+#include <string>
+
+using namespace FLPR;
+
+bool subtree_hashes() {
+  std::string const src{"subroutine s(i)\n"
+                        "integer :: i\n"
+                        "if (i > 0) then\n"
+                        "  i = 1\n"
+                        "end if\n"
+                        "end subroutine s\n"
+                        "subroutine t\n"
+                        "end subroutine t\n"};
+  std::istringstream is{src}, is2{src};
+  Parsed_File<> f(is, "hash.f90", 0), orig(is2, "hash.f90", 0);
+  TEST_TRUE(f.prefetch_parse_tree());
+  TEST_TRUE(orig.prefetch_parse_tree());
+  auto const &tree = f.parse_tree();
+  auto const &orig_tree = orig.parse_tree();
+  TEST_TRUE(Prgm::subtree_hash(*tree) == Prgm::subtree_hash(*orig_tree));
+  TEST_TRUE(Prgm::diff(orig_tree, tree).empty());
+
+  auto &stmts = f.statements();
+  auto const assign_stmt = std::next(stmts.begin(), 3);
+  auto const t_stmt = std::next(stmts.begin(), 6);
+  auto const t_node = f.stmt_to_node_cursor(t_stmt);
+  TEST_TRUE(t_node->has_hash());
+  auto const t_hash = t_node->hash();
+  auto const root_hash = Prgm::subtree_hash(*tree);
+
+  f.logical_file().replace_stmt_text(assign_stmt, {"  i = 2"},
+                                     Syntax_Tags::UNKNOWN);
+  TEST_TRUE(f.reparse_dirty());
+  TEST_FALSE(Prgm::subtree_hash(*tree) == root_hash);
+  /* The untouched subroutine kept its cached hash */
+  TEST_TRUE(t_node->has_hash());
+  TEST_TRUE(t_node->hash() == t_hash);
+
+  /* Only the edited statement is reported */
+  auto const d = Prgm::diff(orig_tree, tree);
+  TEST_INT(d.size(), 1);
+  TEST_TRUE(d[0].a != nullptr && d[0].b != nullptr);
+  TEST_TRUE((*d[0].b)->is_stmt());
+  TEST_TRUE(&(*d[0].b)->ll_stmt() == &*assign_stmt);
+
+  /* The lazily updated hash matches a fresh parse of the edited text */
+  std::ostringstream edited;
+  for (auto const &ll : f.logical_lines())
+    ll.print(edited) << '\n';
+  std::istringstream is3{edited.str()};
+  Parsed_File<> f3(is3, "hash.f90", 0);
+  TEST_TRUE(f3.prefetch_parse_tree());
+  TEST_TRUE(Prgm::subtree_hash(*f3.parse_tree()) == Prgm::subtree_hash(*tree));
+
+  /* An inserted statement is reported as added */
+  f.logical_file().emplace_ll_stmt(std::next(assign_stmt),
+                                   Logical_Line{"  i = 3"},
+                                   Syntax_Tags::UNKNOWN);
+  TEST_TRUE(f.reparse_dirty());
+  auto const d2 = Prgm::diff(f3.parse_tree(), tree);
+  TEST_INT(d2.size(), 1);
+  TEST_TRUE(d2[0].a == nullptr && d2[0].b != nullptr);
+
+  /* A new label is an edit too */
+  std::istringstream is4{src};
+  Parsed_File<> g(is4, "hash.f90", 0);
+  TEST_TRUE(g.prefetch_parse_tree());
+  auto const g_root_hash = Prgm::subtree_hash(*g.parse_tree());
+  auto const g_assign = std::next(g.statements().begin(), 3);
+  TEST_TRUE(g.logical_file().set_stmt_label(g_assign, 10));
+  TEST_TRUE(g.reparse_dirty());
+  TEST_FALSE(Prgm::subtree_hash(*g.parse_tree()) == g_root_hash);
+  auto const d3 = Prgm::diff(orig_tree, g.parse_tree());
+  TEST_INT(d3.size(), 1);
+  TEST_TRUE(d3[0].b != nullptr && &(*d3[0].b)->ll_stmt() == &*g_assign);
+  std::ostringstream relabeled;
+  for (auto const &ll : g.logical_lines())
+    ll.print(relabeled) << '\n';
+  std::istringstream is5{relabeled.str()};
+  Parsed_File<> g2(is5, "hash.f90", 0);
+  TEST_TRUE(g2.prefetch_parse_tree());
+  TEST_TRUE(Prgm::subtree_hash(*g2.parse_tree()) ==
+            Prgm::subtree_hash(*g.parse_tree()));
+  return true;
+}
+
+int main() {
+  TEST_MAIN_DECL;
+  TEST(subtree_hashes);
+  TEST_MAIN_REPORT;
+}
@@ -80,6 +80,17 @@ bool ext_test() {
   return true;
 }
 
+bool ext_freeze() {
+  const int ext_tag = FLPR::Syntax_Tags::CLIENT_EXTENSION + 3;
+  TEST_TRUE(FLPR::Syntax_Tags::register_ext(ext_tag, "mytag4", 5));
+  FLPR::Syntax_Tags::freeze_extensions();
+  TEST_TRUE(FLPR::Syntax_Tags::extensions_frozen());
+  TEST_FALSE(FLPR::Syntax_Tags::register_ext(ext_tag + 1, "mytag5", 5));
+  TEST_STR("mytag4", FLPR::Syntax_Tags::label(ext_tag));
+  TEST_STR("<client-extension+4>", FLPR::Syntax_Tags::label(ext_tag + 1));
+  return true;
+}
+
 int main() {
   TEST_MAIN_DECL;
   TEST(tag_bounds);
@@ -87,5 +98,6 @@ int main() {
   TEST(kw_type);
   TEST(tk_type);
   TEST(ext_test);
+  TEST(ext_freeze);
   TEST_MAIN_REPORT;
 }